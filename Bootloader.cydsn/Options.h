@@ -26,11 +26,130 @@
 #define NO                      (0u)
 #define YES                     (1u)
 
+/* This project exports the shared API table (Shared\sharedapi.h) */
+#define SHARED_API_EXPORT       (YES)
+
 
 /*******************************************************************************
 * Following section contains bootloadable project compile-time options.
 *******************************************************************************/
 
+/* Bootloader_Start() runs when a command packet is pending and at least
+ * once per service period (timebase ticks, Shared\timebase.h).
+ */
+#define BOOTLOADER_SERVICE_PERIOD       (32768u/10u)    /* 100 ms @ 32.768kHz clock */
+
+/* Print main loop wakeups per second and active CPU time over B_UART */
+#define LOOP_STATS_ENABLED              (NO)
+#define LOOP_STATS_WINDOW               (32768u)        /* 1 s @ 32.768kHz clock */
+#define LOOP_STATS_SYSTICK_RELOAD       (0x00FFFFFFu)
+
+/* Power state residency and Deep-Sleep refusal counters (powerstats.c).
+ * The counters are written to characteristic POWER_STATS_CHAR_INDEX of the
+ * custom "Lookup" service once per report period. The first one belongs to
+ * HelloApp's UART bridge (UART_BRIDGE_CHAR_INDEX), so the counters need a
+ * read-only characteristic of POWER_STATS_VALUE_SIZE bytes of their own
+ * after it in the BLE component; they stay disabled until it is added.
+ */
+#define POWER_STATS_ENABLED             (NO)
+#define POWER_STATS_DUMP_ENABLED        (NO)
+#define POWER_STATS_REPORT_PERIOD       (32768u * 10u)  /* 10 s @ 32.768kHz clock */
+#define POWER_STATS_CHAR_INDEX          (1u)
+#define POWER_STATS_CHAR_HANDLE         (cyBle_customs[0u].customServiceInfo[POWER_STATS_CHAR_INDEX].customServiceCharHandle)
+
+/* Record boot phase checkpoints (Shared\bootprof.h) and print the breakdown
+ * once the first advertisement has started.
+ */
+#define BOOT_PROFILE_ENABLED            (YES)
+
+/* BLE event trace ring (Shared\bletrace.h). Records are sent as GATT
+ * notifications on BLE_TRACE_CHAR_HANDLE while connected, once a
+ * characteristic for them is added to the BLE component, or printed over
+ * UART when BLE_TRACE_UART_ENABLED.
+ */
+#define BLE_TRACE_ENABLED               (YES)
+#define BLE_TRACE_SIZE                  (32u)    /* Records, power of two */
+#define BLE_TRACE_UART_ENABLED          (NO)
+#define BLE_TRACE_CHAR_HANDLE           (0u)
+
+/* Reset-surviving diagnostic log (Shared\diaglog.h), reported over UART at
+ * every boot.
+ */
+#define DIAG_LOG_ENABLED                (YES)
+
+/* Advertising schedule (Shared\advsched.h): directed advertising to the
+ * last central after an unexpected disconnect, then a back-off curve whose
+ * first stage lasts twice the usual reconnect time, between the limits
+ * below (s). ADV_SCHED_LAST_TIMEOUT is the length of the slowest stage (s);
+ * the Bootloader hibernates after it.
+ */
+#define ADV_SCHED_DIRECTED_ENABLED      (YES)
+#define ADV_SCHED_FAST_MIN              (2u)
+#define ADV_SCHED_FAST_MAX              (30u)
+#define ADV_SCHED_LAST_TIMEOUT          (120u)
+
+/* GATT database signature (Shared\gattsig.h): Service Changed is written at
+ * start only when a client last connected to a different database. NO
+ * writes it at every start. The first command latency is logged either way
+ * in the ota-start record of the diagnostic log.
+ */
+#define GATT_SIG_ENABLED                (YES)
+
+/* Deferred flash writes (Shared\flashsched.h) are made while connected only
+ * when the connection interval is at least this long (1.25 ms units), so a
+ * row write fits between two connection events.
+ */
+#define FLASH_SCHED_CONN_INTV_MIN       (24u)
+
+/* BLE event dispatch (Shared\bledispatch.h). With BLE_DISPATCH_STATS_ENABLED
+ * the CPU cycles of every handler call go into a histogram that is printed
+ * over UART each report period, and calls longer than BLE_DISPATCH_SLOW_US
+ * are added to the BLE event trace. Takes over SysTick.
+ */
+#define BLE_DISPATCH_STATS_ENABLED      (NO)
+#define BLE_DISPATCH_REPORT_PERIOD      (32768u * 10u)  /* 10 s @ 32.768kHz clock */
+#define BLE_DISPATCH_SLOW_US            (1000u)
+
+/* Buffer pool (Shared\bufpool.h): block size and count per class, smallest
+ * first. The 32 byte class holds the prepared write blocks of the live
+ * connection and of every session kept by otasession.h, so a kept long
+ * write cannot starve the central that is connected.
+ */
+#define BUF_POOL_CLASSES(X) \
+    X(32u, PREP_WRITE_BLOCKS * (OTA_SESSION_SLOTS + 1u))
+
+/* Prepared write reassembly (prepwrite.h). Fragments are packed into the
+ * blocks, so a command of up to CYBLE_BTS_COMMAND_MAX_LENGTH (144) bytes
+ * takes PREP_WRITE_BLOCKS blocks from the buffer pool at any MTU.
+ */
+#define PREP_WRITE_BLOCK_DATA           (24u)
+#define PREP_WRITE_BLOCKS               (6u)
+
+/* OTA session handoff (otasession.h). Sessions of up to OTA_SESSION_SLOTS
+ * centrals are kept after a link loss; a kept long write holds its blocks
+ * of the buffer pool until the central returns or OTA_SESSION_HOLD ends.
+ */
+#define OTA_SESSION_SLOTS               (2u)
+#define OTA_SESSION_HOLD                (32768u * 30u)  /* 30 s @ 32.768kHz clock */
+
+/* Image authentication (imageauth.h). The programmed rows are hashed as
+ * they arrive and the image launches only when IMAGE_AUTH_SIG_ROW holds
+ * an ECDSA P-256 signature of the digest, written by Tools\imagesign.c
+ * with the private key. The Bootloader verifies it with the public key
+ * IMAGE_AUTH_PUBLIC_KEY from imageauthkey.h next to this file, which is
+ * not under version control and has no default: create the key pair and
+ * the header for each product with
+ *   imagesign keygen <key file> imageauthkey.h
+ * or, from a key kept elsewhere, with imagesign header. Only the key
+ * file can sign; it never goes into a build.
+ * IMAGE_AUTH_PROFILE_ENABLED prints the hash cycles per row and the
+ * verification time over B_UART at the end of each session and takes
+ * over SysTick.
+ */
+#define IMAGE_AUTH_ENABLED              (YES)
+#define IMAGE_AUTH_PROFILE_ENABLED      (NO)
+#define IMAGE_AUTH_SIG_ROW              (CY_FLASH_NUMBER_ROWS - 2u)
+
 
 #endif /* Options_H */
 
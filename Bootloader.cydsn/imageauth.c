@@ -0,0 +1,486 @@
+/*******************************************************************************
+* File Name: imageauth.c
+*
+* Version 1.30
+*
+* Description:
+*  Image authentication; see imageauth.h. The Bootloader component gives no
+*  hook into its flash writes, so the pending command packet is inspected
+*  before Bootloader_Start() parses it and the programmed row is hashed
+*  from flash afterwards. Hashing what is in flash rather than what was
+*  received also covers a write that failed: the host sends the row again
+*  and its hash input is replaced.
+*
+*  The application checksum the Bootloader validates is an 8-bit sum that
+*  an image can be built to match, so a failed image is not launched
+*  because of the seal rather than a broken checksum: the Exit Bootloader
+*  command that would launch it is dropped, and after a reset the
+*  Bootloader is scheduled to stay.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "main.h"
+#include "imageauth.h"
+#include "diaglog.h"
+#if (IMAGE_AUTH_PROFILE_ENABLED == YES)
+    #include "timebase.h"
+#endif /* (IMAGE_AUTH_PROFILE_ENABLED == YES) */
+
+#if (IMAGE_AUTH_ENABLED == YES)
+
+/* Per-build public key, see Options.h */
+#if defined(__has_include)
+    #if !__has_include("imageauthkey.h")
+        #error imageauthkey.h is missing: create it with Tools\imagesign.c keygen or header
+    #endif
+#endif /* defined(__has_include) */
+#include "imageauthkey.h"
+#if !defined(IMAGE_AUTH_PUBLIC_KEY)
+    #error imageauthkey.h does not define IMAGE_AUTH_PUBLIC_KEY: create it again with Tools\imagesign.c header
+#endif /* !defined(IMAGE_AUTH_PUBLIC_KEY) */
+
+#define IMAGE_AUTH_NO_ROW               (0xFFFFFFFFu)
+#define IMAGE_AUTH_SYSTICK_RELOAD       (0x00FFFFFFu)
+
+#define IMAGE_AUTH_ROW_ADDRESS(row)     (CYDEV_FLASH_BASE + ((row) * CY_FLASH_SIZEOF_ROW))
+#define IMAGE_AUTH_ROW_NUMBER(address)  (((address) - CYDEV_FLASH_BASE) / CY_FLASH_SIZEOF_ROW)
+
+/* Filled from the Bootloader Service by the BLE component, see prepwrite.c */
+extern uint8 *cyBle_btsBuffPtr;
+
+static const uint8 imageAuthPublicKey[P256_PUBLIC_KEY_SIZE] = IMAGE_AUTH_PUBLIC_KEY;
+
+/* Built sealed, so an image programmed together with the Bootloader
+ * launches; rewritten by ImageAuth_Seal().
+ */
+CY_ALIGN(CY_FLASH_SIZEOF_ROW)
+static const IMAGE_AUTH_SEAL_ROW_T imageAuthSealRow = { IMAGE_AUTH_SEALED, { 0u } };
+
+static SHA256_CTX_T imageAuthHash;
+static SHA256_CTX_T imageAuthPrevious;  /* Before the last row, for a retry */
+static uint32 imageAuthPending;
+static uint32 imageAuthPendingArray;
+static uint32 imageAuthPendingRow;
+static uint32 imageAuthLastRow;
+static uint32 imageAuthWritten;         /* A Program Row was seen in this session */
+static uint32 imageAuthFailure;         /* IMAGE_AUTH_FAIL_*, 0 while valid */
+static IMAGE_AUTH_STATS_T imageAuthStats;
+
+static void ImageAuth_Begin(void);
+static void ImageAuth_Verify(void);
+static uint32 ImageAuth_IsSealed(void);
+static void ImageAuth_Seal(uint32 seal);
+static void ImageAuth_Drop(void);
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_Begin()
+********************************************************************************
+*
+* Summary:
+*   Starts the hash of a new session.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void ImageAuth_Begin(void)
+{
+    Sha256_Init(&imageAuthHash);
+    imageAuthPending = 0u;
+    imageAuthLastRow = IMAGE_AUTH_NO_ROW;
+    imageAuthWritten = 0u;
+    imageAuthFailure = 0u;
+    (void) memset(&imageAuthStats, 0, sizeof(imageAuthStats));
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_Start()
+********************************************************************************
+*
+* Summary:
+*   Initializes the session hash and keeps an image that is not sealed
+*   from being launched by the first Bootloader_Start() call. With
+*   IMAGE_AUTH_PROFILE_ENABLED SysTick is started as a free-running cycle
+*   counter, unless another profiler already runs it the same way.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void ImageAuth_Start(void)
+{
+    ImageAuth_Begin();
+
+    /* A reset in the middle of an upload, or after a failed one */
+    if(0u == ImageAuth_IsSealed())
+    {
+        Bootloader_SET_RUN_TYPE(Bootloader_SCHEDULE_BTLDR);
+    }
+
+#if (IMAGE_AUTH_PROFILE_ENABLED == YES)
+    if(0u == (CY_SYS_SYST_CSR_REG & CY_SYS_SYST_CSR_ENABLE))
+    {
+        CY_SYS_SYST_RVR_REG = IMAGE_AUTH_SYSTICK_RELOAD;
+        CY_SYS_SYST_CVR_REG = 0u;
+        CY_SYS_SYST_CSR_REG = CY_SYS_SYST_CSR_ENABLE | CY_SYS_SYST_CSR_CLK_SRC_SYSCLK;
+    }
+#endif /* (IMAGE_AUTH_PROFILE_ENABLED == YES) */
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_Inspect()
+********************************************************************************
+*
+* Summary:
+*   Looks at the command packet Bootloader_Start() is about to process.
+*   Enter Bootloader starts a new session and fails one that programmed
+*   rows. The first Program Row of a session breaks the seal before the
+*   row is written and is remembered for ImageAuth_Update(). Erase Row
+*   is dropped and fails the session, in case the component has it. Exit
+*   Bootloader verifies the signature of a session that programmed rows;
+*   it is dropped unless the image is sealed afterwards.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Zero if the packet was dropped and Bootloader_Start() must not run.
+*
+*******************************************************************************/
+uint32 ImageAuth_Inspect(void)
+{
+    const uint8 *packet;
+    uint32 length;
+    uint32 dataLength;
+    uint32 process = 1u;
+
+    if(0u != packetRXFlag)
+    {
+        packet = packetRX;
+        length = packetRXSize;
+    }
+    else if(0u != cyBle_cmdReceivedFlag)
+    {
+        packet = cyBle_btsBuffPtr;
+        length = cyBle_cmdLength;
+    }
+    else
+    {
+        return process;
+    }
+
+    /* A malformed packet is rejected by the Bootloader as well */
+    if((length < IMAGE_AUTH_PACKET_OVERHEAD) || (packet[0u] != IMAGE_AUTH_PACKET_SOP) ||
+       (packet[length - 1u] != IMAGE_AUTH_PACKET_EOP))
+    {
+        return process;
+    }
+    dataLength = (uint32) packet[2u] | ((uint32) packet[3u] << 8u);
+    if((dataLength + IMAGE_AUTH_PACKET_OVERHEAD) != length)
+    {
+        return process;
+    }
+
+    switch(packet[1u])
+    {
+        case IMAGE_AUTH_CMD_ENTER:
+            /* The image in flash is part old, part new; it stays unsealed */
+            if(0u != imageAuthWritten)
+            {
+                DiagLog_Append(DIAG_EVT_OTA_AUTH_FAIL, IMAGE_AUTH_FAIL_RESTART);
+            }
+            ImageAuth_Begin();
+            break;
+        case IMAGE_AUTH_CMD_PROGRAM_ROW:
+            if(0u != ImageAuth_IsSealed())
+            {
+                ImageAuth_Seal(0u);
+            }
+            imageAuthWritten = 1u;
+            if(dataLength >= 3u)
+            {
+                imageAuthPendingArray = packet[4u];
+                imageAuthPendingRow = (uint32) packet[5u] | ((uint32) packet[6u] << 8u);
+                imageAuthPending = 1u;
+            }
+            break;
+        case IMAGE_AUTH_CMD_ERASE_ROW:
+            /* Not hashed; the image can no longer pass in this session */
+            if(0u != ImageAuth_IsSealed())
+            {
+                ImageAuth_Seal(0u);
+            }
+            imageAuthWritten = 1u;
+            if(0u == imageAuthFailure)
+            {
+                imageAuthFailure = IMAGE_AUTH_FAIL_UNHASHED;
+            }
+            ImageAuth_Drop();
+            process = 0u;
+            break;
+        case IMAGE_AUTH_CMD_EXIT:
+            if(0u != imageAuthWritten)
+            {
+                ImageAuth_Verify();
+            }
+            else if(0u == ImageAuth_IsSealed())
+            {
+                DiagLog_Append(DIAG_EVT_OTA_AUTH_FAIL, IMAGE_AUTH_FAIL_NOT_SEALED);
+            }
+            else
+            {
+                /* The sealed image in flash is launched */
+            }
+
+            /* Exit has no response; the host sees the device stay */
+            if(0u == ImageAuth_IsSealed())
+            {
+                ImageAuth_Drop();
+                process = 0u;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return process;
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_Update()
+********************************************************************************
+*
+* Summary:
+*   Adds the row programmed by the last Bootloader_Start() call to the
+*   session hash. A row below the last one fails the session; the last row
+*   sent again is hashed again from the state before it.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void ImageAuth_Update(void)
+{
+    uint8 record[3u];
+    uint32 row = imageAuthPendingRow;
+#if (IMAGE_AUTH_PROFILE_ENABLED == YES)
+    uint32 start;
+    uint32 cycles;
+#endif /* (IMAGE_AUTH_PROFILE_ENABLED == YES) */
+
+    if((0u == imageAuthPending) || (row == IMAGE_AUTH_SIG_ROW))
+    {
+        imageAuthPending = 0u;
+        return;
+    }
+    imageAuthPending = 0u;
+
+    if(0u != imageAuthFailure)
+    {
+        return;
+    }
+    if((imageAuthPendingArray != 0u) || (row >= CY_FLASH_NUMBER_ROWS) ||
+       ((imageAuthLastRow != IMAGE_AUTH_NO_ROW) && (row < imageAuthLastRow)))
+    {
+        imageAuthFailure = IMAGE_AUTH_FAIL_ORDER;
+        return;
+    }
+
+#if (IMAGE_AUTH_PROFILE_ENABLED == YES)
+    start = CY_SYS_SYST_CVR_REG;
+#endif /* (IMAGE_AUTH_PROFILE_ENABLED == YES) */
+
+    if(row == imageAuthLastRow)
+    {
+        imageAuthHash = imageAuthPrevious;
+        imageAuthStats.retries++;
+    }
+    else
+    {
+        imageAuthPrevious = imageAuthHash;
+        imageAuthLastRow = row;
+        imageAuthStats.rows++;
+    }
+
+    record[0u] = (uint8) imageAuthPendingArray;
+    record[1u] = (uint8) row;
+    record[2u] = (uint8) (row >> 8u);
+    Sha256_Update(&imageAuthHash, record, sizeof(record));
+    Sha256_Update(&imageAuthHash, (const uint8 *) IMAGE_AUTH_ROW_ADDRESS(row), CY_FLASH_SIZEOF_ROW);
+
+#if (IMAGE_AUTH_PROFILE_ENABLED == YES)
+    cycles = (start - CY_SYS_SYST_CVR_REG) & IMAGE_AUTH_SYSTICK_RELOAD;
+    imageAuthStats.hashCyclesTotal += cycles;
+    if(cycles > imageAuthStats.hashCyclesMax)
+    {
+        imageAuthStats.hashCyclesMax = cycles;
+    }
+#endif /* (IMAGE_AUTH_PROFILE_ENABLED == YES) */
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_Verify()
+********************************************************************************
+*
+* Summary:
+*   Finalizes the digest and verifies the signature row, which takes most
+*   of the time at the end of the session. The image is sealed when it
+*   passes; a failed session is logged and leaves it unsealed.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void ImageAuth_Verify(void)
+{
+    const IMAGE_AUTH_SIG_T *signature = (const IMAGE_AUTH_SIG_T *) IMAGE_AUTH_ROW_ADDRESS(IMAGE_AUTH_SIG_ROW);
+    uint8 digest[SHA256_DIGEST_SIZE];
+    uint32 reason = imageAuthFailure;
+#if (IMAGE_AUTH_PROFILE_ENABLED == YES)
+    uint32 start = Timebase_Now();          /* Longer than a SysTick period */
+    char8 report[112u];
+#endif /* (IMAGE_AUTH_PROFILE_ENABLED == YES) */
+
+    if(0u == reason)
+    {
+        Sha256_Final(&imageAuthHash, digest);
+        if(signature->magic != IMAGE_AUTH_MAGIC)
+        {
+            reason = IMAGE_AUTH_FAIL_NO_SIGNATURE;
+        }
+        else if(signature->rowCount != imageAuthStats.rows)
+        {
+            reason = IMAGE_AUTH_FAIL_ROW_COUNT;
+        }
+        else if(0u == P256_Verify(imageAuthPublicKey, digest, signature->signature))
+        {
+            reason = IMAGE_AUTH_FAIL_SIGNATURE;
+        }
+        else
+        {
+            /* Signed by the holder of the private key */
+        }
+    }
+
+#if (IMAGE_AUTH_PROFILE_ENABLED == YES)
+    imageAuthStats.verifyUs = TIMEBASE_TICKS_TO_US(Timebase_Now() - start);
+    (void) sprintf(report, "image-auth: %lu rows, %lu retries, hash %lu/%lu cycles/row, verify %lu us\r\n",
+        (unsigned long) imageAuthStats.rows, (unsigned long) imageAuthStats.retries,
+        (unsigned long) ((0u != imageAuthStats.rows) ? (imageAuthStats.hashCyclesTotal /
+            (imageAuthStats.rows + imageAuthStats.retries)) : 0u),
+        (unsigned long) imageAuthStats.hashCyclesMax, (unsigned long) imageAuthStats.verifyUs);
+    B_UART_PutString(report);
+#endif /* (IMAGE_AUTH_PROFILE_ENABLED == YES) */
+
+    if(0u != reason)
+    {
+        DiagLog_Append(DIAG_EVT_OTA_AUTH_FAIL, reason);
+    }
+    else
+    {
+        ImageAuth_Seal(IMAGE_AUTH_SEALED);
+    }
+
+    /* A repeated Exit must not finalize the hash again */
+    ImageAuth_Begin();
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_IsSealed()
+********************************************************************************
+*
+* Summary:
+*   Reads the seal from flash; the compiler must not use the initializer.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Non-zero if the image in flash passed and was not changed since.
+*
+*******************************************************************************/
+static uint32 ImageAuth_IsSealed(void)
+{
+    return (uint32) (*((const volatile uint32 *) &imageAuthSealRow.seal) == IMAGE_AUTH_SEALED);
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_Seal()
+********************************************************************************
+*
+* Summary:
+*   Writes the seal row. The write is done at once: breaking the seal must
+*   be in flash before the first row of a session is.
+*
+* Parameters:
+*   seal - IMAGE_AUTH_SEALED, or 0 to break the seal
+*
+*******************************************************************************/
+static void ImageAuth_Seal(uint32 seal)
+{
+    IMAGE_AUTH_SEAL_ROW_T sealRow;
+
+    (void) memset(&sealRow, 0, sizeof(sealRow));
+    sealRow.seal = seal;
+    (void) CySysFlashWriteRow(IMAGE_AUTH_ROW_NUMBER((uint32) &imageAuthSealRow), (const uint8 *) &sealRow);
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_Drop()
+********************************************************************************
+*
+* Summary:
+*   Discards the pending command packet, as CyBtldrCommRead() would after
+*   reading it.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void ImageAuth_Drop(void)
+{
+    if(0u != packetRXFlag)
+    {
+        packetRXFlag = 0u;
+    }
+    else
+    {
+        cyBle_cmdReceivedFlag = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ImageAuth_GetStats()
+********************************************************************************
+*
+* Summary:
+*   Copies the counters of the current session.
+*
+* Parameters:
+*   stats - destination
+*
+*******************************************************************************/
+void ImageAuth_GetStats(IMAGE_AUTH_STATS_T *stats)
+{
+    *stats = imageAuthStats;
+}
+
+#endif /* (IMAGE_AUTH_ENABLED == YES) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,122 @@
+/*******************************************************************************
+* File Name: imageauth.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the image
+*  authentication. Every row the Bootloader programs in an OTA session is
+*  read back from flash and added to a SHA-256 hash as
+*   array ID (1 byte) | row number (2 bytes, little endian) | row data,
+*  in the order programmed, which must be ascending. The host signs the
+*  resulting digest and uploads the signature in a row of its own,
+*  IMAGE_AUTH_SIG_ROW, which is not hashed. On the Exit Bootloader command
+*  the digest is finalized and the signature is checked once.
+*
+*  Whether the image in flash may launch is kept in a seal row owned by the
+*  Bootloader. The first Program Row of a session breaks the seal before
+*  the row is written, and only a matching signature seals the image again.
+*  An unsealed image is never launched: Exit Bootloader is dropped and,
+*  after a reset, the Bootloader is scheduled to stay. This covers a reset
+*  or link loss during an upload, an Enter Bootloader that restarts one,
+*  which fails the session, and an Exit without rows after a failed one.
+*  Erase Row is not hashed, and an erased row reads as instructions that
+*  do nothing: it is dropped, breaks the seal and fails the session.
+*
+*  The signature is an ECDSA P-256 signature of the digest (p256.h) by
+*  the private key kept with Tools\imagesign.c; the Bootloader only holds
+*  the public key, IMAGE_AUTH_PUBLIC_KEY of the per-build imageauthkey.h,
+*  so reading its flash does not allow signing an image. HelloApp keeps
+*  IMAGE_AUTH_SIG_ROW free as its checksum exclude section. The last row
+*  sent again, after an error response or a reconnect, replaces its
+*  previous hash input.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(IMAGEAUTH_H)
+#define IMAGEAUTH_H
+
+#include <project.h>
+#include "Options.h"
+#include "sha256.h"
+#include "p256.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Bootloader packet: SOP, command, length (2), data, checksum (2), EOP */
+#define IMAGE_AUTH_PACKET_SOP           (0x01u)
+#define IMAGE_AUTH_PACKET_EOP           (0x17u)
+#define IMAGE_AUTH_PACKET_OVERHEAD      (7u)
+#define IMAGE_AUTH_CMD_ERASE_ROW        (0x34u)
+#define IMAGE_AUTH_CMD_ENTER            (0x38u)
+#define IMAGE_AUTH_CMD_PROGRAM_ROW      (0x39u)
+#define IMAGE_AUTH_CMD_EXIT             (0x3Bu)
+
+/* "IAS2", first word of the signature row */
+#define IMAGE_AUTH_MAGIC                (0x32534149u)
+
+/* "IAOK", seal of an image that passed and was not changed since */
+#define IMAGE_AUTH_SEALED               (0x4B4F4149u)
+
+/* Reasons for DIAG_EVT_OTA_AUTH_FAIL */
+#define IMAGE_AUTH_FAIL_ORDER           (1u)    /* A row below the last one, or in another array */
+#define IMAGE_AUTH_FAIL_NO_SIGNATURE    (2u)    /* The signature row was not programmed */
+#define IMAGE_AUTH_FAIL_ROW_COUNT       (3u)    /* The image was signed with other rows */
+#define IMAGE_AUTH_FAIL_SIGNATURE       (4u)    /* The signature does not match */
+#define IMAGE_AUTH_FAIL_RESTART         (5u)    /* Enter Bootloader after rows were programmed */
+#define IMAGE_AUTH_FAIL_NOT_SEALED      (6u)    /* Exit without rows, the image in flash did not pass */
+#define IMAGE_AUTH_FAIL_UNHASHED        (7u)    /* A command that changes flash without being hashed */
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Layout of IMAGE_AUTH_SIG_ROW */
+typedef struct
+{
+    uint32 magic;                       /* IMAGE_AUTH_MAGIC */
+    uint32 rowCount;                    /* Rows hashed */
+    uint8  signature[P256_SIGNATURE_SIZE];  /* r | s of the digest */
+} IMAGE_AUTH_SIG_T;
+
+/* The seal takes a whole row so that writing it does not erase anything else */
+typedef struct
+{
+    uint32 seal;                        /* IMAGE_AUTH_SEALED, or 0 */
+    uint8  reserved[CY_FLASH_SIZEOF_ROW - 4u];
+} IMAGE_AUTH_SEAL_ROW_T;
+
+typedef struct
+{
+    uint32 rows;                        /* Rows hashed in this session */
+    uint32 retries;                     /* Rows hashed again */
+    uint32 hashCyclesTotal;             /* With IMAGE_AUTH_PROFILE_ENABLED */
+    uint32 hashCyclesMax;
+    uint32 verifyUs;                    /* Digest and signature, in microseconds */
+} IMAGE_AUTH_STATS_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+#if (IMAGE_AUTH_ENABLED == YES)
+    void ImageAuth_Start(void);
+    uint32 ImageAuth_Inspect(void);
+    void ImageAuth_Update(void);
+    void ImageAuth_GetStats(IMAGE_AUTH_STATS_T *stats);
+#endif /* (IMAGE_AUTH_ENABLED == YES) */
+
+#endif /* IMAGEAUTH_H */
+
+
+/* [] END OF FILE */
@@ -28,13 +28,83 @@
 *******************************************************************************/
 
 #include "main.h"
+#include "timebase.h"
+#include "powerstats.h"
+#include "bootprof.h"
+#include "bletrace.h"
+#include "diaglog.h"
+#include "advsched.h"
+#include "gattsig.h"
+#include "flashsched.h"
+#include "bledispatch.h"
+#include "bufpool.h"
+#include "prepwrite.h"
+#include "otasession.h"
+#include "imageauth.h"
 
 CYBLE_CONN_HANDLE_T connHandle;
 
+/* Timebase tick of the last Bootloader_Start() call */
+static uint32 lastServiceTime;
+
+/* Timebase tick of the last connection, for the first command latency */
+static uint32 connectTime;
+
+#if (GATT_SIG_ENABLED == YES)
+    /* Signature of the GATT database this image shows */
+    static uint32 dbSignature;
+#endif /* (GATT_SIG_ENABLED == YES) */
+
+#if (LOOP_STATS_ENABLED == YES)
+    static uint32 loopStatsWindowStart;
+    static uint32 loopStatsPassStart;
+    static uint32 loopStatsWakeups;
+    static uint32 loopStatsActiveCycles;
+    static uint32 loopStatsPackets;
+#endif /* (LOOP_STATS_ENABLED == YES) */
+
 #if defined(__ARMCC_VERSION)
     static unsigned long keep_me __attribute__((used));
 #endif /* defined(__ARMCC_VERSION) */
 static void LowPowerImplementation(void);
+static uint32 GetPendingWork(void);
+#if (GATT_SIG_ENABLED == YES)
+    static uint32 ServicesSignature(void);
+#endif /* (GATT_SIG_ENABLED == YES) */
+#if (LOOP_STATS_ENABLED == YES)
+    static void LoopStatsStart(void);
+    static void LoopStatsUpdate(uint32 events);
+#endif /* (LOOP_STATS_ENABLED == YES) */
+static void OnStackOn(uint32 event, void *eventParam);
+static void OnHardwareError(uint32 event, void *eventParam);
+static void OnConnected(uint32 event, void *eventParam);
+static void OnDisconnected(uint32 event, void *eventParam);
+static void OnConnectionUpdate(uint32 event, void *eventParam);
+static void OnAdvertisementStartStop(uint32 event, void *eventParam);
+static void OnGattConnect(uint32 event, void *eventParam);
+
+/* BLE event handlers (Shared\bledispatch.h). CYBLE_EVT_PENDING_FLASH_WRITE
+ * has none: FlashSched_Task() writes the data in an idle window.
+ */
+#define APP_BLE_HANDLERS(X) \
+    X(CYBLE_EVT_STACK_ON,                           OnStackOn) \
+    X(CYBLE_EVT_HARDWARE_ERROR,                     OnHardwareError) \
+    X(CYBLE_EVT_GAP_DEVICE_CONNECTED,               OnConnected) \
+    X(CYBLE_EVT_GAP_DEVICE_DISCONNECTED,            OnDisconnected) \
+    X(CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE,    OnConnectionUpdate) \
+    X(CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP,      OnAdvertisementStartStop) \
+    X(CYBLE_EVT_GATT_CONNECT_IND,                   OnGattConnect) \
+    X(CYBLE_EVT_GATT_CONNECT_IND,                   OtaSession_Event) \
+    X(CYBLE_EVT_GATT_DISCONNECT_IND,                OnGattConnect) \
+    X(CYBLE_EVT_GATT_DISCONNECT_IND,                OtaSession_Event) \
+    X(CYBLE_EVT_GATT_DISCONNECT_IND,                PrepWrite_Event) \
+    X(CYBLE_EVT_GATTS_PREP_WRITE_REQ,               PrepWrite_Event) \
+    X(CYBLE_EVT_GATTS_EXEC_WRITE_REQ,               PrepWrite_Event)
+
+static const BLE_DISPATCH_ENTRY_T appBleHandlers[] =
+{
+    APP_BLE_HANDLERS(BLE_DISPATCH_ENTRY)
+};
 
 
 /*******************************************************************************
@@ -56,18 +126,39 @@ int main()
 {
     const char8 serialNumber[] = "123456";
     
+    /* cy_boot has already initialized RAM when main() is entered */
+    BootProf_Begin(BOOT_PROFILE_IMAGE_BOOTLOADER, &B_UART_PutString);
+    BootProf_Mark(BOOT_PHASE_SRAM_INIT);
+    DiagLog_Begin(DIAG_IMAGE_BOOTLOADER);
+
 #if defined(__ARMCC_VERSION)    
     keep_me = Image$$DATA$$ZI$$Limit;
     CyReturnToBootloaddableAddress = 0u;
 #endif /*__ARMCC_VERSION*/    
 
-
     packetRXFlag = 0u;
     B_UART_PutString("Bootloader\n\r");
+    DiagLog_Report(&B_UART_PutString);
     
+    Timebase_Start();
+    lastServiceTime = Timebase_Now();
+    BufPool_Start();
+#if (IMAGE_AUTH_ENABLED == YES)
+    ImageAuth_Start();
+#endif /* (IMAGE_AUTH_ENABLED == YES) */
+#if (POWER_STATS_ENABLED == YES)
+    PowerStats_Start();
+#endif /* (POWER_STATS_ENABLED == YES) */
+#if (LOOP_STATS_ENABLED == YES)
+    LoopStatsStart();
+#endif /* (LOOP_STATS_ENABLED == YES) */
+
     CyGlobalIntEnable;
 
-    CyBle_Start(AppCallBack);
+    BootProf_Mark(BOOT_PHASE_BLE_START);
+    PrepWrite_Start();
+    BleDispatch_Init(appBleHandlers, BLE_DISPATCH_COUNT(appBleHandlers));
+    CyBle_Start(&BleDispatch_Event);
     
     /* Set Serial Number string not initialized in GUI */
     CyBle_DissSetCharacteristicValue(CYBLE_DIS_SERIAL_NUMBER, sizeof(serialNumber), (uint8 *)serialNumber);
@@ -77,125 +168,383 @@ int main()
     CyBle_GattsDisableAttribute(cyBle_bass[0].serviceHandle);
     CyBle_GattsDisableAttribute(cyBle_scpss.serviceHandle);
 
-    /* Force client to rediscover services in range of bootloader service */
-    WriteAttrServChanged();
+#if (GATT_SIG_ENABLED == YES)
+    /* A client that last connected to this same database keeps its cache */
+    dbSignature = ServicesSignature();
+    if(0u == GattSig_Matches(dbSignature))
+#endif /* (GATT_SIG_ENABLED == YES) */
+    {
+        /* Force client to rediscover services in range of bootloader service */
+        WriteAttrServChanged();
+    }
     
     while(1u == 1u)
     {
+        uint32 events;
+
+    #if (LOOP_STATS_ENABLED == YES)
+        loopStatsPassStart = CY_SYS_SYST_CVR_REG;
+    #endif /* (LOOP_STATS_ENABLED == YES) */
+
         /* CyBle_ProcessEvents() allows BLE stack to process pending events */
         CyBle_ProcessEvents();
 
-        /* To achieve low power in the device */
-        LowPowerImplementation();
+        /* Parse bootloader commands only when a packet has arrived or the
+         * service period has elapsed, not on every wakeup.
+         */
+        events = GetPendingWork();
+        if(0u != events)
+        {
+            if((0u != (events & LOOP_EVT_PACKET)) && (DiagLog_GetOtaState() != DIAG_OTA_IN_PROGRESS))
+            {
+                uint32 latency = TIMEBASE_TICKS_TO_MS(Timebase_Now() - connectTime);
+
+                DiagLog_Append(DIAG_EVT_OTA_START, (latency > 0xFFFFu) ? 0xFFFFu : latency);
+            }
+            if(0u != (events & LOOP_EVT_PACKET))
+            {
+                /* No deferred flash write may delay the OTA session */
+                FlashSched_Hold(1u);
+            }
+            lastServiceTime = Timebase_Now();
+        #if (IMAGE_AUTH_ENABLED == YES)
+            if(0u != ImageAuth_Inspect())
+            {
+                Bootloader_Start();
+                ImageAuth_Update();
+            }
+        #else
+            Bootloader_Start();
+        #endif /* (IMAGE_AUTH_ENABLED == YES) */
+        }
+
+    #if (LOOP_STATS_ENABLED == YES)
+        LoopStatsUpdate(events);
+    #endif /* (LOOP_STATS_ENABLED == YES) */
+
+    #if (POWER_STATS_ENABLED == YES)
+        PowerStats_Task();
+    #endif /* (POWER_STATS_ENABLED == YES) */
 
-        Bootloader_Start();
+        BleTrace_Task(&B_UART_PutString);
+
+        BleDispatch_Task(&B_UART_PutString);
+
+        FlashSched_Task();
+
+        OtaSession_Task();
+
+        /* To achieve low power in the device. The CPU wakes up on the next
+         * BLE interrupt.
+         */
+        LowPowerImplementation();
     }
 }
 
 
 /*******************************************************************************
-* Function Name: AppCallBack()
+* Function Name: GetPendingWork()
 ********************************************************************************
 *
 * Summary:
-*   This function handles events that are generated by BLE stack.
+*   Collects the reasons to run bootloader command processing.
 *
 * Parameters:
 *   None
 *
 * Return:
+*   LOOP_EVT_* mask, zero when there is no work.
+*
+*******************************************************************************/
+static uint32 GetPendingWork(void)
+{
+    uint32 events = 0u;
+
+    if((0u != packetRXFlag) || (0u != cyBle_cmdReceivedFlag))
+    {
+        events |= LOOP_EVT_PACKET;
+    }
+    if((Timebase_Now() - lastServiceTime) >= BOOTLOADER_SERVICE_PERIOD)
+    {
+        events |= LOOP_EVT_TIMER;
+    }
+
+    return events;
+}
+
+
+#if (LOOP_STATS_ENABLED == YES)
+/*******************************************************************************
+* Function Name: LoopStatsStart()
+********************************************************************************
+*
+* Summary:
+*   Starts SysTick as a free-running CPU cycle counter. Each pass is timed
+*   from its start to LowPowerImplementation(), so sleep time and the
+*   report printing are not counted as active.
+*
+* Parameters:
 *   None
 *
 *******************************************************************************/
-void AppCallBack(uint32 event, void* eventParam)
+static void LoopStatsStart(void)
+{
+    CY_SYS_SYST_CSR_REG = 0u;
+    CY_SYS_SYST_RVR_REG = LOOP_STATS_SYSTICK_RELOAD;
+    CY_SYS_SYST_CVR_REG = 0u;
+    CY_SYS_SYST_CSR_REG = CY_SYS_SYST_CSR_ENABLE | CY_SYS_SYST_CSR_CLK_SRC_SYSCLK;
+
+    loopStatsWindowStart = Timebase_Now();
+}
+
+
+/*******************************************************************************
+* Function Name: LoopStatsUpdate()
+********************************************************************************
+*
+* Summary:
+*   Accounts one main loop pass and prints the wakeup rate and the active
+*   CPU time once per LOOP_STATS_WINDOW. A window in which packets were
+*   processed is reported as "transfer", otherwise as idle.
+*
+* Parameters:
+*   events - work dispatched in this pass
+*
+*******************************************************************************/
+static void LoopStatsUpdate(uint32 events)
+{
+    uint32 window;
+
+    loopStatsWakeups++;
+    loopStatsActiveCycles += (loopStatsPassStart - CY_SYS_SYST_CVR_REG) & LOOP_STATS_SYSTICK_RELOAD;
+    if(0u != (events & LOOP_EVT_PACKET))
+    {
+        loopStatsPackets++;
+    }
+
+    window = Timebase_Now() - loopStatsWindowStart;
+    if(window >= LOOP_STATS_WINDOW)
+    {
+        char8 report[80u];
+        /* Rates per second as count * 32 / (window / 1024) to stay in 32 bits */
+        uint32 window1k = window / 1024u;
+
+        (void) sprintf(report, "loop %s: %lu wakeups/s, %lu us/s active, %lu packets\r\n",
+            (0u != loopStatsPackets) ? "transfer" :
+            ((CyBle_GetState() == CYBLE_STATE_CONNECTED) ? "idle-connected" : "idle"),
+            (unsigned long) ((loopStatsWakeups * 32u) / window1k),
+            (unsigned long) (((loopStatsActiveCycles / CYDEV_BCLK__SYSCLK__MHZ) * 32u) / window1k),
+            (unsigned long) loopStatsPackets);
+        B_UART_PutString(report);
+
+        loopStatsWindowStart += window;
+        loopStatsWakeups = 0u;
+        loopStatsActiveCycles = 0u;
+        loopStatsPackets = 0u;
+    }
+}
+#endif /* (LOOP_STATS_ENABLED == YES) */
+
+
+/*******************************************************************************
+* Function Name: OnStackOn()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_STACK_ON: the component has started. Enters discoverable mode
+*   so that the remote can search for the device.
+*
+* Parameters:
+*   event - event code
+*   eventParam - event parameter
+*
+*******************************************************************************/
+static void OnStackOn(uint32 event, void *eventParam)
+{
+    CYBLE_API_RESULT_T apiResult;
+
+    (void) event;
+    (void) eventParam;
+
+    BootProf_Mark(BOOT_PHASE_STACK_ON);
+    apiResult = AdvSched_Start(ADV_SCHED_REASON_BOOT);
+    if(apiResult != CYBLE_ERROR_OK)
+    {
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OnHardwareError()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_HARDWARE_ERROR: some internal HW error has occurred.
+*
+* Parameters:
+*   event - event code
+*   eventParam - event parameter
+*
+*******************************************************************************/
+static void OnHardwareError(uint32 event, void *eventParam)
+{
+    (void) event;
+    (void) eventParam;
+
+    DiagLog_Append(DIAG_EVT_HW_ERROR, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: OnConnected()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GAP_DEVICE_CONNECTED: requests the short connection interval
+*   of the OTA transfer when the central chose a longer one.
+*
+* Parameters:
+*   event - event code
+*   eventParam - CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T
+*
+*******************************************************************************/
+static void OnConnected(uint32 event, void *eventParam)
 {
     CYBLE_API_RESULT_T apiResult;
     CYBLE_GAP_CONN_UPDATE_PARAM_T connUpdateParam;
-    
-    switch (event)
+
+    (void) event;
+
+    DiagLog_Append(DIAG_EVT_CONNECTED, (*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv);
+    AdvSched_Connected();
+    FlashSched_SetConnInterval((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv);
+    connectTime = Timebase_Now();
+#if (GATT_SIG_ENABLED == YES)
+    GattSig_Seen(dbSignature);
+#endif /* (GATT_SIG_ENABLED == YES) */
+    if ((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv > 0x0006u)
     {
-        /**********************************************************
-        *                       General Events
-        ***********************************************************/
-        case CYBLE_EVT_STACK_ON: /* This event received when component is Started */
-            /* Enter into discoverable mode so that remote can search it. */
-            apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
-            if(apiResult != CYBLE_ERROR_OK)
-            {
-            }
-            break;
-        case CYBLE_EVT_HARDWARE_ERROR:    /* This event indicates that some internal HW error has occurred. */
-            break;
-            
-
-        /**********************************************************
-        *                       GAP Events
-        ***********************************************************/
-        case CYBLE_EVT_GAP_AUTH_REQ:
-            break;
-        case CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST:
-            break;
-        case CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST:
-            break;
-        case CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT:
-            break;
-        case CYBLE_EVT_GAP_AUTH_COMPLETE:
-            break;
-        case CYBLE_EVT_GAP_AUTH_FAILED:
-            break;
-        case CYBLE_EVT_GAP_DEVICE_CONNECTED:
-            if ((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv > 0x0006u)
-            {
-                /* If connection settings do not match expected ones - request parameter update */
-                connUpdateParam.connIntvMin   = 0x0006u;
-                connUpdateParam.connIntvMax   = 0x0006u;
-                connUpdateParam.connLatency   = 0x0000u;
-                connUpdateParam.supervisionTO = 0x0064u;
-                apiResult = CyBle_L2capLeConnectionParamUpdateRequest(cyBle_connHandle.bdHandle, &connUpdateParam);
-            }
-            break;
-        case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
-            apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
-            if(apiResult != CYBLE_ERROR_OK)
-            {
-            }
-            break;
-        case CYBLE_EVT_GAP_ENCRYPT_CHANGE:
-            break;
-        case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
-            break;
-        case CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
-            if(CYBLE_STATE_DISCONNECTED == CyBle_GetState())
-            {   
-                /* Fast and slow advertising period complete, go to low power  
-                 * mode (Hibernate mode) and wait for an external
-                 * user event to wake up the device again */
-                Bootloader_Service_Activation_ClearInterrupt();
-                Wakeup_Interrupt_ClearPending();
-                Wakeup_Interrupt_Start();
-                CySysPmHibernate();
-            }
-            break;
-
-            
-        /**********************************************************
-        *                       GATT Events
-        ***********************************************************/
-        case CYBLE_EVT_GATT_CONNECT_IND:
-            connHandle = *(CYBLE_CONN_HANDLE_T *)eventParam;
-            break;
-        case CYBLE_EVT_GATT_DISCONNECT_IND:
-            connHandle.bdHandle = 0;
-            break;
-        case CYBLE_EVT_GATTS_WRITE_CMD_REQ:
-            break;
-        case CYBLE_EVT_GATTS_PREP_WRITE_REQ:
-            (void)CyBle_GattsPrepWriteReqSupport(CYBLE_GATTS_PREP_WRITE_NOT_SUPPORT);
-            break;
-        case CYBLE_EVT_HCI_STATUS:
-        default:
-            break;
+        /* If connection settings do not match expected ones - request parameter update */
+        connUpdateParam.connIntvMin   = 0x0006u;
+        connUpdateParam.connIntvMax   = 0x0006u;
+        connUpdateParam.connLatency   = 0x0000u;
+        connUpdateParam.supervisionTO = 0x0064u;
+        apiResult = CyBle_L2capLeConnectionParamUpdateRequest(cyBle_connHandle.bdHandle, &connUpdateParam);
+        if(apiResult != CYBLE_ERROR_OK)
+        {
         }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OnDisconnected()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GAP_DEVICE_DISCONNECTED: restarts the advertising schedule.
+*
+* Parameters:
+*   event - event code
+*   eventParam - HCI reason of the disconnect
+*
+*******************************************************************************/
+static void OnDisconnected(uint32 event, void *eventParam)
+{
+    CYBLE_API_RESULT_T apiResult;
+
+    (void) event;
+
+    /* The host dropped the link before the new image was launched */
+    DiagLog_Append((DiagLog_GetOtaState() == DIAG_OTA_IN_PROGRESS) ? DIAG_EVT_OTA_ABORT : DIAG_EVT_DISCONNECTED,
+        *(uint8 *)eventParam);
+    FlashSched_Hold(0u);
+    apiResult = AdvSched_Start(*(uint8 *)eventParam);
+    if(apiResult != CYBLE_ERROR_OK)
+    {
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OnConnectionUpdate()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE.
+*
+* Parameters:
+*   event - event code
+*   eventParam - CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T
+*
+*******************************************************************************/
+static void OnConnectionUpdate(uint32 event, void *eventParam)
+{
+    (void) event;
+
+    FlashSched_SetConnInterval((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv);
+}
+
+
+/*******************************************************************************
+* Function Name: OnAdvertisementStartStop()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP: moves to the next stage of the
+*   advertising schedule and hibernates after the last one.
+*
+* Parameters:
+*   event - event code
+*   eventParam - event parameter
+*
+*******************************************************************************/
+static void OnAdvertisementStartStop(uint32 event, void *eventParam)
+{
+    (void) event;
+    (void) eventParam;
+
+    if(CYBLE_STATE_ADVERTISING == CyBle_GetState())
+    {
+        BootProf_Mark(BOOT_PHASE_ADV_START);
+    }
+    if((CYBLE_STATE_DISCONNECTED == CyBle_GetState()) && (0u == AdvSched_Next()))
+    {   
+        /* All stages of the advertising schedule complete, go to low power  
+         * mode (Hibernate mode) and wait for an external
+         * user event to wake up the device again */
+        Bootloader_Service_Activation_ClearInterrupt();
+        Wakeup_Interrupt_ClearPending();
+        Wakeup_Interrupt_Start();
+        DiagLog_Append(DIAG_EVT_HIBERNATE, 0u);
+        CySysPmHibernate();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OnGattConnect()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GATT_CONNECT_IND and CYBLE_EVT_GATT_DISCONNECT_IND: keeps the
+*   handle of the current connection.
+*
+* Parameters:
+*   event - event code
+*   eventParam - CYBLE_CONN_HANDLE_T
+*
+*******************************************************************************/
+static void OnGattConnect(uint32 event, void *eventParam)
+{
+    if(event == (uint32) CYBLE_EVT_GATT_CONNECT_IND)
+    {
+        connHandle = *(CYBLE_CONN_HANDLE_T *)eventParam;
+    }
+    else
+    {
+        connHandle.bdHandle = 0;
+    }
 }
 
 
@@ -230,6 +579,37 @@ void WriteAttrServChanged(void)
 }
 
 
+#if (GATT_SIG_ENABLED == YES)
+/*******************************************************************************
+* Function Name: ServicesSignature()
+********************************************************************************
+*
+* Summary:
+*   Computes the signature of the GATT database with the services this
+*   image leaves enabled.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   The signature.
+*
+*******************************************************************************/
+static uint32 ServicesSignature(void)
+{
+    uint16 services[GATT_SIG_SERVICE_COUNT];
+
+    services[0u] = cyBle_hidss[0].serviceHandle;
+    services[1u] = cyBle_diss.serviceHandle;
+    services[2u] = cyBle_bass[0].serviceHandle;
+    services[3u] = cyBle_scpss.serviceHandle;
+    services[4u] = cyBle_btss.btServiceHandle;
+
+    return GattSig_Compute(services, GATT_SIG_SERVICE_COUNT, GATT_SIG_MASK_BOOTLOADER);
+}
+#endif /* (GATT_SIG_ENABLED == YES) */
+
+
 /*******************************************************************************
 * Function Name: LowPowerImplementation()
 ********************************************************************************
@@ -251,6 +631,7 @@ void WriteAttrServChanged(void)
 static void LowPowerImplementation(void)
 {
     CYBLE_LP_MODE_T bleMode;
+    CYBLE_BLESS_STATE_T blessState;
     uint8 interruptStatus;
     
     /* For advertising and connected states, implement deep sleep 
@@ -265,27 +646,62 @@ static void LowPowerImplementation(void)
         bleMode = CyBle_EnterLPM(CYBLE_BLESS_DEEPSLEEP);
         /* Disable global interrupts */
         interruptStatus = CyEnterCriticalSection();
+        blessState = CyBle_GetBleSsState();
         /* When BLE subsystem has been put into Deep-Sleep mode */
         if(bleMode == CYBLE_BLESS_DEEPSLEEP)
         {
             /* And it is still there or ECO is on */
-            if((CyBle_GetBleSsState() == CYBLE_BLESS_STATE_ECO_ON) || 
-               (CyBle_GetBleSsState() == CYBLE_BLESS_STATE_DEEPSLEEP))
+            if((blessState == CYBLE_BLESS_STATE_ECO_ON) || 
+               (blessState == CYBLE_BLESS_STATE_DEEPSLEEP))
             {
+            #if (POWER_STATS_ENABLED == YES)
+                PowerStats_Enter(POWER_STATE_DEEPSLEEP);
                 CySysPmDeepSleep();
+                PowerStats_Exit();
+            #else
+                CySysPmDeepSleep();
+            #endif /* (POWER_STATS_ENABLED == YES) */
+            }
+        #if (POWER_STATS_ENABLED == YES)
+            else
+            {
+                PowerStats_Refuse(POWER_REFUSE_BLESS_STATE);
             }
+        #endif /* (POWER_STATS_ENABLED == YES) */
         }
         else /* When BLE subsystem has been put into Sleep mode or is active */
         {
+        #if (POWER_STATS_ENABLED == YES)
+            PowerStats_Refuse(POWER_REFUSE_LPM_DENIED);
+        #endif /* (POWER_STATS_ENABLED == YES) */
+
             /* And hardware doesn't finish Tx/Rx opeation - put the CPU into Sleep mode */
-            if(CyBle_GetBleSsState() != CYBLE_BLESS_STATE_EVENT_CLOSE)
+            if(blessState != CYBLE_BLESS_STATE_EVENT_CLOSE)
             {
+            #if (POWER_STATS_ENABLED == YES)
+                PowerStats_Enter(POWER_STATE_SLEEP);
+                CySysPmSleep();
+                PowerStats_Exit();
+            #else
                 CySysPmSleep();
+            #endif /* (POWER_STATS_ENABLED == YES) */
+            }
+        #if (POWER_STATS_ENABLED == YES)
+            else
+            {
+                PowerStats_Refuse(POWER_REFUSE_EVENT_CLOSE);
             }
+        #endif /* (POWER_STATS_ENABLED == YES) */
         }
         /* Enable global interrupt */
         CyExitCriticalSection(interruptStatus);
     }
+#if (POWER_STATS_ENABLED == YES)
+    else
+    {
+        PowerStats_Refuse(POWER_REFUSE_BLE_STATE);
+    }
+#endif /* (POWER_STATS_ENABLED == YES) */
 }
 
 
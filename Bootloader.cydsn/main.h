@@ -31,7 +31,9 @@
 #include "Options.h"
 #include "OTAMandatory.h"
 
-void AppCallBack(uint32 event, void* eventParam);
+/* Work dispatched by the main loop */
+#define LOOP_EVT_PACKET         (0x01u)
+#define LOOP_EVT_TIMER          (0x02u)
 
 void WriteAttrServChanged(void);
 
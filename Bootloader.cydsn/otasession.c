@@ -0,0 +1,262 @@
+/*******************************************************************************
+* File Name: otasession.c
+*
+* Version 1.30
+*
+* Description:
+*  OTA session handoff; see otasession.h. The peer address is read when the
+*  link comes up, as it is no longer available at the disconnect. The
+*  Client Characteristic Configuration is restored from OtaSession_Task(),
+*  after CyBle_ProcessEvents() has handled all connection events and the
+*  stack has initialized the descriptors of the new link.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "main.h"
+#include "otasession.h"
+#include "prepwrite.h"
+#include "timebase.h"
+#include "diaglog.h"
+
+typedef struct
+{
+    CYBLE_GAP_BD_ADDR_T peer;
+    PREP_WRITE_QUEUE_T queue;
+    uint32 suspendTime;                 /* Timebase tick of the disconnect */
+    uint16 cccd;
+    uint8 used;
+} OTA_SESSION_T;
+
+static OTA_SESSION_T otaSession[OTA_SESSION_SLOTS];
+static CYBLE_GAP_BD_ADDR_T otaSessionPeer;
+static uint32 otaSessionPeerKnown;
+static uint32 otaSessionCccdPending;
+static uint16 otaSessionCccd;
+static OTA_SESSION_STATS_T otaSessionStats;
+
+static uint16 OtaSession_ReadCccd(void);
+static void OtaSession_Suspend(void);
+static void OtaSession_Resume(const CYBLE_CONN_HANDLE_T *handle);
+
+
+/*******************************************************************************
+* Function Name: OtaSession_ReadCccd()
+********************************************************************************
+*
+* Summary:
+*   Returns the Client Characteristic Configuration of the Bootloader
+*   characteristic.
+*
+*******************************************************************************/
+static uint16 OtaSession_ReadCccd(void)
+{
+    uint8 value[CYBLE_CCCD_LEN] = { 0u, 0u };
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T handleValuePair;
+
+    handleValuePair.attrHandle = cyBle_btss.btServiceInfo[0u].btServiceCharDescriptors[0u];
+    handleValuePair.value.val = value;
+    handleValuePair.value.len = CYBLE_CCCD_LEN;
+    (void) CyBle_GattsReadAttributeValue(&handleValuePair, NULL, CYBLE_GATT_DB_LOCALLY_INITIATED);
+
+    return (uint16) ((uint32) value[0u] | ((uint32) value[1u] << 8u));
+}
+
+
+/*******************************************************************************
+* Function Name: OtaSession_Suspend()
+********************************************************************************
+*
+* Summary:
+*   Keeps the session of the peer that disconnected, when it used the
+*   Bootloader Service. Takes the oldest slot when all are in use.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void OtaSession_Suspend(void)
+{
+    OTA_SESSION_T *slot = &otaSession[0u];
+    PREP_WRITE_QUEUE_T queue;
+    uint16 cccd = OtaSession_ReadCccd();
+    uint32 now = Timebase_Now();
+    uint32 i;
+
+    PrepWrite_Suspend(&queue);
+    if((0u == otaSessionPeerKnown) || ((0u == cccd) && (queue.head == NULL)))
+    {
+        /* Not a Bootloader Service session */
+        PrepWrite_Release(&queue);
+        otaSessionPeerKnown = 0u;
+        return;
+    }
+    otaSessionPeerKnown = 0u;
+
+    for(i = 0u; i < OTA_SESSION_SLOTS; i++)
+    {
+        if(0u == otaSession[i].used)
+        {
+            slot = &otaSession[i];
+            break;
+        }
+        if((now - otaSession[i].suspendTime) > (now - slot->suspendTime))
+        {
+            slot = &otaSession[i];
+        }
+    }
+
+    if(0u != slot->used)
+    {
+        PrepWrite_Release(&slot->queue);
+        otaSessionStats.evicted++;
+    }
+
+    slot->peer = otaSessionPeer;
+    slot->queue = queue;
+    slot->cccd = cccd;
+    slot->suspendTime = now;
+    slot->used = 1u;
+    otaSessionStats.suspended++;
+}
+
+
+/*******************************************************************************
+* Function Name: OtaSession_Resume()
+********************************************************************************
+*
+* Summary:
+*   Reads the address of the new peer and hands it its kept session.
+*
+* Parameters:
+*   handle - connection handle of the new link
+*
+*******************************************************************************/
+static void OtaSession_Resume(const CYBLE_CONN_HANDLE_T *handle)
+{
+    OTA_SESSION_T *slot;
+    uint32 elapsed;
+    uint32 i;
+
+    otaSessionPeerKnown = 0u;
+    if(CyBle_GapGetPeerBdAddr(handle->bdHandle, &otaSessionPeer) != CYBLE_ERROR_OK)
+    {
+        return;
+    }
+    otaSessionPeerKnown = 1u;
+
+    for(i = 0u; i < OTA_SESSION_SLOTS; i++)
+    {
+        slot = &otaSession[i];
+        if((0u != slot->used) && (slot->peer.type == otaSessionPeer.type) &&
+           (0 == memcmp(slot->peer.bdAddr, otaSessionPeer.bdAddr, CYBLE_GAP_BD_ADDR_SIZE)))
+        {
+            elapsed = TIMEBASE_TICKS_TO_MS(Timebase_Now() - slot->suspendTime);
+
+            PrepWrite_Resume(&slot->queue);
+            otaSessionCccd = slot->cccd;
+            otaSessionCccdPending = 1u;
+            slot->used = 0u;
+            otaSessionStats.resumed++;
+            DiagLog_Append(DIAG_EVT_OTA_RESUME, (elapsed > 0xFFFFu) ? 0xFFFFu : elapsed);
+            break;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OtaSession_Event()
+********************************************************************************
+*
+* Summary:
+*   BLE event handler for CYBLE_EVT_GATT_CONNECT_IND and
+*   CYBLE_EVT_GATT_DISCONNECT_IND. Must come before PrepWrite_Event() in
+*   the dispatch table, which drops the queue at the disconnect.
+*
+* Parameters:
+*   event - event code
+*   eventParam - CYBLE_CONN_HANDLE_T
+*
+*******************************************************************************/
+void OtaSession_Event(uint32 event, void *eventParam)
+{
+    if(event == (uint32) CYBLE_EVT_GATT_CONNECT_IND)
+    {
+        OtaSession_Resume((const CYBLE_CONN_HANDLE_T *) eventParam);
+    }
+    else
+    {
+        otaSessionCccdPending = 0u;
+        OtaSession_Suspend();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OtaSession_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop after CyBle_ProcessEvents(). Restores the
+*   descriptor of a resumed session and drops sessions kept longer than
+*   OTA_SESSION_HOLD, returning their blocks to the buffer pool.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void OtaSession_Task(void)
+{
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T handleValuePair;
+    uint8 value[CYBLE_CCCD_LEN];
+    uint32 now = Timebase_Now();
+    uint32 i;
+
+    if((0u != otaSessionCccdPending) && (CyBle_GetState() == CYBLE_STATE_CONNECTED))
+    {
+        value[0u] = (uint8) otaSessionCccd;
+        value[1u] = (uint8) (otaSessionCccd >> 8u);
+        handleValuePair.attrHandle = cyBle_btss.btServiceInfo[0u].btServiceCharDescriptors[0u];
+        handleValuePair.value.val = value;
+        handleValuePair.value.len = CYBLE_CCCD_LEN;
+        (void) CyBle_GattsWriteAttributeValue(&handleValuePair, 0u, &cyBle_connHandle,
+            CYBLE_GATT_DB_LOCALLY_INITIATED);
+        otaSessionCccdPending = 0u;
+    }
+
+    for(i = 0u; i < OTA_SESSION_SLOTS; i++)
+    {
+        if((0u != otaSession[i].used) && ((now - otaSession[i].suspendTime) >= OTA_SESSION_HOLD))
+        {
+            PrepWrite_Release(&otaSession[i].queue);
+            otaSession[i].used = 0u;
+            otaSessionStats.expired++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OtaSession_GetStats()
+********************************************************************************
+*
+* Summary:
+*   Copies the handoff counters, counted since start.
+*
+* Parameters:
+*   stats - receives the counters
+*
+*******************************************************************************/
+void OtaSession_GetStats(OTA_SESSION_STATS_T *stats)
+{
+    *stats = otaSessionStats;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,58 @@
+/*******************************************************************************
+* File Name: otasession.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the OTA session
+*  handoff. When a central that uses the Bootloader Service loses the link,
+*  its session is kept for OTA_SESSION_HOLD, keyed by its Bluetooth device
+*  address:
+*   - the command it was sending in Prepare Write requests, i.e. the part
+*    of the row in flight, and the offset expected next (prepwrite.h);
+*   - the Client Characteristic Configuration of the Bootloader
+*    characteristic, so responses are notified without a new write.
+*  A central that reconnects from the same address within that time gets
+*  its session back and may continue the long write where the link broke.
+*  A central using a resolvable private address is only recognized while
+*  its address does not change.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(OTASESSION_H)
+#define OTASESSION_H
+
+#include <project.h>
+#include "Options.h"
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    uint32 suspended;                   /* Sessions kept at a disconnect */
+    uint32 resumed;                     /* Sessions handed to a reconnect */
+    uint32 expired;                     /* Sessions dropped after OTA_SESSION_HOLD */
+    uint32 evicted;                     /* Sessions dropped for a newer one */
+} OTA_SESSION_STATS_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+void OtaSession_Event(uint32 event, void *eventParam);
+void OtaSession_Task(void);
+void OtaSession_GetStats(OTA_SESSION_STATS_T *stats);
+
+#endif /* OTASESSION_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,326 @@
+/*******************************************************************************
+* File Name: powerstats.c
+*
+* Version 1.30
+*
+* Description:
+*  Residency counters for the power states chosen by LowPowerImplementation().
+*  Every timebase tick is charged to exactly one state: the span since the
+*  last transition is closed whenever a state is entered or left. The
+*  counters are published periodically to a read-only GATT characteristic
+*  and optionally dumped over B_UART.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "main.h"
+#include "powerstats.h"
+#include "timebase.h"
+#include "bletrace.h"
+
+#define POWER_STATS_FORMAT      (1u)
+
+/* Never the characteristic of HelloApp's UART bridge */
+#if (defined(CYBLE_CUSTOM_SERVICE_CHAR_COUNT) && (CYBLE_CUSTOM_SERVICE_CHAR_COUNT > POWER_STATS_CHAR_INDEX))
+    #define POWER_STATS_CHAR_PRESENT    (YES)
+#else
+    #define POWER_STATS_CHAR_PRESENT    (NO)
+    #if (POWER_STATS_ENABLED == YES)
+        #error POWER_STATS_ENABLED needs characteristic POWER_STATS_CHAR_INDEX of the custom service in the BLE component
+    #endif /* (POWER_STATS_ENABLED == YES) */
+#endif /* (CYBLE_CUSTOM_SERVICE_CHAR_COUNT > POWER_STATS_CHAR_INDEX) */
+
+#if ((BLE_TRACE_ENABLED == YES) && (POWER_STATS_REPORT_PERIOD > (TIMEBASE_TICKS_PER_SEC * 65u)))
+    #error Power trace records hold at most 65535 ms, shorten POWER_STATS_REPORT_PERIOD
+#endif /* ((BLE_TRACE_ENABLED == YES) && (POWER_STATS_REPORT_PERIOD > (TIMEBASE_TICKS_PER_SEC * 65u))) */
+
+POWER_STATS_T powerStats;
+
+static uint32 powerStatsState;
+static uint32 powerStatsSince;
+static uint32 powerStatsLastReport;
+#if (BLE_TRACE_ENABLED == YES)
+    static uint32 powerStatsTracedMs[POWER_STATE_COUNT];
+#endif /* (BLE_TRACE_ENABLED == YES) */
+
+static const char8 * const powerStateName[POWER_STATE_COUNT] =
+{
+    "active", "sleep", "deepsleep"
+};
+
+static const char8 * const powerRefuseName[POWER_REFUSE_COUNT] =
+{
+    "ble-state", "lpm-denied", "bless-state", "event-close"
+};
+
+static void PowerStats_Accumulate(void);
+#if (BLE_TRACE_ENABLED == YES)
+    static void PowerStats_Trace(void);
+#endif /* (BLE_TRACE_ENABLED == YES) */
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Accumulate()
+********************************************************************************
+*
+* Summary:
+*   Charges the time since the last transition to the current state.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void PowerStats_Accumulate(void)
+{
+    uint32 now = Timebase_Now();
+    uint32 span = now - powerStatsSince;
+    uint32 ticks = powerStats.ticks[powerStatsState] + (span % TIMEBASE_TICKS_PER_SEC);
+
+    powerStats.seconds[powerStatsState] += span / TIMEBASE_TICKS_PER_SEC;
+    if(ticks >= TIMEBASE_TICKS_PER_SEC)
+    {
+        ticks -= TIMEBASE_TICKS_PER_SEC;
+        powerStats.seconds[powerStatsState]++;
+    }
+    powerStats.ticks[powerStatsState] = ticks;
+    powerStatsSince = now;
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Start()
+********************************************************************************
+*
+* Summary:
+*   Starts accounting in the active state. Timebase_Start() must have been
+*   called.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void PowerStats_Start(void)
+{
+    (void) memset(&powerStats, 0, sizeof(powerStats));
+    powerStatsState = POWER_STATE_ACTIVE;
+    powerStats.entries[POWER_STATE_ACTIVE] = 1u;
+    powerStatsSince = Timebase_Now();
+    powerStatsLastReport = powerStatsSince;
+#if (BLE_TRACE_ENABLED == YES)
+    (void) memset(powerStatsTracedMs, 0, sizeof(powerStatsTracedMs));
+#endif /* (BLE_TRACE_ENABLED == YES) */
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Enter()
+********************************************************************************
+*
+* Summary:
+*   Called right before the CPU enters a low power state.
+*
+* Parameters:
+*   state - POWER_STATE_SLEEP or POWER_STATE_DEEPSLEEP
+*
+*******************************************************************************/
+void PowerStats_Enter(uint32 state)
+{
+    PowerStats_Accumulate();
+    powerStatsState = state;
+    powerStats.entries[state]++;
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Exit()
+********************************************************************************
+*
+* Summary:
+*   Called right after the CPU woke up from the state given to
+*   PowerStats_Enter().
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void PowerStats_Exit(void)
+{
+    PowerStats_Accumulate();
+    powerStatsState = POWER_STATE_ACTIVE;
+    powerStats.entries[POWER_STATE_ACTIVE]++;
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Refuse()
+********************************************************************************
+*
+* Summary:
+*   Counts a pass of LowPowerImplementation() that did not enter Deep-Sleep.
+*
+* Parameters:
+*   reason - POWER_REFUSE_*
+*
+*******************************************************************************/
+void PowerStats_Refuse(uint32 reason)
+{
+    powerStats.refusals[reason]++;
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Serialize()
+********************************************************************************
+*
+* Summary:
+*   Packs the counters as little-endian 32-bit words: format, entries[],
+*   seconds[], ticks[] (each indexed by POWER_STATE_*), refusals[] (indexed
+*   by POWER_REFUSE_*).
+*
+* Parameters:
+*   value - buffer of POWER_STATS_VALUE_SIZE bytes
+*
+* Return:
+*   Number of bytes written.
+*
+*******************************************************************************/
+uint32 PowerStats_Serialize(uint8 value[])
+{
+    const uint32 *word = &powerStats.entries[0u];
+    uint32 size = 0u;
+    uint32 i;
+
+    value[0u] = (uint8) POWER_STATS_FORMAT;
+    value[1u] = 0u;
+    value[2u] = 0u;
+    value[3u] = 0u;
+    size = 4u;
+
+    /* POWER_STATS_T holds only uint32 members, in serialization order */
+    for(i = 0u; i < (sizeof(powerStats) / sizeof(uint32)); i++)
+    {
+        value[size]      = (uint8) (word[i]);
+        value[size + 1u] = (uint8) (word[i] >> 8u);
+        value[size + 2u] = (uint8) (word[i] >> 16u);
+        value[size + 3u] = (uint8) (word[i] >> 24u);
+        size += 4u;
+    }
+
+    return size;
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Dump()
+********************************************************************************
+*
+* Summary:
+*   Prints the counters over B_UART.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void PowerStats_Dump(void)
+{
+    char8 line[64u];
+    uint32 i;
+
+    for(i = 0u; i < POWER_STATE_COUNT; i++)
+    {
+        (void) sprintf(line, "power %s: %lu.%03lu s, %lu entries\r\n", powerStateName[i],
+            (unsigned long) powerStats.seconds[i],
+            (unsigned long) ((powerStats.ticks[i] * 1000u) / TIMEBASE_TICKS_PER_SEC),
+            (unsigned long) powerStats.entries[i]);
+        B_UART_PutString(line);
+    }
+    for(i = 0u; i < POWER_REFUSE_COUNT; i++)
+    {
+        (void) sprintf(line, "power refused %s: %lu\r\n", powerRefuseName[i],
+            (unsigned long) powerStats.refusals[i]);
+        B_UART_PutString(line);
+    }
+}
+
+
+#if (BLE_TRACE_ENABLED == YES)
+/*******************************************************************************
+* Function Name: PowerStats_Trace()
+********************************************************************************
+*
+* Summary:
+*   Adds the time spent in each state since the previous call to the BLE
+*   event trace, so host tools can line residency up with BLE events.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void PowerStats_Trace(void)
+{
+    uint32 ms;
+    uint32 i;
+
+    for(i = 0u; i < POWER_STATE_COUNT; i++)
+    {
+        ms = (powerStats.seconds[i] * 1000u) + ((powerStats.ticks[i] * 1000u) / TIMEBASE_TICKS_PER_SEC);
+        BleTrace_RecordValue(BLE_TRACE_EVT_POWER + i, ms - powerStatsTracedMs[i]);
+        powerStatsTracedMs[i] = ms;
+    }
+}
+#endif /* (BLE_TRACE_ENABLED == YES) */
+
+
+/*******************************************************************************
+* Function Name: PowerStats_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop. Once per POWER_STATS_REPORT_PERIOD updates
+*   the GATT characteristic value (when the BLE component has
+*   characteristic POWER_STATS_CHAR_INDEX) and dumps the counters if
+*   enabled.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void PowerStats_Task(void)
+{
+#if (POWER_STATS_CHAR_PRESENT == YES)
+    uint8 value[POWER_STATS_VALUE_SIZE];
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T handleValuePair;
+#endif /* (POWER_STATS_CHAR_PRESENT == YES) */
+
+    if((Timebase_Now() - powerStatsLastReport) >= POWER_STATS_REPORT_PERIOD)
+    {
+        PowerStats_Accumulate();
+        powerStatsLastReport = powerStatsSince;
+
+    #if (BLE_TRACE_ENABLED == YES)
+        PowerStats_Trace();
+    #endif /* (BLE_TRACE_ENABLED == YES) */
+
+    #if (POWER_STATS_CHAR_PRESENT == YES)
+        if(0u != POWER_STATS_CHAR_HANDLE)
+        {
+            handleValuePair.attrHandle = POWER_STATS_CHAR_HANDLE;
+            handleValuePair.value.val = value;
+            handleValuePair.value.len = (uint16) PowerStats_Serialize(value);
+            (void) CyBle_GattsWriteAttributeValue(&handleValuePair, 0u, NULL, CYBLE_GATT_DB_LOCALLY_INITIATED);
+        }
+    #endif /* (POWER_STATS_CHAR_PRESENT == YES) */
+
+    #if (POWER_STATS_DUMP_ENABLED == YES)
+        PowerStats_Dump();
+    #endif /* (POWER_STATS_DUMP_ENABLED == YES) */
+    }
+}
+
+
+/* [] END OF FILE */
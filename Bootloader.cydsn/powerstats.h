@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: powerstats.h
+*
+* Version 1.30
+*
+* Description:
+*  Residency counters for the power states chosen by LowPowerImplementation()
+*  and the reasons Deep-Sleep was refused. Time is measured with the LFCLK
+*  timebase (Shared\timebase.h).
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(POWERSTATS_H)
+#define POWERSTATS_H
+
+#include <project.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Power states */
+#define POWER_STATE_ACTIVE              (0u)
+#define POWER_STATE_SLEEP               (1u)
+#define POWER_STATE_DEEPSLEEP           (2u)
+#define POWER_STATE_COUNT               (3u)
+
+/* Reasons Deep-Sleep was not entered on a pass of LowPowerImplementation() */
+#define POWER_REFUSE_BLE_STATE          (0u)    /* Not advertising or connected */
+#define POWER_REFUSE_LPM_DENIED         (1u)    /* CyBle_EnterLPM() kept BLESS out of Deep-Sleep */
+#define POWER_REFUSE_BLESS_STATE        (2u)    /* BLESS not in ECO_ON or DEEPSLEEP */
+#define POWER_REFUSE_EVENT_CLOSE        (3u)    /* BLESS EVENT_CLOSE pending, CPU Sleep skipped too */
+#define POWER_REFUSE_COUNT              (4u)
+
+/* Size of the GATT characteristic value, see PowerStats_Serialize() */
+#define POWER_STATS_VALUE_SIZE          (4u * (1u + (3u * POWER_STATE_COUNT) + POWER_REFUSE_COUNT))
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    uint32 entries[POWER_STATE_COUNT];      /* Times the state was entered */
+    uint32 seconds[POWER_STATE_COUNT];      /* Whole seconds spent in the state */
+    uint32 ticks[POWER_STATE_COUNT];        /* Remainder in timebase ticks */
+    uint32 refusals[POWER_REFUSE_COUNT];
+} POWER_STATS_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void PowerStats_Start(void);
+void PowerStats_Enter(uint32 state);
+void PowerStats_Exit(void);
+void PowerStats_Refuse(uint32 reason);
+void PowerStats_Task(void);
+void PowerStats_Dump(void);
+uint32 PowerStats_Serialize(uint8 value[]);
+
+extern POWER_STATS_T powerStats;
+
+#endif /* POWERSTATS_H */
+
+
+/* [] END OF FILE */
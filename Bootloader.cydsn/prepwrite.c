@@ -0,0 +1,443 @@
+/*******************************************************************************
+* File Name: prepwrite.c
+*
+* Version 1.30
+*
+* Description:
+*  Prepared write reassembly; see prepwrite.h. Fragments must arrive in
+*  offset order, as every central sends a long write, so the queue is a
+*  list in arrival order and the command length is the next expected
+*  offset. Blocks come from the buffer pool (Shared\bufpool.h). A fragment
+*  first fills the free end of the last block and then takes new blocks,
+*  so a command takes the same number of blocks whatever the MTU; the
+*  pool is checked before the first one is taken, so a refused fragment
+*  leaves the queue as it was unless an interrupt takes the blocks in
+*  between.
+*
+*  The fragments are also in the stack's own prepare write queue, but
+*  that queue is emptied with the link. otasession.c keeps the queue of a
+*  central that drops mid-command so the long write can continue after it
+*  reconnects, which needs a copy the stack does not own. The queue is
+*  sized for one command, as the stack's is.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "main.h"
+#include "prepwrite.h"
+#include "bufpool.h"
+
+typedef struct PREP_WRITE_BLOCK_S
+{
+    struct PREP_WRITE_BLOCK_S *next;
+    uint16 offset;                      /* Of data[0] in the command */
+    uint16 length;
+    uint8 data[PREP_WRITE_BLOCK_DATA];
+} PREP_WRITE_BLOCK_T;
+
+/* Blocks of the buffer pool classes a PREP_WRITE_BLOCK_T fits in */
+#define PREP_WRITE_FIT_COUNT(size, count)   + (((size) >= sizeof(PREP_WRITE_BLOCK_T)) ? (count) : 0u)
+#define PREP_WRITE_POOL_BLOCKS          (0u BUF_POOL_CLASSES(PREP_WRITE_FIT_COUNT))
+
+/* BUF_POOL_CLASSES in Options.h must hold a full queue for the live
+ * connection and for each of the OTA_SESSION_SLOTS queues kept by
+ * otasession.c.
+ */
+typedef char prepWriteAssertPool[(PREP_WRITE_POOL_BLOCKS >= (PREP_WRITE_BLOCKS * (OTA_SESSION_SLOTS + 1u))) ? 1 : -1];
+
+/* PREP_WRITE_BLOCKS in Options.h must hold one command and no more */
+typedef char prepWriteAssertBlocks[(((PREP_WRITE_BLOCKS * PREP_WRITE_BLOCK_DATA) >= CYBLE_BTS_COMMAND_MAX_LENGTH) &&
+                                    (((PREP_WRITE_BLOCKS - 1u) * PREP_WRITE_BLOCK_DATA) < CYBLE_BTS_COMMAND_MAX_LENGTH)) ?
+                                   1 : -1];
+
+/* Command buffer of the Bootloader transport (BLE_bts.c), read by
+ * CyBtldrCommRead() once cyBle_cmdReceivedFlag is set.
+ */
+extern uint8 *cyBle_btsBuffPtr;
+
+static PREP_WRITE_QUEUE_T prepWriteQueue;
+static uint32 prepWriteResumed;
+static uint8 prepWriteCommand[CYBLE_BTS_COMMAND_MAX_LENGTH];
+static PREP_WRITE_STATS_T prepWriteStats;
+
+static void PrepWrite_Truncate(uint32 offset);
+static CYBLE_GATT_ERR_CODE_T PrepWrite_Queue(const CYBLE_GATT_HANDLE_VALUE_OFFSET_PARAM_T *fragment);
+static CYBLE_GATT_ERR_CODE_T PrepWrite_Execute(void);
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Start()
+********************************************************************************
+*
+* Summary:
+*   Empties the queue. Called after BufPool_Start() and before
+*   CyBle_Start().
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void PrepWrite_Start(void)
+{
+    (void) memset(&prepWriteQueue, 0, sizeof(prepWriteQueue));
+    prepWriteResumed = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Release()
+********************************************************************************
+*
+* Summary:
+*   Returns the blocks of a queue to the buffer pool and empties it.
+*
+* Parameters:
+*   queue - the current queue or one from PrepWrite_Suspend()
+*
+*******************************************************************************/
+void PrepWrite_Release(PREP_WRITE_QUEUE_T *queue)
+{
+    PREP_WRITE_BLOCK_T *block;
+
+    while(queue->head != NULL)
+    {
+        block = queue->head;
+        queue->head = block->next;
+        BufPool_Free(block);
+    }
+    queue->tail = NULL;
+    queue->length = 0u;
+    queue->blocks = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Truncate()
+********************************************************************************
+*
+* Summary:
+*   Drops the queued bytes from the given offset on, so a resumed long
+*   write can repeat fragments whose response was lost with the link.
+*
+* Parameters:
+*   offset - new length, at most the queued length
+*
+*******************************************************************************/
+static void PrepWrite_Truncate(uint32 offset)
+{
+    PREP_WRITE_BLOCK_T *block = prepWriteQueue.head;
+    PREP_WRITE_BLOCK_T *last = NULL;
+    PREP_WRITE_BLOCK_T *next;
+
+    while((block != NULL) && (block->offset < offset))
+    {
+        if((block->offset + block->length) > offset)
+        {
+            block->length = (uint16) (offset - block->offset);
+        }
+        last = block;
+        block = block->next;
+    }
+    while(block != NULL)
+    {
+        next = block->next;
+        BufPool_Free(block);
+        prepWriteQueue.blocks--;
+        block = next;
+    }
+
+    if(last == NULL)
+    {
+        prepWriteQueue.head = NULL;
+    }
+    else
+    {
+        last->next = NULL;
+    }
+    prepWriteQueue.tail = last;
+    prepWriteQueue.length = offset;
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Queue()
+********************************************************************************
+*
+* Summary:
+*   Appends a fragment of the Bootloader characteristic to the queue.
+*
+* Parameters:
+*   fragment - handle, value and offset of the Prepare Write request
+*
+* Return:
+*   CYBLE_GATT_ERR_NONE when queued, else the error to respond with.
+*
+*******************************************************************************/
+static CYBLE_GATT_ERR_CODE_T PrepWrite_Queue(const CYBLE_GATT_HANDLE_VALUE_OFFSET_PARAM_T *fragment)
+{
+    PREP_WRITE_BLOCK_T *block = prepWriteQueue.tail;
+    const uint8 *value = fragment->handleValuePair.value.val;
+    uint32 length = fragment->handleValuePair.value.len;
+    uint32 space = (block == NULL) ? 0u : (PREP_WRITE_BLOCK_DATA - (uint32) block->length);
+    uint32 needed = 0u;
+    uint32 done;
+    uint32 part;
+
+    if(length > space)
+    {
+        needed = ((length - space) + PREP_WRITE_BLOCK_DATA - 1u) / PREP_WRITE_BLOCK_DATA;
+    }
+
+    if(fragment->offset != prepWriteQueue.length)
+    {
+        return CYBLE_GATT_ERR_INVALID_OFFSET;
+    }
+    if((prepWriteQueue.length + length) > CYBLE_BTS_COMMAND_MAX_LENGTH)
+    {
+        return CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+    if(((prepWriteQueue.blocks + needed) > PREP_WRITE_BLOCKS) ||
+       (BufPool_Available(sizeof(PREP_WRITE_BLOCK_T)) < needed))
+    {
+        return CYBLE_GATT_ERR_PREPARE_WRITE_QUEUE_FULL;
+    }
+
+    /* The last block continues at the offset of this fragment */
+    part = (length < space) ? length : space;
+    if(part != 0u)
+    {
+        (void) memcpy(&block->data[block->length], value, part);
+        block->length += (uint16) part;
+    }
+
+    for(done = part; done < length; done += part)
+    {
+        part = ((length - done) > PREP_WRITE_BLOCK_DATA) ? PREP_WRITE_BLOCK_DATA : (length - done);
+
+        block = (PREP_WRITE_BLOCK_T *) BufPool_Alloc(sizeof(PREP_WRITE_BLOCK_T));
+        if(block == NULL)
+        {
+            /* Taken from an interrupt since the check; the long write
+             * cannot complete any more
+             */
+            PrepWrite_Release(&prepWriteQueue);
+            return CYBLE_GATT_ERR_PREPARE_WRITE_QUEUE_FULL;
+        }
+        block->next = NULL;
+        block->offset = (uint16) (prepWriteQueue.length + done);
+        block->length = (uint16) part;
+        (void) memcpy(block->data, &value[done], part);
+
+        if(prepWriteQueue.tail == NULL)
+        {
+            prepWriteQueue.head = block;
+        }
+        else
+        {
+            prepWriteQueue.tail->next = block;
+        }
+        prepWriteQueue.tail = block;
+        prepWriteQueue.blocks++;
+    }
+    prepWriteQueue.length += length;
+
+    if(prepWriteQueue.blocks > prepWriteStats.maxBlocks)
+    {
+        prepWriteStats.maxBlocks = prepWriteQueue.blocks;
+    }
+
+    return CYBLE_GATT_ERR_NONE;
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Execute()
+********************************************************************************
+*
+* Summary:
+*   Joins the queue into one command and passes it to the Bootloader, the
+*   way the BLE component passes a single write.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   CYBLE_GATT_ERR_NONE when passed on, else the error to respond with.
+*
+*******************************************************************************/
+static CYBLE_GATT_ERR_CODE_T PrepWrite_Execute(void)
+{
+    const PREP_WRITE_BLOCK_T *block;
+
+    if(0u != cyBle_cmdReceivedFlag)
+    {
+        /* The previous command has not been read yet */
+        return CYBLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+    }
+
+    for(block = prepWriteQueue.head; block != NULL; block = block->next)
+    {
+        (void) memcpy(&prepWriteCommand[block->offset], block->data, block->length);
+    }
+
+    cyBle_btsBuffPtr = prepWriteCommand;
+    cyBle_cmdLength = (uint16) prepWriteQueue.length;
+    cyBle_cmdReceivedFlag = 1u;
+    prepWriteStats.commands++;
+
+    return CYBLE_GATT_ERR_NONE;
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Event()
+********************************************************************************
+*
+* Summary:
+*   BLE event handler for CYBLE_EVT_GATTS_PREP_WRITE_REQ,
+*   CYBLE_EVT_GATTS_EXEC_WRITE_REQ and CYBLE_EVT_GATT_DISCONNECT_IND.
+*   Prepared writes to other attributes than the Bootloader characteristic
+*   are not supported.
+*
+* Parameters:
+*   event - event code
+*   eventParam - event parameter
+*
+*******************************************************************************/
+void PrepWrite_Event(uint32 event, void *eventParam)
+{
+    CYBLE_GATTS_PREP_WRITE_REQ_PARAM_T *prepParam = (CYBLE_GATTS_PREP_WRITE_REQ_PARAM_T *) eventParam;
+    CYBLE_GATTS_EXEC_WRITE_REQ_T *execParam = (CYBLE_GATTS_EXEC_WRITE_REQ_T *) eventParam;
+    const CYBLE_GATT_HANDLE_VALUE_OFFSET_PARAM_T *fragment;
+    CYBLE_GATT_ERR_CODE_T result;
+
+    switch(event)
+    {
+        case CYBLE_EVT_GATTS_PREP_WRITE_REQ:
+            /* The latest request is the last one of the stack's queue */
+            fragment = &prepParam->baseAddr[prepParam->currentPrepWriteReqCount - 1u];
+            if(fragment->handleValuePair.attrHandle != cyBle_btss.btServiceInfo[0u].btServiceCharHandle)
+            {
+                (void) CyBle_GattsPrepWriteReqSupport(CYBLE_GATTS_PREP_WRITE_NOT_SUPPORT);
+                break;
+            }
+            if(1u == prepParam->currentPrepWriteReqCount)
+            {
+                if((0u != prepWriteResumed) && (fragment->offset != 0u) &&
+                   (fragment->offset <= prepWriteQueue.length))
+                {
+                    /* The central continues the long write of a previous link */
+                    PrepWrite_Truncate(fragment->offset);
+                    prepWriteStats.resumed++;
+                }
+                else
+                {
+                    PrepWrite_Release(&prepWriteQueue);
+                }
+                prepWriteResumed = 0u;
+                (void) CyBle_GattsPrepWriteReqSupport(CYBLE_GATTS_PREP_WRITE_SUPPORT);
+            }
+            result = PrepWrite_Queue(fragment);
+            if(result == CYBLE_GATT_ERR_NONE)
+            {
+                prepWriteStats.fragments++;
+            }
+            else
+            {
+                prepParam->gattErrorCode = (uint8) result;
+                prepWriteStats.refused++;
+            }
+            break;
+        case CYBLE_EVT_GATTS_EXEC_WRITE_REQ:
+            if((execParam->execWriteFlag == CYBLE_GATT_EXECUTE_WRITE_EXEC_FLAG) && (prepWriteQueue.head != NULL))
+            {
+                result = PrepWrite_Execute();
+                execParam->gattErrorCode = (uint8) result;
+            }
+            else if(prepWriteQueue.head != NULL)
+            {
+                prepWriteStats.cancelled++;
+            }
+            else
+            {
+                /* Nothing queued */
+            }
+            PrepWrite_Release(&prepWriteQueue);
+            prepWriteResumed = 0u;
+            break;
+        default:
+            if(prepWriteQueue.head != NULL)
+            {
+                prepWriteStats.cancelled++;
+            }
+            PrepWrite_Release(&prepWriteQueue);
+            prepWriteResumed = 0u;
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_GetStats()
+********************************************************************************
+*
+* Summary:
+*   Copies the reassembly counters, counted since start.
+*
+* Parameters:
+*   stats - receives the counters
+*
+*******************************************************************************/
+void PrepWrite_GetStats(PREP_WRITE_STATS_T *stats)
+{
+    *stats = prepWriteStats;
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Suspend()
+********************************************************************************
+*
+* Summary:
+*   Moves the current queue out, leaving it empty. Called before
+*   CYBLE_EVT_GATT_DISCONNECT_IND reaches PrepWrite_Event().
+*
+* Parameters:
+*   queue - receives the queue; release or resume it later
+*
+*******************************************************************************/
+void PrepWrite_Suspend(PREP_WRITE_QUEUE_T *queue)
+{
+    *queue = prepWriteQueue;
+    (void) memset(&prepWriteQueue, 0, sizeof(prepWriteQueue));
+    prepWriteResumed = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: PrepWrite_Resume()
+********************************************************************************
+*
+* Summary:
+*   Makes a suspended queue the current one, for a central that reconnected.
+*   The current queue is released.
+*
+* Parameters:
+*   queue - queue from PrepWrite_Suspend(), emptied
+*
+*******************************************************************************/
+void PrepWrite_Resume(PREP_WRITE_QUEUE_T *queue)
+{
+    PrepWrite_Release(&prepWriteQueue);
+    prepWriteQueue = *queue;
+    (void) memset(queue, 0, sizeof(*queue));
+    prepWriteResumed = (prepWriteQueue.head != NULL) ? 1u : 0u;
+}
+
+
+/* [] END OF FILE */
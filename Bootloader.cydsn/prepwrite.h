@@ -0,0 +1,73 @@
+/*******************************************************************************
+* File Name: prepwrite.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the prepared write
+*  reassembly. A Bootloader command longer than ATT MTU - 3 bytes, e.g. a
+*  144 byte Program Row from a central limited to the default MTU, arrives
+*  as a queue of Prepare Write requests to the Bootloader characteristic.
+*  The fragments are kept in up to PREP_WRITE_BLOCKS pool blocks and joined
+*  into one command when the Execute Write request arrives, which is then
+*  handed to the Bootloader like a single write. A cancelled or
+*  disconnected queue is dropped, unless the OTA session handoff
+*  (otasession.h) suspends it for the central to continue after a
+*  reconnect. The first Prepare Write request after PrepWrite_Resume() may
+*  then restart at any offset up to the length already queued.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(PREPWRITE_H)
+#define PREPWRITE_H
+
+#include <project.h>
+#include "Options.h"
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+struct PREP_WRITE_BLOCK_S;
+
+/* Fragments of one long write */
+typedef struct
+{
+    struct PREP_WRITE_BLOCK_S *head;
+    struct PREP_WRITE_BLOCK_S *tail;
+    uint32 length;                      /* Next expected offset */
+    uint32 blocks;
+} PREP_WRITE_QUEUE_T;
+
+typedef struct
+{
+    uint32 commands;                    /* Commands executed */
+    uint32 fragments;                   /* Prepare Write requests queued */
+    uint32 refused;                     /* Prepare Write requests refused */
+    uint32 cancelled;                   /* Queues cancelled or dropped */
+    uint32 maxBlocks;                   /* Most blocks queued at once */
+    uint32 resumed;                     /* Queues continued after a reconnect */
+} PREP_WRITE_STATS_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+void PrepWrite_Start(void);
+void PrepWrite_Event(uint32 event, void *eventParam);
+void PrepWrite_GetStats(PREP_WRITE_STATS_T *stats);
+void PrepWrite_Suspend(PREP_WRITE_QUEUE_T *queue);
+void PrepWrite_Resume(PREP_WRITE_QUEUE_T *queue);
+void PrepWrite_Release(PREP_WRITE_QUEUE_T *queue);
+
+#endif /* PREPWRITE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,39 @@
+/*******************************************************************************
+* File Name: sharedapi.c
+*
+* Version 1.30
+*
+* Description:
+*  Generates the shared API jump table (Shared\sharedapi.h) from the BLE
+*  component of this project. The linker script places the table at the
+*  fixed address the bootloadable reads it from.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "main.h"
+#include "gattsig.h"
+#include "sharedapi.h"
+
+#define SHARED_API_FUNCTION_INIT(ret, name, params)     &name,
+#define SHARED_API_VARIABLE_INIT(type, name)            &name,
+
+CY_SECTION(".cysharedapi")
+const SHARED_API_T cySharedApi =
+{
+    SHARED_API_MAGIC,
+    SHARED_API_VERSION_MAJOR,
+    SHARED_API_VERSION_MINOR,
+    sizeof(SHARED_API_T),
+    SHARED_API_LAYOUT_SIGNATURE,
+    SHARED_API_FUNCTIONS(SHARED_API_FUNCTION_INIT)
+    SHARED_API_VARIABLES(SHARED_API_VARIABLE_INIT)
+    SHARED_API_APPENDED(SHARED_API_FUNCTION_INIT, SHARED_API_VARIABLE_INIT)
+};
+
+
+/* [] END OF FILE */
@@ -20,6 +20,15 @@
 * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
 *******************************************************************************/
 #include "common.h"
+#include "blockmem.h"
+#include "diaglog.h"
+#include "advsched.h"
+#include "battery.h"
+
+#if (SRAM_INIT_PROFILE_ENABLED == YES)
+    /* CPU cycles spent in the last InitializeBootloaderSRAM() call */
+    uint32 sramInitCycles;
+#endif /* (SRAM_INIT_PROFILE_ENABLED == YES) */
 
 #if defined(__ARMCC_VERSION)
     
@@ -94,8 +103,9 @@ extern void initialize_psoc(void);
     ********************************************************************************
     *
     * Summary:
-    *   This function initializes bootloader RAM .bss section. It is required for 
-    *   BLE Stack operation.
+    *   This function initializes bootloader RAM .data and .bss sections. It is
+    *   required for BLE Stack operation. Regions are filled with block
+    *   transfers.
     *
     * Parameters:
     *   None
@@ -109,31 +119,15 @@ extern void initialize_psoc(void);
         /* Initialize memory */
         for (regions = Bootloader__cy_region_num; regions != 0u; regions--)
         {
-            uint32 *src = (uint32 *)rptr->init;
-            uint32 *dst = (uint32 *)rptr->data;
-            unsigned limit = rptr->init_size;
-            unsigned count;
-
-            for (count = 0u; count != limit; count += sizeof (uint32))
-            {
-                *dst = *src;
-                dst++;
-                src++;
-            }
-            limit = rptr->zero_size;
-            for (count = 0u; count != limit; count += sizeof (uint32))
-            {
-                *dst = 0u;
-                dst++;
-            }
-
+            BlockMem_Copy32((uint32 *)rptr->data, (const uint32 *)rptr->init, rptr->init_size);
+            BlockMem_Zero32((uint32 *)(rptr->data + rptr->init_size), rptr->zero_size);
             rptr++;
         }
 
         /* Invoke static objects constructors using Bootloader__libc_init_array() function call here
          * if they are needed.
          */
-}   
+    }
 #elif defined (__ICCARM__)
     /*******************************************************************************
     * Following code implements re-initialization of separate RAM segment containing
@@ -159,6 +153,16 @@ extern void initialize_psoc(void);
 *******************************************************************************/
 void InitializeBootloaderSRAM()
 {
+#if (SRAM_INIT_PROFILE_ENABLED == YES)
+    uint32 startCount;
+
+    CY_SYS_SYST_CSR_REG = 0u;
+    CY_SYS_SYST_RVR_REG = SRAM_INIT_SYSTICK_RELOAD;
+    CY_SYS_SYST_CVR_REG = 0u;
+    CY_SYS_SYST_CSR_REG = CY_SYS_SYST_CSR_ENABLE | CY_SYS_SYST_CSR_CLK_SRC_SYSCLK;
+    startCount = CY_SYS_SYST_CVR_REG;
+#endif /* (SRAM_INIT_PROFILE_ENABLED == YES) */
+
 #if defined(__ARMCC_VERSION)
     CyReturnToBootloaddableAddress = (uint32)$Super$$main;
     Bootloader__main();
@@ -167,6 +171,12 @@ void InitializeBootloaderSRAM()
 #elif defined (__ICCARM__)
     Bootloader__iar_data_init3();
 #endif /* defined(__ARMCC_VERSION) */
+
+#if (SRAM_INIT_PROFILE_ENABLED == YES)
+    /* SysTick counts down from the reload value at the CPU clock */
+    sramInitCycles = (startCount - CY_SYS_SYST_CVR_REG) & SRAM_INIT_SYSTICK_RELOAD;
+    CY_SYS_SYST_CSR_REG = 0u;
+#endif /* (SRAM_INIT_PROFILE_ENABLED == YES) */
 }
 
 
@@ -195,7 +205,8 @@ void ConfigureSharedPins()
 *
 * Summary:
 *   This function polls SW2 button and if it is pressed - shedules bootloader 
-*   project launch. That action includes sotware reset.
+*   project launch. That action includes sotware reset. The launch is
+*   refused, once per press, while the battery is too low for an update.
 *
 * Parameters:
 *   None
@@ -203,24 +214,40 @@ void ConfigureSharedPins()
 *******************************************************************************/
 void BootloaderSwitch()
 {
+    static uint32 refused = 0u;
+
     if (Bootloader_Service_Activation_Read() == 0)
     {
         CyDelay(100);
-        if (Bootloader_Service_Activation_Read() == 0)
+        if ((Bootloader_Service_Activation_Read() == 0) && (0u == Battery_OtaAllowed()))
+        {
+            if (0u == refused)
+            {
+                refused = 1u;
+                DiagLog_Append(DIAG_EVT_OTA_REFUSED, Battery_GetMv());
+                H_UART_UartPutString("Battery low, update refused\r\n");
+            }
+        }
+        else if (Bootloader_Service_Activation_Read() == 0)
         {
             CyDelay(500);
             
-            
+            /* The Bootloader advertises directly to a connected central */
+            AdvSched_Handoff();
             CyBle_Shutdown(); /* stop all ongoing activities */
             CyBle_ProcessEvents(); /* process all pending events */
             CyBle_SetState(CYBLE_STATE_STOPPED);
             CySysWdtUnlock();
             CySysWdtDisable(WDT_COUNTER_MASK);
             CyGlobalIntDisable;
+            DiagLog_Append(DIAG_EVT_LOAD_BOOTLOADER, DIAG_LOAD_BUTTON);
             Bootloadable_Load();
         }
     }
-
+    else
+    {
+        refused = 0u;
+    }
 }
 
 
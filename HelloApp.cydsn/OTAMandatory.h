@@ -195,6 +195,10 @@ typedef struct
     uint8     type; /*public = 0, Random = 1*/
 }CYBLE_GAP_BD_ADDR_T;
 
+/* Bluetooth Device Address types */
+#define CYBLE_GAP_ADDR_TYPE_PUBLIC          0x00u
+#define CYBLE_GAP_ADDR_TYPE_RANDOM          0x01u
+
 /* Authentication Failed Error Codes */
 typedef enum
 {
@@ -632,6 +636,10 @@ typedef struct
 
 }CYBLE_GATT_HANDLE_VALUE_PAIR_T;
 
+/* Flags of CyBle_GattsWriteAttributeValue() */
+#define CYBLE_GATT_DB_LOCALLY_INITIATED              (0x00u)
+#define CYBLE_GATT_DB_PEER_INITIATED                 (0x40u)
+
 /* Write request parameter received from Client */
 typedef struct
 {
@@ -643,6 +651,45 @@ typedef struct
 	
 }CYBLE_GATTS_WRITE_REQ_PARAM_T;
 
+/* Write command parameter type, the same as for the write request */
+typedef CYBLE_GATTS_WRITE_REQ_PARAM_T CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T;
+
+/* Connection parameters, CYBLE_EVT_GAP_DEVICE_CONNECTED and
+ * CYBLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE event parameter
+ */
+typedef struct
+{
+	/* HCI error code */
+	uint8                   status;
+
+	/* Connection interval, 1.25 ms units */
+	uint16                  connIntv;
+
+	/* Slave latency, connection events */
+	uint16                  connLatency;
+
+	/* Supervision timeout, 10 ms units */
+	uint16                  supervisionTO;
+
+}CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T;
+
+/* Connection parameter update request */
+typedef struct
+{
+	/* Minimum connection interval, 1.25 ms units */
+	uint16                  connIntvMin;
+
+	/* Maximum connection interval, 1.25 ms units */
+	uint16                  connIntvMax;
+
+	/* Slave latency, connection events */
+	uint16                  connLatency;
+
+	/* Supervision timeout, 10 ms units */
+	uint16                  supervisionTO;
+
+}CYBLE_GAP_CONN_UPDATE_PARAM_T;
+
 #define CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE   CYBLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE
 
 /* BLE power modes */
@@ -1007,6 +1054,11 @@ typedef struct
 	
 } CYBLE_GAPP_SCAN_RSP_DATA_T;
 
+/* Discovery modes */
+#define CYBLE_GAPP_NONE_DISC_BROADCAST_MODE     0x00u
+#define CYBLE_GAPP_LTD_DISC_MODE                0x01u
+#define CYBLE_GAPP_GEN_DISC_MODE                0x02u
+
 /* Advertising information   */
 typedef struct
 {
@@ -1071,6 +1123,7 @@ typedef struct
 } CYBLE_BLESS_PWR_IN_DB_T;
 
 #define CYBLE_GATT_MTU                               (0x0090u)
+#define CYBLE_GATT_DEFAULT_MTU                       (23u)
 #define CYBLE_DEFAULT_HEAP_SIZE				(16 + 2196 + 1008)
 
 #define CYBLE_STACK_HEAP_SIZE           (CYBLE_DEFAULT_HEAP_SIZE + (CYBLE_GATT_MTU - (CYBLE_GATT_MTU % 4u) - 20u) * 2u)
@@ -1239,13 +1292,17 @@ typedef struct
 	
 }CYBLE_GATTS_ERR_PARAM_T;
 
+#define CYBLE_CUSTOMS_SERVICE_COUNT                  (0x01u)
+#define CYBLE_CUSTOM_SERVICE_CHAR_COUNT              (0x01u)
+#define CYBLE_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT  (0x01u)
+
 /* Contains information about Custom Characteristic structure */
 typedef struct
 {
     /* Custom Characteristic handle */
     CYBLE_GATT_DB_ATTR_HANDLE_T customServiceCharHandle;
     /* Custom Characteristic Descriptors handles */
-    CYBLE_GATT_DB_ATTR_HANDLE_T customServiceCharDescriptors[1];
+    CYBLE_GATT_DB_ATTR_HANDLE_T customServiceCharDescriptors[CYBLE_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT];
 } CYBLE_CUSTOMS_INFO_T;
 
 /* Structure with Custom Service attribute handles. */
@@ -1255,7 +1312,7 @@ typedef struct
     CYBLE_GATT_DB_ATTR_HANDLE_T customServiceHandle;
     
     /* Information about Custom Characteristics */
-    CYBLE_CUSTOMS_INFO_T customServiceInfo[1];
+    CYBLE_CUSTOMS_INFO_T customServiceInfo[CYBLE_CUSTOM_SERVICE_CHAR_COUNT];
 } CYBLE_CUSTOMS_T;
 
 /* DIS characteristic index */
@@ -1474,6 +1531,7 @@ typedef struct
 #define CYBLE_DIS_SERVICE_HANDLE      (0x0021u)
 #define CYBLE_BAS_SERVICE_HANDLE      (0x0028u)
 #define CYBLE_SCPS_SERVICE_HANDLE     (0x002Du)
+#define CYBLE_SCPS_SCAN_REFRESH_CHAR_HANDLE (0x0031u)
 #define CYBLE_BTS_SERVICE_HANDLE      (0x0033u)
 
 /* Structure with Scan Parameters Service attribute handles */
@@ -3229,6 +3287,9 @@ extern CYBLE_API_RESULT_T CyBle_GattsWriteRsp(CYBLE_CONN_HANDLE_T connHandle);
 extern CYBLE_API_RESULT_T CyBle_Start(CYBLE_CALLBACK_T callbackFunc);
 extern CYBLE_API_RESULT_T CyBle_GappStartAdvertisement(uint8 advertisingIntervalType);
 extern CYBLE_API_RESULT_T CyBle_GetDeviceAddress(CYBLE_GAP_BD_ADDR_T* bdAddr);
+extern CYBLE_API_RESULT_T CyBle_GapGetPeerBdAddr(uint8 bdHandle, CYBLE_GAP_BD_ADDR_T* peerBdAddr);
+extern CYBLE_API_RESULT_T CyBle_L2capLeConnectionParamUpdateRequest(uint8 bdHandle,
+    CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam);
 extern CYBLE_STATE_T cyBle_state;
 #define CyBle_GetState() (cyBle_state)
 extern CYBLE_LP_MODE_T CyBle_EnterLPM(CYBLE_LP_MODE_T pwrMode);
@@ -3265,6 +3326,8 @@ CYBLE_API_RESULT_T CyBle_GattsIndication(CYBLE_CONN_HANDLE_T connHandle, CYBLE_G
 CYBLE_API_RESULT_T CyBle_GattsErrorRsp(CYBLE_CONN_HANDLE_T connHandle, CYBLE_GATTS_ERR_PARAM_T * errRspParam);
 CYBLE_API_RESULT_T CyBle_GattsExchangeMtuRsp(CYBLE_CONN_HANDLE_T connHandle, uint16 mtu);
 CYBLE_API_RESULT_T CyBle_GattsWriteRsp(CYBLE_CONN_HANDLE_T connHandle);
+CYBLE_GATT_ERR_CODE_T CyBle_GattsWriteAttributeValue(CYBLE_GATT_HANDLE_VALUE_PAIR_T *handleValuePair,
+    uint16 offset, CYBLE_CONN_HANDLE_T *connHandle, uint8 flags);
 
 
 /* Pin APIs */
@@ -3338,7 +3401,7 @@ extern CYBLE_GAP_AUTH_INFO_T cyBle_authInfo;
 extern uint8 cyBle_stackMemoryHeap[CYBLE_STACK_HEAP_SIZE];
 extern CYBLE_HIDSS_REPORT_T cyBle_hids1ReportArray[0x02u];
 extern const uint8 cyBle_attUuid128[2u][16u];
-extern const CYBLE_CUSTOMS_T cyBle_customs[1];
+extern const CYBLE_CUSTOMS_T cyBle_customs[CYBLE_CUSTOMS_SERVICE_COUNT];
 extern const CYBLE_DISS_T cyBle_diss;
 extern const CYBLE_HIDSS_T cyBle_hidss[0x01u];
 extern const CYBLE_BASS_T cyBle_bass[0x01];
@@ -3347,10 +3410,16 @@ extern uint8  cyBle_cmdReceivedFlag;
 extern uint16 cyBle_cmdLength;
 extern const CYBLE_BTSS_T cyBle_btss;
 
+void InitializeBootloaderSRAM(void);
 void ConfigureSharedPins(void);
 void BootloaderSwitch(void);
 void ConfigureServices(void);
 
+extern uint32 sramInitCycles;
+
+/* Routes the shared BLE APIs through the Bootloader jump table */
+#include "sharedapi.h"
+
 #endif /* SHARED_API_HEADER */
 
 
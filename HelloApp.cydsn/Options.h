@@ -33,6 +33,118 @@
 * Following section contains bootloadable project compile-time options.
 *******************************************************************************/
 
+/* Measure InitializeBootloaderSRAM() with SysTick and print the cycle count
+ * over H_UART at startup.
+ */
+#define SRAM_INIT_PROFILE_ENABLED               (NO)
+#define SRAM_INIT_SYSTICK_RELOAD                (0x00FFFFFFu)
+
+/* Record boot phase checkpoints (Shared\bootprof.h) and print the breakdown
+ * once the first advertisement has started.
+ */
+#define BOOT_PROFILE_ENABLED                    (YES)
+
+/* BLE event trace ring (Shared\bletrace.h). Records are sent as GATT
+ * notifications on BLE_TRACE_CHAR_HANDLE while connected, once a
+ * characteristic for them is added to the BLE component, or printed over
+ * UART when BLE_TRACE_UART_ENABLED.
+ */
+#define BLE_TRACE_ENABLED                       (YES)
+#define BLE_TRACE_SIZE                          (64u)    /* Records, power of two */
+#define BLE_TRACE_UART_ENABLED                  (NO)
+#define BLE_TRACE_CHAR_HANDLE                   (0u)
+
+/* Reset-surviving diagnostic log (Shared\diaglog.h), reported over UART at
+ * every boot.
+ */
+#define DIAG_LOG_ENABLED                        (YES)
+
+/* Advertising schedule (Shared\advsched.h): directed advertising to the
+ * last central after an unexpected disconnect, then a back-off curve whose
+ * first stage lasts twice the usual reconnect time, between the limits
+ * below (s). ADV_SCHED_LAST_TIMEOUT is the length of the slowest stage (s);
+ * with 0 HelloApp keeps advertising in it.
+ */
+#define ADV_SCHED_DIRECTED_ENABLED              (YES)
+#define ADV_SCHED_FAST_MIN                      (2u)
+#define ADV_SCHED_FAST_MAX                      (30u)
+#define ADV_SCHED_LAST_TIMEOUT                  (0u)
+
+/* GATT database signature (Shared\gattsig.h): records that a client saw the
+ * HelloApp database, so the Bootloader asks it to rediscover services.
+ */
+#define GATT_SIG_ENABLED                        (YES)
+
+/* Deferred flash writes (Shared\flashsched.h) are made while connected only
+ * when the connection interval is at least this long (1.25 ms units), so a
+ * row write fits between two connection events.
+ */
+#define FLASH_SCHED_CONN_INTV_MIN               (24u)
+
+/* Idle manager (idle.h): Deep-Sleep is not entered for IDLE_UART_HOLD_MS
+ * after a character is received; the time in each power state goes to the
+ * BLE event trace every IDLE_REPORT_PERIOD seconds (at most 65).
+ */
+#define IDLE_UART_HOLD_MS                       (2000u)
+#define IDLE_REPORT_PERIOD                      (10u)
+
+/* BLE event dispatch (Shared\bledispatch.h). With BLE_DISPATCH_STATS_ENABLED
+ * the CPU cycles of every handler call go into a histogram that is printed
+ * over UART each report period, and calls longer than BLE_DISPATCH_SLOW_US
+ * are added to the BLE event trace. Takes over SysTick.
+ */
+#define BLE_DISPATCH_STATS_ENABLED              (YES)
+#define BLE_DISPATCH_REPORT_PERIOD              (32768u * 10u)  /* 10 s @ 32.768kHz clock */
+#define BLE_DISPATCH_SLOW_US                    (1000u)
+
+/* Notification transmit queue (txqueue.h): values waiting for stack buffers,
+ * and the longest value in bytes (ATT MTU - 3 at the default MTU).
+ */
+#define TX_QUEUE_DEPTH                          (8u)
+#define TX_QUEUE_VALUE_SIZE                     (20u)
+
+/* Link timing policy (linkpolicy.h) driven by the scan parameters of the
+ * central: the longest fast advertising interval (0.625 ms units), the
+ * connection interval range (1.25 ms units), the most slave latency and the
+ * shortest supervision timeout (10 ms units) to request.
+ */
+#define LINK_POLICY_ADV_INTV_MAX                (160u)          /* 100 ms */
+#define LINK_POLICY_CONN_INTV_MIN               (6u)            /* 7.5 ms */
+#define LINK_POLICY_CONN_INTV_MAX               (12u)           /* 15 ms */
+#define LINK_POLICY_LATENCY_MAX                 (30u)
+#define LINK_POLICY_SUPERVISION_TO              (400u)          /* 4 s */
+
+/* Battery monitor (battery.h). BATTERY_ADC_ENABLED needs an ADC_SAR_Seq
+ * named ADC with the battery, through a BATTERY_ADC_DIVIDER : 1 divider, on
+ * BATTERY_ADC_CHANNEL. The level is linear between BATTERY_MV_EMPTY and
+ * BATTERY_MV_FULL and is notified in BATTERY_NOTIFY_STEP percent steps.
+ */
+#define BATTERY_ADC_ENABLED                     (NO)
+#define BATTERY_ADC_CHANNEL                     (0u)
+#define BATTERY_ADC_DIVIDER                     (2u)
+#define BATTERY_SAMPLE_PERIOD                   (32768u * 5u)   /* 5 s @ 32.768kHz clock */
+#define BATTERY_FILTER_SHIFT                    (3u)            /* Time constant of 8 samples */
+#define BATTERY_MV_FULL                         (3000u)
+#define BATTERY_MV_EMPTY                        (2000u)
+#define BATTERY_NOTIFY_STEP                     (10u)           /* % */
+#define BATTERY_HYSTERESIS                      (2u)            /* % */
+#define BATTERY_OTA_MIN_MV                      (2400u)
+
+/* UART to BLE bridge (uartbridge.h) on characteristic UART_BRIDGE_CHAR_INDEX
+ * of the custom service; give it the Notify, Write and Write Without
+ * Response properties and a CCCD in the Bootloader's BLE component. The
+ * Bootloader's power statistics use the next one (POWER_STATS_CHAR_INDEX
+ * in Bootloader.cydsn\Options.h), never this one. The ring sizes
+ * are powers of two. A partial notification is sent UART_BRIDGE_FLUSH_MS
+ * after its first byte arrived; 0 sends every byte at once.
+ */
+#define UART_BRIDGE_CHAR_INDEX                  (0u)
+#define UART_BRIDGE_CHAR_HANDLE                 (cyBle_customs[0u].customServiceInfo[UART_BRIDGE_CHAR_INDEX].customServiceCharHandle)
+#define UART_BRIDGE_CCCD_HANDLE                 (cyBle_customs[0u].customServiceInfo[UART_BRIDGE_CHAR_INDEX].customServiceCharDescriptors[0u])
+#define UART_BRIDGE_RX_SIZE                     (512u)          /* H_UART to BLE */
+#define UART_BRIDGE_TX_SIZE                     (512u)          /* BLE to H_UART */
+#define UART_BRIDGE_FLUSH_MS                    (10u)
+
 #endif /* Options_H */
 
 
@@ -0,0 +1,237 @@
+/*******************************************************************************
+* File Name: battery.c
+*
+* Version: 1.30
+*
+* Description:
+*  Battery monitor; see battery.h. The filter keeps the voltage scaled by
+*  2^BATTERY_FILTER_SHIFT, so each sample moves it by 1/2^BATTERY_FILTER_SHIFT
+*  of the difference without a division. Without an ADC in the design
+*  (BATTERY_ADC_ENABLED == NO) the monitor reports BATTERY_MV_FULL.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "battery.h"
+#include "idle.h"
+#include "txqueue.h"
+
+#if (BATTERY_MV_FULL <= BATTERY_MV_EMPTY)
+    #error BATTERY_MV_FULL must be above BATTERY_MV_EMPTY
+#endif
+#if ((BATTERY_NOTIFY_STEP == 0u) || (BATTERY_HYSTERESIS >= BATTERY_NOTIFY_STEP))
+    #error BATTERY_HYSTERESIS must be below a non-zero BATTERY_NOTIFY_STEP
+#endif
+
+static uint32 batteryFilter;
+static uint8 batteryLevel;
+static uint32 batteryBand;
+
+static uint32 Battery_Sample(void);
+static uint32 Battery_Level(uint32 mv);
+static void Battery_Update(void);
+
+
+/*******************************************************************************
+* Function Name: Battery_Sample()
+********************************************************************************
+*
+* Summary:
+*   Wakes the ADC, converts the battery channel and puts the ADC back to
+*   sleep.
+*
+* Return:
+*   Battery voltage in mV.
+*
+*******************************************************************************/
+static uint32 Battery_Sample(void)
+{
+#if (BATTERY_ADC_ENABLED == YES)
+    int16 counts;
+
+    ADC_Wakeup();
+    ADC_StartConvert();
+    (void) ADC_IsEndConversion(ADC_WAIT_FOR_RESULT);
+    counts = ADC_GetResult16(BATTERY_ADC_CHANNEL);
+    ADC_Sleep();
+
+    counts = ADC_CountsTo_mVolts(BATTERY_ADC_CHANNEL, counts);
+    return (counts > 0) ? ((uint32) counts * BATTERY_ADC_DIVIDER) : 0u;
+#else
+    return BATTERY_MV_FULL;
+#endif /* (BATTERY_ADC_ENABLED == YES) */
+}
+
+
+/*******************************************************************************
+* Function Name: Battery_Level()
+********************************************************************************
+*
+* Summary:
+*   Maps a voltage linearly to the Battery Level range.
+*
+* Parameters:
+*   mv - battery voltage in mV
+*
+* Return:
+*   Level in percent.
+*
+*******************************************************************************/
+static uint32 Battery_Level(uint32 mv)
+{
+    uint32 level;
+
+    if(mv <= BATTERY_MV_EMPTY)
+    {
+        level = 0u;
+    }
+    else if(mv >= BATTERY_MV_FULL)
+    {
+        level = BATTERY_LEVEL_MAX;
+    }
+    else
+    {
+        level = ((mv - BATTERY_MV_EMPTY) * BATTERY_LEVEL_MAX) / (BATTERY_MV_FULL - BATTERY_MV_EMPTY);
+    }
+
+    return level;
+}
+
+
+/*******************************************************************************
+* Function Name: Battery_Update()
+********************************************************************************
+*
+* Summary:
+*   Stores a new level in the Battery Level characteristic and notifies it
+*   when it left the band of the last notified level.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void Battery_Update(void)
+{
+    uint32 level = Battery_Level(Battery_GetMv());
+    uint32 low = batteryBand * BATTERY_NOTIFY_STEP;
+    uint32 high = low + BATTERY_NOTIFY_STEP + BATTERY_HYSTERESIS;
+
+    low = (low > BATTERY_HYSTERESIS) ? (low - BATTERY_HYSTERESIS) : 0u;
+
+    if(level != batteryLevel)
+    {
+        batteryLevel = (uint8) level;
+        (void) CyBle_BassSetCharacteristicValue(0u, CYBLE_BAS_BATTERY_LEVEL, sizeof(batteryLevel), &batteryLevel);
+    }
+
+    if((level < low) || (level >= high))
+    {
+        batteryBand = level / BATTERY_NOTIFY_STEP;
+        (void) TxQueue_Bass(0u, CYBLE_BAS_BATTERY_LEVEL, &batteryLevel, sizeof(batteryLevel), TX_QUEUE_COALESCE);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Battery_Start()
+********************************************************************************
+*
+* Summary:
+*   Starts the ADC, seeds the filter with a first sample and starts the
+*   sampling timer. Called after Idle_Start().
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void Battery_Start(void)
+{
+#if (BATTERY_ADC_ENABLED == YES)
+    ADC_Start();
+#endif /* (BATTERY_ADC_ENABLED == YES) */
+
+    batteryFilter = Battery_Sample() << BATTERY_FILTER_SHIFT;
+    batteryLevel = (uint8) Battery_Level(Battery_GetMv());
+    batteryBand = batteryLevel / BATTERY_NOTIFY_STEP;
+    (void) CyBle_BassSetCharacteristicValue(0u, CYBLE_BAS_BATTERY_LEVEL, sizeof(batteryLevel), &batteryLevel);
+
+    Idle_TimerStart(IDLE_TIMER_BATTERY, BATTERY_SAMPLE_PERIOD);
+}
+
+
+/*******************************************************************************
+* Function Name: Battery_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop. Takes a sample each BATTERY_SAMPLE_PERIOD.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void Battery_Task(void)
+{
+    if(0u != Idle_TimerExpired(IDLE_TIMER_BATTERY))
+    {
+        batteryFilter += Battery_Sample() - (batteryFilter >> BATTERY_FILTER_SHIFT);
+        Battery_Update();
+        Idle_TimerStart(IDLE_TIMER_BATTERY, BATTERY_SAMPLE_PERIOD);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Battery_GetMv()
+********************************************************************************
+*
+* Summary:
+*   Returns the filtered battery voltage in mV.
+*
+*******************************************************************************/
+uint32 Battery_GetMv(void)
+{
+    return batteryFilter >> BATTERY_FILTER_SHIFT;
+}
+
+
+/*******************************************************************************
+* Function Name: Battery_GetLevel()
+********************************************************************************
+*
+* Summary:
+*   Returns the Battery Level characteristic value in percent.
+*
+*******************************************************************************/
+uint32 Battery_GetLevel(void)
+{
+    return batteryLevel;
+}
+
+
+/*******************************************************************************
+* Function Name: Battery_OtaAllowed()
+********************************************************************************
+*
+* Summary:
+*   Checks whether the battery can carry a firmware update.
+*
+* Return:
+*   Non-zero when the filtered voltage is at least BATTERY_OTA_MIN_MV.
+*
+*******************************************************************************/
+uint32 Battery_OtaAllowed(void)
+{
+    return (Battery_GetMv() >= BATTERY_OTA_MIN_MV) ? 1u : 0u;
+}
+
+
+/* [] END OF FILE */
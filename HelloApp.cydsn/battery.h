@@ -0,0 +1,52 @@
+/*******************************************************************************
+* File Name: battery.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the battery monitor.
+*  The battery voltage is sampled once per BATTERY_SAMPLE_PERIOD through the
+*  ADC, which sleeps in between, and smoothed by a first order IIR filter in
+*  fixed point. The Battery Level characteristic always holds the latest
+*  level, but a notification is only sent when the level leaves the
+*  BATTERY_NOTIFY_STEP wide band of the last notified level by more than
+*  BATTERY_HYSTERESIS, so ADC noise does not wake the central.
+*  Switching to the Bootloader for an update is refused below
+*  BATTERY_OTA_MIN_MV, so a flash write is not cut off by a brown-out.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BATTERY_H)
+#define BATTERY_H
+
+#include <project.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Battery Level characteristic range, percent */
+#define BATTERY_LEVEL_MAX               (100u)
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+void Battery_Start(void);
+void Battery_Task(void);
+uint32 Battery_GetMv(void);
+uint32 Battery_GetLevel(void);
+uint32 Battery_OtaAllowed(void);
+
+#endif /* BATTERY_H */
+
+
+/* [] END OF FILE */
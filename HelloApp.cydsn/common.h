@@ -16,6 +16,7 @@
 
 #include <project.h>
 #include "OTAMandatory.h"
+#include "Options.h"
 
 #define LED_1_DM_RES_UP          (0x02u)
 
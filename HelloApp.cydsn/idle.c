@@ -0,0 +1,383 @@
+/*******************************************************************************
+* File Name: idle.c
+*
+* Version: 1.30
+*
+* Description:
+*  Low power idle manager of the main loop. There is no periodic tick: at
+*  the end of each pass Idle_Enter() finds the next deadline and picks the
+*  deepest mode that still wakes the CPU in time.
+*   - Received UART data, an expired timer or a deadline before the next BLE
+*     interrupt keep the CPU running.
+*   - UART transmission, or reception within IDLE_UART_HOLD_MS, allow only
+*     CPU Sleep, as the SCB loses its clock in Deep-Sleep.
+*   - Otherwise Deep-Sleep is entered between advertising and connection
+*     events, with the BLESS state checks of the Bootloader's
+*     LowPowerImplementation().
+*  The BLE interrupt is the only wake source, so timers are checked at the
+*  advertising or connection interval.
+*
+*  The time spent in each state is added to the BLE event trace every
+*  IDLE_REPORT_PERIOD seconds, where Tools\energyest turns it into average
+*  current.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "idle.h"
+#include "timebase.h"
+#include "bletrace.h"
+
+#if (IDLE_REPORT_PERIOD > 65u)
+    #error IDLE_REPORT_PERIOD must fit the 16-bit millisecond trace digest
+#endif /* (IDLE_REPORT_PERIOD > 65u) */
+
+#define IDLE_REPORT_TICKS               (IDLE_REPORT_PERIOD * TIMEBASE_TICKS_PER_SEC)
+#define IDLE_UART_HOLD_TICKS            ((IDLE_UART_HOLD_MS * TIMEBASE_TICKS_PER_SEC) / 1000u)
+
+/* Ticks per 0.625 ms advertising unit and per 1.25 ms connection unit, x100 */
+#define IDLE_ADV_UNIT_TICKS_X100        (2048u)
+#define IDLE_CONN_UNIT_TICKS_X100       (4096u)
+
+static uint32 idleTimerDeadline[IDLE_TIMER_COUNT];
+static uint32 idleTimerRunning;
+static uint32 idleConnIntv;
+static uint32 idleConnLatency;
+static uint32 idleUartLast;
+static uint32 idleSince;
+static uint32 idleReportStart;
+static uint32 idleTicks[IDLE_STATE_COUNT];
+
+static void Idle_Charge(uint32 state);
+static uint32 Idle_NextDeadline(uint32 now);
+static uint32 Idle_BleWakeTicks(void);
+
+
+/*******************************************************************************
+* Function Name: Idle_Charge()
+********************************************************************************
+*
+* Summary:
+*   Charges the time since the last call to a power state.
+*
+* Parameters:
+*   state - IDLE_STATE_*
+*
+*******************************************************************************/
+static void Idle_Charge(uint32 state)
+{
+    uint32 now = Timebase_Now();
+
+    idleTicks[state] += now - idleSince;
+    idleSince = now;
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Start()
+********************************************************************************
+*
+* Summary:
+*   Starts the timebase and the accounting in the active state.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void Idle_Start(void)
+{
+    Timebase_Start();
+    idleSince = Timebase_Now();
+    idleReportStart = idleSince;
+    idleUartLast = idleSince - IDLE_UART_HOLD_TICKS;
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_TimerStart()
+********************************************************************************
+*
+* Summary:
+*   Starts a one-shot software timer.
+*
+* Parameters:
+*   timer - index below IDLE_TIMER_COUNT
+*   ticks - timebase ticks until it expires
+*
+*******************************************************************************/
+void Idle_TimerStart(uint32 timer, uint32 ticks)
+{
+    idleTimerDeadline[timer] = Timebase_Now() + ticks;
+    idleTimerRunning |= (1u << timer);
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_TimerStop()
+********************************************************************************
+*
+* Summary:
+*   Stops a software timer.
+*
+* Parameters:
+*   timer - index below IDLE_TIMER_COUNT
+*
+*******************************************************************************/
+void Idle_TimerStop(uint32 timer)
+{
+    idleTimerRunning &= ~(1u << timer);
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_TimerExpired()
+********************************************************************************
+*
+* Summary:
+*   Checks a software timer and stops it when it has expired.
+*
+* Parameters:
+*   timer - index below IDLE_TIMER_COUNT
+*
+* Return:
+*   Non-zero once, when the timer has expired.
+*
+*******************************************************************************/
+uint32 Idle_TimerExpired(uint32 timer)
+{
+    uint32 expired = 0u;
+
+    if((0u != (idleTimerRunning & (1u << timer))) &&
+       ((int32) (Timebase_Now() - idleTimerDeadline[timer]) >= 0))
+    {
+        idleTimerRunning &= ~(1u << timer);
+        expired = 1u;
+    }
+
+    return expired;
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_SetConnParam()
+********************************************************************************
+*
+* Summary:
+*   Sets the parameters of the current connection. Called on
+*   CYBLE_EVT_GAP_DEVICE_CONNECTED and on
+*   CYBLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE.
+*
+* Parameters:
+*   connIntv - connection interval in 1.25 ms units
+*   connLatency - slave latency in connection events
+*
+*******************************************************************************/
+void Idle_SetConnParam(uint32 connIntv, uint32 connLatency)
+{
+    idleConnIntv = connIntv;
+    idleConnLatency = connLatency;
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_UartActivity()
+********************************************************************************
+*
+* Summary:
+*   Called when a character has been received. Deep-Sleep is not entered
+*   for IDLE_UART_HOLD_MS, so the rest of the input is not lost.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void Idle_UartActivity(void)
+{
+    idleUartLast = Timebase_Now();
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_NextDeadline()
+********************************************************************************
+*
+* Summary:
+*   Finds the ticks until the first running software timer expires.
+*
+* Parameters:
+*   now - current timebase tick
+*
+* Return:
+*   Ticks until the deadline, 0 when a timer has expired and 0xFFFFFFFF when
+*   no timer is running.
+*
+*******************************************************************************/
+static uint32 Idle_NextDeadline(uint32 now)
+{
+    uint32 next = 0xFFFFFFFFu;
+    int32 left;
+    uint32 i;
+
+    for(i = 0u; i < IDLE_TIMER_COUNT; i++)
+    {
+        if(0u != (idleTimerRunning & (1u << i)))
+        {
+            left = (int32) (idleTimerDeadline[i] - now);
+            if(left <= 0)
+            {
+                next = 0u;
+            }
+            else if((uint32) left < next)
+            {
+                next = (uint32) left;
+            }
+            else
+            {
+                /* A later deadline */
+            }
+        }
+    }
+
+    return next;
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_BleWakeTicks()
+********************************************************************************
+*
+* Summary:
+*   Returns the longest time the BLE Stack can leave the CPU asleep.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Timebase ticks, 0 when the BLE Stack does not wake the CPU periodically.
+*
+*******************************************************************************/
+static uint32 Idle_BleWakeTicks(void)
+{
+    uint32 ticks = 0u;
+
+    if(CyBle_GetState() == CYBLE_STATE_ADVERTISING)
+    {
+        ticks = ((uint32) cyBle_discoveryModeInfo.advParam->advIntvMax * IDLE_ADV_UNIT_TICKS_X100) / 100u;
+    }
+    else if(CyBle_GetState() == CYBLE_STATE_CONNECTED)
+    {
+        ticks = (idleConnIntv * (idleConnLatency + 1u) * IDLE_CONN_UNIT_TICKS_X100) / 100u;
+    }
+    else
+    {
+        /* Nothing wakes the CPU */
+    }
+
+    return ticks;
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop. Once per IDLE_REPORT_PERIOD adds the
+*   milliseconds spent in each power state to the BLE event trace.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void Idle_Task(void)
+{
+    uint32 i;
+
+    if((Timebase_Now() - idleReportStart) >= IDLE_REPORT_TICKS)
+    {
+        Idle_Charge(IDLE_STATE_ACTIVE);
+        idleReportStart = idleSince;
+        for(i = 0u; i < IDLE_STATE_COUNT; i++)
+        {
+            BleTrace_RecordValue(BLE_TRACE_EVT_POWER + i, TIMEBASE_TICKS_TO_MS(idleTicks[i]));
+            idleTicks[i] = 0u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Enter()
+********************************************************************************
+*
+* Summary:
+*   Puts the device into the deepest low power mode that does not delay
+*   pending work. Called at the end of each pass of the main loop.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void Idle_Enter(void)
+{
+    CYBLE_LP_MODE_T bleMode;
+    CYBLE_BLESS_STATE_T blessState;
+    uint8 interruptStatus;
+    uint32 now = Timebase_Now();
+    uint32 bleWake = Idle_BleWakeTicks();
+    uint32 deepSleepAllowed = 1u;
+
+    /* Work for the next pass, or a deadline no interrupt would wake for */
+    if((0u != H_UART_SpiUartGetRxBufferSize()) || (0u == bleWake) ||
+       (Idle_NextDeadline(now) < bleWake))
+    {
+        return;
+    }
+
+    if(((H_UART_SpiUartGetTxBufferSize() + H_UART_GET_TX_FIFO_SR_VALID) != 0u) ||
+       ((now - idleUartLast) < IDLE_UART_HOLD_TICKS))
+    {
+        deepSleepAllowed = 0u;
+    }
+
+    Idle_Charge(IDLE_STATE_ACTIVE);
+
+    /* Request BLE subsystem to enter into Deep-Sleep mode between connection and advertising intervals */
+    bleMode = CyBle_EnterLPM((0u != deepSleepAllowed) ? CYBLE_BLESS_DEEPSLEEP : CYBLE_BLESS_SLEEP);
+    /* Disable global interrupts */
+    interruptStatus = CyEnterCriticalSection();
+    blessState = CyBle_GetBleSsState();
+    /* When BLE subsystem has been put into Deep-Sleep mode */
+    if(bleMode == CYBLE_BLESS_DEEPSLEEP)
+    {
+        /* And it is still there or ECO is on */
+        if((blessState == CYBLE_BLESS_STATE_ECO_ON) ||
+           (blessState == CYBLE_BLESS_STATE_DEEPSLEEP))
+        {
+            CySysPmDeepSleep();
+            Idle_Charge(IDLE_STATE_DEEPSLEEP);
+        }
+    }
+    else /* When BLE subsystem has been put into Sleep mode or is active */
+    {
+        /* And hardware doesn't finish Tx/Rx opeation - put the CPU into Sleep mode */
+        if(blessState != CYBLE_BLESS_STATE_EVENT_CLOSE)
+        {
+            CySysPmSleep();
+            Idle_Charge(IDLE_STATE_SLEEP);
+        }
+    }
+    /* Enable global interrupt */
+    CyExitCriticalSection(interruptStatus);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,58 @@
+/*******************************************************************************
+* File Name: idle.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the low power idle
+*  manager of the main loop.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(IDLE_H)
+#define IDLE_H
+
+#include <project.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Power states; the same numbers as POWER_STATE_* of the Bootloader, so the
+ * trace records (BLE_TRACE_EVT_POWER + state) read the same on the host.
+ */
+#define IDLE_STATE_ACTIVE               (0u)
+#define IDLE_STATE_SLEEP                (1u)
+#define IDLE_STATE_DEEPSLEEP            (2u)
+#define IDLE_STATE_COUNT                (3u)
+
+/* Software timers */
+#define IDLE_TIMER_BATTERY              (0u)
+#define IDLE_TIMER_UART_BRIDGE          (1u)
+#define IDLE_TIMER_COUNT                (4u)
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+void Idle_Start(void);
+void Idle_TimerStart(uint32 timer, uint32 ticks);
+void Idle_TimerStop(uint32 timer);
+uint32 Idle_TimerExpired(uint32 timer);
+void Idle_SetConnParam(uint32 connIntv, uint32 connLatency);
+void Idle_UartActivity(void);
+void Idle_Task(void);
+void Idle_Enter(void);
+
+#endif /* IDLE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,249 @@
+/*******************************************************************************
+* File Name: linkpolicy.c
+*
+* Version: 1.30
+*
+* Description:
+*  Link timing policy; see linkpolicy.h. The connection parameters are
+*  requested once per connection and per change of the preference, so a
+*  central that does not accept them is not asked again and again.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "scps.h"
+#include "linkpolicy.h"
+#include "advsched.h"
+#include "txqueue.h"
+
+static uint32 linkPolicyAdvIntv;
+static uint32 linkPolicyKnown;
+static uint32 linkPolicyRequested;
+static uint32 linkPolicyConnIntv;
+static uint32 linkPolicyConnLatency;
+static CYBLE_GAP_CONN_UPDATE_PARAM_T linkPolicyPreferred;
+
+static uint32 LinkPolicy_AdvInterval(uint32 interval, uint32 window);
+static void LinkPolicy_Apply(void);
+static void LinkPolicy_Request(void);
+static void LinkPolicy_ScanRefresh(void);
+
+
+/*******************************************************************************
+* Function Name: LinkPolicy_AdvInterval()
+********************************************************************************
+*
+* Summary:
+*   Picks the fast advertising interval for a scan duty cycle.
+*
+* Parameters:
+*   interval - scan interval, 0.625 ms units
+*   window - scan window, 0.625 ms units
+*
+* Return:
+*   Advertising interval in 0.625 ms units, 0 for the default one.
+*
+*******************************************************************************/
+static uint32 LinkPolicy_AdvInterval(uint32 interval, uint32 window)
+{
+    uint32 advIntv;
+
+    if((0u == interval) || (0u == window))
+    {
+        advIntv = 0u;
+    }
+    else if(window >= interval)
+    {
+        /* Continuous scan: the advertising interval is the reconnect time */
+        advIntv = LINK_POLICY_ADV_INTV_MAX;
+    }
+    else if(window >= (LINK_POLICY_ADV_INTV_MIN + LINK_POLICY_ADV_MARGIN))
+    {
+        advIntv = window - LINK_POLICY_ADV_MARGIN;
+        if(advIntv > LINK_POLICY_ADV_INTV_MAX)
+        {
+            advIntv = LINK_POLICY_ADV_INTV_MAX;
+        }
+    }
+    else
+    {
+        /* Windows this short are only hit by chance; try as often as allowed */
+        advIntv = LINK_POLICY_ADV_INTV_MIN;
+    }
+
+    return advIntv;
+}
+
+
+/*******************************************************************************
+* Function Name: LinkPolicy_Apply()
+********************************************************************************
+*
+* Summary:
+*   Derives the advertising interval and the preferred connection
+*   parameters from the scan parameters of the central.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void LinkPolicy_Apply(void)
+{
+    uint32 advIntv = LinkPolicy_AdvInterval(scanInterval, scanWindow);
+    uint32 latency;
+    uint32 timeout;
+    uint32 changed = 0u;
+
+    if(advIntv != linkPolicyAdvIntv)
+    {
+        linkPolicyAdvIntv = advIntv;
+        AdvSched_SetFastInterval(advIntv - (advIntv / 16u), advIntv);
+        changed = 1u;
+    }
+
+    if((0u == scanInterval) || (0u == scanWindow))
+    {
+        return;
+    }
+
+    /* (latency + 1) connection intervals cover one scan interval */
+    latency = ((uint32) scanInterval / (2u * LINK_POLICY_CONN_INTV_MAX));
+    latency = (latency > 0u) ? (latency - 1u) : 0u;
+    if(latency > LINK_POLICY_LATENCY_MAX)
+    {
+        latency = LINK_POLICY_LATENCY_MAX;
+    }
+
+    /* The link must survive two effective intervals without a packet */
+    timeout = (((latency + 1u) * LINK_POLICY_CONN_INTV_MAX) / 4u) + 1u;
+    if(timeout < LINK_POLICY_SUPERVISION_TO)
+    {
+        timeout = LINK_POLICY_SUPERVISION_TO;
+    }
+    if(timeout > LINK_POLICY_SUPERVISION_TO_MAX)
+    {
+        timeout = LINK_POLICY_SUPERVISION_TO_MAX;
+    }
+
+    if((0u == linkPolicyKnown) || (latency != linkPolicyPreferred.connLatency))
+    {
+        linkPolicyPreferred.connIntvMin = LINK_POLICY_CONN_INTV_MIN;
+        linkPolicyPreferred.connIntvMax = LINK_POLICY_CONN_INTV_MAX;
+        linkPolicyPreferred.connLatency = (uint16) latency;
+        linkPolicyPreferred.supervisionTO = (uint16) timeout;
+        linkPolicyKnown = 1u;
+        linkPolicyRequested = 0u;
+    }
+
+    LinkPolicy_Request();
+    if(0u != changed)
+    {
+        LinkPolicy_ScanRefresh();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LinkPolicy_Request()
+********************************************************************************
+*
+* Summary:
+*   Asks the central for the preferred connection parameters when the
+*   current ones differ and they were not asked for yet.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void LinkPolicy_Request(void)
+{
+    if((0u != linkPolicyKnown) && (0u == linkPolicyRequested) &&
+       (CyBle_GetState() == CYBLE_STATE_CONNECTED) &&
+       ((linkPolicyConnIntv < linkPolicyPreferred.connIntvMin) ||
+        (linkPolicyConnIntv > linkPolicyPreferred.connIntvMax) ||
+        (linkPolicyConnLatency != linkPolicyPreferred.connLatency)))
+    {
+        if(CyBle_L2capLeConnectionParamUpdateRequest(cyBle_connHandle.bdHandle, &linkPolicyPreferred) ==
+           CYBLE_ERROR_OK)
+        {
+            linkPolicyRequested = 1u;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LinkPolicy_ScanRefresh()
+********************************************************************************
+*
+* Summary:
+*   Asks the central to write its scan parameters again, when it enabled
+*   Scan Refresh notifications.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void LinkPolicy_ScanRefresh(void)
+{
+    static const uint8 refresh = LINK_POLICY_SCAN_REFRESH;
+
+    if(0u != requestScanRefresh)
+    {
+        (void) TxQueue_Gatts(CYBLE_SCPS_SCAN_REFRESH_CHAR_HANDLE, &refresh, sizeof(refresh), TX_QUEUE_COALESCE);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LinkPolicy_Event()
+********************************************************************************
+*
+* Summary:
+*   BLE event handler for CYBLE_EVT_SCPSS_SCAN_INT_WIN_CHAR_WRITE, after
+*   ScpsCallBack(), and for the connection events.
+*
+* Parameters:
+*   event - event code
+*   eventParam - event parameter
+*
+*******************************************************************************/
+void LinkPolicy_Event(uint32 event, void *eventParam)
+{
+    const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *connParam =
+        (const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *) eventParam;
+
+    switch(event)
+    {
+        case CYBLE_EVT_GAP_DEVICE_CONNECTED:
+            linkPolicyConnIntv = connParam->connIntv;
+            linkPolicyConnLatency = connParam->connLatency;
+            linkPolicyRequested = 0u;
+            LinkPolicy_Request();
+            break;
+        case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
+            if((connParam->connIntv != linkPolicyConnIntv) || (connParam->connLatency != linkPolicyConnLatency))
+            {
+                linkPolicyConnIntv = connParam->connIntv;
+                linkPolicyConnLatency = connParam->connLatency;
+                LinkPolicy_ScanRefresh();
+            }
+            break;
+        case CYBLE_EVT_SCPSS_SCAN_INT_WIN_CHAR_WRITE:
+            LinkPolicy_Apply();
+            break;
+        default:
+            break;
+    }
+}
+
+
+/* [] END OF FILE */
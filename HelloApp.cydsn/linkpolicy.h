@@ -0,0 +1,61 @@
+/*******************************************************************************
+* File Name: linkpolicy.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the link timing policy.
+*  The scan interval and window a central writes to the Scan Parameters
+*  Service set:
+*   - the fast advertising interval, the longest one that still falls into
+*    every scan window, so a reconnect takes at most one scan interval at
+*    the lowest advertising current;
+*   - the preferred slave latency, which stretches the effective connection
+*    interval to the central's scan interval. Input reports are still sent
+*    at the next connection event; only data from the central waits longer.
+*  The central is asked to refresh its scan parameters through Scan Refresh
+*  whenever either timing changes.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(LINKPOLICY_H)
+#define LINKPOLICY_H
+
+#include <project.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Shortest connectable undirected advertising interval, 0.625 ms units */
+#define LINK_POLICY_ADV_INTV_MIN        (32u)
+
+/* Margin of an advertising event in a scan window, 0.625 ms units: the
+ * random advDelay of up to 10 ms and about 2 ms on the three channels.
+ */
+#define LINK_POLICY_ADV_MARGIN          (19u)
+
+/* Longest supervision timeout, 10 ms units */
+#define LINK_POLICY_SUPERVISION_TO_MAX  (3200u)
+
+/* Scan Refresh value: the server requires a refresh */
+#define LINK_POLICY_SCAN_REFRESH        (0u)
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+void LinkPolicy_Event(uint32 event, void *eventParam);
+
+#endif /* LINKPOLICY_H */
+
+
+/* [] END OF FILE */
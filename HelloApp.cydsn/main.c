@@ -29,6 +29,90 @@
 *******************************************************************************/
 
 #include "main.h"
+#include "bootprof.h"
+#include "bletrace.h"
+#include "diaglog.h"
+#include "advsched.h"
+#include "gattsig.h"
+#include "flashsched.h"
+#include "idle.h"
+#include "bledispatch.h"
+#include "txqueue.h"
+#include "linkpolicy.h"
+#include "battery.h"
+#include "uartbridge.h"
+#include "writerouter.h"
+
+#if (GATT_SIG_ENABLED == YES)
+    /* Services of GATT_SIG_SERVICE_COUNT; HelloApp keeps all of them enabled */
+    static const uint16 appServices[GATT_SIG_SERVICE_COUNT] =
+    {
+        CYBLE_HID_SERVICE_HANDLE,
+        CYBLE_DIS_SERVICE_HANDLE,
+        CYBLE_BAS_SERVICE_HANDLE,
+        CYBLE_SCPS_SERVICE_HANDLE,
+        CYBLE_BTS_SERVICE_HANDLE
+    };
+#endif /* (GATT_SIG_ENABLED == YES) */
+
+static void OnStackOn(uint32 event, void* eventParam);
+static void OnHardwareError(uint32 event, void* eventParam);
+static void OnAdvertisementStartStop(uint32 event, void* eventParam);
+static void OnConnected(uint32 event, void* eventParam);
+static void OnDisconnected(uint32 event, void* eventParam);
+static void OnConnectionUpdate(uint32 event, void* eventParam);
+static void OnMtuRequest(uint32 event, void* eventParam);
+static void OnGattConnect(uint32 event, void* eventParam);
+static void InitWriteRoutes(void);
+
+/* BLE event handlers (Shared\bledispatch.h), for the stack and the services.
+ * CYBLE_EVT_PENDING_FLASH_WRITE has none: FlashSched_Task() writes the data
+ * in an idle window.
+ */
+#define APP_BLE_HANDLERS(X) \
+    X(CYBLE_EVT_STACK_ON,                           OnStackOn) \
+    X(CYBLE_EVT_HARDWARE_ERROR,                     OnHardwareError) \
+    X(CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP,      OnAdvertisementStartStop) \
+    X(CYBLE_EVT_GAP_DEVICE_CONNECTED,               OnConnected) \
+    X(CYBLE_EVT_GAP_DEVICE_CONNECTED,               LinkPolicy_Event) \
+    X(CYBLE_EVT_GAP_DEVICE_DISCONNECTED,            OnDisconnected) \
+    X(CYBLE_EVT_GAP_DEVICE_DISCONNECTED,            TxQueue_Event) \
+    X(CYBLE_EVT_GAP_DEVICE_DISCONNECTED,            UartBridge_Event) \
+    X(CYBLE_EVT_STACK_BUSY_STATUS,                  TxQueue_Event) \
+    X(CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE,    OnConnectionUpdate) \
+    X(CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE,    LinkPolicy_Event) \
+    X(CYBLE_EVT_GATTS_XCNHG_MTU_REQ,                OnMtuRequest) \
+    X(CYBLE_EVT_GATTS_WRITE_REQ,                    WriteRouter_Event) \
+    X(CYBLE_EVT_GATTS_WRITE_CMD_REQ,                WriteRouter_Event) \
+    X(CYBLE_EVT_GATT_CONNECT_IND,                   OnGattConnect) \
+    X(CYBLE_EVT_SCPSS_NOTIFICATION_ENABLED,         ScpsCallBack) \
+    X(CYBLE_EVT_SCPSS_NOTIFICATION_DISABLED,        ScpsCallBack) \
+    X(CYBLE_EVT_SCPSS_SCAN_INT_WIN_CHAR_WRITE,      ScpsCallBack) \
+    X(CYBLE_EVT_SCPSS_SCAN_INT_WIN_CHAR_WRITE,      LinkPolicy_Event)
+
+static const BLE_DISPATCH_ENTRY_T appBleHandlers[] =
+{
+    APP_BLE_HANDLERS(BLE_DISPATCH_ENTRY)
+};
+
+/* GATT write routes (Shared\writerouter.h), in handle order. The HID, DIS,
+ * BAS and SCPS services take the writes to their attributes in the stack
+ * and report them as service events; the writes to them that reach the
+ * application are refused, as are writes past the custom service.
+ *
+ * The custom service handles belong to the Bootloader's GATT database, so
+ * InitWriteRoutes() reads them from cyBle_customs through the shared API
+ * and fills in the range of APP_ROUTE_CUSTOM_SERVICE.
+ */
+#define APP_ROUTE_CUSTOM_SERVICE        (0u)
+
+#define APP_WRITE_ROUTES(X) \
+    X(0u, 0u, 1u, UART_BRIDGE_PACKET_MAX, UartBridge_Write)
+
+static WRITE_ROUTER_ENTRY_T appWriteRoutes[] =
+{
+    APP_WRITE_ROUTES(WRITE_ROUTER_ENTRY)
+};
 
 /*******************************************************************************
 * Function Name: main()
@@ -42,154 +126,321 @@
 *******************************************************************************/
 int main()
 {
-    CYBLE_LP_MODE_T lpMode;
-    CYBLE_BLESS_STATE_T blessState;
- 
+    BootProf_Begin(BOOT_PROFILE_IMAGE_APP, &H_UART_UartPutString);
+    DiagLog_Begin(DIAG_IMAGE_APP);
+
+    /* A Bootloader built from different BLE definitions can't run this image;
+     * stay in the Bootloader so that a matching image can be loaded.
+     */
+    if(0u == SharedApi_IsCompatible())
+    {
+        DiagLog_Append(DIAG_EVT_LOAD_BOOTLOADER, DIAG_LOAD_INCOMPATIBLE);
+        Bootloadable_Load();
+    }
+
 #if !defined(__ARMCC_VERSION)
     InitializeBootloaderSRAM();
 #endif
+    BootProf_Mark(BOOT_PHASE_SRAM_INIT);
 
     H_UART_Start();
     H_UART_UartPutString("HelloApp");
+    DiagLog_Report(&H_UART_UartPutString);
+
+#if (SRAM_INIT_PROFILE_ENABLED == YES)
+    {
+        char8 report[40u];
+
+        (void) sprintf(report, "\r\nSRAM init: %lu cycles\r\n", (unsigned long) sramInitCycles);
+        H_UART_UartPutString(report);
+    }
+#endif /* (SRAM_INIT_PROFILE_ENABLED == YES) */
    
     ConfigureSharedPins();
    
     CyGlobalIntEnable;  
 
     /* Start CYBLE component and register generic event handler */
-    CyBle_Start(AppCallBack);
+    BootProf_Mark(BOOT_PHASE_BLE_START);
+    UartBridge_Start();
+    InitWriteRoutes();
+    WriteRouter_Init(appWriteRoutes, WRITE_ROUTER_COUNT(appWriteRoutes));
+    BleDispatch_Init(appBleHandlers, BLE_DISPATCH_COUNT(appBleHandlers));
+    CyBle_Start(&BleDispatch_Event);
+
+    Idle_Start();
+    Battery_Start();
 
 
     while(1) 
     {           
         CyBle_ProcessEvents();
+        TxQueue_Task();
+        UartBridge_Task();
+        BleTrace_Task(&H_UART_UartPutString);
+        BleDispatch_Task(&H_UART_UartPutString);
+        FlashSched_Task();
+        Battery_Task();
         BootloaderSwitch();
-        DoProcess();
+        Idle_Task();
+
+        /* Sleep until the next BLE interrupt when nothing is pending; the
+         * button is polled on each wakeup, so hold it for about a second.
+         */
+        Idle_Enter();
     }   
 }
 
-void DoProcess(void)
+/*******************************************************************************
+* Function Name: OnStackOn()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_STACK_ON: the component has started. Enters discoverable mode
+*   so that the remote can search for the device.
+*
+* Parameters:
+*  event - event code
+*  eventParam - event parameters
+*
+*******************************************************************************/
+static void OnStackOn(uint32 event, void* eventParam)
 {
-    char8 rxData;
-    rxData = H_UART_UartGetChar();
-    if (rxData){
-        H_UART_UartPutChar(rxData);
-    }    
+    CYBLE_API_RESULT_T apiResult;
+    CYBLE_GAP_BD_ADDR_T localAddr;
+
+    (void) event;
+    (void) eventParam;
+
+    BootProf_Mark(BOOT_PHASE_STACK_ON);
+    apiResult = AdvSched_Start(ADV_SCHED_REASON_BOOT);
+    if(apiResult != CYBLE_ERROR_OK)
+    {
+    }
+    localAddr.type = 0u;
+    CyBle_GetDeviceAddress(&localAddr);
 }
 
 
+/*******************************************************************************
+* Function Name: OnHardwareError()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_HARDWARE_ERROR: some internal HW error has occurred.
+*
+* Parameters:
+*  event - event code
+*  eventParam - event parameters
+*
+*******************************************************************************/
+static void OnHardwareError(uint32 event, void* eventParam)
+{
+    (void) event;
+    (void) eventParam;
+
+    DiagLog_Append(DIAG_EVT_HW_ERROR, 0u);
+}
+
 
 /*******************************************************************************
-* Function Name: AppCallBack()
+* Function Name: OnAdvertisementStartStop()
 ********************************************************************************
 *
 * Summary:
-*   This is an event callback function to receive events from the BLE Component.
+*   CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP: moves to the next stage of the
+*   advertising schedule.
 *
 * Parameters:
 *  event - event code
 *  eventParam - event parameters
 *
 *******************************************************************************/
-void AppCallBack(uint32 event, void* eventParam)
+static void OnAdvertisementStartStop(uint32 event, void* eventParam)
+{
+    (void) event;
+    (void) eventParam;
+
+    if(CYBLE_STATE_ADVERTISING == CyBle_GetState())
+    {
+        BootProf_Mark(BOOT_PHASE_ADV_START);
+    }
+    if((CYBLE_STATE_DISCONNECTED == CyBle_GetState()) && (0u == AdvSched_Next()))
+    {   
+//        /* Fast and slow advertising period complete, go to low power  
+//         * mode (Hibernate mode) and wait for an external
+//         * user event to wake up the device again */
+//        H_UART_UartPutString("BLE Sleep");
+//        Bootloader_Service_Activation_ClearInterrupt();
+//        Wakeup_Interrupt_ClearPending();
+//        Wakeup_Interrupt_Start();
+//        CySysPmHibernate();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OnConnected()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GAP_DEVICE_CONNECTED.
+*
+* Parameters:
+*  event - event code
+*  eventParam - CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T
+*
+*******************************************************************************/
+static void OnConnected(uint32 event, void* eventParam)
+{
+    (void) event;
+
+    DiagLog_Append(DIAG_EVT_CONNECTED, (*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv);
+    AdvSched_Connected();
+    FlashSched_SetConnInterval((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv);
+    Idle_SetConnParam((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv,
+        (*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connLatency);
+#if (GATT_SIG_ENABLED == YES)
+    /* The Bootloader signals Service Changed on its next start */
+    GattSig_Seen(GattSig_Compute(appServices, GATT_SIG_SERVICE_COUNT, GATT_SIG_MASK_APP));
+#endif /* (GATT_SIG_ENABLED == YES) */
+    H_UART_UartPutString("CONNECTED");
+}
+
+
+/*******************************************************************************
+* Function Name: OnDisconnected()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GAP_DEVICE_DISCONNECTED: restarts the advertising schedule.
+*
+* Parameters:
+*  event - event code
+*  eventParam - HCI reason of the disconnect
+*
+*******************************************************************************/
+static void OnDisconnected(uint32 event, void* eventParam)
 {
     CYBLE_API_RESULT_T apiResult;
-    CYBLE_GAP_BD_ADDR_T localAddr;
-    
-    switch (event)
+
+    (void) event;
+
+    DiagLog_Append(DIAG_EVT_DISCONNECTED, *(uint8 *)eventParam);
+    H_UART_UartPutString("DISCONNECTED");
+    apiResult = AdvSched_Start(*(uint8 *)eventParam);
+    if(apiResult != CYBLE_ERROR_OK)
+    {
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: OnConnectionUpdate()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE.
+*
+* Parameters:
+*  event - event code
+*  eventParam - CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T
+*
+*******************************************************************************/
+static void OnConnectionUpdate(uint32 event, void* eventParam)
+{
+    (void) event;
+
+    FlashSched_SetConnInterval((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv);
+    Idle_SetConnParam((*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connIntv,
+        (*(CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *)eventParam).connLatency);
+}
+
+
+/*******************************************************************************
+* Function Name: OnMtuRequest()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GATTS_XCNHG_MTU_REQ.
+*
+* Parameters:
+*  event - event code
+*  eventParam - event parameters
+*
+*******************************************************************************/
+static void OnMtuRequest(uint32 event, void* eventParam)
+{
+    uint16 mtu;
+
+    (void) event;
+    (void) eventParam;
+
+    CyBle_GattGetMtuSize(&mtu);
+}
+
+
+/*******************************************************************************
+* Function Name: OnGattConnect()
+********************************************************************************
+*
+* Summary:
+*   CYBLE_EVT_GATT_CONNECT_IND: registers the service specific callbacks.
+*
+* Parameters:
+*  event - event code
+*  eventParam - event parameters
+*
+*******************************************************************************/
+static void OnGattConnect(uint32 event, void* eventParam)
+{
+    (void) event;
+    (void) eventParam;
+
+    ScpsInit();
+}
+
+/*******************************************************************************
+* Function Name: InitWriteRoutes()
+********************************************************************************
+*
+* Summary:
+*   Sets the handle range of the custom service route from cyBle_customs:
+*   the service declaration up to the highest characteristic or descriptor
+*   handle. Descriptors the service does not have read as the invalid
+*   handle 0 and do not extend the range.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void InitWriteRoutes(void)
+{
+    WRITE_ROUTER_ENTRY_T *route = &appWriteRoutes[APP_ROUTE_CUSTOM_SERVICE];
+    const CYBLE_CUSTOMS_T *service = &cyBle_customs[0u];
+    uint16 last = service->customServiceHandle;
+    uint32 charIndex;
+    uint32 descrIndex;
+
+    for(charIndex = 0u; charIndex < CYBLE_CUSTOM_SERVICE_CHAR_COUNT; charIndex++)
     {
-        /**********************************************************
-        *                       General Events
-        ***********************************************************/
-        case CYBLE_EVT_STACK_ON: /* This event is received when the component is Started */
-            /* Enter into discoverable mode so that remote can search it. */
-            apiResult = CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_FAST);
-            if(apiResult != CYBLE_ERROR_OK)
+        const CYBLE_CUSTOMS_INFO_T *info = &service->customServiceInfo[charIndex];
+
+        if(info->customServiceCharHandle > last)
+        {
+            last = info->customServiceCharHandle;
+        }
+        for(descrIndex = 0u; descrIndex < CYBLE_CUSTOM_SERVICE_CHAR_DESCRIPTORS_COUNT; descrIndex++)
+        {
+            if(info->customServiceCharDescriptors[descrIndex] > last)
             {
+                last = info->customServiceCharDescriptors[descrIndex];
             }
-            localAddr.type = 0u;
-            CyBle_GetDeviceAddress(&localAddr);
-            break;
-        case CYBLE_EVT_TIMEOUT: 
-            break;
-        case CYBLE_EVT_HARDWARE_ERROR:    /* This event indicates that some internal HW error has occurred. */
-            break;
-            
-        /* This event will be triggered by host stack if BLE stack is busy or not busy.
-         *  Parameter corresponding to this event will be the state of BLE stack.
-         *  BLE stack busy = CYBLE_STACK_STATE_BUSY,
-         *  BLE stack not busy = CYBLE_STACK_STATE_FREE 
-         */
-        case CYBLE_EVT_STACK_BUSY_STATUS:
-            break;
-        case CYBLE_EVT_HCI_STATUS:
-            break;
-            
-        /**********************************************************
-        *                       GAP Events
-        ***********************************************************/
-        case CYBLE_EVT_GAP_AUTH_REQ:
-            break;
-        case CYBLE_EVT_GAP_PASSKEY_ENTRY_REQUEST:
-            break;
-        case CYBLE_EVT_GAP_PASSKEY_DISPLAY_REQUEST:
-            break;
-        case CYBLE_EVT_GAP_KEYINFO_EXCHNGE_CMPLT:
-            break;
-        case CYBLE_EVT_GAP_AUTH_COMPLETE:
-            break;
-        case CYBLE_EVT_GAP_AUTH_FAILED:
-            break;
-        case CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
-            if(CYBLE_STATE_DISCONNECTED == CyBle_GetState())
-            {   
-//                /* Fast and slow advertising period complete, go to low power  
-//                 * mode (Hibernate mode) and wait for an external
-//                 * user event to wake up the device again */
-//                H_UART_UartPutString("BLE Sleep");
-//                Bootloader_Service_Activation_ClearInterrupt();
-//                Wakeup_Interrupt_ClearPending();
-//                Wakeup_Interrupt_Start();
-//                CySysPmHibernate();
-            }
-            break;
-        case CYBLE_EVT_GAP_DEVICE_CONNECTED:
-                H_UART_UartPutString("CONNECTED");
-            break;
-        case CYBLE_EVT_GAP_DEVICE_DISCONNECTED:
-                H_UART_UartPutString("DISCONNECTED");
-            break;
-        case CYBLE_EVT_GATTS_XCNHG_MTU_REQ:
-            { 
-                uint16 mtu;
-                CyBle_GattGetMtuSize(&mtu);
-            }
-            break;
-        case CYBLE_EVT_GATTS_WRITE_REQ:
-            (void)CyBle_GattsWriteRsp(((CYBLE_GATTS_WRITE_REQ_PARAM_T *)eventParam)->connHandle);
-            break;
-        case CYBLE_EVT_GAP_ENCRYPT_CHANGE:
-            break;
-        case CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE:
-            break;
-            
-        /**********************************************************
-        *                       GATT Events
-        ***********************************************************/
-        case CYBLE_EVT_GATT_CONNECT_IND:
-            /* Register service specific callback functions */
-            ScpsInit();
-            break;
-        case CYBLE_EVT_GATT_DISCONNECT_IND:
-            break;
-            
-        /**********************************************************
-        *                       Other Events
-        ***********************************************************/
-        default:
-            break;
+        }
     }
 
+    route->first = service->customServiceHandle;
+    route->last = last;
 }
 
 
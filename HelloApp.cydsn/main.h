@@ -27,16 +27,12 @@
 *******************************************************************************/
 #if !defined(MAIN_H)
 #define MAIN_H
+#include <stdio.h>
 #include "OTAMandatory.h"
 #include "common.h"
 #include "scps.h"
 
 
-
-void AppCallBack(uint32 event, void* eventParam);
-
-void DoProcess(void);
-
 #endif /* MAIN_H */
 
 /* [] END OF FILE */
@@ -18,6 +18,7 @@
 
 #include "common.h"
 #include "scps.h"
+#include "bledispatch.h"
 
 uint16 requestScanRefresh = 0u;
 uint16 scanInterval = 0u;
@@ -79,8 +80,8 @@ void ScpsInit(void)
     CYBLE_API_RESULT_T apiResult;
     uint16 cccdValue;
     
-    /* Register service specific callback function */
-    CyBle_ScpsRegisterAttrCallback(ScpsCallBack);
+    /* SCPS events go through the same handler table as the stack events */
+    CyBle_ScpsRegisterAttrCallback(&BleDispatch_Event);
 
     /* Read CCCD configurations from flash */
     apiResult = CyBle_ScpssGetCharacteristicDescriptor(CYBLE_SCPS_SCAN_REFRESH,
@@ -0,0 +1,343 @@
+/*******************************************************************************
+* File Name: txqueue.c
+*
+* Version: 1.30
+*
+* Description:
+*  Notification transmit queue; see txqueue.h. Values are copied into a ring
+*  of TX_QUEUE_DEPTH entries. TxQueue_Task() sends from the head until the
+*  stack runs out of buffers; the stack then reports CYBLE_STACK_STATE_BUSY
+*  and sending resumes once it reports CYBLE_STACK_STATE_FREE after a
+*  connection event. A value the stack refuses for any other reason, e.g.
+*  notifications disabled by the client, is dropped.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "common.h"
+#include "txqueue.h"
+
+/* Notification APIs */
+#define TX_QUEUE_KIND_GATTS             (0u)
+#define TX_QUEUE_KIND_HIDSS             (1u)
+#define TX_QUEUE_KIND_BASS              (2u)
+
+typedef struct
+{
+    uint8  kind;                        /* TX_QUEUE_KIND_* */
+    uint8  serviceIndex;
+    uint16 target;                      /* Attribute handle or characteristic index */
+    uint8  length;
+    uint8  value[TX_QUEUE_VALUE_SIZE];
+} TX_QUEUE_ENTRY_T;
+
+static TX_QUEUE_ENTRY_T txQueue[TX_QUEUE_DEPTH];
+static uint32 txQueueHead;
+static uint32 txQueueCount;
+static uint32 txQueueStackBusy;
+static TX_QUEUE_STATS_T txQueueStats;
+
+static uint32 TxQueue_Post(uint32 kind, uint32 serviceIndex, uint32 target,
+    const uint8 value[], uint32 length, uint32 mode);
+static CYBLE_API_RESULT_T TxQueue_Send(TX_QUEUE_ENTRY_T *entry);
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Post()
+********************************************************************************
+*
+* Summary:
+*   Copies a value into the queue, or over the queued value of the same
+*   characteristic in TX_QUEUE_COALESCE mode.
+*
+* Parameters:
+*   kind - TX_QUEUE_KIND_*
+*   serviceIndex - service instance, 0 for TX_QUEUE_KIND_GATTS
+*   target - attribute handle or characteristic index
+*   value - value to send
+*   length - bytes, at most TX_QUEUE_VALUE_SIZE
+*   mode - TX_QUEUE_APPEND or TX_QUEUE_COALESCE
+*
+* Return:
+*   Non-zero when queued, zero when not connected, too long or full.
+*
+*******************************************************************************/
+static uint32 TxQueue_Post(uint32 kind, uint32 serviceIndex, uint32 target,
+    const uint8 value[], uint32 length, uint32 mode)
+{
+    TX_QUEUE_ENTRY_T *entry = NULL;
+    uint32 i;
+
+    if((CyBle_GetState() != CYBLE_STATE_CONNECTED) || (length > TX_QUEUE_VALUE_SIZE))
+    {
+        return 0u;
+    }
+
+    if(mode == TX_QUEUE_COALESCE)
+    {
+        for(i = 0u; i < txQueueCount; i++)
+        {
+            TX_QUEUE_ENTRY_T *queued = &txQueue[(txQueueHead + i) % TX_QUEUE_DEPTH];
+
+            if((queued->kind == kind) && (queued->serviceIndex == serviceIndex) && (queued->target == target))
+            {
+                entry = queued;
+                txQueueStats.coalesced++;
+                break;
+            }
+        }
+    }
+
+    if(entry == NULL)
+    {
+        if(txQueueCount == TX_QUEUE_DEPTH)
+        {
+            txQueueStats.dropped++;
+            return 0u;
+        }
+        entry = &txQueue[(txQueueHead + txQueueCount) % TX_QUEUE_DEPTH];
+        entry->kind = (uint8) kind;
+        entry->serviceIndex = (uint8) serviceIndex;
+        entry->target = (uint16) target;
+        txQueueCount++;
+        if(txQueueCount > txQueueStats.maxDepth)
+        {
+            txQueueStats.maxDepth = txQueueCount;
+        }
+    }
+
+    (void) memcpy(entry->value, value, length);
+    entry->length = (uint8) length;
+
+    return 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Gatts()
+********************************************************************************
+*
+* Summary:
+*   Queues a CyBle_GattsNotification().
+*
+* Parameters:
+*   attrHandle - characteristic value handle
+*   value - value to send
+*   length - bytes, at most TX_QUEUE_VALUE_SIZE
+*   mode - TX_QUEUE_APPEND or TX_QUEUE_COALESCE
+*
+* Return:
+*   Non-zero when queued.
+*
+*******************************************************************************/
+uint32 TxQueue_Gatts(CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle, const uint8 value[], uint32 length, uint32 mode)
+{
+    return TxQueue_Post(TX_QUEUE_KIND_GATTS, 0u, attrHandle, value, length, mode);
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Hidss()
+********************************************************************************
+*
+* Summary:
+*   Queues a CyBle_HidssSendNotification().
+*
+* Parameters:
+*   serviceIndex - HID Service instance
+*   charIndex - report characteristic
+*   value - value to send
+*   length - bytes, at most TX_QUEUE_VALUE_SIZE
+*   mode - TX_QUEUE_APPEND or TX_QUEUE_COALESCE
+*
+* Return:
+*   Non-zero when queued.
+*
+*******************************************************************************/
+uint32 TxQueue_Hidss(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+    const uint8 value[], uint32 length, uint32 mode)
+{
+    return TxQueue_Post(TX_QUEUE_KIND_HIDSS, serviceIndex, (uint32) charIndex, value, length, mode);
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Bass()
+********************************************************************************
+*
+* Summary:
+*   Queues a CyBle_BassSendNotification().
+*
+* Parameters:
+*   serviceIndex - Battery Service instance
+*   charIndex - characteristic
+*   value - value to send
+*   length - bytes, at most TX_QUEUE_VALUE_SIZE
+*   mode - TX_QUEUE_APPEND or TX_QUEUE_COALESCE
+*
+* Return:
+*   Non-zero when queued.
+*
+*******************************************************************************/
+uint32 TxQueue_Bass(uint8 serviceIndex, CYBLE_BAS_CHAR_INDEX_T charIndex,
+    const uint8 value[], uint32 length, uint32 mode)
+{
+    return TxQueue_Post(TX_QUEUE_KIND_BASS, serviceIndex, (uint32) charIndex, value, length, mode);
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Event()
+********************************************************************************
+*
+* Summary:
+*   BLE event handler. Follows CYBLE_EVT_STACK_BUSY_STATUS and empties the
+*   queue on CYBLE_EVT_GAP_DEVICE_DISCONNECTED.
+*
+* Parameters:
+*   event - event code
+*   eventParam - stack state for CYBLE_EVT_STACK_BUSY_STATUS
+*
+*******************************************************************************/
+void TxQueue_Event(uint32 event, void *eventParam)
+{
+    if(event == (uint32) CYBLE_EVT_STACK_BUSY_STATUS)
+    {
+        txQueueStackBusy = (*(uint8 *)eventParam == CYBLE_STACK_STATE_BUSY) ? 1u : 0u;
+        if(0u != txQueueStackBusy)
+        {
+            txQueueStats.busy++;
+        }
+    }
+    else
+    {
+        txQueueStats.dropped += txQueueCount;
+        txQueueHead = 0u;
+        txQueueCount = 0u;
+        txQueueStackBusy = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Send()
+********************************************************************************
+*
+* Summary:
+*   Hands one queued value to the stack.
+*
+* Parameters:
+*   entry - queued value
+*
+* Return:
+*   Result of the notification API.
+*
+*******************************************************************************/
+static CYBLE_API_RESULT_T TxQueue_Send(TX_QUEUE_ENTRY_T *entry)
+{
+    CYBLE_API_RESULT_T result;
+    CYBLE_GATTS_HANDLE_VALUE_NTF_T notification;
+
+    switch(entry->kind)
+    {
+        case TX_QUEUE_KIND_HIDSS:
+            result = CyBle_HidssSendNotification(cyBle_connHandle, entry->serviceIndex,
+                (CYBLE_HIDS_CHAR_INDEX_T) entry->target, entry->length, entry->value);
+            break;
+        case TX_QUEUE_KIND_BASS:
+            result = CyBle_BassSendNotification(cyBle_connHandle, entry->serviceIndex,
+                (CYBLE_BAS_CHAR_INDEX_T) entry->target, entry->length, entry->value);
+            break;
+        default:
+            notification.attrHandle = entry->target;
+            notification.value.val = entry->value;
+            notification.value.len = entry->length;
+            result = CyBle_GattsNotification(cyBle_connHandle, &notification);
+            break;
+    }
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop after CyBle_ProcessEvents(). Sends queued
+*   values while the stack reports that it is free.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void TxQueue_Task(void)
+{
+    CYBLE_API_RESULT_T result;
+
+    while((txQueueCount != 0u) && (0u == txQueueStackBusy) &&
+          (CyBle_GattGetBusStatus() == CYBLE_STACK_STATE_FREE))
+    {
+        result = TxQueue_Send(&txQueue[txQueueHead]);
+        if(result == CYBLE_ERROR_INSUFFICIENT_RESOURCES)
+        {
+            /* Out of buffers; the stack reports when it is free again */
+            break;
+        }
+
+        if(result == CYBLE_ERROR_OK)
+        {
+            txQueueStats.sent++;
+        }
+        else
+        {
+            txQueueStats.dropped++;
+        }
+        txQueueHead = (txQueueHead + 1u) % TX_QUEUE_DEPTH;
+        txQueueCount--;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_Depth()
+********************************************************************************
+*
+* Summary:
+*   Returns the number of values waiting to be sent.
+*
+*******************************************************************************/
+uint32 TxQueue_Depth(void)
+{
+    return txQueueCount;
+}
+
+
+/*******************************************************************************
+* Function Name: TxQueue_GetStats()
+********************************************************************************
+*
+* Summary:
+*   Copies the queue counters, counted since start.
+*
+* Parameters:
+*   stats - receives the counters
+*
+*******************************************************************************/
+void TxQueue_GetStats(TX_QUEUE_STATS_T *stats)
+{
+    *stats = txQueueStats;
+    stats->depth = txQueueCount;
+}
+
+
+/* [] END OF FILE */
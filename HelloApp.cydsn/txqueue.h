@@ -0,0 +1,71 @@
+/*******************************************************************************
+* File Name: txqueue.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the notification
+*  transmit queue. Notifications are posted here instead of being sent
+*  directly, and are sent from the main loop in posting order while the
+*  BLE Stack reports CYBLE_STACK_STATE_FREE, so a burst waits for stack
+*  buffers instead of failing with CYBLE_ERROR_INSUFFICIENT_RESOURCES.
+*  A value posted with TX_QUEUE_COALESCE replaces a queued value of the same
+*  characteristic, keeping its place in the queue.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(TXQUEUE_H)
+#define TXQUEUE_H
+
+#include <project.h>
+#include "Options.h"
+#include "OTAMandatory.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Posting modes */
+#define TX_QUEUE_APPEND                 (0u)    /* Every value is sent, e.g. samples */
+#define TX_QUEUE_COALESCE               (1u)    /* Only the latest value matters */
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    uint32 depth;                       /* Values waiting now */
+    uint32 maxDepth;                    /* Most values waiting at once */
+    uint32 sent;
+    uint32 coalesced;                   /* Values replaced before they were sent */
+    uint32 dropped;                     /* Values refused when full or not sent */
+    uint32 busy;                        /* CYBLE_STACK_STATE_BUSY reports */
+} TX_QUEUE_STATS_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+uint32 TxQueue_Gatts(CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle, const uint8 value[], uint32 length, uint32 mode);
+uint32 TxQueue_Hidss(uint8 serviceIndex, CYBLE_HIDS_CHAR_INDEX_T charIndex,
+    const uint8 value[], uint32 length, uint32 mode);
+uint32 TxQueue_Bass(uint8 serviceIndex, CYBLE_BAS_CHAR_INDEX_T charIndex,
+    const uint8 value[], uint32 length, uint32 mode);
+void TxQueue_Event(uint32 event, void *eventParam);
+void TxQueue_Task(void);
+uint32 TxQueue_Depth(void);
+void TxQueue_GetStats(TX_QUEUE_STATS_T *stats);
+
+#endif /* TXQUEUE_H */
+
+
+/* [] END OF FILE */
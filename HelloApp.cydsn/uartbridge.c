@@ -0,0 +1,356 @@
+/*******************************************************************************
+* File Name: uartbridge.c
+*
+* Version: 1.30
+*
+* Description:
+*  UART to BLE bridge; see uartbridge.h. Both directions go through a byte
+*  ring (Shared\bytering.h) that is filled and drained from the main loop.
+*  The flush time runs on an idle software timer that starts when the first
+*  byte enters the empty UART ring, so the device sleeps until it runs out.
+*
+* Hardware Dependency:
+*  CY8CKIT-042 BLE
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "common.h"
+#include "uartbridge.h"
+#include "bytering.h"
+#include "idle.h"
+#include "timebase.h"
+
+#if (((UART_BRIDGE_RX_SIZE & (UART_BRIDGE_RX_SIZE - 1u)) != 0u) || \
+     ((UART_BRIDGE_TX_SIZE & (UART_BRIDGE_TX_SIZE - 1u)) != 0u))
+    #error UART_BRIDGE_RX_SIZE and UART_BRIDGE_TX_SIZE must be powers of two
+#endif
+
+#define UART_BRIDGE_FLUSH_TICKS         ((UART_BRIDGE_FLUSH_MS * TIMEBASE_TICKS_PER_SEC) / 1000u)
+
+static uint8 uartBridgeRxBuffer[UART_BRIDGE_RX_SIZE];  /* H_UART to BLE */
+static uint8 uartBridgeTxBuffer[UART_BRIDGE_TX_SIZE];  /* BLE to H_UART */
+static BYTE_RING_T uartBridgeRx;
+static BYTE_RING_T uartBridgeTx;
+static uint8 uartBridgePacket[UART_BRIDGE_PACKET_MAX];
+static uint32 uartBridgeNotify;
+static uint32 uartBridgeFlush;
+static UART_BRIDGE_STATS_T uartBridgeStats;
+
+static uint32 UartBridge_FromUart(void);
+static void UartBridge_ToBle(void);
+static void UartBridge_ToUart(void);
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Start()
+********************************************************************************
+*
+* Summary:
+*   Empties both rings. Called before CyBle_Start().
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void UartBridge_Start(void)
+{
+    /* Both attributes must be in the custom service, which is the route of
+     * UartBridge_Write()
+     */
+    CYASSERT((UART_BRIDGE_CHAR_HANDLE > cyBle_customs[0u].customServiceHandle) &&
+             (UART_BRIDGE_CCCD_HANDLE > UART_BRIDGE_CHAR_HANDLE));
+
+    ByteRing_Init(&uartBridgeRx, uartBridgeRxBuffer, UART_BRIDGE_RX_SIZE);
+    ByteRing_Init(&uartBridgeTx, uartBridgeTxBuffer, UART_BRIDGE_TX_SIZE);
+    uartBridgeNotify = 0u;
+    uartBridgeFlush = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Write()
+********************************************************************************
+*
+* Summary:
+*   Write handler (Shared\writerouter.h) of the custom service: stores
+*   writes to the bridge characteristic and its CCCD in the GATT database,
+*   like the stack does for the other services, and passes them on.
+*   uartBridgeNotify only caches the CCCD for UartBridge_ToBle().
+*
+* Parameters:
+*   writeParam - write request or command
+*   request - non-zero for a write request
+*
+* Return:
+*   CYBLE_GATT_ERR_NONE when taken.
+*
+*******************************************************************************/
+CYBLE_GATT_ERR_CODE_T UartBridge_Write(const CYBLE_GATTS_WRITE_REQ_PARAM_T *writeParam, uint32 request)
+{
+    CYBLE_GATT_HANDLE_VALUE_PAIR_T pair = writeParam->handleValPair;
+    CYBLE_CONN_HANDLE_T connHandle = writeParam->connHandle;
+    CYBLE_GATT_ERR_CODE_T result = CYBLE_GATT_ERR_NONE;
+    uint32 length = pair.value.len;
+
+    if(pair.attrHandle == UART_BRIDGE_CCCD_HANDLE)
+    {
+        if(length != CYBLE_CCCD_LEN)
+        {
+            result = CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+        }
+    }
+    else if(pair.attrHandle != UART_BRIDGE_CHAR_HANDLE)
+    {
+        result = CYBLE_GATT_ERR_WRITE_NOT_PERMITTED;
+    }
+    else if((0u != request) && (length > ByteRing_Space(&uartBridgeTx)))
+    {
+        uartBridgeStats.refused++;
+        result = CYBLE_GATT_ERR_INSUFFICIENT_RESOURCE;
+    }
+    else
+    {
+        /* Value write, checked when stored */
+    }
+
+    if(CYBLE_GATT_ERR_NONE == result)
+    {
+        result = CyBle_GattsWriteAttributeValue(&pair, 0u, &connHandle, CYBLE_GATT_DB_PEER_INITIATED);
+    }
+
+    if(CYBLE_GATT_ERR_NONE == result)
+    {
+        if(pair.attrHandle == UART_BRIDGE_CCCD_HANDLE)
+        {
+            uartBridgeNotify = (0u != (pair.value.val[0u] & CYBLE_CCCD_NOTIFICATION)) ? 1u : 0u;
+        }
+        else
+        {
+            uartBridgeStats.lostToUart += length - ByteRing_Write(&uartBridgeTx, pair.value.val, length);
+        }
+    }
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Event()
+********************************************************************************
+*
+* Summary:
+*   BLE event handler for CYBLE_EVT_GAP_DEVICE_DISCONNECTED: drops the bytes
+*   not sent yet.
+*
+* Parameters:
+*   event - event code
+*   eventParam - event parameter
+*
+*******************************************************************************/
+void UartBridge_Event(uint32 event, void *eventParam)
+{
+    (void) event;
+    (void) eventParam;
+
+    uartBridgeNotify = 0u;
+    uartBridgeStats.lostToBle += ByteRing_Count(&uartBridgeRx);
+    ByteRing_Drop(&uartBridgeRx, ByteRing_Count(&uartBridgeRx));
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_FromUart()
+********************************************************************************
+*
+* Summary:
+*   Moves the received UART bytes into the ring. Bytes that find it full
+*   are dropped, so the UART does not hold the device awake.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Number of bytes read from the UART.
+*
+*******************************************************************************/
+static uint32 UartBridge_FromUart(void)
+{
+    uint8 rxByte;
+    uint32 wasEmpty = (0u == ByteRing_Count(&uartBridgeRx)) ? 1u : 0u;
+    uint32 received = 0u;
+
+    while(0u != H_UART_SpiUartGetRxBufferSize())
+    {
+        rxByte = (uint8) H_UART_SpiUartReadRxData();
+        received++;
+        if(0u == ByteRing_Write(&uartBridgeRx, &rxByte, 1u))
+        {
+            uartBridgeStats.lostToBle++;
+        }
+    }
+
+    if((0u != received) && (0u != wasEmpty) && (0u != ByteRing_Count(&uartBridgeRx)))
+    {
+        if(0u == UART_BRIDGE_FLUSH_TICKS)
+        {
+            uartBridgeFlush = 1u;
+        }
+        else
+        {
+            Idle_TimerStart(IDLE_TIMER_UART_BRIDGE, UART_BRIDGE_FLUSH_TICKS);
+        }
+    }
+
+    return received;
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_ToBle()
+********************************************************************************
+*
+* Summary:
+*   Sends full packets, and the partial one once the flush time has run
+*   out, while the stack has buffers.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void UartBridge_ToBle(void)
+{
+    CYBLE_GATTS_HANDLE_VALUE_NTF_T notification;
+    CYBLE_API_RESULT_T result;
+    uint16 mtu = CYBLE_GATT_DEFAULT_MTU;
+    uint32 payload;
+    uint32 length;
+
+    if(0u != Idle_TimerExpired(IDLE_TIMER_UART_BRIDGE))
+    {
+        uartBridgeFlush = 1u;
+    }
+
+    if((0u == uartBridgeNotify) || (CyBle_GetState() != CYBLE_STATE_CONNECTED))
+    {
+        return;
+    }
+
+    (void) CyBle_GattGetMtuSize(&mtu);
+    payload = (uint32) mtu - 3u;
+    if(payload > UART_BRIDGE_PACKET_MAX)
+    {
+        payload = UART_BRIDGE_PACKET_MAX;
+    }
+
+    while(CyBle_GattGetBusStatus() == CYBLE_STACK_STATE_FREE)
+    {
+        length = ByteRing_Chunk(&uartBridgeRx, payload, uartBridgeFlush);
+        if(0u == length)
+        {
+            break;
+        }
+
+        notification.attrHandle = UART_BRIDGE_CHAR_HANDLE;
+        notification.value.val = uartBridgePacket;
+        notification.value.len = (uint16) ByteRing_Peek(&uartBridgeRx, uartBridgePacket, length);
+        result = CyBle_GattsNotification(cyBle_connHandle, &notification);
+        if(result == CYBLE_ERROR_INSUFFICIENT_RESOURCES)
+        {
+            /* Keep the bytes; the stack reports when it is free again */
+            break;
+        }
+
+        ByteRing_Drop(&uartBridgeRx, length);
+        if(result == CYBLE_ERROR_OK)
+        {
+            uartBridgeStats.toBle += length;
+            uartBridgeStats.packets++;
+        }
+        else
+        {
+            uartBridgeStats.lostToBle += length;
+        }
+    }
+
+    if(0u == ByteRing_Count(&uartBridgeRx))
+    {
+        uartBridgeFlush = 0u;
+        Idle_TimerStop(IDLE_TIMER_UART_BRIDGE);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_ToUart()
+********************************************************************************
+*
+* Summary:
+*   Fills the UART transmit buffer from the ring.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+static void UartBridge_ToUart(void)
+{
+    uint8 txByte;
+
+    while((0u != ByteRing_Count(&uartBridgeTx)) && (H_UART_SpiUartGetTxBufferSize() < H_UART_TX_BUFFER_SIZE))
+    {
+        (void) ByteRing_Read(&uartBridgeTx, &txByte, 1u);
+        H_UART_SpiUartWriteTxData(txByte);
+        uartBridgeStats.toUart++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop after CyBle_ProcessEvents(). Moves data in
+*   both directions and keeps the UART awake while it receives or has bytes
+*   to send.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void UartBridge_Task(void)
+{
+    uint32 received = UartBridge_FromUart();
+
+    UartBridge_ToBle();
+    UartBridge_ToUart();
+
+    if((0u != received) || (0u != ByteRing_Count(&uartBridgeTx)))
+    {
+        Idle_UartActivity();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: UartBridge_GetStats()
+********************************************************************************
+*
+* Summary:
+*   Copies the bridge counters, counted since start.
+*
+* Parameters:
+*   stats - receives the counters
+*
+*******************************************************************************/
+void UartBridge_GetStats(UART_BRIDGE_STATS_T *stats)
+{
+    *stats = uartBridgeStats;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,73 @@
+/*******************************************************************************
+* File Name: uartbridge.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the UART to BLE bridge.
+*  The bridge uses the characteristic of the custom service in both
+*  directions:
+*   - bytes received on H_UART are buffered and sent as notifications of up
+*    to ATT MTU - 3 bytes once the client has enabled them. A packet is sent
+*    as soon as it is full, a partial one after UART_BRIDGE_FLUSH_MS; a
+*    short flush time lowers latency, a long one fills packets and so
+*    carries more bytes per connection event;
+*   - values the client writes, with or without response, are buffered and
+*    sent on H_UART. A write request that does not fit is answered with
+*    Insufficient Resources so the client retries it; a write command that
+*    does not fit is cut and counted.
+*  The notifications bypass the transmit queue: the ring is the queue, and
+*  the packets are longer than TX_QUEUE_VALUE_SIZE.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(UARTBRIDGE_H)
+#define UARTBRIDGE_H
+
+#include <project.h>
+#include "Options.h"
+#include "OTAMandatory.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Longest notification payload, at the largest ATT MTU of the component */
+#define UART_BRIDGE_PACKET_MAX          (CYBLE_GATT_MTU - 3u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    uint32 toBle;                       /* Bytes sent in notifications */
+    uint32 toUart;                      /* Bytes sent on H_UART */
+    uint32 packets;                     /* Notifications sent */
+    uint32 lostToBle;                   /* UART bytes dropped with the ring full */
+    uint32 lostToUart;                  /* Written bytes cut with the ring full */
+    uint32 refused;                     /* Write requests answered with an error */
+} UART_BRIDGE_STATS_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+void UartBridge_Start(void);
+CYBLE_GATT_ERR_CODE_T UartBridge_Write(const CYBLE_GATTS_WRITE_REQ_PARAM_T *writeParam, uint32 request);
+void UartBridge_Event(uint32 event, void *eventParam);
+void UartBridge_Task(void);
+void UartBridge_GetStats(UART_BRIDGE_STATS_T *stats);
+
+#endif /* UARTBRIDGE_H */
+
+
+/* [] END OF FILE */
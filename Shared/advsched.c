@@ -0,0 +1,360 @@
+/*******************************************************************************
+* File Name: advsched.c
+*
+* Version 1.30
+*
+* Description:
+*  Adaptive advertising schedule. Each stage is started with
+*  CYBLE_ADVERTISING_CUSTOM and a timeout; the advertisement stop event that
+*  follows the timeout moves to the next stage. The retained block has a
+*  fixed slot of .btldr_run in both GCC linker scripts, so the Bootloader
+*  can direct its first advertisements to the central that was connected to
+*  HelloApp, and the other way round.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "main.h"
+#include "advsched.h"
+#include "timebase.h"
+
+/* Stage index of high duty cycle directed advertising */
+#define ADV_SCHED_DIRECTED              (0xFFu)
+
+/* The host timeout ends directed advertising before the 1.28 s limit of the
+ * controller, so its end is reported like the end of any other stage.
+ */
+#define ADV_SCHED_DIRECTED_TIMEOUT      (1u)        /* s */
+#define ADV_SCHED_DIRECTED_MISSES_MAX   (2u)
+
+#define ADV_SCHED_RECONNECT_DEFAULT_MS  (3000u)
+
+/* Random static addresses have the two top bits set; resolvable private
+ * addresses change, so they are not used as a directed target.
+ */
+#define ADV_SCHED_ADDR_STATIC_MASK      (0xC0u)
+
+typedef struct
+{
+    uint16 intervalMin;                 /* 0.625 ms units */
+    uint16 intervalMax;
+    uint16 timeout;                     /* s, 0 for the adaptive first stage */
+} ADV_SCHED_STAGE_T;
+
+/* Back-off curve of undirected advertising */
+static const ADV_SCHED_STAGE_T advSchedCurve[] =
+{
+    {   32u,   48u, 0u  },              /* 20 - 30 ms */
+    {  244u,  256u, 30u },              /* 152.5 - 160 ms */
+    {  668u,  700u, 60u },              /* 417.5 - 437.5 ms */
+    { 1636u, 1700u, ADV_SCHED_LAST_TIMEOUT } /* 1022.5 - 1062.5 ms */
+};
+
+#define ADV_SCHED_STAGES                (sizeof(advSchedCurve) / sizeof(advSchedCurve[0u]))
+
+CY_SECTION(ADV_SCHED_SECTION)
+volatile ADV_SCHED_MEMORY_T advSchedMemory;
+
+static uint32 advSchedStage;
+static uint32 advSchedStartTime;
+static uint32 advSchedHandoff;
+static uint8 advSchedDiscMode;
+static uint8 advSchedDiscModeSaved;
+static uint16 advSchedFastMin;
+static uint16 advSchedFastMax;          /* 0: interval of advSchedCurve[0] */
+
+static uint32 AdvSched_Check(void);
+static void AdvSched_Seal(void);
+static CYBLE_API_RESULT_T AdvSched_Enter(uint32 stage);
+
+
+/*******************************************************************************
+* Function Name: AdvSched_Check()
+********************************************************************************
+*
+* Summary:
+*   Computes the check word of the retained block.
+*
+*******************************************************************************/
+static uint32 AdvSched_Check(void)
+{
+    return ~(advSchedMemory.magic ^ advSchedMemory.reconnectMs ^ advSchedMemory.pending ^
+             advSchedMemory.misses ^ advSchedMemory.peerLow ^ advSchedMemory.peerHigh);
+}
+
+
+/*******************************************************************************
+* Function Name: AdvSched_Seal()
+********************************************************************************
+*
+* Summary:
+*   Updates the check word after a change of the retained block.
+*
+*******************************************************************************/
+static void AdvSched_Seal(void)
+{
+    advSchedMemory.check = AdvSched_Check();
+}
+
+
+/*******************************************************************************
+* Function Name: AdvSched_Enter()
+********************************************************************************
+*
+* Summary:
+*   Starts advertising with the parameters of a stage.
+*
+* Parameters:
+*   stage - index in advSchedCurve[] or ADV_SCHED_DIRECTED
+*
+* Return:
+*   Result of CyBle_GappStartAdvertisement().
+*
+*******************************************************************************/
+static CYBLE_API_RESULT_T AdvSched_Enter(uint32 stage)
+{
+    CYBLE_GAPP_DISC_PARAM_T *param = cyBle_discoveryModeInfo.advParam;
+    uint32 timeout;
+
+    if(0u == advSchedDiscModeSaved)
+    {
+        advSchedDiscMode = cyBle_discoveryModeInfo.discMode;
+        advSchedDiscModeSaved = 1u;
+    }
+    advSchedStage = stage;
+
+    if(stage == ADV_SCHED_DIRECTED)
+    {
+        /* Directed advertising carries no advertising data */
+        param->advType = CYBLE_GAPP_CONNECTABLE_HIGH_DC_DIRECTED_ADV;
+        param->directAddrType = (uint8) (advSchedMemory.peerHigh >> 16u);
+        param->directAddr[0u] = (uint8) advSchedMemory.peerLow;
+        param->directAddr[1u] = (uint8) (advSchedMemory.peerLow >> 8u);
+        param->directAddr[2u] = (uint8) (advSchedMemory.peerLow >> 16u);
+        param->directAddr[3u] = (uint8) (advSchedMemory.peerLow >> 24u);
+        param->directAddr[4u] = (uint8) advSchedMemory.peerHigh;
+        param->directAddr[5u] = (uint8) (advSchedMemory.peerHigh >> 8u);
+        cyBle_discoveryModeInfo.discMode = CYBLE_GAPP_NONE_DISC_BROADCAST_MODE;
+        cyBle_discoveryModeInfo.advTo = ADV_SCHED_DIRECTED_TIMEOUT;
+    }
+    else
+    {
+        param->advType = CYBLE_GAPP_CONNECTABLE_UNDIRECTED_ADV;
+        param->advIntvMin = advSchedCurve[stage].intervalMin;
+        param->advIntvMax = advSchedCurve[stage].intervalMax;
+        if((stage == 0u) && (0u != advSchedFastMax))
+        {
+            param->advIntvMin = advSchedFastMin;
+            param->advIntvMax = advSchedFastMax;
+        }
+        cyBle_discoveryModeInfo.discMode = advSchedDiscMode;
+
+        timeout = advSchedCurve[stage].timeout;
+        if(stage == 0u)
+        {
+            /* Twice the usual reconnect time, rounded up to seconds */
+            timeout = ((2u * advSchedMemory.reconnectMs) + 999u) / 1000u;
+            if(timeout < ADV_SCHED_FAST_MIN)
+            {
+                timeout = ADV_SCHED_FAST_MIN;
+            }
+            if(timeout > ADV_SCHED_FAST_MAX)
+            {
+                timeout = ADV_SCHED_FAST_MAX;
+            }
+        }
+        cyBle_discoveryModeInfo.advTo = (uint16) timeout;
+    }
+
+    return CyBle_GappStartAdvertisement(CYBLE_ADVERTISING_CUSTOM);
+}
+
+
+/*******************************************************************************
+* Function Name: AdvSched_Start()
+********************************************************************************
+*
+* Summary:
+*   Starts the schedule. Called on CYBLE_EVT_STACK_ON and on
+*   CYBLE_EVT_GAP_DEVICE_DISCONNECTED. Begins with directed advertising when
+*   the last link did not end by request and its central has a stable
+*   address that answered directed advertising before.
+*
+* Parameters:
+*   reason - HCI disconnect reason, or ADV_SCHED_REASON_BOOT
+*
+* Return:
+*   Result of CyBle_GappStartAdvertisement().
+*
+*******************************************************************************/
+CYBLE_API_RESULT_T AdvSched_Start(uint32 reason)
+{
+    CYBLE_API_RESULT_T apiResult = CYBLE_ERROR_OK;
+    uint32 stage = 0u;
+
+    if(0u == advSchedHandoff)
+    {
+        Timebase_Start();
+
+        if((advSchedMemory.magic != ADV_SCHED_MAGIC) || (advSchedMemory.check != AdvSched_Check()))
+        {
+            advSchedMemory.magic = ADV_SCHED_MAGIC;
+            advSchedMemory.reconnectMs = ADV_SCHED_RECONNECT_DEFAULT_MS;
+            advSchedMemory.pending = 0u;
+            advSchedMemory.misses = 0u;
+            advSchedMemory.peerLow = 0u;
+            advSchedMemory.peerHigh = 0u;
+        }
+        if((reason == ADV_SCHED_HCI_REMOTE_USER) || (reason == ADV_SCHED_HCI_LOCAL_HOST))
+        {
+            advSchedMemory.pending = 0u;
+        }
+        AdvSched_Seal();
+
+    #if (ADV_SCHED_DIRECTED_ENABLED == YES)
+        if((0u != advSchedMemory.pending) && (advSchedMemory.misses < ADV_SCHED_DIRECTED_MISSES_MAX) &&
+           ((((advSchedMemory.peerHigh >> 16u) & 0xFFu) == CYBLE_GAP_ADDR_TYPE_PUBLIC) ||
+            (((advSchedMemory.peerHigh >> 8u) & ADV_SCHED_ADDR_STATIC_MASK) == ADV_SCHED_ADDR_STATIC_MASK)))
+        {
+            stage = ADV_SCHED_DIRECTED;
+        }
+    #endif /* (ADV_SCHED_DIRECTED_ENABLED == YES) */
+
+        advSchedStartTime = Timebase_Now();
+        apiResult = AdvSched_Enter(stage);
+    }
+
+    return apiResult;
+}
+
+
+/*******************************************************************************
+* Function Name: AdvSched_Next()
+********************************************************************************
+*
+* Summary:
+*   Moves to the next stage. Called on CYBLE_EVT_GAPP_ADVERTISEMENT_START_STOP
+*   when advertising has stopped and the device is not connected.
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Non-zero while advertising continues, zero after the last stage.
+*
+*******************************************************************************/
+uint32 AdvSched_Next(void)
+{
+    uint32 stage = advSchedStage + 1u;
+
+    if(0u != advSchedHandoff)
+    {
+        return 0u;
+    }
+
+    if(advSchedStage == ADV_SCHED_DIRECTED)
+    {
+        advSchedMemory.misses++;
+        AdvSched_Seal();
+        stage = 0u;
+    }
+    if(stage >= ADV_SCHED_STAGES)
+    {
+        return 0u;
+    }
+
+    (void) AdvSched_Enter(stage);
+    return 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: AdvSched_Connected()
+********************************************************************************
+*
+* Summary:
+*   Called on CYBLE_EVT_GAP_DEVICE_CONNECTED. Folds the time since the
+*   schedule started into the reconnect estimate and remembers the central,
+*   so that a link that ends without a request is followed by directed
+*   advertising to it.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void AdvSched_Connected(void)
+{
+    CYBLE_GAP_BD_ADDR_T peer;
+    uint32 peerLow;
+    uint32 peerHigh;
+    uint32 elapsed = TIMEBASE_TICKS_TO_MS(Timebase_Now() - advSchedStartTime);
+
+    /* Waits for a user to open the app are not reconnects */
+    if(elapsed > (ADV_SCHED_FAST_MAX * 1000u))
+    {
+        elapsed = ADV_SCHED_FAST_MAX * 1000u;
+    }
+    advSchedMemory.reconnectMs = ((3u * advSchedMemory.reconnectMs) + elapsed) / 4u;
+
+    if(CyBle_GapGetPeerBdAddr(cyBle_connHandle.bdHandle, &peer) == CYBLE_ERROR_OK)
+    {
+        peerLow = (uint32) peer.bdAddr[0u] | ((uint32) peer.bdAddr[1u] << 8u) |
+                  ((uint32) peer.bdAddr[2u] << 16u) | ((uint32) peer.bdAddr[3u] << 24u);
+        peerHigh = (uint32) peer.bdAddr[4u] | ((uint32) peer.bdAddr[5u] << 8u) | ((uint32) peer.type << 16u);
+
+        /* The remembered central, or a new one, is in range again; whatever
+         * stage it came back in, directed advertising is worth trying.
+         */
+        advSchedMemory.misses = 0u;
+        advSchedMemory.peerLow = peerLow;
+        advSchedMemory.peerHigh = peerHigh;
+    }
+    advSchedMemory.pending = 1u;
+    AdvSched_Seal();
+}
+
+
+/*******************************************************************************
+* Function Name: AdvSched_SetFastInterval()
+********************************************************************************
+*
+* Summary:
+*   Replaces the interval of the fast stage, from the next time it starts.
+*
+* Parameters:
+*   intervalMin - 0.625 ms units
+*   intervalMax - 0.625 ms units, 0 to restore the default
+*
+*******************************************************************************/
+void AdvSched_SetFastInterval(uint32 intervalMin, uint32 intervalMax)
+{
+    advSchedFastMin = (uint16) intervalMin;
+    advSchedFastMax = (uint16) intervalMax;
+}
+
+
+/*******************************************************************************
+* Function Name: AdvSched_Handoff()
+********************************************************************************
+*
+* Summary:
+*   Called before the BLE Stack is shut down for a switch to the other
+*   image. Keeps the link marked as not ended by request, so the other image
+*   starts with directed advertising, and ignores the events of the
+*   shutdown.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void AdvSched_Handoff(void)
+{
+    advSchedHandoff = 1u;
+}
+
+
+/* [] END OF FILE */
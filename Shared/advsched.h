@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: advsched.h
+*
+* Version 1.30
+*
+* Description:
+*  Adaptive advertising schedule. After an unexpected disconnect, and after
+*  a reset or image switch while connected, the device first uses high duty
+*  cycle directed advertising to the last central. It then steps through a
+*  back-off curve of undirected advertising intervals. The length of the
+*  fast stage follows the reconnect times seen so far. The last central and
+*  the reconnect estimate are kept in a retained block shared by the
+*  Bootloader and HelloApp.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(ADVSCHED_H)
+#define ADVSCHED_H
+
+#include <cytypes.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+#define ADV_SCHED_MAGIC                 (0x56444153u)
+#define ADV_SCHED_SECTION               ".bootloaderruntype.advsched"
+
+/* AdvSched_Start() reason for the first start after reset */
+#define ADV_SCHED_REASON_BOOT           (0x100u)
+
+/* HCI disconnect reasons after which the central is not expected back */
+#define ADV_SCHED_HCI_REMOTE_USER       (0x13u)
+#define ADV_SCHED_HCI_LOCAL_HOST        (0x16u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Retained; all members are words so the check covers them with one XOR */
+typedef struct
+{
+    uint32 magic;                       /* ADV_SCHED_MAGIC when valid */
+    uint32 reconnectMs;                 /* Smoothed time from advertising start to connection */
+    uint32 pending;                     /* Non-zero: the last link did not end by request */
+    uint32 misses;                      /* Directed attempts in a row the central did not answer */
+    uint32 peerLow;                     /* Address bytes 0-3 of the last central */
+    uint32 peerHigh;                    /* Bytes 4-5, type in bits 16-23 */
+    uint32 check;                       /* Inverted XOR of the words above */
+} ADV_SCHED_MEMORY_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+CYBLE_API_RESULT_T AdvSched_Start(uint32 reason);
+uint32 AdvSched_Next(void);
+void AdvSched_Connected(void);
+void AdvSched_SetFastInterval(uint32 intervalMin, uint32 intervalMax);
+void AdvSched_Handoff(void);
+
+extern volatile ADV_SCHED_MEMORY_T advSchedMemory;
+
+#endif /* ADVSCHED_H */
+
+
+/* [] END OF FILE */
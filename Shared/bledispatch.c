@@ -0,0 +1,239 @@
+/*******************************************************************************
+* File Name: bledispatch.c
+*
+* Version 1.30
+*
+* Description:
+*  BLE event dispatch; see bledispatch.h. BleDispatch_Init() chains the
+*  entries of each index bucket in table order, so an event costs one
+*  bucket lookup and a walk over the few entries that share its low bits.
+*  The cycle counts come from SysTick running as a free 24-bit down
+*  counter, the same way as the Bootloader's loop statistics.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "main.h"
+#include "bledispatch.h"
+#include "bletrace.h"
+#include "timebase.h"
+
+#define BLE_DISPATCH_NONE               (0xFFu)
+#define BLE_DISPATCH_BUCKET_MASK        (BLE_DISPATCH_BUCKETS - 1u)
+
+#if ((BLE_DISPATCH_BUCKETS & BLE_DISPATCH_BUCKET_MASK) != 0u)
+    #error BLE_DISPATCH_BUCKETS must be a power of two
+#endif /* ((BLE_DISPATCH_BUCKETS & BLE_DISPATCH_BUCKET_MASK) != 0u) */
+
+#if (BLE_DISPATCH_BINS != 8u)
+    #error BLE_DISPATCH_LINE_HISTOGRAM prints eight bins
+#endif /* (BLE_DISPATCH_BINS != 8u) */
+
+static const BLE_DISPATCH_ENTRY_T *bleDispatchTable;
+static uint8 bleDispatchHead[BLE_DISPATCH_BUCKETS];
+static uint8 bleDispatchNext[BLE_DISPATCH_HANDLERS_MAX];
+
+#if (BLE_DISPATCH_STATS_ENABLED == YES)
+
+#define BLE_DISPATCH_SYSTICK_RELOAD     (0x00FFFFFFu)
+#define BLE_DISPATCH_SLOW_CYCLES        (BLE_DISPATCH_SLOW_US * CYDEV_BCLK__SYSCLK__MHZ)
+
+typedef struct
+{
+    uint32 calls;
+    uint32 maxCycles;
+    uint16 bins[BLE_DISPATCH_BINS];     /* Saturate at 0xFFFF */
+} BLE_DISPATCH_STATS_T;
+
+static BLE_DISPATCH_STATS_T bleDispatchStats[BLE_DISPATCH_HANDLERS_MAX];
+static uint32 bleDispatchCount;
+static uint32 bleDispatchReportStart;
+
+static void BleDispatch_Account(uint32 entry, uint32 cycles);
+
+#endif /* (BLE_DISPATCH_STATS_ENABLED == YES) */
+
+
+/*******************************************************************************
+* Function Name: BleDispatch_Init()
+********************************************************************************
+*
+* Summary:
+*   Builds the event index of a handler table. Called once, before
+*   CyBle_Start().
+*
+* Parameters:
+*   table - handler entries; must stay valid
+*   count - number of entries, at most BLE_DISPATCH_HANDLERS_MAX
+*
+*******************************************************************************/
+void BleDispatch_Init(const BLE_DISPATCH_ENTRY_T table[], uint32 count)
+{
+    uint32 bucket;
+    uint32 i;
+
+    CYASSERT(count <= BLE_DISPATCH_HANDLERS_MAX);
+
+    bleDispatchTable = table;
+    for(bucket = 0u; bucket < BLE_DISPATCH_BUCKETS; bucket++)
+    {
+        bleDispatchHead[bucket] = BLE_DISPATCH_NONE;
+    }
+
+    /* Insert from the end so each chain keeps the table order */
+    for(i = count; i > 0u; i--)
+    {
+        bucket = (uint32) table[i - 1u].event & BLE_DISPATCH_BUCKET_MASK;
+        bleDispatchNext[i - 1u] = bleDispatchHead[bucket];
+        bleDispatchHead[bucket] = (uint8) (i - 1u);
+    }
+
+#if (BLE_DISPATCH_STATS_ENABLED == YES)
+    bleDispatchCount = count;
+
+    CY_SYS_SYST_CSR_REG = 0u;
+    CY_SYS_SYST_RVR_REG = BLE_DISPATCH_SYSTICK_RELOAD;
+    CY_SYS_SYST_CVR_REG = 0u;
+    CY_SYS_SYST_CSR_REG = CY_SYS_SYST_CSR_ENABLE | CY_SYS_SYST_CSR_CLK_SRC_SYSCLK;
+
+    Timebase_Start();
+    bleDispatchReportStart = Timebase_Now();
+#endif /* (BLE_DISPATCH_STATS_ENABLED == YES) */
+}
+
+
+/*******************************************************************************
+* Function Name: BleDispatch_Event()
+********************************************************************************
+*
+* Summary:
+*   Records the event in the BLE event trace and calls its handlers. This is
+*   the callback given to CyBle_Start() and to the services.
+*
+* Parameters:
+*   event - CYBLE_EVT_* code
+*   eventParam - event parameter
+*
+*******************************************************************************/
+void BleDispatch_Event(uint32 event, void *eventParam)
+{
+    uint32 i;
+#if (BLE_DISPATCH_STATS_ENABLED == YES)
+    uint32 start;
+#endif /* (BLE_DISPATCH_STATS_ENABLED == YES) */
+
+    BleTrace_Record(event, eventParam);
+
+    i = bleDispatchHead[event & BLE_DISPATCH_BUCKET_MASK];
+    while(i != BLE_DISPATCH_NONE)
+    {
+        if((uint32) bleDispatchTable[i].event == event)
+        {
+        #if (BLE_DISPATCH_STATS_ENABLED == YES)
+            start = CY_SYS_SYST_CVR_REG;
+            bleDispatchTable[i].handler(event, eventParam);
+            BleDispatch_Account(i, (start - CY_SYS_SYST_CVR_REG) & BLE_DISPATCH_SYSTICK_RELOAD);
+        #else
+            bleDispatchTable[i].handler(event, eventParam);
+        #endif /* (BLE_DISPATCH_STATS_ENABLED == YES) */
+        }
+        i = bleDispatchNext[i];
+    }
+}
+
+
+#if (BLE_DISPATCH_STATS_ENABLED == YES)
+/*******************************************************************************
+* Function Name: BleDispatch_Account()
+********************************************************************************
+*
+* Summary:
+*   Adds one handler call to the histogram of its entry. A handler that
+*   holds the stack callback for longer than BLE_DISPATCH_SLOW_US is also
+*   added to the BLE event trace.
+*
+* Parameters:
+*   entry - table index
+*   cycles - CPU cycles spent in the handler
+*
+*******************************************************************************/
+static void BleDispatch_Account(uint32 entry, uint32 cycles)
+{
+    BLE_DISPATCH_STATS_T *stats = &bleDispatchStats[entry];
+    uint32 length = cycles >> (BLE_DISPATCH_BIN_SHIFT + 1u);
+    uint32 bin = 0u;
+
+    while((length != 0u) && (bin < (BLE_DISPATCH_BINS - 1u)))
+    {
+        length >>= 1u;
+        bin++;
+    }
+
+    stats->calls++;
+    if(cycles > stats->maxCycles)
+    {
+        stats->maxCycles = cycles;
+    }
+    if(stats->bins[bin] != 0xFFFFu)
+    {
+        stats->bins[bin]++;
+    }
+
+    if(cycles >= BLE_DISPATCH_SLOW_CYCLES)
+    {
+        BleTrace_RecordValue(BLE_TRACE_EVT_SLOW_HANDLER, bleDispatchTable[entry].event);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BleDispatch_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop. Once per BLE_DISPATCH_REPORT_PERIOD prints
+*   the histogram of every entry called since the previous report and
+*   clears it.
+*
+* Parameters:
+*   putString - UART output function
+*
+*******************************************************************************/
+void BleDispatch_Task(void (*putString)(const char8 string[]))
+{
+    BLE_DISPATCH_STATS_T *stats;
+    char8 line[96u];
+    uint32 i;
+
+    if((Timebase_Now() - bleDispatchReportStart) < BLE_DISPATCH_REPORT_PERIOD)
+    {
+        return;
+    }
+    bleDispatchReportStart = Timebase_Now();
+
+    for(i = 0u; i < bleDispatchCount; i++)
+    {
+        stats = &bleDispatchStats[i];
+        if(stats->calls != 0u)
+        {
+            (void) sprintf(line, BLE_DISPATCH_LINE_HISTOGRAM,
+                (unsigned int) bleDispatchTable[i].event,
+                (unsigned long) stats->calls, (unsigned long) stats->maxCycles,
+                (unsigned int) stats->bins[0u], (unsigned int) stats->bins[1u],
+                (unsigned int) stats->bins[2u], (unsigned int) stats->bins[3u],
+                (unsigned int) stats->bins[4u], (unsigned int) stats->bins[5u],
+                (unsigned int) stats->bins[6u], (unsigned int) stats->bins[7u]);
+            putString(line);
+            (void) memset(stats, 0, sizeof(BLE_DISPATCH_STATS_T));
+        }
+    }
+}
+#endif /* (BLE_DISPATCH_STATS_ENABLED == YES) */
+
+
+/* [] END OF FILE */
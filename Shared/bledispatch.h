@@ -0,0 +1,97 @@
+/*******************************************************************************
+* File Name: bledispatch.h
+*
+* Version 1.30
+*
+* Description:
+*  BLE event dispatch. Each project lists its handlers in a constant table
+*  of { event, handler } entries built at compile time, e.g.
+*
+*   #define APP_BLE_HANDLERS(X) \
+*       X(CYBLE_EVT_STACK_ON,                   StackOnHandler) \
+*       X(CYBLE_EVT_SCPSS_NOTIFICATION_ENABLED, ScpsCallBack)
+*
+*   static const BLE_DISPATCH_ENTRY_T appHandlers[] =
+*   {
+*       APP_BLE_HANDLERS(BLE_DISPATCH_ENTRY)
+*   };
+*
+*  BleDispatch_Event() is passed to CyBle_Start() and to the service
+*  CyBle_*RegisterAttrCallback() functions, so stack and service events
+*  reach their handlers the same way. An event may have several handlers;
+*  they run in table order. Events without a handler are only traced.
+*
+*  With BLE_DISPATCH_STATS_ENABLED the CPU cycles of each handler call go
+*  into a log2 histogram per table entry, printed over UART every
+*  BLE_DISPATCH_REPORT_PERIOD, and calls longer than
+*  BLE_DISPATCH_SLOW_CYCLES add a BLE_TRACE_EVT_SLOW_HANDLER record.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BLEDISPATCH_H)
+#define BLEDISPATCH_H
+
+#include <cytypes.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Table entries the index can hold */
+#define BLE_DISPATCH_HANDLERS_MAX       (32u)
+
+/* Index buckets, power of two; events are hashed by their low bits */
+#define BLE_DISPATCH_BUCKETS            (32u)
+
+/* Histogram bins: bin 0 counts calls below 2^(BLE_DISPATCH_BIN_SHIFT + 1)
+ * cycles, each further bin twice as long, the last one everything above.
+ */
+#define BLE_DISPATCH_BINS               (8u)
+#define BLE_DISPATCH_BIN_SHIFT          (8u)
+
+/* UART line: "@H <event> <calls> <max cycles> <bin 0> ... <bin 7>" */
+#define BLE_DISPATCH_LINE_HISTOGRAM     "@H %04X %lu %lu %u %u %u %u %u %u %u %u\r\n"
+
+/* Initializer of one BLE_DISPATCH_ENTRY_T, for the handler list X-macros */
+#define BLE_DISPATCH_ENTRY(event, handler)  { (uint16) (event), &(handler) },
+
+#define BLE_DISPATCH_COUNT(table)       (sizeof(table) / sizeof((table)[0u]))
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef void (*BLE_DISPATCH_HANDLER_T)(uint32 event, void *eventParam);
+
+typedef struct
+{
+    uint16 event;                       /* CYBLE_EVT_* code */
+    BLE_DISPATCH_HANDLER_T handler;
+} BLE_DISPATCH_ENTRY_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void BleDispatch_Init(const BLE_DISPATCH_ENTRY_T table[], uint32 count);
+void BleDispatch_Event(uint32 event, void *eventParam);
+
+#if (BLE_DISPATCH_STATS_ENABLED == YES)
+    void BleDispatch_Task(void (*putString)(const char8 string[]));
+#else
+    #define BleDispatch_Task(putString)
+#endif /* (BLE_DISPATCH_STATS_ENABLED == YES) */
+
+#endif /* BLEDISPATCH_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,245 @@
+/*******************************************************************************
+* File Name: bletrace.c
+*
+* Version 1.30
+*
+* Description:
+*  BLE event trace ring. Producers may run in thread or interrupt context:
+*  each one fills its record inside a critical section of a few
+*  instructions, so the consumer sees only complete records and never masks
+*  interrupts. When the ring is full new records are dropped and counted.
+*  The BLE API comes from the project's main.h.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "main.h"
+#include "bletrace.h"
+#include "timebase.h"
+
+#if (BLE_TRACE_ENABLED == YES)
+
+#define BLE_TRACE_MASK          (BLE_TRACE_SIZE - 1u)
+
+#if ((BLE_TRACE_SIZE & BLE_TRACE_MASK) != 0u)
+    #error BLE_TRACE_SIZE must be a power of two
+#endif /* ((BLE_TRACE_SIZE & BLE_TRACE_MASK) != 0u) */
+
+static BLE_TRACE_RECORD_T bleTraceRing[BLE_TRACE_SIZE];
+static volatile uint32 bleTraceHead;
+static volatile uint32 bleTraceTail;
+static volatile uint32 bleTraceDropped;
+
+
+/*******************************************************************************
+* Function Name: BleTrace_Record()
+********************************************************************************
+*
+* Summary:
+*   Appends a BLE Stack event to the ring. Safe to call from interrupts.
+*
+* Parameters:
+*   event - CYBLE_EVT_* code
+*   eventParam - event parameter as passed to BleDispatch_Event(), may be NULL
+*
+*******************************************************************************/
+void BleTrace_Record(uint32 event, const void *eventParam)
+{
+    const uint8 *param = (const uint8 *) eventParam;
+    uint32 digest = 0u;
+
+    if(param != NULL)
+    {
+        if((event == (uint32) CYBLE_EVT_GATTS_WRITE_REQ) || (event == (uint32) CYBLE_EVT_GATTS_WRITE_CMD_REQ))
+        {
+            digest = ((const CYBLE_GATTS_WRITE_REQ_PARAM_T *) eventParam)->handleValPair.attrHandle;
+        }
+        else if((event == (uint32) CYBLE_EVT_GAP_DEVICE_CONNECTED) ||
+                (event == (uint32) CYBLE_EVT_GAPC_CONNECTION_UPDATE_COMPLETE))
+        {
+            digest = ((const CYBLE_GAP_CONN_PARAM_UPDATED_IN_CONTROLLER_T *) eventParam)->connIntv;
+        }
+        else
+        {
+            digest = (uint32) param[0u] | ((uint32) param[1u] << 8u);
+        }
+    }
+
+    BleTrace_RecordValue(event, digest);
+}
+
+
+/*******************************************************************************
+* Function Name: BleTrace_RecordValue()
+********************************************************************************
+*
+* Summary:
+*   Appends a record with an explicit digest. Safe to call from interrupts.
+*
+* Parameters:
+*   event - CYBLE_EVT_* or BLE_TRACE_EVT_* code
+*   digest - 16-bit record value
+*
+*******************************************************************************/
+void BleTrace_RecordValue(uint32 event, uint32 digest)
+{
+    uint32 stamp = Timebase_Now();
+    uint32 head;
+    uint8 interruptStatus;
+
+    interruptStatus = CyEnterCriticalSection();
+    head = bleTraceHead;
+    if((head - bleTraceTail) < BLE_TRACE_SIZE)
+    {
+        BLE_TRACE_RECORD_T *record = &bleTraceRing[head & BLE_TRACE_MASK];
+
+        record->stamp = stamp;
+        record->event = (uint16) event;
+        record->digest = (uint16) digest;
+        bleTraceHead = head + 1u;
+    }
+    else
+    {
+        bleTraceDropped++;
+    }
+    CyExitCriticalSection(interruptStatus);
+}
+
+
+/*******************************************************************************
+* Function Name: BleTrace_Peek()
+********************************************************************************
+*
+* Summary:
+*   Copies the oldest records without removing them. Single consumer only.
+*
+* Parameters:
+*   record - destination
+*   count - capacity of record[]
+*
+* Return:
+*   Number of records copied.
+*
+*******************************************************************************/
+uint32 BleTrace_Peek(BLE_TRACE_RECORD_T record[], uint32 count)
+{
+    uint32 tail = bleTraceTail;
+    uint32 available = bleTraceHead - tail;
+    uint32 i;
+
+    if(count > available)
+    {
+        count = available;
+    }
+    for(i = 0u; i < count; i++)
+    {
+        record[i] = bleTraceRing[(tail + i) & BLE_TRACE_MASK];
+    }
+
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: BleTrace_Consume()
+********************************************************************************
+*
+* Summary:
+*   Removes records returned by BleTrace_Peek().
+*
+* Parameters:
+*   count - number of records to remove
+*
+*******************************************************************************/
+void BleTrace_Consume(uint32 count)
+{
+    bleTraceTail += count;
+}
+
+
+/*******************************************************************************
+* Function Name: BleTrace_Task()
+********************************************************************************
+*
+* Summary:
+*   Called from the main loop. Sends pending records as GATT notifications
+*   while connected, when BLE_TRACE_CHAR_HANDLE is present in the GATT
+*   database, otherwise prints them over UART if BLE_TRACE_UART_ENABLED.
+*
+* Parameters:
+*   putString - UART string output function of the project
+*
+*******************************************************************************/
+void BleTrace_Task(void (*putString)(const char8 string[]))
+{
+    BLE_TRACE_RECORD_T record[BLE_TRACE_NOTIFY_RECORDS];
+    uint32 count;
+
+    if((0u != BLE_TRACE_CHAR_HANDLE) && (CyBle_GetState() == CYBLE_STATE_CONNECTED))
+    {
+        uint8 value[BLE_TRACE_NOTIFY_RECORDS * BLE_TRACE_RECORD_SIZE];
+        CYBLE_GATTS_HANDLE_VALUE_NTF_T notification;
+        uint32 i;
+
+        count = BleTrace_Peek(record, BLE_TRACE_NOTIFY_RECORDS);
+        if((count != 0u) && (CyBle_GattGetBusStatus() == CYBLE_STACK_STATE_FREE))
+        {
+            for(i = 0u; i < count; i++)
+            {
+                uint8 *dst = &value[i * BLE_TRACE_RECORD_SIZE];
+
+                dst[0u] = (uint8) record[i].stamp;
+                dst[1u] = (uint8) (record[i].stamp >> 8u);
+                dst[2u] = (uint8) (record[i].stamp >> 16u);
+                dst[3u] = (uint8) (record[i].stamp >> 24u);
+                dst[4u] = (uint8) record[i].event;
+                dst[5u] = (uint8) (record[i].event >> 8u);
+                dst[6u] = (uint8) record[i].digest;
+                dst[7u] = (uint8) (record[i].digest >> 8u);
+            }
+            notification.attrHandle = BLE_TRACE_CHAR_HANDLE;
+            notification.value.val = value;
+            notification.value.len = (uint16) (count * BLE_TRACE_RECORD_SIZE);
+            if(CyBle_GattsNotification(cyBle_connHandle, &notification) == CYBLE_ERROR_OK)
+            {
+                BleTrace_Consume(count);
+            }
+        }
+    }
+#if (BLE_TRACE_UART_ENABLED == YES)
+    else
+    {
+        char8 line[32u];
+
+        while(0u != BleTrace_Peek(record, 1u))
+        {
+            (void) sprintf(line, BLE_TRACE_LINE_RECORD, (unsigned long) record[0u].stamp,
+                (unsigned int) record[0u].event, (unsigned int) record[0u].digest);
+            putString(line);
+            BleTrace_Consume(1u);
+        }
+        if(0u != bleTraceDropped)
+        {
+            uint8 interruptStatus = CyEnterCriticalSection();
+            uint32 dropped = bleTraceDropped;
+
+            bleTraceDropped = 0u;
+            CyExitCriticalSection(interruptStatus);
+
+            (void) sprintf(line, BLE_TRACE_LINE_DROPPED, (unsigned long) dropped);
+            putString(line);
+        }
+    }
+#else
+    (void) putString;
+#endif /* (BLE_TRACE_UART_ENABLED == YES) */
+}
+
+#endif /* (BLE_TRACE_ENABLED == YES) */
+
+
+/* [] END OF FILE */
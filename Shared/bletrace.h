@@ -0,0 +1,85 @@
+/*******************************************************************************
+* File Name: bletrace.h
+*
+* Version 1.30
+*
+* Description:
+*  BLE event trace. BleDispatch_Event() records every event with a
+*  timestamp and a 16-bit digest of its parameter into a fixed-size ring.
+*  The ring is drained over UART as text lines or over GATT notifications as
+*  binary records; Tools\bletrace.c decodes both into a timeline.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BLETRACE_H)
+#define BLETRACE_H
+
+#include <cytypes.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* UART line formats: "@T <stamp> <event> <digest>" and "@D <dropped>" */
+#define BLE_TRACE_LINE_RECORD           "@T %08lX %04X %04X\r\n"
+#define BLE_TRACE_LINE_DROPPED          "@D %lu\r\n"
+
+/* Records carried by one GATT notification (20-byte payload at default MTU) */
+#define BLE_TRACE_NOTIFY_RECORDS        (2u)
+
+#define BLE_TRACE_RECORD_SIZE           (8u)
+
+/* Records added by the application, outside the CYBLE_EVT_* range.
+ * BLE_TRACE_EVT_POWER + POWER_STATE_*: milliseconds spent in that power
+ * state since the previous power record.
+ */
+#define BLE_TRACE_EVT_POWER             (0xF100u)
+
+/* BLE_TRACE_EVT_SLOW_HANDLER: a handler of the event in the digest held the
+ * BLE Stack callback for longer than BLE_DISPATCH_SLOW_US (bledispatch.h).
+ */
+#define BLE_TRACE_EVT_SLOW_HANDLER      (0xF200u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Sent little-endian in this order over GATT */
+typedef struct
+{
+    uint32 stamp;       /* Timebase ticks (Shared\timebase.h) */
+    uint16 event;       /* CYBLE_EVT_* code */
+    uint16 digest;      /* Attribute handle for writes, connection interval on
+                         * connect and update, else first 2 parameter bytes
+                         */
+} BLE_TRACE_RECORD_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+#if (BLE_TRACE_ENABLED == YES)
+    void BleTrace_Record(uint32 event, const void *eventParam);
+    void BleTrace_RecordValue(uint32 event, uint32 digest);
+    uint32 BleTrace_Peek(BLE_TRACE_RECORD_T record[], uint32 count);
+    void BleTrace_Consume(uint32 count);
+    void BleTrace_Task(void (*putString)(const char8 string[]));
+#else
+    #define BleTrace_Record(event, eventParam)
+    #define BleTrace_RecordValue(event, digest)
+    #define BleTrace_Task(putString)
+#endif /* (BLE_TRACE_ENABLED == YES) */
+
+#endif /* BLETRACE_H */
+
+
+/* [] END OF FILE */
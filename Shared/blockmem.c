@@ -0,0 +1,128 @@
+/*******************************************************************************
+* File Name: blockmem.c
+*
+* Version 1.30
+*
+* Description:
+*  Word-aligned block copy and zero-fill. With GCC for Thumb the loops move
+*  16 bytes per iteration using LDMIA/STMIA multi-register transfers; other
+*  compilers and the host tools use a 4-word unrolled C loop.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "blockmem.h"
+
+#define BLOCKMEM_BLOCK_SIZE     (16u)
+
+
+/*******************************************************************************
+* Function Name: BlockMem_Copy32()
+********************************************************************************
+*
+* Summary:
+*   Copies a block of words.
+*
+* Parameters:
+*  dst - word-aligned destination
+*  src - word-aligned source
+*  size - number of bytes, multiple of 4
+*
+*******************************************************************************/
+void BlockMem_Copy32(uint32 *dst, const uint32 *src, uint32 size)
+{
+#if defined(__GNUC__) && defined(__thumb__)
+    uint32 blocks = size / BLOCKMEM_BLOCK_SIZE;
+
+    /* LDMIA/STMIA are spelled the same in divided and unified syntax */
+    while(blocks != 0u)
+    {
+        __asm volatile (
+            "ldmia %[src]!, {r2-r5}\n\t"
+            "stmia %[dst]!, {r2-r5}"
+            : [dst] "+l" (dst), [src] "+l" (src)
+            :
+            : "r2", "r3", "r4", "r5", "memory");
+        blocks--;
+    }
+#else
+    while(size >= BLOCKMEM_BLOCK_SIZE)
+    {
+        dst[0u] = src[0u];
+        dst[1u] = src[1u];
+        dst[2u] = src[2u];
+        dst[3u] = src[3u];
+        dst += 4u;
+        src += 4u;
+        size -= BLOCKMEM_BLOCK_SIZE;
+    }
+#endif /* defined(__GNUC__) && defined(__thumb__) */
+
+    size &= (BLOCKMEM_BLOCK_SIZE - 1u);
+    while(size != 0u)
+    {
+        *dst = *src;
+        dst++;
+        src++;
+        size -= sizeof(uint32);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BlockMem_Zero32()
+********************************************************************************
+*
+* Summary:
+*   Fills a block of words with zero.
+*
+* Parameters:
+*  dst - word-aligned destination
+*  size - number of bytes, multiple of 4
+*
+*******************************************************************************/
+void BlockMem_Zero32(uint32 *dst, uint32 size)
+{
+#if defined(__GNUC__) && defined(__thumb__)
+    register uint32 zero0 __asm("r2") = 0u;
+    register uint32 zero1 __asm("r3") = 0u;
+    register uint32 zero2 __asm("r4") = 0u;
+    register uint32 zero3 __asm("r5") = 0u;
+    uint32 blocks = size / BLOCKMEM_BLOCK_SIZE;
+
+    while(blocks != 0u)
+    {
+        __asm volatile (
+            "stmia %[dst]!, {r2-r5}"
+            : [dst] "+l" (dst)
+            : "r" (zero0), "r" (zero1), "r" (zero2), "r" (zero3)
+            : "memory");
+        blocks--;
+    }
+#else
+    while(size >= BLOCKMEM_BLOCK_SIZE)
+    {
+        dst[0u] = 0u;
+        dst[1u] = 0u;
+        dst[2u] = 0u;
+        dst[3u] = 0u;
+        dst += 4u;
+        size -= BLOCKMEM_BLOCK_SIZE;
+    }
+#endif /* defined(__GNUC__) && defined(__thumb__) */
+
+    size &= (BLOCKMEM_BLOCK_SIZE - 1u);
+    while(size != 0u)
+    {
+        *dst = 0u;
+        dst++;
+        size -= sizeof(uint32);
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,35 @@
+/*******************************************************************************
+* File Name: blockmem.h
+*
+* Version 1.30
+*
+* Description:
+*  Word-aligned block copy and zero-fill used for SRAM initialization.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BLOCKMEM_H)
+#define BLOCKMEM_H
+
+#include <cytypes.h>
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+/* Both functions take word-aligned pointers and a size in bytes that is a
+ * multiple of four.
+ */
+void BlockMem_Copy32(uint32 *dst, const uint32 *src, uint32 size);
+void BlockMem_Zero32(uint32 *dst, uint32 size);
+
+#endif /* BLOCKMEM_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,163 @@
+/*******************************************************************************
+* File Name: blockpool.c
+*
+* Version 1.30
+*
+* Description:
+*  Fixed-size block pool; see blockpool.h.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <CyLib.h>
+#include "blockpool.h"
+
+
+/*******************************************************************************
+* Function Name: BlockPool_Init()
+********************************************************************************
+*
+* Summary:
+*   Chains all blocks of the storage into the free list.
+*
+* Parameters:
+*  pool - pool to initialize
+*  storage - BLOCK_POOL_STORAGE_WORDS(blockSize, count) words
+*  blockSize - bytes per block, at least the size of a pointer
+*  count - number of blocks
+*
+*******************************************************************************/
+void BlockPool_Init(BLOCK_POOL_T *pool, uint32 storage[], uint32 blockSize, uint32 count)
+{
+    uint32 words = BLOCK_POOL_BLOCK_SIZE(blockSize) / 4u;
+    uint32 i;
+
+    pool->freeList = NULL;
+    pool->blockSize = words * 4u;
+    pool->count = count;
+    pool->available = count;
+    pool->minAvailable = count;
+    pool->failures = 0u;
+
+    /* Chain from the last block so the first one is allocated first */
+    for(i = count; i != 0u; i--)
+    {
+        void **block = (void **) &storage[(i - 1u) * words];
+
+        *block = pool->freeList;
+        pool->freeList = block;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BlockPool_Alloc()
+********************************************************************************
+*
+* Summary:
+*   Takes a block from the pool. May be called from interrupt handlers.
+*
+* Parameters:
+*  pool - pool to allocate from
+*
+* Return:
+*   The block, NULL when the pool is empty.
+*
+*******************************************************************************/
+void *BlockPool_Alloc(BLOCK_POOL_T *pool)
+{
+    uint8 interruptStatus = CyEnterCriticalSection();
+    void **block = (void **) pool->freeList;
+
+    if(block != NULL)
+    {
+        pool->freeList = *block;
+        pool->available--;
+        if(pool->available < pool->minAvailable)
+        {
+            pool->minAvailable = pool->available;
+        }
+    }
+    else
+    {
+        pool->failures++;
+    }
+    CyExitCriticalSection(interruptStatus);
+
+    return block;
+}
+
+
+/*******************************************************************************
+* Function Name: BlockPool_Free()
+********************************************************************************
+*
+* Summary:
+*   Returns a block to the pool it was allocated from. May be called from
+*   interrupt handlers.
+*
+* Parameters:
+*  pool - pool of the block
+*  block - block to free, NULL is ignored
+*
+*******************************************************************************/
+void BlockPool_Free(BLOCK_POOL_T *pool, void *block)
+{
+    uint8 interruptStatus;
+
+    if(block != NULL)
+    {
+        interruptStatus = CyEnterCriticalSection();
+        *(void **) block = pool->freeList;
+        pool->freeList = block;
+        pool->available++;
+        CyExitCriticalSection(interruptStatus);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BlockPool_Available()
+********************************************************************************
+*
+* Summary:
+*   Returns the number of free blocks.
+*
+*******************************************************************************/
+uint32 BlockPool_Available(const BLOCK_POOL_T *pool)
+{
+    return pool->available;
+}
+
+
+/*******************************************************************************
+* Function Name: BlockPool_GetStats()
+********************************************************************************
+*
+* Summary:
+*   Copies the pool counters, counted since BlockPool_Init().
+*
+* Parameters:
+*  pool - pool to report
+*  stats - receives the counters
+*
+*******************************************************************************/
+void BlockPool_GetStats(const BLOCK_POOL_T *pool, BLOCK_POOL_STATS_T *stats)
+{
+    uint8 interruptStatus = CyEnterCriticalSection();
+
+    stats->blockSize = pool->blockSize;
+    stats->count = pool->count;
+    stats->used = pool->count - pool->available;
+    stats->maxUsed = pool->count - pool->minAvailable;
+    stats->failures = pool->failures;
+    CyExitCriticalSection(interruptStatus);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,93 @@
+/*******************************************************************************
+* File Name: blockpool.h
+*
+* Version 1.30
+*
+* Description:
+*  Fixed-size block pool. The caller provides the storage for a number of
+*  equal blocks; free blocks are chained through their first word, so
+*  allocating and freeing take constant time and the pool needs no memory
+*  besides its descriptor. Blocks are word aligned.
+*
+*  Allocating and freeing may be done from interrupt handlers: the
+*  Cortex-M0 has no exclusive access instructions, so the free list is
+*  changed in a critical section of a few instructions.
+*
+*  Storage declared with BLOCK_POOL_STORAGE() goes into the NOLOAD section
+*  BLOCK_POOL_SECTION, which the GCC linker script places apart from .bss
+*  and so from cyBle_stackMemoryHeap; it is not cleared at startup, as
+*  BlockPool_Init() writes every block it uses.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BLOCKPOOL_H)
+#define BLOCKPOOL_H
+
+#include <cytypes.h>
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Bytes a block of the given size takes in the storage, rounded to words */
+#define BLOCK_POOL_BLOCK_SIZE(size)     ((((size) + 3u) / 4u) * 4u)
+
+/* Storage words for count blocks of the given size */
+#define BLOCK_POOL_STORAGE_WORDS(size, count)   ((BLOCK_POOL_BLOCK_SIZE(size) / 4u) * (count))
+
+#define BLOCK_POOL_SECTION              ".blockpool"
+
+/* Declares static storage for count blocks of the given size */
+#if defined (__GNUC__) && !defined(__ARMCC_VERSION)
+    #define BLOCK_POOL_STORAGE(name, size, count) \
+        CY_SECTION(BLOCK_POOL_SECTION) static uint32 name[BLOCK_POOL_STORAGE_WORDS(size, count)]
+#else
+    #define BLOCK_POOL_STORAGE(name, size, count) \
+        static uint32 name[BLOCK_POOL_STORAGE_WORDS(size, count)]
+#endif /* defined (__GNUC__) && !defined(__ARMCC_VERSION) */
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    void *freeList;                     /* First free block */
+    uint32 blockSize;                   /* Bytes per block, word multiple */
+    uint32 count;                       /* Blocks in the storage */
+    uint32 available;                   /* Free blocks */
+    uint32 minAvailable;                /* Fewest free blocks seen */
+    uint32 failures;                    /* Allocations from an empty pool */
+} BLOCK_POOL_T;
+
+typedef struct
+{
+    uint32 blockSize;
+    uint32 count;
+    uint32 used;                        /* Blocks allocated now */
+    uint32 maxUsed;                     /* High-water mark of used */
+    uint32 failures;
+} BLOCK_POOL_STATS_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void BlockPool_Init(BLOCK_POOL_T *pool, uint32 storage[], uint32 blockSize, uint32 count);
+void *BlockPool_Alloc(BLOCK_POOL_T *pool);
+void BlockPool_Free(BLOCK_POOL_T *pool, void *block);
+uint32 BlockPool_Available(const BLOCK_POOL_T *pool);
+void BlockPool_GetStats(const BLOCK_POOL_T *pool, BLOCK_POOL_STATS_T *stats);
+
+#endif /* BLOCKPOOL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,140 @@
+/*******************************************************************************
+* File Name: bootprof.c
+*
+* Version 1.30
+*
+* Description:
+*  Boot phase profiler records. Both GCC linker scripts give the record block
+*  the same fixed slot of the .btldr_run section, which no startup code
+*  initializes, so it survives software resets and the switch between the
+*  Bootloader and HelloApp.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "bootprof.h"
+#include "timebase.h"
+
+#if (BOOT_PROFILE_ENABLED == YES)
+
+CY_SECTION(BOOT_PROFILE_SECTION)
+volatile BOOT_PROFILE_T bootProfile[BOOT_PROFILE_IMAGE_COUNT];
+
+static volatile BOOT_PROFILE_T *bootProfileCurrent;
+static void (*bootProfilePutString)(const char8 string[]);
+
+static const char8 * const bootPhaseName[BOOT_PHASE_COUNT] =
+{
+    "reset", "sram-init", "ble-start", "stack-on", "adv-start"
+};
+
+
+/*******************************************************************************
+* Function Name: BootProf_Begin()
+********************************************************************************
+*
+* Summary:
+*   Records the reset checkpoint of this boot. Starts the timebase if it is
+*   not running, so it must be the first call in main().
+*
+* Parameters:
+*   image - BOOT_PROFILE_IMAGE_BOOTLOADER or BOOT_PROFILE_IMAGE_APP
+*   putString - UART string output used to report the breakdown once the
+*               last checkpoint is recorded, NULL for no report
+*
+*******************************************************************************/
+void BootProf_Begin(uint32 image, void (*putString)(const char8 string[]))
+{
+    volatile BOOT_PROFILE_T *record = &bootProfile[image];
+
+    Timebase_Start();
+
+    if(record->magic != BOOT_PROFILE_MAGIC)
+    {
+        record->magic = BOOT_PROFILE_MAGIC;
+        record->bootCount = 0u;
+    }
+    record->bootCount++;
+    record->marked = 0u;
+    bootProfileCurrent = record;
+    bootProfilePutString = putString;
+
+    BootProf_Mark(BOOT_PHASE_RESET);
+}
+
+
+/*******************************************************************************
+* Function Name: BootProf_Mark()
+********************************************************************************
+*
+* Summary:
+*   Records a checkpoint. Only the first occurrence after BootProf_Begin()
+*   is kept, so it can be called from event handlers that run repeatedly.
+*
+* Parameters:
+*   phase - BOOT_PHASE_*
+*
+*******************************************************************************/
+void BootProf_Mark(uint32 phase)
+{
+    volatile BOOT_PROFILE_T *record = bootProfileCurrent;
+
+    if((record != NULL) && (0u == (record->marked & (1u << phase))))
+    {
+        record->ticks[phase] = Timebase_Now();
+        record->marked |= (1u << phase);
+
+        if((phase == (BOOT_PHASE_COUNT - 1u)) && (bootProfilePutString != NULL))
+        {
+            BootProf_Report();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BootProf_Report()
+********************************************************************************
+*
+* Summary:
+*   Prints the time of each recorded checkpoint relative to reset and the
+*   duration of the phase that ended there, using the output function given
+*   to BootProf_Begin().
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void BootProf_Report(void)
+{
+    volatile BOOT_PROFILE_T *record = bootProfileCurrent;
+    char8 line[64u];
+    uint32 previous;
+    uint32 phase;
+
+    if((record != NULL) && (bootProfilePutString != NULL))
+    {
+        previous = record->ticks[BOOT_PHASE_RESET];
+        for(phase = 0u; phase < BOOT_PHASE_COUNT; phase++)
+        {
+            if(0u != (record->marked & (1u << phase)))
+            {
+                (void) sprintf(line, "boot %-9s %6lu us (+%lu us)\r\n", bootPhaseName[phase],
+                    (unsigned long) TIMEBASE_TICKS_TO_US(record->ticks[phase] - record->ticks[BOOT_PHASE_RESET]),
+                    (unsigned long) TIMEBASE_TICKS_TO_US(record->ticks[phase] - previous));
+                bootProfilePutString(line);
+                previous = record->ticks[phase];
+            }
+        }
+    }
+}
+
+#endif /* (BOOT_PROFILE_ENABLED == YES) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,80 @@
+/*******************************************************************************
+* File Name: bootprof.h
+*
+* Version 1.30
+*
+* Description:
+*  Boot phase profiler. Each image records the timebase tick of every boot
+*  checkpoint in its own record of a retained block, so the breakdown of the
+*  last boot can be read after the device is up (debugger, UART report or a
+*  later boot). Define BOOT_PROFILE_ENABLED as NO in the project's Options.h
+*  to compile the checkpoints out; the retained slot stays reserved.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BOOTPROF_H)
+#define BOOTPROF_H
+
+#include <cytypes.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Checkpoints, in boot order */
+#define BOOT_PHASE_RESET                (0u)    /* Entry to main() */
+#define BOOT_PHASE_SRAM_INIT            (1u)    /* Bootloader RAM initialized */
+#define BOOT_PHASE_BLE_START            (2u)    /* CyBle_Start() called */
+#define BOOT_PHASE_STACK_ON             (3u)    /* CYBLE_EVT_STACK_ON */
+#define BOOT_PHASE_ADV_START            (4u)    /* First advertisement start completed */
+#define BOOT_PHASE_COUNT                (5u)
+
+/* Record index of each image in the retained block */
+#define BOOT_PROFILE_IMAGE_BOOTLOADER   (0u)
+#define BOOT_PROFILE_IMAGE_APP          (1u)
+#define BOOT_PROFILE_IMAGE_COUNT        (2u)
+
+#define BOOT_PROFILE_MAGIC              (0x46525042u)
+#define BOOT_PROFILE_SECTION            ".bootloaderruntype.bootprof"
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    uint32 magic;                       /* BOOT_PROFILE_MAGIC when valid */
+    uint32 bootCount;                   /* Boots since the record was created */
+    uint32 marked;                      /* Bit n set: ticks[n] is recorded */
+    uint32 ticks[BOOT_PHASE_COUNT];     /* Timebase tick of each checkpoint */
+} BOOT_PROFILE_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+#if (BOOT_PROFILE_ENABLED == YES)
+    void BootProf_Begin(uint32 image, void (*putString)(const char8 string[]));
+    void BootProf_Mark(uint32 phase);
+    void BootProf_Report(void);
+
+    extern volatile BOOT_PROFILE_T bootProfile[BOOT_PROFILE_IMAGE_COUNT];
+#else
+    #define BootProf_Begin(image, putString)
+    #define BootProf_Mark(phase)
+    #define BootProf_Report()
+#endif /* (BOOT_PROFILE_ENABLED == YES) */
+
+#endif /* BOOTPROF_H */
+
+
+/* [] END OF FILE */
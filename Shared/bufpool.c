@@ -0,0 +1,175 @@
+/*******************************************************************************
+* File Name: bufpool.c
+*
+* Version 1.30
+*
+* Description:
+*  Buffer pool; see bufpool.h. The class of a freed buffer is found from
+*  the storage range it lies in.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stddef.h>
+#include "bufpool.h"
+
+typedef struct
+{
+    uint32 *storage;
+    uint32 size;
+    uint32 count;
+} BUF_POOL_CLASS_T;
+
+#define BUF_POOL_STORAGE(size, count)   BLOCK_POOL_STORAGE(bufPoolStorage##size, size, count);
+#define BUF_POOL_CLASS(size, count)     { bufPoolStorage##size, (size), (count) },
+
+BUF_POOL_CLASSES(BUF_POOL_STORAGE)
+
+static const BUF_POOL_CLASS_T bufPoolClass[BUF_POOL_CLASS_COUNT] =
+{
+    BUF_POOL_CLASSES(BUF_POOL_CLASS)
+};
+
+static BLOCK_POOL_T bufPool[BUF_POOL_CLASS_COUNT];
+
+
+/*******************************************************************************
+* Function Name: BufPool_Start()
+********************************************************************************
+*
+* Summary:
+*   Fills every class with its blocks. Called before any buffer is
+*   allocated and before interrupts that allocate are enabled.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void BufPool_Start(void)
+{
+    uint32 i;
+
+    for(i = 0u; i < BUF_POOL_CLASS_COUNT; i++)
+    {
+        /* Classes must be listed smallest first */
+        CYASSERT((i == 0u) || (bufPoolClass[i - 1u].size < bufPoolClass[i].size));
+
+        BlockPool_Init(&bufPool[i], bufPoolClass[i].storage, bufPoolClass[i].size, bufPoolClass[i].count);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BufPool_Alloc()
+********************************************************************************
+*
+* Summary:
+*   Takes a buffer from the smallest class it fits in that has one free.
+*
+* Parameters:
+*   size - bytes needed
+*
+* Return:
+*   The word aligned buffer, NULL when no class can hold it.
+*
+*******************************************************************************/
+void *BufPool_Alloc(uint32 size)
+{
+    void *buffer = NULL;
+    uint32 i;
+
+    for(i = 0u; (buffer == NULL) && (i < BUF_POOL_CLASS_COUNT); i++)
+    {
+        if(size <= bufPool[i].blockSize)
+        {
+            buffer = BlockPool_Alloc(&bufPool[i]);
+        }
+    }
+
+    return buffer;
+}
+
+
+/*******************************************************************************
+* Function Name: BufPool_Free()
+********************************************************************************
+*
+* Summary:
+*   Returns a buffer to its class.
+*
+* Parameters:
+*   buffer - buffer from BufPool_Alloc(), NULL is ignored
+*
+*******************************************************************************/
+void BufPool_Free(void *buffer)
+{
+    const uint32 *word = (const uint32 *) buffer;
+    uint32 i;
+
+    for(i = 0u; i < BUF_POOL_CLASS_COUNT; i++)
+    {
+        if((word >= bufPoolClass[i].storage) &&
+           (word < &bufPoolClass[i].storage[BLOCK_POOL_STORAGE_WORDS(bufPoolClass[i].size, bufPoolClass[i].count)]))
+        {
+            BlockPool_Free(&bufPool[i], buffer);
+            break;
+        }
+    }
+
+    /* Not a buffer of this pool */
+    CYASSERT((buffer == NULL) || (i < BUF_POOL_CLASS_COUNT));
+}
+
+
+/*******************************************************************************
+* Function Name: BufPool_Available()
+********************************************************************************
+*
+* Summary:
+*   Returns the number of free buffers that can hold the given size.
+*
+* Parameters:
+*   size - bytes needed
+*
+*******************************************************************************/
+uint32 BufPool_Available(uint32 size)
+{
+    uint32 available = 0u;
+    uint32 i;
+
+    for(i = 0u; i < BUF_POOL_CLASS_COUNT; i++)
+    {
+        if(size <= bufPool[i].blockSize)
+        {
+            available += BlockPool_Available(&bufPool[i]);
+        }
+    }
+
+    return available;
+}
+
+
+/*******************************************************************************
+* Function Name: BufPool_GetStats()
+********************************************************************************
+*
+* Summary:
+*   Copies the counters of one class, with the high-water mark of buffers
+*   in use and the allocations that found the class empty.
+*
+* Parameters:
+*   classIndex - class, 0 for the smallest
+*   stats - receives the counters
+*
+*******************************************************************************/
+void BufPool_GetStats(uint32 classIndex, BLOCK_POOL_STATS_T *stats)
+{
+    BlockPool_GetStats(&bufPool[classIndex], stats);
+}
+
+
+/* [] END OF FILE */
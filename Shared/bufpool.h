@@ -0,0 +1,59 @@
+/*******************************************************************************
+* File Name: bufpool.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the buffer pool, a set
+*  of block pools (blockpool.h) with the block sizes and counts of
+*  BUF_POOL_CLASSES in the project's Options.h:
+*
+*   #define BUF_POOL_CLASSES(X) \
+*       X(32u,  8u) \
+*       X(160u, 2u)
+*
+*  Classes are listed smallest first. A buffer comes from the smallest
+*  class it fits in, or from the next larger one when that class is empty,
+*  so allocating takes at most one step per class. The storage of all
+*  classes is static and sized at compile time. Buffers may be allocated
+*  and freed from interrupt handlers.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BUFPOOL_H)
+#define BUFPOOL_H
+
+#include <cytypes.h>
+#include "Options.h"
+#include "blockpool.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+#define BUF_POOL_COUNT_CLASS(size, count)   + 1u
+
+/* Number of classes in BUF_POOL_CLASSES */
+#define BUF_POOL_CLASS_COUNT            (0u BUF_POOL_CLASSES(BUF_POOL_COUNT_CLASS))
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+
+void BufPool_Start(void);
+void *BufPool_Alloc(uint32 size);
+void BufPool_Free(void *buffer);
+uint32 BufPool_Available(uint32 size);
+void BufPool_GetStats(uint32 classIndex, BLOCK_POOL_STATS_T *stats);
+
+#endif /* BUFPOOL_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,229 @@
+/*******************************************************************************
+* File Name: bytering.c
+*
+* Version 1.30
+*
+* Description:
+*  Byte ring buffer; see bytering.h.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "bytering.h"
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Init()
+********************************************************************************
+*
+* Summary:
+*   Empties a ring and attaches its storage.
+*
+* Parameters:
+*  ring - ring to initialize
+*  buffer - storage of size bytes
+*  size - power of two
+*
+*******************************************************************************/
+void ByteRing_Init(BYTE_RING_T *ring, uint8 buffer[], uint32 size)
+{
+    ring->buffer = buffer;
+    ring->mask = size - 1u;
+    ring->head = 0u;
+    ring->tail = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Count()
+********************************************************************************
+*
+* Summary:
+*   Returns the number of bytes that can be read.
+*
+*******************************************************************************/
+uint32 ByteRing_Count(const BYTE_RING_T *ring)
+{
+    return ring->head - ring->tail;
+}
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Space()
+********************************************************************************
+*
+* Summary:
+*   Returns the number of bytes that can be written.
+*
+*******************************************************************************/
+uint32 ByteRing_Space(const BYTE_RING_T *ring)
+{
+    return (ring->mask + 1u) - (ring->head - ring->tail);
+}
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Write()
+********************************************************************************
+*
+* Summary:
+*   Appends as many bytes as fit.
+*
+* Parameters:
+*  ring - ring to write
+*  data - bytes to append
+*  length - number of bytes
+*
+* Return:
+*   Number of bytes appended.
+*
+*******************************************************************************/
+uint32 ByteRing_Write(BYTE_RING_T *ring, const uint8 data[], uint32 length)
+{
+    uint32 offset = ring->head & ring->mask;
+    uint32 first;
+
+    if(length > ByteRing_Space(ring))
+    {
+        length = ByteRing_Space(ring);
+    }
+
+    first = (ring->mask + 1u) - offset;
+    if(first > length)
+    {
+        first = length;
+    }
+    (void) memcpy(&ring->buffer[offset], data, first);
+    (void) memcpy(ring->buffer, &data[first], length - first);
+    ring->head += length;
+
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Peek()
+********************************************************************************
+*
+* Summary:
+*   Copies bytes from the read side without removing them.
+*
+* Parameters:
+*  ring - ring to read
+*  data - receives the bytes
+*  length - most bytes to copy
+*
+* Return:
+*   Number of bytes copied.
+*
+*******************************************************************************/
+uint32 ByteRing_Peek(const BYTE_RING_T *ring, uint8 data[], uint32 length)
+{
+    uint32 offset = ring->tail & ring->mask;
+    uint32 first;
+
+    if(length > ByteRing_Count(ring))
+    {
+        length = ByteRing_Count(ring);
+    }
+
+    first = (ring->mask + 1u) - offset;
+    if(first > length)
+    {
+        first = length;
+    }
+    (void) memcpy(data, &ring->buffer[offset], first);
+    (void) memcpy(&data[first], ring->buffer, length - first);
+
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Drop()
+********************************************************************************
+*
+* Summary:
+*   Removes bytes from the read side, e.g. once a peeked packet was sent.
+*
+* Parameters:
+*  ring - ring to read
+*  length - number of bytes, at most ByteRing_Count()
+*
+*******************************************************************************/
+void ByteRing_Drop(BYTE_RING_T *ring, uint32 length)
+{
+    ring->tail += length;
+}
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Read()
+********************************************************************************
+*
+* Summary:
+*   Copies and removes bytes from the read side.
+*
+* Parameters:
+*  ring - ring to read
+*  data - receives the bytes
+*  length - most bytes to read
+*
+* Return:
+*   Number of bytes read.
+*
+*******************************************************************************/
+uint32 ByteRing_Read(BYTE_RING_T *ring, uint8 data[], uint32 length)
+{
+    length = ByteRing_Peek(ring, data, length);
+    ByteRing_Drop(ring, length);
+
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: ByteRing_Chunk()
+********************************************************************************
+*
+* Summary:
+*   Decides how many bytes to send as the next packet: a full payload as
+*   soon as one is buffered, and a partial one only when the caller's flush
+*   latency has run out.
+*
+* Parameters:
+*  ring - ring to read
+*  payload - packet payload size
+*  flush - non-zero to send a partial packet
+*
+* Return:
+*   Packet length, 0 to wait for more data.
+*
+*******************************************************************************/
+uint32 ByteRing_Chunk(const BYTE_RING_T *ring, uint32 payload, uint32 flush)
+{
+    uint32 count = ByteRing_Count(ring);
+
+    if(count >= payload)
+    {
+        count = payload;
+    }
+    else if(0u == flush)
+    {
+        count = 0u;
+    }
+    else
+    {
+        /* Partial packet */
+    }
+
+    return count;
+}
+
+
+/* [] END OF FILE */
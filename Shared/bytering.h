@@ -0,0 +1,54 @@
+/*******************************************************************************
+* File Name: bytering.h
+*
+* Version 1.30
+*
+* Description:
+*  Byte ring buffer for streams between a peripheral and the BLE Stack, with
+*  one writer and one reader. The indices run free and are masked on access,
+*  so the size must be a power of two and a full ring needs no spare byte.
+*  Data moves with memcpy() in at most two pieces; no DMA is involved.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(BYTERING_H)
+#define BYTERING_H
+
+#include <cytypes.h>
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    uint8 *buffer;
+    uint32 mask;                        /* Size - 1 */
+    volatile uint32 head;               /* Bytes written since init */
+    volatile uint32 tail;               /* Bytes read since init */
+} BYTE_RING_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void ByteRing_Init(BYTE_RING_T *ring, uint8 buffer[], uint32 size);
+uint32 ByteRing_Count(const BYTE_RING_T *ring);
+uint32 ByteRing_Space(const BYTE_RING_T *ring);
+uint32 ByteRing_Write(BYTE_RING_T *ring, const uint8 data[], uint32 length);
+uint32 ByteRing_Peek(const BYTE_RING_T *ring, uint8 data[], uint32 length);
+void ByteRing_Drop(BYTE_RING_T *ring, uint32 length);
+uint32 ByteRing_Read(BYTE_RING_T *ring, uint8 data[], uint32 length);
+uint32 ByteRing_Chunk(const BYTE_RING_T *ring, uint32 payload, uint32 flush);
+
+#endif /* BYTERING_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,334 @@
+/*******************************************************************************
+* File Name: diaglog.c
+*
+* Version 1.30
+*
+* Description:
+*  Reset-surviving diagnostic log. Both GCC linker scripts give the log the
+*  same fixed slot of the .btldr_run section, which no startup code
+*  initializes. A record is written before the header that counts it, and
+*  the header is checked with its CRC at every boot, so a reset in the
+*  middle of an update loses at most that record.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stddef.h>
+#include <project.h>
+#include "diaglog.h"
+#include "timebase.h"
+
+#if (DIAG_LOG_ENABLED == YES)
+
+#define DIAG_LOG_MASK                   (DIAG_LOG_RECORDS - 1u)
+#define DIAG_LOG_CRC_SIZE               (offsetof(DIAG_LOG_HEADER_T, crc))
+
+#if ((DIAG_LOG_RECORDS & DIAG_LOG_MASK) != 0u)
+    #error DIAG_LOG_RECORDS must be a power of two
+#endif /* ((DIAG_LOG_RECORDS & DIAG_LOG_MASK) != 0u) */
+
+CY_SECTION(DIAG_LOG_SECTION)
+volatile DIAG_LOG_T diagLog;
+
+/* CRC-16/CCITT, one nibble per step */
+static const uint16 diagLogCrcTable[16u] =
+{
+    0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+    0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu
+};
+
+static const char8 * const diagResetName[] =
+{
+    "power", "software", "wdt", "fault", "hibernate"
+};
+
+static const char8 * const diagOtaName[] =
+{
+    "none", "in-progress", "success", "failed", "aborted"
+};
+
+static uint16 DiagLog_Crc(void);
+static void DiagLog_Seal(void);
+static uint32 DiagLog_ReadResetCause(void);
+static const char8 *DiagLog_EventName(uint32 event);
+
+
+/*******************************************************************************
+* Function Name: DiagLog_Crc()
+********************************************************************************
+*
+* Summary:
+*   Computes the CRC of the header fields.
+*
+*******************************************************************************/
+static uint16 DiagLog_Crc(void)
+{
+    const volatile uint8 *data = (const volatile uint8 *) &diagLog.header;
+    uint32 crc = 0xFFFFu;
+    uint32 i;
+
+    for(i = 0u; i < DIAG_LOG_CRC_SIZE; i++)
+    {
+        crc = ((crc << 4u) & 0xFFFFu) ^ diagLogCrcTable[((crc >> 12u) ^ ((uint32) data[i] >> 4u)) & 0x0Fu];
+        crc = ((crc << 4u) & 0xFFFFu) ^ diagLogCrcTable[((crc >> 12u) ^ (uint32) data[i]) & 0x0Fu];
+    }
+
+    return (uint16) crc;
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_Seal()
+********************************************************************************
+*
+* Summary:
+*   Updates the header CRC after a header change.
+*
+*******************************************************************************/
+static void DiagLog_Seal(void)
+{
+    diagLog.header.crc = DiagLog_Crc();
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_ReadResetCause()
+********************************************************************************
+*
+* Summary:
+*   Reads and clears the reset cause, so the next image sees only its own.
+*
+*******************************************************************************/
+static uint32 DiagLog_ReadResetCause(void)
+{
+    uint32 cause = CySysGetResetReason(CY_SYS_RESET_WDT | CY_SYS_RESET_PROTFAULT | CY_SYS_RESET_SW);
+    uint32 result = DIAG_RESET_POWER;
+
+    if(0u != (cause & CY_SYS_RESET_PROTFAULT))
+    {
+        result = DIAG_RESET_FAULT;
+    }
+    else if(0u != (cause & CY_SYS_RESET_WDT))
+    {
+        result = DIAG_RESET_WDT;
+    }
+    else if(0u != (cause & CY_SYS_RESET_SW))
+    {
+        result = DIAG_RESET_SOFTWARE;
+    }
+#if defined(CY_PM_RESET_REASON_WAKEUP_HIB)
+    else if(CySysPmGetResetReason() == CY_PM_RESET_REASON_WAKEUP_HIB)
+    {
+        result = DIAG_RESET_HIBERNATE;
+    }
+#endif /* defined(CY_PM_RESET_REASON_WAKEUP_HIB) */
+    else
+    {
+        /* Power-on, brown-out or XRES */
+    }
+
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_Begin()
+********************************************************************************
+*
+* Summary:
+*   Validates the retained log, starting a new one if the header is damaged,
+*   records the boot with its reset cause and settles an OTA session left
+*   in progress by the previous run: HelloApp starting means the new image
+*   was launched, the Bootloader starting again means it was not. Starts
+*   the timebase if it is not running.
+*
+* Parameters:
+*   image - DIAG_IMAGE_BOOTLOADER or DIAG_IMAGE_APP
+*
+*******************************************************************************/
+void DiagLog_Begin(uint32 image)
+{
+    uint32 cause = DiagLog_ReadResetCause();
+
+    Timebase_Start();
+
+    if((diagLog.header.magic != DIAG_LOG_MAGIC) || (diagLog.header.crc != DiagLog_Crc()))
+    {
+        diagLog.header.magic = DIAG_LOG_MAGIC;
+        diagLog.header.sequence = 0u;
+        diagLog.header.bootCount = 0u;
+        diagLog.header.otaState = (uint8) DIAG_OTA_NONE;
+        diagLog.header.reserved = 0u;
+    }
+    diagLog.header.bootCount++;
+    diagLog.header.resetCause = (uint8) cause;
+    diagLog.header.image = (uint8) image;
+    DiagLog_Seal();
+
+    DiagLog_Append(DIAG_EVT_BOOT, cause);
+
+    if(diagLog.header.otaState == DIAG_OTA_IN_PROGRESS)
+    {
+        DiagLog_Append((image == DIAG_IMAGE_APP) ? DIAG_EVT_OTA_DONE : DIAG_EVT_OTA_FAIL, 0u);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_Append()
+********************************************************************************
+*
+* Summary:
+*   Writes an event over the oldest record. OTA events also update the
+*   session state in the header.
+*
+* Parameters:
+*   event - DIAG_EVT_*
+*   arg - event argument, see diaglog.h
+*
+*******************************************************************************/
+void DiagLog_Append(uint32 event, uint32 arg)
+{
+    volatile DIAG_LOG_RECORD_T *record;
+    uint32 stamp = Timebase_Now();
+    uint32 sequence;
+    uint8 interruptStatus;
+
+    interruptStatus = CyEnterCriticalSection();
+    sequence = diagLog.header.sequence;
+    record = &diagLog.record[sequence & DIAG_LOG_MASK];
+    record->stamp = stamp;
+    record->arg = (uint16) arg;
+    record->event = (uint8) event;
+    record->tag = (uint8) sequence;
+
+    diagLog.header.sequence = sequence + 1u;
+    switch(event)
+    {
+        case DIAG_EVT_OTA_START:
+            diagLog.header.otaState = (uint8) DIAG_OTA_IN_PROGRESS;
+            break;
+        case DIAG_EVT_OTA_DONE:
+            diagLog.header.otaState = (uint8) DIAG_OTA_SUCCESS;
+            break;
+        case DIAG_EVT_OTA_FAIL:
+        case DIAG_EVT_OTA_AUTH_FAIL:
+            diagLog.header.otaState = (uint8) DIAG_OTA_FAILED;
+            break;
+        case DIAG_EVT_OTA_ABORT:
+            diagLog.header.otaState = (uint8) DIAG_OTA_ABORTED;
+            break;
+        case DIAG_EVT_OTA_RESUME:
+            /* The host reconnected and continues the session */
+            if(diagLog.header.otaState == DIAG_OTA_ABORTED)
+            {
+                diagLog.header.otaState = (uint8) DIAG_OTA_IN_PROGRESS;
+            }
+            break;
+        default:
+            break;
+    }
+    DiagLog_Seal();
+    CyExitCriticalSection(interruptStatus);
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_GetOtaState()
+********************************************************************************
+*
+* Summary:
+*   Returns the state of the last OTA session.
+*
+* Return:
+*   DIAG_OTA_*
+*
+*******************************************************************************/
+uint32 DiagLog_GetOtaState(void)
+{
+    return diagLog.header.otaState;
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_EventName()
+********************************************************************************
+*
+* Summary:
+*   Returns the report name of an event.
+*
+*******************************************************************************/
+static const char8 *DiagLog_EventName(uint32 event)
+{
+    const char8 *name;
+
+    switch(event)
+    {
+        case DIAG_EVT_BOOT:             name = "boot";          break;
+        case DIAG_EVT_CONNECTED:        name = "connected";     break;
+        case DIAG_EVT_DISCONNECTED:     name = "disconnected";  break;
+        case DIAG_EVT_HW_ERROR:         name = "hw-error";      break;
+        case DIAG_EVT_HIBERNATE:        name = "hibernate";     break;
+        case DIAG_EVT_LOAD_BOOTLOADER:  name = "load-btldr";    break;
+        case DIAG_EVT_OTA_START:        name = "ota-start";     break;
+        case DIAG_EVT_OTA_DONE:         name = "ota-done";      break;
+        case DIAG_EVT_OTA_FAIL:         name = "ota-fail";      break;
+        case DIAG_EVT_OTA_ABORT:        name = "ota-abort";     break;
+        case DIAG_EVT_OTA_REFUSED:      name = "ota-refused";   break;
+        case DIAG_EVT_OTA_RESUME:       name = "ota-resume";    break;
+        case DIAG_EVT_OTA_AUTH_FAIL:    name = "ota-auth-fail"; break;
+        default:                        name = "?";             break;
+    }
+
+    return name;
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_Report()
+********************************************************************************
+*
+* Summary:
+*   Prints the header and the retained events, oldest first. The events
+*   before this boot's "boot" record tell why the previous run ended.
+*
+* Parameters:
+*   putString - UART string output function of the project
+*
+*******************************************************************************/
+void DiagLog_Report(void (*putString)(const char8 string[]))
+{
+    char8 line[64u];
+    uint32 sequence = diagLog.header.sequence;
+    uint32 first = (sequence > DIAG_LOG_RECORDS) ? (sequence - DIAG_LOG_RECORDS) : 0u;
+    uint32 i;
+
+    (void) sprintf(line, "diag boot %u, reset %s, last ota %s\r\n",
+        (unsigned int) diagLog.header.bootCount,
+        diagResetName[diagLog.header.resetCause % (sizeof(diagResetName) / sizeof(diagResetName[0u]))],
+        diagOtaName[diagLog.header.otaState % (sizeof(diagOtaName) / sizeof(diagOtaName[0u]))]);
+    putString(line);
+
+    for(i = first; i != sequence; i++)
+    {
+        volatile DIAG_LOG_RECORD_T *record = &diagLog.record[i & DIAG_LOG_MASK];
+
+        /* Skip a record overwritten by an update cut short by a reset */
+        if(record->tag == (uint8) i)
+        {
+            (void) sprintf(line, "diag %5lu %08lX %-12s %04X\r\n", (unsigned long) i,
+                (unsigned long) record->stamp, DiagLog_EventName(record->event), (unsigned int) record->arg);
+            putString(line);
+        }
+    }
+}
+
+#endif /* (DIAG_LOG_ENABLED == YES) */
+
+
+/* [] END OF FILE */
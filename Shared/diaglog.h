@@ -0,0 +1,128 @@
+/*******************************************************************************
+* File Name: diaglog.h
+*
+* Version 1.30
+*
+* Description:
+*  Reset-surviving diagnostic log. A header protected by a CRC and a ring of
+*  the last DIAG_LOG_RECORDS events live in a retained block shared by the
+*  Bootloader and HelloApp, so the next boot of either image can report the
+*  reset cause, the outcome of the last OTA session and the events that led
+*  to the reset. Only RAM is written. Define DIAG_LOG_ENABLED as NO in the
+*  project's Options.h to compile the calls out; the retained slot stays
+*  reserved.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(DIAGLOG_H)
+#define DIAGLOG_H
+
+#include <cytypes.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Both images must agree on the layout, so the size is not a project option */
+#define DIAG_LOG_RECORDS                (16u)    /* Power of two */
+#define DIAG_LOG_MAGIC                  (0x47414944u)
+#define DIAG_LOG_SECTION                ".bootloaderruntype.diaglog"
+
+/* Images */
+#define DIAG_IMAGE_BOOTLOADER           (0u)
+#define DIAG_IMAGE_APP                  (1u)
+
+/* Reset causes, recorded by DiagLog_Begin() */
+#define DIAG_RESET_POWER                (0u)    /* Power-on, brown-out or XRES */
+#define DIAG_RESET_SOFTWARE             (1u)
+#define DIAG_RESET_WDT                  (2u)
+#define DIAG_RESET_FAULT                (3u)    /* Protection fault */
+#define DIAG_RESET_HIBERNATE            (4u)    /* Wakeup from Hibernate */
+
+/* OTA session states */
+#define DIAG_OTA_NONE                   (0u)
+#define DIAG_OTA_IN_PROGRESS            (1u)
+#define DIAG_OTA_SUCCESS                (2u)    /* HelloApp started after the session */
+#define DIAG_OTA_FAILED                 (3u)    /* Bootloader restarted, image not launched */
+#define DIAG_OTA_ABORTED                (4u)    /* Host disconnected during the session */
+
+/* Events and the meaning of their argument */
+#define DIAG_EVT_BOOT                   (0x01u) /* DIAG_RESET_* */
+#define DIAG_EVT_CONNECTED              (0x02u) /* Connection interval */
+#define DIAG_EVT_DISCONNECTED           (0x03u) /* HCI reason */
+#define DIAG_EVT_HW_ERROR               (0x04u) /* Error code */
+#define DIAG_EVT_HIBERNATE              (0x05u) /* - */
+#define DIAG_EVT_LOAD_BOOTLOADER        (0x06u) /* DIAG_LOAD_* */
+#define DIAG_EVT_OTA_START              (0x10u) /* ms from connection to the first command */
+#define DIAG_EVT_OTA_DONE               (0x11u) /* - */
+#define DIAG_EVT_OTA_FAIL               (0x12u) /* - */
+#define DIAG_EVT_OTA_ABORT              (0x13u) /* HCI reason */
+#define DIAG_EVT_OTA_REFUSED            (0x14u) /* Battery mV */
+#define DIAG_EVT_OTA_RESUME             (0x15u) /* ms from the disconnect */
+#define DIAG_EVT_OTA_AUTH_FAIL          (0x16u) /* IMAGE_AUTH_FAIL_* (Bootloader.cydsn\imageauth.h) */
+
+/* Reasons for DIAG_EVT_LOAD_BOOTLOADER */
+#define DIAG_LOAD_BUTTON                (0u)
+#define DIAG_LOAD_INCOMPATIBLE          (1u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct
+{
+    uint32 stamp;                       /* Timebase tick, valid within one run */
+    uint16 arg;
+    uint8  event;                       /* DIAG_EVT_* */
+    uint8  tag;                         /* Low byte of the record's sequence */
+} DIAG_LOG_RECORD_T;
+
+typedef struct
+{
+    uint32 magic;                       /* DIAG_LOG_MAGIC when valid */
+    uint32 sequence;                    /* Records written since the log was created */
+    uint16 bootCount;
+    uint8  resetCause;                  /* DIAG_RESET_* of the current run */
+    uint8  otaState;                    /* DIAG_OTA_* */
+    uint8  image;                       /* DIAG_IMAGE_* of the current run */
+    uint8  reserved;
+    uint16 crc;                         /* CRC-16/CCITT of the fields above */
+} DIAG_LOG_HEADER_T;
+
+typedef struct
+{
+    DIAG_LOG_HEADER_T header;
+    DIAG_LOG_RECORD_T record[DIAG_LOG_RECORDS];
+} DIAG_LOG_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+#if (DIAG_LOG_ENABLED == YES)
+    void DiagLog_Begin(uint32 image);
+    void DiagLog_Append(uint32 event, uint32 arg);
+    uint32 DiagLog_GetOtaState(void);
+    void DiagLog_Report(void (*putString)(const char8 string[]));
+
+    extern volatile DIAG_LOG_T diagLog;
+#else
+    #define DiagLog_Begin(image)
+    #define DiagLog_Append(event, arg)
+    #define DiagLog_GetOtaState()       (DIAG_OTA_NONE)
+    #define DiagLog_Report(putString)
+#endif /* (DIAG_LOG_ENABLED == YES) */
+
+#endif /* DIAGLOG_H */
+
+
+/* [] END OF FILE */
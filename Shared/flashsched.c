@@ -0,0 +1,208 @@
+/*******************************************************************************
+* File Name: flashsched.c
+*
+* Version 1.30
+*
+* Description:
+*  Deferred flash writes; see flashsched.h. A row write stops the CPU for
+*  several milliseconds, so each FlashSched_Task() call makes at most one
+*  write and the BLE Stack data goes first.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "main.h"
+#include "flashsched.h"
+
+typedef struct
+{
+    const uint8 *src;
+    const uint8 *dest;                  /* NULL when the slot is free */
+    uint32 length;
+} FLASH_SCHED_SLOT_T;
+
+static FLASH_SCHED_SLOT_T flashSchedSlot[FLASH_SCHED_APP_SLOTS];
+static uint32 flashSchedHold;
+static uint32 flashSchedConnIntv;
+
+
+/*******************************************************************************
+* Function Name: FlashSched_Post()
+********************************************************************************
+*
+* Summary:
+*   Queues an application record. The source must stay valid and may still
+*   change until the record is written; a record for a destination that is
+*   already queued replaces it.
+*
+* Parameters:
+*   src - data to write
+*   dest - flash destination, in a row used only by this record
+*   length - number of bytes
+*
+* Return:
+*   Non-zero when queued, zero when all slots are taken.
+*
+*******************************************************************************/
+uint32 FlashSched_Post(const uint8 src[], const uint8 dest[], uint32 length)
+{
+    uint32 i;
+    uint32 free = FLASH_SCHED_APP_SLOTS;
+
+    for(i = 0u; i < FLASH_SCHED_APP_SLOTS; i++)
+    {
+        if(flashSchedSlot[i].dest == dest)
+        {
+            free = i;
+            break;
+        }
+        if((flashSchedSlot[i].dest == NULL) && (free == FLASH_SCHED_APP_SLOTS))
+        {
+            free = i;
+        }
+    }
+
+    if(free == FLASH_SCHED_APP_SLOTS)
+    {
+        return 0u;
+    }
+
+    flashSchedSlot[free].src = src;
+    flashSchedSlot[free].dest = dest;
+    flashSchedSlot[free].length = length;
+
+    return 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: FlashSched_Hold()
+********************************************************************************
+*
+* Summary:
+*   Holds or releases the queued writes.
+*
+* Parameters:
+*   hold - non-zero to hold
+*
+*******************************************************************************/
+void FlashSched_Hold(uint32 hold)
+{
+    flashSchedHold = hold;
+}
+
+
+/*******************************************************************************
+* Function Name: FlashSched_SetConnInterval()
+********************************************************************************
+*
+* Summary:
+*   Sets the interval of the current connection. Called on
+*   CYBLE_EVT_GAP_DEVICE_CONNECTED and on
+*   CYBLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE.
+*
+* Parameters:
+*   connIntv - connection interval in 1.25 ms units
+*
+*******************************************************************************/
+void FlashSched_SetConnInterval(uint32 connIntv)
+{
+    flashSchedConnIntv = connIntv;
+}
+
+
+/*******************************************************************************
+* Function Name: FlashSched_Pending()
+********************************************************************************
+*
+* Summary:
+*   Reports whether writes are waiting.
+*
+* Return:
+*   Non-zero when the BLE Stack or the application has data to write.
+*
+*******************************************************************************/
+uint32 FlashSched_Pending(void)
+{
+    uint32 pending = (0u != cyBle_pendingFlashWrite) ? 1u : 0u;
+    uint32 i;
+
+    for(i = 0u; i < FLASH_SCHED_APP_SLOTS; i++)
+    {
+        if(flashSchedSlot[i].dest != NULL)
+        {
+            pending = 1u;
+        }
+    }
+
+    return pending;
+}
+
+
+/*******************************************************************************
+* Function Name: FlashSched_Task()
+********************************************************************************
+*
+* Summary:
+*   Makes one queued write if this is an idle window. Called from the main
+*   loop after CyBle_ProcessEvents(), before the device goes to sleep.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void FlashSched_Task(void)
+{
+    CYBLE_BLESS_STATE_T blessState;
+    CYBLE_API_RESULT_T result;
+    uint8 force = 0u;
+    uint32 i;
+
+    if((0u != flashSchedHold) || (0u == FlashSched_Pending()))
+    {
+        return;
+    }
+
+    if(CyBle_GetState() == CYBLE_STATE_CONNECTED)
+    {
+        /* The next connection event must be further away than a row write.
+         * That is known only right after an event has closed; in Sleep or
+         * Deep-Sleep the next anchor may already be close.
+         */
+        blessState = CyBle_GetBleSsState();
+        if((flashSchedConnIntv < FLASH_SCHED_CONN_INTV_MIN) ||
+           (blessState != CYBLE_BLESS_STATE_EVENT_CLOSE))
+        {
+            return;
+        }
+        force = 1u;
+    }
+
+    if(0u != cyBle_pendingFlashWrite)
+    {
+        (void) CyBle_StoreBondingData(force);
+    }
+    else
+    {
+        for(i = 0u; i < FLASH_SCHED_APP_SLOTS; i++)
+        {
+            if(flashSchedSlot[i].dest != NULL)
+            {
+                result = CyBle_StoreAppData((uint8 *) flashSchedSlot[i].src, flashSchedSlot[i].dest,
+                                            flashSchedSlot[i].length, force);
+                if(result != CYBLE_ERROR_FLASH_WRITE_NOT_PERMITED)
+                {
+                    flashSchedSlot[i].dest = NULL;
+                }
+                break;
+            }
+        }
+    }
+}
+
+
+/* [] END OF FILE */
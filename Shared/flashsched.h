@@ -0,0 +1,53 @@
+/*******************************************************************************
+* File Name: flashsched.h
+*
+* Version 1.30
+*
+* Description:
+*  Deferred flash writes. Bonding and CCCD data that the BLE Stack marks in
+*  cyBle_pendingFlashWrite, and application records posted with
+*  FlashSched_Post(), are written one at a time from the main loop, only
+*  when the write cannot delay a connection event:
+*   - while not connected, or
+*   - while connected with an interval of at least FLASH_SCHED_CONN_INTV_MIN,
+*     right after a connection event has closed.
+*  Nothing is written while the application holds the scheduler, e.g.
+*  during an OTA session. Posting the same destination again replaces the
+*  queued write.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(FLASHSCHED_H)
+#define FLASHSCHED_H
+
+#include <cytypes.h>
+#include "Options.h"
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Application records that can be queued at the same time */
+#define FLASH_SCHED_APP_SLOTS           (2u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+uint32 FlashSched_Post(const uint8 src[], const uint8 dest[], uint32 length);
+void FlashSched_Hold(uint32 hold);
+void FlashSched_SetConnInterval(uint32 connIntv);
+uint32 FlashSched_Pending(void);
+void FlashSched_Task(void);
+
+#endif /* FLASHSCHED_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,135 @@
+/*******************************************************************************
+* File Name: gattsig.c
+*
+* Version 1.30
+*
+* Description:
+*  Signature of the visible GATT database and its record in flash. The
+*  record is written through the flash write scheduler (flashsched.h).
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "main.h"
+#include "gattsig.h"
+#include "flashsched.h"
+
+#define GATT_SIG_FNV_OFFSET             (0x811C9DC5u)
+#define GATT_SIG_FNV_PRIME              (0x01000193u)
+
+#if (SHARED_API_EXPORT != 0u)
+    /* Erased (zero) until the first client connects; the check fails then */
+    CY_ALIGN(GATT_SIG_ROW_SIZE)
+    const GATT_SIG_ROW_T gattSigRow = { 0u, 0u, { 0u } };
+#endif /* (SHARED_API_EXPORT != 0u) */
+
+/* Latest record; holds a valid check once a record has been posted */
+static uint32 gattSigStore[2u];
+
+
+/*******************************************************************************
+* Function Name: GattSig_Compute()
+********************************************************************************
+*
+* Summary:
+*   Computes the signature of a set of services: FNV-1a over the handle of
+*   each service and whether it is enabled.
+*
+* Parameters:
+*   serviceHandle - service declaration handles, in a fixed order
+*   count - number of handles
+*   enabledMask - bit n set when serviceHandle[n] is enabled
+*
+* Return:
+*   The signature.
+*
+*******************************************************************************/
+uint32 GattSig_Compute(const uint16 serviceHandle[], uint32 count, uint32 enabledMask)
+{
+    uint32 hash = GATT_SIG_FNV_OFFSET;
+    uint32 i;
+
+    for(i = 0u; i < count; i++)
+    {
+        hash = (hash ^ (serviceHandle[i] & 0xFFu)) * GATT_SIG_FNV_PRIME;
+        hash = (hash ^ (uint32) (serviceHandle[i] >> 8u)) * GATT_SIG_FNV_PRIME;
+        hash = (hash ^ ((enabledMask >> i) & 0x01u)) * GATT_SIG_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+
+/*******************************************************************************
+* Function Name: GattSig_Matches()
+********************************************************************************
+*
+* Summary:
+*   Checks whether a client last connected to the database with this
+*   signature. A record that has not reached flash yet counts.
+*
+* Parameters:
+*   signature - signature of the database this image shows
+*
+* Return:
+*   Non-zero when the signatures match.
+*
+*******************************************************************************/
+uint32 GattSig_Matches(uint32 signature)
+{
+    uint32 stored;
+    uint32 valid;
+
+    if(gattSigStore[1u] == ~gattSigStore[0u])
+    {
+        stored = gattSigStore[0u];
+        valid = 1u;
+    }
+    else
+    {
+        stored = gattSigRow.signature;
+        valid = (gattSigRow.check == ~stored) ? 1u : 0u;
+    }
+
+    return ((0u != valid) && (stored == signature)) ? 1u : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: GattSig_Seen()
+********************************************************************************
+*
+* Summary:
+*   Records that a client has connected to the database with this
+*   signature. Called on CYBLE_EVT_GAP_DEVICE_CONNECTED; the record is
+*   queued for flash only when it changes.
+*
+* Parameters:
+*   signature - signature of the database this image shows
+*
+*******************************************************************************/
+void GattSig_Seen(uint32 signature)
+{
+    uint32 saved[2u];
+
+    if(0u == GattSig_Matches(signature))
+    {
+        saved[0u] = gattSigStore[0u];
+        saved[1u] = gattSigStore[1u];
+        gattSigStore[0u] = signature;
+        gattSigStore[1u] = ~signature;
+        if(0u == FlashSched_Post((const uint8 *) gattSigStore, (const uint8 *) &gattSigRow, sizeof(gattSigStore)))
+        {
+            /* Queue full: the next connection tries again */
+            gattSigStore[0u] = saved[0u];
+            gattSigStore[1u] = saved[1u];
+        }
+    }
+}
+
+
+/* [] END OF FILE */
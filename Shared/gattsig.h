@@ -0,0 +1,74 @@
+/*******************************************************************************
+* File Name: gattsig.h
+*
+* Version 1.30
+*
+* Description:
+*  Signature of the visible GATT database. The Bootloader and HelloApp share
+*  one GATT database but enable different services. The signature of the
+*  database a client last connected to is kept in a flash row owned by the
+*  Bootloader, so the Bootloader only asks for rediscovery through Service
+*  Changed when the database it shows differs from that one.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(GATTSIG_H)
+#define GATTSIG_H
+
+#include <cytypes.h>
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Flash row of PSoC 4 BLE; the stored record takes a whole row so that
+ * writing it does not erase anything else.
+ */
+#define GATT_SIG_ROW_SIZE               (128u)
+
+/* Services both images pass to GattSig_Compute(), in this order: HID, DIS,
+ * BAS, SCPS, Bootloader Service. The masks give the services each image
+ * keeps enabled.
+ */
+#define GATT_SIG_SERVICE_COUNT          (5u)
+#define GATT_SIG_MASK_BOOTLOADER        (0x10u)
+#define GATT_SIG_MASK_APP               (0x1Fu)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+typedef struct GATT_SIG_ROW_S
+{
+    uint32 signature;                   /* Database a client last connected to */
+    uint32 check;                       /* ~signature when the record is valid */
+    uint8  reserved[GATT_SIG_ROW_SIZE - 8u];
+} GATT_SIG_ROW_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+uint32 GattSig_Compute(const uint16 serviceHandle[], uint32 count, uint32 enabledMask);
+uint32 GattSig_Matches(uint32 signature);
+void GattSig_Seen(uint32 signature);
+
+/* Defined by the Bootloader. In HelloApp gattSigRow is the shared API
+ * macro of sharedapi.h, which reaches the Bootloader's record.
+ */
+#if !defined(gattSigRow)
+    extern const GATT_SIG_ROW_T gattSigRow;
+#endif /* !defined(gattSigRow) */
+
+#endif /* GATTSIG_H */
+
+
+/* [] END OF FILE */
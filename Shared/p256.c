@@ -0,0 +1,850 @@
+/*******************************************************************************
+* File Name: p256.c
+*
+* Version: 1.30
+*
+* Description:
+*  ECDSA over NIST P-256 with a SHA-256 digest; see p256.h. Numbers are
+*  sixteen 16-bit digits, least significant first, so that every product
+*  and its carries fit a uint32 and the Cortex-M0 needs no 64-bit
+*  multiplication. Arithmetic modulo the field prime p and the group order
+*  n is done in Montgomery form, R = 2^256, with one multiplication for
+*  both moduli; points are in Jacobian coordinates. Verification handles
+*  public data only and is not constant time; neither is signing, which
+*  only runs on the host that holds the private key. The nonce of a
+*  signature is derived from the key and the digest as in RFC 6979.
+*
+*  The code only depends on cytypes.h and sha256.h so the same file is
+*  compiled into the firmware and into the host tools.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <string.h>
+#include "p256.h"
+#include "sha256.h"
+
+#define P256_DIGITS             (16u)
+#define P256_BYTES              (32u)
+#define P256_BITS               (256u)
+
+/* RFC 6979 tries before giving up; one is needed except once in 2^32 */
+#define P256_SIGN_TRIES         (16u)
+
+
+/***************************************
+*       Data Types
+***************************************/
+typedef struct
+{
+    uint16 m[P256_DIGITS];              /* Modulus */
+    uint16 rr[P256_DIGITS];             /* R^2 mod m */
+    uint16 mInv;                        /* -1/m mod 2^16 */
+} P256_MOD_T;
+
+/* Jacobian (X / Z^2, Y / Z^3) in Montgomery form; Z = 0 is the point at infinity */
+typedef struct
+{
+    uint16 x[P256_DIGITS];
+    uint16 y[P256_DIGITS];
+    uint16 z[P256_DIGITS];
+} P256_POINT_T;
+
+
+/***************************************
+*       Curve constants
+***************************************/
+static const P256_MOD_T p256P =
+{
+    { 0xFFFFu, 0xFFFFu, 0xFFFFu, 0xFFFFu, 0xFFFFu, 0xFFFFu, 0x0000u, 0x0000u,
+      0x0000u, 0x0000u, 0x0000u, 0x0000u, 0x0001u, 0x0000u, 0xFFFFu, 0xFFFFu },
+    { 0x0003u, 0x0000u, 0x0000u, 0x0000u, 0xFFFFu, 0xFFFFu, 0xFFFBu, 0xFFFFu,
+      0xFFFEu, 0xFFFFu, 0xFFFFu, 0xFFFFu, 0xFFFDu, 0xFFFFu, 0x0004u, 0x0000u },
+    0x0001u
+};
+
+static const P256_MOD_T p256N =
+{
+    { 0x2551u, 0xFC63u, 0xCAC2u, 0xF3B9u, 0x9E84u, 0xA717u, 0xFAADu, 0xBCE6u,
+      0xFFFFu, 0xFFFFu, 0xFFFFu, 0xFFFFu, 0x0000u, 0x0000u, 0xFFFFu, 0xFFFFu },
+    { 0xEEA2u, 0xBE79u, 0x4C95u, 0x8324u, 0x6FA6u, 0x49BDu, 0x799Cu, 0x4699u,
+      0xEC59u, 0x2B6Bu, 0xB239u, 0x2845u, 0x5620u, 0xF3D9u, 0x2D94u, 0x66E1u },
+    0xBC4Fu
+};
+
+static const uint16 p256B[P256_DIGITS] =
+{
+    0x604Bu, 0x27D2u, 0x3C3Eu, 0x3BCEu, 0xB0F6u, 0xCC53u, 0x06B0u, 0x651Du,
+    0x86BCu, 0x7698u, 0xBD55u, 0xB3EBu, 0x93E7u, 0xAA3Au, 0x35D8u, 0x5AC6u
+};
+
+static const uint16 p256Gx[P256_DIGITS] =
+{
+    0xC296u, 0xD898u, 0x3945u, 0xF4A1u, 0x33A0u, 0x2DEBu, 0x7D81u, 0x7703u,
+    0x40F2u, 0x63A4u, 0xE6E5u, 0xF8BCu, 0x4247u, 0xE12Cu, 0xD1F2u, 0x6B17u
+};
+
+static const uint16 p256Gy[P256_DIGITS] =
+{
+    0x51F5u, 0x37BFu, 0x4068u, 0xCBB6u, 0x5ECEu, 0x6B31u, 0x3357u, 0x2BCEu,
+    0x9E16u, 0x7C0Fu, 0xEB4Au, 0x8EE7u, 0x7F9Bu, 0xFE1Au, 0x42E2u, 0x4FE3u
+};
+
+static void   P256_FromBytes(uint16 r[], const uint8 bytes[]);
+static void   P256_ToBytes(uint8 bytes[], const uint16 a[]);
+static int32  P256_Compare(const uint16 a[], const uint16 b[]);
+static uint32 P256_IsZero(const uint16 a[]);
+static uint32 P256_Add(uint16 r[], const uint16 a[], const uint16 b[]);
+static uint32 P256_Sub(uint16 r[], const uint16 a[], const uint16 b[]);
+static void   P256_ModAdd(uint16 r[], const uint16 a[], const uint16 b[], const P256_MOD_T *mod);
+static void   P256_ModSub(uint16 r[], const uint16 a[], const uint16 b[], const P256_MOD_T *mod);
+static void   P256_ModMul(uint16 r[], const uint16 a[], const uint16 b[], const P256_MOD_T *mod);
+static void   P256_ModOne(uint16 r[], const P256_MOD_T *mod);
+static void   P256_ModInv(uint16 r[], const uint16 a[], const P256_MOD_T *mod);
+static void   P256_Double(P256_POINT_T *r, const P256_POINT_T *a);
+static void   P256_AddPoint(P256_POINT_T *r, const P256_POINT_T *a, const P256_POINT_T *b);
+static void   P256_MulAdd(P256_POINT_T *r, const uint16 u1[], const uint16 u2[], const P256_POINT_T *q);
+static uint32 P256_Affine(uint16 x[], uint16 y[], const P256_POINT_T *a);
+static uint32 P256_LoadPoint(P256_POINT_T *r, const uint8 publicKey[]);
+
+
+/*******************************************************************************
+* Function Name: P256_FromBytes()
+********************************************************************************
+*
+* Summary:
+*   Converts 32 big-endian bytes to digits.
+*
+*******************************************************************************/
+static void P256_FromBytes(uint16 r[], const uint8 bytes[])
+{
+    uint32 i;
+
+    for(i = 0u; i < P256_DIGITS; i++)
+    {
+        r[i] = (uint16) (((uint32) bytes[P256_BYTES - 2u - (2u * i)] << 8u) |
+                         (uint32) bytes[P256_BYTES - 1u - (2u * i)]);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: P256_ToBytes()
+********************************************************************************
+*
+* Summary:
+*   Converts digits to 32 big-endian bytes.
+*
+*******************************************************************************/
+static void P256_ToBytes(uint8 bytes[], const uint16 a[])
+{
+    uint32 i;
+
+    for(i = 0u; i < P256_DIGITS; i++)
+    {
+        bytes[P256_BYTES - 2u - (2u * i)] = (uint8) (a[i] >> 8u);
+        bytes[P256_BYTES - 1u - (2u * i)] = (uint8) a[i];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: P256_Compare()
+********************************************************************************
+*
+* Return:
+*   Negative, zero or positive as a is below, equal to or above b.
+*
+*******************************************************************************/
+static int32 P256_Compare(const uint16 a[], const uint16 b[])
+{
+    uint32 i = P256_DIGITS;
+
+    while(i != 0u)
+    {
+        i--;
+        if(a[i] != b[i])
+        {
+            return (a[i] < b[i]) ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: P256_IsZero()
+********************************************************************************
+*
+* Return:
+*   Non-zero if every digit is zero.
+*
+*******************************************************************************/
+static uint32 P256_IsZero(const uint16 a[])
+{
+    uint32 bits = 0u;
+    uint32 i;
+
+    for(i = 0u; i < P256_DIGITS; i++)
+    {
+        bits |= a[i];
+    }
+
+    return (uint32) (bits == 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: P256_Add()
+********************************************************************************
+*
+* Summary:
+*   r = a + b; r may be a or b.
+*
+* Return:
+*   The carry out of the top digit.
+*
+*******************************************************************************/
+static uint32 P256_Add(uint16 r[], const uint16 a[], const uint16 b[])
+{
+    uint32 sum = 0u;
+    uint32 i;
+
+    for(i = 0u; i < P256_DIGITS; i++)
+    {
+        sum += (uint32) a[i] + (uint32) b[i];
+        r[i] = (uint16) sum;
+        sum >>= 16u;
+    }
+
+    return sum;
+}
+
+
+/*******************************************************************************
+* Function Name: P256_Sub()
+********************************************************************************
+*
+* Summary:
+*   r = a - b; r may be a or b.
+*
+* Return:
+*   The borrow out of the top digit.
+*
+*******************************************************************************/
+static uint32 P256_Sub(uint16 r[], const uint16 a[], const uint16 b[])
+{
+    uint32 borrow = 0u;
+    uint32 difference;
+    uint32 i;
+
+    for(i = 0u; i < P256_DIGITS; i++)
+    {
+        difference = ((uint32) a[i] - (uint32) b[i]) - borrow;
+        r[i] = (uint16) difference;
+        borrow = (difference >> 16u) & 1u;
+    }
+
+    return borrow;
+}
+
+
+/*******************************************************************************
+* Function Name: P256_ModAdd()
+********************************************************************************
+*
+* Summary:
+*   r = a + b mod m for a and b below m.
+*
+*******************************************************************************/
+static void P256_ModAdd(uint16 r[], const uint16 a[], const uint16 b[], const P256_MOD_T *mod)
+{
+    if((0u != P256_Add(r, a, b)) || (P256_Compare(r, mod->m) >= 0))
+    {
+        (void) P256_Sub(r, r, mod->m);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: P256_ModSub()
+********************************************************************************
+*
+* Summary:
+*   r = a - b mod m for a and b below m.
+*
+*******************************************************************************/
+static void P256_ModSub(uint16 r[], const uint16 a[], const uint16 b[], const P256_MOD_T *mod)
+{
+    if(0u != P256_Sub(r, a, b))
+    {
+        (void) P256_Add(r, r, mod->m);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: P256_ModMul()
+********************************************************************************
+*
+* Summary:
+*   Montgomery product r = a * b / R mod m, word by word (CIOS). The
+*   result is below m if a is below R and b below m; r may be a or b.
+*
+*******************************************************************************/
+static void P256_ModMul(uint16 r[], const uint16 a[], const uint16 b[], const P256_MOD_T *mod)
+{
+    uint16 t[P256_DIGITS + 2u];
+    uint32 carry;
+    uint32 sum;
+    uint32 q;
+    uint32 i;
+    uint32 j;
+
+    (void) memset(t, 0, sizeof(t));
+    for(i = 0u; i < P256_DIGITS; i++)
+    {
+        /* t += a * b[i]; 0xFFFF * 0xFFFF + 2 * 0xFFFF still fits */
+        carry = 0u;
+        for(j = 0u; j < P256_DIGITS; j++)
+        {
+            sum = ((uint32) a[j] * (uint32) b[i]) + (uint32) t[j] + carry;
+            t[j] = (uint16) sum;
+            carry = sum >> 16u;
+        }
+        sum = (uint32) t[P256_DIGITS] + carry;
+        t[P256_DIGITS] = (uint16) sum;
+        t[P256_DIGITS + 1u] = (uint16) (sum >> 16u);
+
+        /* t = (t + q * m) / 2^16, with q making the low digit zero */
+        q = ((uint32) t[0u] * (uint32) mod->mInv) & 0xFFFFu;
+        carry = (((uint32) q * (uint32) mod->m[0u]) + (uint32) t[0u]) >> 16u;
+        for(j = 1u; j < P256_DIGITS; j++)
+        {
+            sum = ((uint32) q * (uint32) mod->m[j]) + (uint32) t[j] + carry;
+            t[j - 1u] = (uint16) sum;
+            carry = sum >> 16u;
+        }
+        sum = (uint32) t[P256_DIGITS] + carry;
+        t[P256_DIGITS - 1u] = (uint16) sum;
+        t[P256_DIGITS] = (uint16) ((uint32) t[P256_DIGITS + 1u] + (sum >> 16u));
+    }
+
+    if((0u != t[P256_DIGITS]) || (P256_Compare(t, mod->m) >= 0))
+    {
+        (void) P256_Sub(t, t, mod->m);
+    }
+    (void) memcpy(r, t, P256_DIGITS * sizeof(uint16));
+}
+
+
+/*******************************************************************************
+* Function Name: P256_ModOne()
+********************************************************************************
+*
+* Summary:
+*   r = 1 in Montgomery form, R mod m.
+*
+*******************************************************************************/
+static void P256_ModOne(uint16 r[], const P256_MOD_T *mod)
+{
+    uint16 one[P256_DIGITS];
+
+    (void) memset(one, 0, sizeof(one));
+    one[0u] = 1u;
+    P256_ModMul(r, mod->rr, one, mod);
+}
+
+
+/*******************************************************************************
+* Function Name: P256_ModInv()
+********************************************************************************
+*
+* Summary:
+*   r = 1 / a mod m in Montgomery form, as a^(m - 2) for the prime m. The
+*   inverse is needed once or twice per signature, where an exponentiation
+*   is shorter code than an extended Euclid.
+*
+*******************************************************************************/
+static void P256_ModInv(uint16 r[], const uint16 a[], const P256_MOD_T *mod)
+{
+    uint16 exponent[P256_DIGITS];
+    uint16 two[P256_DIGITS];
+    uint16 result[P256_DIGITS];
+    uint32 i = P256_BITS;
+
+    (void) memset(two, 0, sizeof(two));
+    two[0u] = 2u;
+    (void) P256_Sub(exponent, mod->m, two);
+
+    P256_ModOne(result, mod);
+    while(i != 0u)
+    {
+        i--;
+        P256_ModMul(result, result, result, mod);
+        if(0u != ((exponent[i / 16u] >> (i % 16u)) & 1u))
+        {
+            P256_ModMul(result, result, a, mod);
+        }
+    }
+    (void) memcpy(r, result, sizeof(result));
+}
+
+
+/*******************************************************************************
+* Function Name: P256_Double()
+********************************************************************************
+*
+* Summary:
+*   r = 2a with the a = -3 formulas (dbl-2001-b); the point at infinity
+*   stays at infinity. r may be a.
+*
+*******************************************************************************/
+static void P256_Double(P256_POINT_T *r, const P256_POINT_T *a)
+{
+    uint16 delta[P256_DIGITS];
+    uint16 gamma[P256_DIGITS];
+    uint16 beta[P256_DIGITS];
+    uint16 alpha[P256_DIGITS];
+    uint16 t[P256_DIGITS];
+
+    P256_ModMul(delta, a->z, a->z, &p256P);
+    P256_ModMul(gamma, a->y, a->y, &p256P);
+    P256_ModMul(beta, a->x, gamma, &p256P);
+
+    /* alpha = 3 (X - delta)(X + delta) */
+    P256_ModSub(t, a->x, delta, &p256P);
+    P256_ModAdd(alpha, a->x, delta, &p256P);
+    P256_ModMul(alpha, alpha, t, &p256P);
+    P256_ModAdd(t, alpha, alpha, &p256P);
+    P256_ModAdd(alpha, alpha, t, &p256P);
+
+    /* Z3 = (Y + Z)^2 - gamma - delta */
+    P256_ModAdd(r->z, a->y, a->z, &p256P);
+    P256_ModMul(r->z, r->z, r->z, &p256P);
+    P256_ModSub(r->z, r->z, gamma, &p256P);
+    P256_ModSub(r->z, r->z, delta, &p256P);
+
+    /* X3 = alpha^2 - 8 beta */
+    P256_ModAdd(beta, beta, beta, &p256P);
+    P256_ModAdd(beta, beta, beta, &p256P);
+    P256_ModAdd(t, beta, beta, &p256P);
+    P256_ModMul(r->x, alpha, alpha, &p256P);
+    P256_ModSub(r->x, r->x, t, &p256P);
+
+    /* Y3 = alpha (4 beta - X3) - 8 gamma^2 */
+    P256_ModSub(beta, beta, r->x, &p256P);
+    P256_ModMul(gamma, gamma, gamma, &p256P);
+    P256_ModAdd(gamma, gamma, gamma, &p256P);
+    P256_ModAdd(gamma, gamma, gamma, &p256P);
+    P256_ModAdd(gamma, gamma, gamma, &p256P);
+    P256_ModMul(r->y, alpha, beta, &p256P);
+    P256_ModSub(r->y, r->y, gamma, &p256P);
+}
+
+
+/*******************************************************************************
+* Function Name: P256_AddPoint()
+********************************************************************************
+*
+* Summary:
+*   r = a + b, including a or b at infinity, a = b and a = -b. r may be a
+*   or b.
+*
+*******************************************************************************/
+static void P256_AddPoint(P256_POINT_T *r, const P256_POINT_T *a, const P256_POINT_T *b)
+{
+    uint16 u1[P256_DIGITS];
+    uint16 u2[P256_DIGITS];
+    uint16 s1[P256_DIGITS];
+    uint16 s2[P256_DIGITS];
+    uint16 t[P256_DIGITS];
+
+    if(0u != P256_IsZero(a->z))
+    {
+        *r = *b;
+        return;
+    }
+    if(0u != P256_IsZero(b->z))
+    {
+        *r = *a;
+        return;
+    }
+
+    /* U1 = X1 Z2^2, S1 = Y1 Z2^3, U2 = X2 Z1^2, S2 = Y2 Z1^3 */
+    P256_ModMul(t, b->z, b->z, &p256P);
+    P256_ModMul(u1, a->x, t, &p256P);
+    P256_ModMul(t, t, b->z, &p256P);
+    P256_ModMul(s1, a->y, t, &p256P);
+    P256_ModMul(t, a->z, a->z, &p256P);
+    P256_ModMul(u2, b->x, t, &p256P);
+    P256_ModMul(t, t, a->z, &p256P);
+    P256_ModMul(s2, b->y, t, &p256P);
+
+    /* H = U2 - U1 in u2, rr = S2 - S1 in s2 */
+    P256_ModSub(u2, u2, u1, &p256P);
+    P256_ModSub(s2, s2, s1, &p256P);
+    if(0u != P256_IsZero(u2))
+    {
+        if(0u != P256_IsZero(s2))
+        {
+            P256_Double(r, a);
+        }
+        else
+        {
+            (void) memset(r, 0, sizeof(*r));
+        }
+        return;
+    }
+
+    /* Z3 = Z1 Z2 H */
+    P256_ModMul(r->z, a->z, b->z, &p256P);
+    P256_ModMul(r->z, r->z, u2, &p256P);
+
+    /* With HH = H^2, HHH = H^3 and V = U1 HH: X3 = rr^2 - HHH - 2 V */
+    P256_ModMul(t, u2, u2, &p256P);
+    P256_ModMul(u2, u2, t, &p256P);
+    P256_ModMul(u1, u1, t, &p256P);
+    P256_ModMul(r->x, s2, s2, &p256P);
+    P256_ModSub(r->x, r->x, u2, &p256P);
+    P256_ModSub(r->x, r->x, u1, &p256P);
+    P256_ModSub(r->x, r->x, u1, &p256P);
+
+    /* Y3 = rr (V - X3) - S1 HHH */
+    P256_ModSub(u1, u1, r->x, &p256P);
+    P256_ModMul(u1, u1, s2, &p256P);
+    P256_ModMul(s1, s1, u2, &p256P);
+    P256_ModSub(r->y, u1, s1, &p256P);
+}
+
+
+/*******************************************************************************
+* Function Name: P256_MulAdd()
+********************************************************************************
+*
+* Summary:
+*   r = u1 G + u2 q in one pass over the bits of both scalars (Shamir).
+*   r must not be q.
+*
+*******************************************************************************/
+static void P256_MulAdd(P256_POINT_T *r, const uint16 u1[], const uint16 u2[], const P256_POINT_T *q)
+{
+    P256_POINT_T g;
+    P256_POINT_T gq;
+    uint32 bits;
+    uint32 i = P256_BITS;
+
+    P256_ModMul(g.x, p256Gx, p256P.rr, &p256P);
+    P256_ModMul(g.y, p256Gy, p256P.rr, &p256P);
+    P256_ModOne(g.z, &p256P);
+    P256_AddPoint(&gq, &g, q);
+
+    (void) memset(r, 0, sizeof(*r));
+    while(i != 0u)
+    {
+        i--;
+        P256_Double(r, r);
+        bits = ((u1[i / 16u] >> (i % 16u)) & 1u) | (((u2[i / 16u] >> (i % 16u)) & 1u) << 1u);
+        if(bits == 1u)
+        {
+            P256_AddPoint(r, r, &g);
+        }
+        else if(bits == 2u)
+        {
+            P256_AddPoint(r, r, q);
+        }
+        else if(bits == 3u)
+        {
+            P256_AddPoint(r, r, &gq);
+        }
+        else
+        {
+            /* Neither scalar has the bit */
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: P256_Affine()
+********************************************************************************
+*
+* Summary:
+*   Converts a point to affine coordinates out of Montgomery form; y may
+*   be NULL.
+*
+* Return:
+*   Zero for the point at infinity.
+*
+*******************************************************************************/
+static uint32 P256_Affine(uint16 x[], uint16 y[], const P256_POINT_T *a)
+{
+    uint16 zInv[P256_DIGITS];
+    uint16 t[P256_DIGITS];
+    uint16 one[P256_DIGITS];
+
+    if(0u != P256_IsZero(a->z))
+    {
+        return 0u;
+    }
+
+    (void) memset(one, 0, sizeof(one));
+    one[0u] = 1u;
+    P256_ModInv(zInv, a->z, &p256P);
+    P256_ModMul(t, zInv, zInv, &p256P);
+    P256_ModMul(x, a->x, t, &p256P);
+    P256_ModMul(x, x, one, &p256P);
+    if(NULL != y)
+    {
+        P256_ModMul(t, t, zInv, &p256P);
+        P256_ModMul(y, a->y, t, &p256P);
+        P256_ModMul(y, y, one, &p256P);
+    }
+
+    return 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: P256_LoadPoint()
+********************************************************************************
+*
+* Summary:
+*   Reads a public key and checks that it is a point of the curve,
+*   y^2 = x^3 - 3x + b mod p.
+*
+* Return:
+*   Zero if it is not.
+*
+*******************************************************************************/
+static uint32 P256_LoadPoint(P256_POINT_T *r, const uint8 publicKey[])
+{
+    uint16 left[P256_DIGITS];
+    uint16 right[P256_DIGITS];
+    uint16 t[P256_DIGITS];
+
+    P256_FromBytes(r->x, publicKey);
+    P256_FromBytes(r->y, &publicKey[P256_BYTES]);
+    if((P256_Compare(r->x, p256P.m) >= 0) || (P256_Compare(r->y, p256P.m) >= 0))
+    {
+        return 0u;
+    }
+    P256_ModMul(r->x, r->x, p256P.rr, &p256P);
+    P256_ModMul(r->y, r->y, p256P.rr, &p256P);
+    P256_ModOne(r->z, &p256P);
+
+    P256_ModMul(left, r->y, r->y, &p256P);
+    P256_ModMul(right, r->x, r->x, &p256P);
+    P256_ModMul(right, right, r->x, &p256P);
+    P256_ModSub(right, right, r->x, &p256P);
+    P256_ModSub(right, right, r->x, &p256P);
+    P256_ModSub(right, right, r->x, &p256P);
+    P256_ModMul(t, p256B, p256P.rr, &p256P);
+    P256_ModAdd(right, right, t, &p256P);
+
+    return (uint32) (P256_Compare(left, right) == 0);
+}
+
+
+/*******************************************************************************
+* Function Name: P256_Verify()
+********************************************************************************
+*
+* Summary:
+*   Verifies an ECDSA signature of a digest: with w = 1 / s mod n, the x
+*   coordinate of (digest w) G + (r w) Q must be r mod n.
+*
+* Parameters:
+*  publicKey - X | Y of Q
+*  digest - SHA-256 digest that was signed
+*  signature - r | s
+*
+* Return:
+*   Non-zero if the signature is valid.
+*
+*******************************************************************************/
+uint32 P256_Verify(const uint8 publicKey[P256_PUBLIC_KEY_SIZE], const uint8 digest[P256_DIGEST_SIZE],
+    const uint8 signature[P256_SIGNATURE_SIZE])
+{
+    P256_POINT_T q;
+    P256_POINT_T sum;
+    uint16 r[P256_DIGITS];
+    uint16 s[P256_DIGITS];
+    uint16 e[P256_DIGITS];
+    uint16 u1[P256_DIGITS];
+    uint16 u2[P256_DIGITS];
+
+    P256_FromBytes(r, signature);
+    P256_FromBytes(s, &signature[P256_BYTES]);
+    if((0u != P256_IsZero(r)) || (P256_Compare(r, p256N.m) >= 0) ||
+       (0u != P256_IsZero(s)) || (P256_Compare(s, p256N.m) >= 0) ||
+       (0u == P256_LoadPoint(&q, publicKey)))
+    {
+        return 0u;
+    }
+
+    /* The Montgomery factors cancel: u1 = e (w R) / R */
+    P256_FromBytes(e, digest);
+    P256_ModMul(s, s, p256N.rr, &p256N);
+    P256_ModInv(s, s, &p256N);
+    P256_ModMul(u1, e, s, &p256N);
+    P256_ModMul(u2, r, s, &p256N);
+
+    P256_MulAdd(&sum, u1, u2, &q);
+    if(0u == P256_Affine(e, NULL, &sum))
+    {
+        return 0u;
+    }
+    if(P256_Compare(e, p256N.m) >= 0)
+    {
+        (void) P256_Sub(e, e, p256N.m);
+    }
+
+    return (uint32) (P256_Compare(e, r) == 0);
+}
+
+
+/*******************************************************************************
+* Function Name: P256_PublicKey()
+********************************************************************************
+*
+* Summary:
+*   Derives the public key d G of a private key d.
+*
+* Return:
+*   Zero if the private key is not in 1..n-1.
+*
+*******************************************************************************/
+uint32 P256_PublicKey(const uint8 privateKey[P256_PRIVATE_KEY_SIZE], uint8 publicKey[P256_PUBLIC_KEY_SIZE])
+{
+    P256_POINT_T point;
+    P256_POINT_T infinity;
+    uint16 d[P256_DIGITS];
+    uint16 zero[P256_DIGITS];
+    uint16 x[P256_DIGITS];
+    uint16 y[P256_DIGITS];
+
+    P256_FromBytes(d, privateKey);
+    if((0u != P256_IsZero(d)) || (P256_Compare(d, p256N.m) >= 0))
+    {
+        return 0u;
+    }
+
+    (void) memset(zero, 0, sizeof(zero));
+    (void) memset(&infinity, 0, sizeof(infinity));
+    P256_MulAdd(&point, d, zero, &infinity);
+    (void) P256_Affine(x, y, &point);
+    P256_ToBytes(publicKey, x);
+    P256_ToBytes(&publicKey[P256_BYTES], y);
+
+    return 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: P256_Sign()
+********************************************************************************
+*
+* Summary:
+*   Signs a digest: r = x(k G) mod n and s = (digest + r d) / k mod n, with
+*   the nonce k derived by HMAC-SHA-256 from the key and the digest as in
+*   RFC 6979 section 3.2, so the same digest always gets the same
+*   signature.
+*
+* Parameters:
+*  privateKey - d
+*  digest - SHA-256 digest to sign
+*  signature - r | s
+*
+* Return:
+*   Zero if the private key is not in 1..n-1.
+*
+*******************************************************************************/
+uint32 P256_Sign(const uint8 privateKey[P256_PRIVATE_KEY_SIZE], const uint8 digest[P256_DIGEST_SIZE],
+    uint8 signature[P256_SIGNATURE_SIZE])
+{
+    P256_POINT_T point;
+    P256_POINT_T infinity;
+    uint8 v[SHA256_DIGEST_SIZE];
+    uint8 k[SHA256_DIGEST_SIZE];
+    uint8 input[SHA256_DIGEST_SIZE + 1u + P256_BYTES + P256_BYTES];
+    uint16 d[P256_DIGITS];
+    uint16 e[P256_DIGITS];
+    uint16 nonce[P256_DIGITS];
+    uint16 zero[P256_DIGITS];
+    uint16 r[P256_DIGITS];
+    uint16 s[P256_DIGITS];
+    uint32 tries;
+
+    P256_FromBytes(d, privateKey);
+    if((0u != P256_IsZero(d)) || (P256_Compare(d, p256N.m) >= 0))
+    {
+        return 0u;
+    }
+    P256_FromBytes(e, digest);
+    if(P256_Compare(e, p256N.m) >= 0)
+    {
+        (void) P256_Sub(e, e, p256N.m);
+    }
+
+    /* K = HMAC_K(V | 0x00 | d | e), V = HMAC_K(V), then the same with 0x01 */
+    (void) memset(v, 0x01, sizeof(v));
+    (void) memset(k, 0x00, sizeof(k));
+    (void) memcpy(&input[SHA256_DIGEST_SIZE + 1u], privateKey, P256_BYTES);
+    P256_ToBytes(&input[SHA256_DIGEST_SIZE + 1u + P256_BYTES], e);
+    for(tries = 0u; tries < 2u; tries++)
+    {
+        (void) memcpy(input, v, sizeof(v));
+        input[SHA256_DIGEST_SIZE] = (uint8) tries;
+        Sha256_Hmac(k, sizeof(k), input, sizeof(input), k);
+        Sha256_Hmac(k, sizeof(k), v, sizeof(v), v);
+    }
+
+    (void) memset(zero, 0, sizeof(zero));
+    (void) memset(&infinity, 0, sizeof(infinity));
+    for(tries = 0u; tries < P256_SIGN_TRIES; tries++)
+    {
+        Sha256_Hmac(k, sizeof(k), v, sizeof(v), v);
+        P256_FromBytes(nonce, v);
+        if((0u == P256_IsZero(nonce)) && (P256_Compare(nonce, p256N.m) < 0))
+        {
+            P256_MulAdd(&point, nonce, zero, &infinity);
+            (void) P256_Affine(r, NULL, &point);
+            if(P256_Compare(r, p256N.m) >= 0)
+            {
+                (void) P256_Sub(r, r, p256N.m);
+            }
+
+            /* s = (e + r d) / k; r d comes out of Montgomery form through r R */
+            P256_ModMul(s, r, p256N.rr, &p256N);
+            P256_ModMul(s, s, d, &p256N);
+            P256_ModAdd(s, s, e, &p256N);
+            P256_ModMul(nonce, nonce, p256N.rr, &p256N);
+            P256_ModInv(nonce, nonce, &p256N);
+            P256_ModMul(s, s, nonce, &p256N);
+
+            if((0u == P256_IsZero(r)) && (0u == P256_IsZero(s)))
+            {
+                P256_ToBytes(signature, r);
+                P256_ToBytes(&signature[P256_BYTES], s);
+                return 1u;
+            }
+        }
+
+        /* K = HMAC_K(V | 0x00), V = HMAC_K(V) */
+        (void) memcpy(input, v, sizeof(v));
+        input[SHA256_DIGEST_SIZE] = 0u;
+        Sha256_Hmac(k, sizeof(k), input, SHA256_DIGEST_SIZE + 1u, k);
+        Sha256_Hmac(k, sizeof(k), v, sizeof(v), v);
+    }
+
+    return 0u;
+}
+
+
+/* [] END OF FILE */
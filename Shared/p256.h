@@ -0,0 +1,45 @@
+/*******************************************************************************
+* File Name: p256.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of ECDSA over the NIST
+*  P-256 curve (FIPS 186-4) for a SHA-256 digest. The Bootloader only
+*  verifies; signing and deriving the public key are used by the host side
+*  image tools and are removed from the firmware by the linker.
+*
+*  Keys and signatures are big-endian: the private key is a 32-byte
+*  scalar, the public key X | Y and the signature r | s, 32 bytes each.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(P256_H)
+#define P256_H
+
+#include <cytypes.h>
+
+#define P256_PRIVATE_KEY_SIZE           (32u)
+#define P256_PUBLIC_KEY_SIZE            (64u)
+#define P256_SIGNATURE_SIZE             (64u)
+#define P256_DIGEST_SIZE                (32u)
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+uint32 P256_Verify(const uint8 publicKey[P256_PUBLIC_KEY_SIZE], const uint8 digest[P256_DIGEST_SIZE],
+    const uint8 signature[P256_SIGNATURE_SIZE]);
+uint32 P256_PublicKey(const uint8 privateKey[P256_PRIVATE_KEY_SIZE], uint8 publicKey[P256_PUBLIC_KEY_SIZE]);
+uint32 P256_Sign(const uint8 privateKey[P256_PRIVATE_KEY_SIZE], const uint8 digest[P256_DIGEST_SIZE],
+    uint8 signature[P256_SIGNATURE_SIZE]);
+
+#endif /* P256_H */
+
+
+/* [] END OF FILE */
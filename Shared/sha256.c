@@ -0,0 +1,288 @@
+/*******************************************************************************
+* File Name: sha256.c
+*
+* Version: 1.30
+*
+* Description:
+*  FIPS 180-4 SHA-256 implementation. The code only depends on cytypes.h so
+*  the same file is compiled into the firmware and into the host tools.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "sha256.h"
+
+#define SHA256_ROTR(x, n)       (((x) >> (n)) | ((x) << (32u - (n))))
+#define SHA256_CH(x, y, z)      (((x) & (y)) ^ ((~(x)) & (z)))
+#define SHA256_MAJ(x, y, z)     (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SHA256_EP0(x)           (SHA256_ROTR((x), 2u) ^ SHA256_ROTR((x), 13u) ^ SHA256_ROTR((x), 22u))
+#define SHA256_EP1(x)           (SHA256_ROTR((x), 6u) ^ SHA256_ROTR((x), 11u) ^ SHA256_ROTR((x), 25u))
+#define SHA256_SIG0(x)          (SHA256_ROTR((x), 7u) ^ SHA256_ROTR((x), 18u) ^ ((x) >> 3u))
+#define SHA256_SIG1(x)          (SHA256_ROTR((x), 17u) ^ SHA256_ROTR((x), 19u) ^ ((x) >> 10u))
+
+static const uint32 sha256K[64u] =
+{
+    0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+    0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+    0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+    0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+    0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+    0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+    0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+    0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u
+};
+
+static void Sha256_Transform(SHA256_CTX_T *ctx, const uint8 block[]);
+
+
+/*******************************************************************************
+* Function Name: Sha256_Transform()
+********************************************************************************
+*
+* Summary:
+*   Compresses one 64-byte block into the hash state. The message schedule is
+*   kept in a rolling 16-word window to save stack on the Cortex-M0.
+*
+* Parameters:
+*  ctx - hash context
+*  block - 64 bytes of message data
+*
+*******************************************************************************/
+static void Sha256_Transform(SHA256_CTX_T *ctx, const uint8 block[])
+{
+    uint32 w[16u];
+    uint32 a, b, c, d, e, f, g, h;
+    uint32 t1, t2;
+    uint32 i;
+
+    for(i = 0u; i < 16u; i++)
+    {
+        w[i] = ((uint32)block[i * 4u] << 24u) | ((uint32)block[(i * 4u) + 1u] << 16u) |
+               ((uint32)block[(i * 4u) + 2u] << 8u) | ((uint32)block[(i * 4u) + 3u]);
+    }
+
+    a = ctx->state[0u];
+    b = ctx->state[1u];
+    c = ctx->state[2u];
+    d = ctx->state[3u];
+    e = ctx->state[4u];
+    f = ctx->state[5u];
+    g = ctx->state[6u];
+    h = ctx->state[7u];
+
+    for(i = 0u; i < 64u; i++)
+    {
+        if(i >= 16u)
+        {
+            w[i & 15u] += SHA256_SIG1(w[(i + 14u) & 15u]) + w[(i + 9u) & 15u] + SHA256_SIG0(w[(i + 1u) & 15u]);
+        }
+        t1 = h + SHA256_EP1(e) + SHA256_CH(e, f, g) + sha256K[i] + w[i & 15u];
+        t2 = SHA256_EP0(a) + SHA256_MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    ctx->state[0u] += a;
+    ctx->state[1u] += b;
+    ctx->state[2u] += c;
+    ctx->state[3u] += d;
+    ctx->state[4u] += e;
+    ctx->state[5u] += f;
+    ctx->state[6u] += g;
+    ctx->state[7u] += h;
+}
+
+
+/*******************************************************************************
+* Function Name: Sha256_Init()
+********************************************************************************
+*
+* Summary:
+*   Resets the hash context to the SHA-256 initial value.
+*
+* Parameters:
+*  ctx - hash context
+*
+*******************************************************************************/
+void Sha256_Init(SHA256_CTX_T *ctx)
+{
+    ctx->state[0u] = 0x6a09e667u;
+    ctx->state[1u] = 0xbb67ae85u;
+    ctx->state[2u] = 0x3c6ef372u;
+    ctx->state[3u] = 0xa54ff53au;
+    ctx->state[4u] = 0x510e527fu;
+    ctx->state[5u] = 0x9b05688cu;
+    ctx->state[6u] = 0x1f83d9abu;
+    ctx->state[7u] = 0x5be0cd19u;
+    ctx->bitCountLow = 0u;
+    ctx->bitCountHigh = 0u;
+    ctx->blockLength = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Sha256_Update()
+********************************************************************************
+*
+* Summary:
+*   Adds message data to the hash. Whole blocks are compressed directly from
+*   the caller's buffer, only the tail is copied into the context.
+*
+* Parameters:
+*  ctx - hash context
+*  data - message data
+*  length - number of bytes in data
+*
+*******************************************************************************/
+void Sha256_Update(SHA256_CTX_T *ctx, const uint8 data[], uint32 length)
+{
+    uint32 bits = length << 3u;
+
+    ctx->bitCountLow += bits;
+    if(ctx->bitCountLow < bits)
+    {
+        ctx->bitCountHigh++;
+    }
+    ctx->bitCountHigh += length >> 29u;
+
+    while(length != 0u)
+    {
+        if((ctx->blockLength == 0u) && (length >= SHA256_BLOCK_SIZE))
+        {
+            Sha256_Transform(ctx, data);
+            data += SHA256_BLOCK_SIZE;
+            length -= SHA256_BLOCK_SIZE;
+        }
+        else
+        {
+            ctx->block[ctx->blockLength] = *data;
+            ctx->blockLength++;
+            data++;
+            length--;
+            if(ctx->blockLength == SHA256_BLOCK_SIZE)
+            {
+                Sha256_Transform(ctx, ctx->block);
+                ctx->blockLength = 0u;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sha256_Final()
+********************************************************************************
+*
+* Summary:
+*   Appends the padding and the message length and writes out the digest.
+*   The context must be initialized again before it is reused.
+*
+* Parameters:
+*  ctx - hash context
+*  digest - 32-byte output buffer
+*
+*******************************************************************************/
+void Sha256_Final(SHA256_CTX_T *ctx, uint8 digest[SHA256_DIGEST_SIZE])
+{
+    uint32 i;
+
+    ctx->block[ctx->blockLength] = 0x80u;
+    ctx->blockLength++;
+    if(ctx->blockLength > (SHA256_BLOCK_SIZE - 8u))
+    {
+        while(ctx->blockLength < SHA256_BLOCK_SIZE)
+        {
+            ctx->block[ctx->blockLength] = 0u;
+            ctx->blockLength++;
+        }
+        Sha256_Transform(ctx, ctx->block);
+        ctx->blockLength = 0u;
+    }
+    while(ctx->blockLength < (SHA256_BLOCK_SIZE - 8u))
+    {
+        ctx->block[ctx->blockLength] = 0u;
+        ctx->blockLength++;
+    }
+    for(i = 0u; i < 4u; i++)
+    {
+        ctx->block[56u + i] = (uint8)(ctx->bitCountHigh >> (24u - (i * 8u)));
+        ctx->block[60u + i] = (uint8)(ctx->bitCountLow >> (24u - (i * 8u)));
+    }
+    Sha256_Transform(ctx, ctx->block);
+
+    for(i = 0u; i < 8u; i++)
+    {
+        digest[i * 4u]        = (uint8)(ctx->state[i] >> 24u);
+        digest[(i * 4u) + 1u] = (uint8)(ctx->state[i] >> 16u);
+        digest[(i * 4u) + 2u] = (uint8)(ctx->state[i] >> 8u);
+        digest[(i * 4u) + 3u] = (uint8)(ctx->state[i]);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sha256_Hmac()
+********************************************************************************
+*
+* Summary:
+*   Computes the RFC 2104 HMAC-SHA-256 of a message. Keys longer than a
+*   block are hashed first.
+*
+* Parameters:
+*  key - secret key
+*  keyLength - number of bytes in key
+*  data - message data
+*  length - number of bytes in data
+*  mac - 32-byte output buffer
+*
+*******************************************************************************/
+void Sha256_Hmac(const uint8 key[], uint32 keyLength, const uint8 data[], uint32 length,
+    uint8 mac[SHA256_DIGEST_SIZE])
+{
+    SHA256_CTX_T ctx;
+    uint8 pad[SHA256_BLOCK_SIZE];
+    uint8 keyDigest[SHA256_DIGEST_SIZE];
+    uint32 i;
+
+    if(keyLength > SHA256_BLOCK_SIZE)
+    {
+        Sha256_Init(&ctx);
+        Sha256_Update(&ctx, key, keyLength);
+        Sha256_Final(&ctx, keyDigest);
+        key = keyDigest;
+        keyLength = SHA256_DIGEST_SIZE;
+    }
+
+    /* Inner hash over (key ^ ipad) || data */
+    for(i = 0u; i < SHA256_BLOCK_SIZE; i++)
+    {
+        pad[i] = (uint8)(((i < keyLength) ? key[i] : 0u) ^ 0x36u);
+    }
+    Sha256_Init(&ctx);
+    Sha256_Update(&ctx, pad, SHA256_BLOCK_SIZE);
+    Sha256_Update(&ctx, data, length);
+    Sha256_Final(&ctx, mac);
+
+    /* Outer hash over (key ^ opad) || inner hash */
+    for(i = 0u; i < SHA256_BLOCK_SIZE; i++)
+    {
+        pad[i] ^= (uint8)(0x36u ^ 0x5Cu);
+    }
+    Sha256_Init(&ctx);
+    Sha256_Update(&ctx, pad, SHA256_BLOCK_SIZE);
+    Sha256_Update(&ctx, mac, SHA256_DIGEST_SIZE);
+    Sha256_Final(&ctx, mac);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,51 @@
+/*******************************************************************************
+* File Name: sha256.h
+*
+* Version 1.30
+*
+* Description:
+*  Contains the function prototypes and constants of the SHA-256 hash and of
+*  HMAC-SHA-256, used by the bootloader and by the host side image tools.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(SHA256_H)
+#define SHA256_H
+
+#include <cytypes.h>
+
+#define SHA256_BLOCK_SIZE               (64u)
+#define SHA256_DIGEST_SIZE              (32u)
+
+
+/***************************************
+*       Data Types
+***************************************/
+typedef struct
+{
+    uint32 state[8u];
+    uint32 bitCountLow;
+    uint32 bitCountHigh;
+    uint32 blockLength;
+    uint8  block[SHA256_BLOCK_SIZE];
+} SHA256_CTX_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+void Sha256_Init(SHA256_CTX_T *ctx);
+void Sha256_Update(SHA256_CTX_T *ctx, const uint8 data[], uint32 length);
+void Sha256_Final(SHA256_CTX_T *ctx, uint8 digest[SHA256_DIGEST_SIZE]);
+void Sha256_Hmac(const uint8 key[], uint32 keyLength, const uint8 data[], uint32 length,
+    uint8 mac[SHA256_DIGEST_SIZE]);
+
+#endif /* SHA256_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,282 @@
+/*******************************************************************************
+* File Name: sharedapi.h
+*
+* Version 1.30
+*
+* Description:
+*  Versioned jump table of the BLE Stack APIs and variables that the
+*  Bootloader shares with the bootloadable.
+*
+*  The table is generated from the lists below by the Bootloader build
+*  (sharedapi.c) and placed at SHARED_API_ADDRESS by the Bootloader linker
+*  script. The bootloadable includes the same lists; its calls to the listed
+*  APIs are redirected through the table at that constant address, so no
+*  Bootloader symbol has to be resolved for them.
+*
+*  Rules for changing the lists:
+*   - Add new functions and variables only at the end of
+*     SHARED_API_APPENDED, which follows both of the other lists in the
+*     table, and increment SHARED_API_VERSION_MINOR. Appending to one of the
+*     other lists would move the entries after it for older bootloadables.
+*   - Removing or reordering entries, or changing a shared type, requires
+*     incrementing SHARED_API_VERSION_MAJOR.
+*
+*  The header must be included after the BLE type definitions: project.h in
+*  the Bootloader, OTAMandatory.h in the bootloadable.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(SHAREDAPI_H)
+#define SHAREDAPI_H
+
+#include <stddef.h>
+#include <cytypes.h>
+
+/* Set to YES by the project that owns the table (the Bootloader) */
+#if !defined(SHARED_API_EXPORT)
+    #define SHARED_API_EXPORT           (0u)
+#endif /* !defined(SHARED_API_EXPORT) */
+
+
+/***************************************
+*        Table Location and Version
+***************************************/
+
+/* Must match CY_SHARED_API_ADDR in the Bootloader cm0gcc.ld */
+#define SHARED_API_ADDRESS              (0x00000200u)
+#define SHARED_API_SIZE_MAX             (0x00000100u)
+
+#define SHARED_API_MAGIC                (0x41534359u)   /* "CYSA" */
+#define SHARED_API_VERSION_MAJOR        (1u)
+#define SHARED_API_VERSION_MINOR        (8u)
+
+
+/***************************************
+*        Shared Entries
+***************************************/
+
+/* X(return type, name, parameter list) */
+#define SHARED_API_FUNCTIONS(X) \
+    X(CYBLE_API_RESULT_T,    CyBle_Start,                  (CYBLE_CALLBACK_T callbackFunc)) \
+    X(void,                  CyBle_Shutdown,               (void)) \
+    X(void,                  CyBle_ProcessEvents,          (void)) \
+    X(CYBLE_LP_MODE_T,       CyBle_EnterLPM,               (CYBLE_LP_MODE_T pwrMode)) \
+    X(CYBLE_BLESS_STATE_T,   CyBle_GetBleSsState,          (void)) \
+    X(CYBLE_API_RESULT_T,    CyBle_GappStartAdvertisement, (uint8 advertisingIntervalType)) \
+    X(CYBLE_API_RESULT_T,    CyBle_GetDeviceAddress,       (CYBLE_GAP_BD_ADDR_T *bdAddr)) \
+    X(CYBLE_API_RESULT_T,    CyBle_GattGetMtuSize,         (uint16 *mtu)) \
+    X(CYBLE_API_RESULT_T,    CyBle_GattsWriteRsp,          (CYBLE_CONN_HANDLE_T connHandle)) \
+    X(CYBLE_API_RESULT_T,    CyBle_GattsErrorRsp,          (CYBLE_CONN_HANDLE_T connHandle, \
+                                                            CYBLE_GATTS_ERR_PARAM_T *errRspParam)) \
+    X(CYBLE_API_RESULT_T,    CyBle_GattsNotification,      (CYBLE_CONN_HANDLE_T connHandle, \
+                                                            CYBLE_GATTS_HANDLE_VALUE_NTF_T *ntfParam)) \
+    X(CYBLE_GATT_ERR_CODE_T, CyBle_GattsEnableAttribute,   (CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle)) \
+    X(CYBLE_GATT_ERR_CODE_T, CyBle_GattsDisableAttribute,  (CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle)) \
+    X(uint16,                CyBle_Get16ByPtr,             (const uint8 ptr[])) \
+    X(void,                  CyBle_ScpsRegisterAttrCallback, (CYBLE_CALLBACK_T callbackFunc)) \
+    X(CYBLE_API_RESULT_T,    CyBle_ScpssGetCharacteristicDescriptor, (CYBLE_SCPS_CHAR_INDEX_T charIndex, \
+                                                            CYBLE_SCPS_DESCR_INDEX_T descrIndex, \
+                                                            uint8 attrSize, uint8 *attrValue))
+
+/* X(type, name) */
+#define SHARED_API_VARIABLES(X) \
+    X(CYBLE_STATE_T,               cyBle_state) \
+    X(CYBLE_CONN_HANDLE_T,         cyBle_connHandle) \
+    X(volatile uint8,              cyBle_busyStatus) \
+    X(uint8,                       cyBle_cmdReceivedFlag) \
+    X(uint16,                      cyBle_cmdLength) \
+    X(CYBLE_GAPP_DISC_MODE_INFO_T, cyBle_discoveryModeInfo)
+
+/* Shared arrays are exported whole, so their entries point to the array.
+ * The size is the one the BLE component generates for the Bootloader's
+ * GATT database; HelloApp's mirror in OTAMandatory.h must define the same.
+ */
+#if !defined(CYBLE_CUSTOMS_SERVICE_COUNT)
+    #error CYBLE_CUSTOMS_SERVICE_COUNT is not defined: cyBle_customs needs a custom service
+#endif /* !defined(CYBLE_CUSTOMS_SERVICE_COUNT) */
+
+typedef const CYBLE_CUSTOMS_T SHARED_API_CUSTOMS_T[CYBLE_CUSTOMS_SERVICE_COUNT];
+
+/* Defined in gattsig.h; the table only holds its address */
+struct GATT_SIG_ROW_S;
+
+/* Entries added after version 1.0, in the order they were added:
+ * F(return type, name, parameter list) for functions, V(type, name) for
+ * variables.
+ */
+#define SHARED_API_APPENDED(F, V) \
+    F(CYBLE_API_RESULT_T,    CyBle_GapGetPeerBdAddr,       (uint8 bdHandle, CYBLE_GAP_BD_ADDR_T *peerBdAddr)) \
+    F(CYBLE_API_RESULT_T,    CyBle_StoreAppData,           (uint8 *srcBuff, const uint8 destAddr[], \
+                                                            uint32 buffLen, uint8 isForceWrite)) \
+    V(const struct GATT_SIG_ROW_S, gattSigRow) \
+    F(CYBLE_API_RESULT_T,    CyBle_StoreBondingData,       (uint8 isForceWrite)) \
+    V(uint8,                 cyBle_pendingFlashWrite) \
+    F(CYBLE_API_RESULT_T,    CyBle_HidssSendNotification,  (CYBLE_CONN_HANDLE_T connHandle, uint8 serviceIndex, \
+                                                            CYBLE_HIDS_CHAR_INDEX_T charIndex, \
+                                                            uint8 attrSize, uint8 *attrValue)) \
+    F(CYBLE_API_RESULT_T,    CyBle_BassSendNotification,   (CYBLE_CONN_HANDLE_T connHandle, uint8 serviceIndex, \
+                                                            CYBLE_BAS_CHAR_INDEX_T charIndex, \
+                                                            uint8 attrSize, uint8 *attrValue)) \
+    F(CYBLE_API_RESULT_T,    CyBle_L2capLeConnectionParamUpdateRequest, (uint8 bdHandle, \
+                                                            CYBLE_GAP_CONN_UPDATE_PARAM_T *connParam)) \
+    F(CYBLE_API_RESULT_T,    CyBle_BassSetCharacteristicValue, (uint8 serviceIndex, CYBLE_BAS_CHAR_INDEX_T charIndex, \
+                                                            uint8 attrSize, uint8 *attrValue)) \
+    V(SHARED_API_CUSTOMS_T,  cyBle_customs) \
+    F(CYBLE_GATT_ERR_CODE_T, CyBle_GattsWriteAttributeValue, (CYBLE_GATT_HANDLE_VALUE_PAIR_T *handleValuePair, \
+                                                            uint16 offset, CYBLE_CONN_HANDLE_T *connHandle, \
+                                                            uint8 flags))
+
+/* X(type) - types whose layout both images must agree on */
+#define SHARED_API_TYPES(X) \
+    X(CYBLE_API_RESULT_T) \
+    X(CYBLE_STATE_T) \
+    X(CYBLE_LP_MODE_T) \
+    X(CYBLE_BLESS_STATE_T) \
+    X(CYBLE_CONN_HANDLE_T) \
+    X(CYBLE_GAP_BD_ADDR_T) \
+    X(CYBLE_GATT_HANDLE_VALUE_PAIR_T) \
+    X(CYBLE_GATTS_WRITE_REQ_PARAM_T) \
+    X(CYBLE_GATTS_ERR_PARAM_T) \
+    X(CYBLE_GAPP_DISC_MODE_INFO_T)
+
+
+/***************************************
+*        Data Types
+***************************************/
+
+#define SHARED_API_FUNCTION_MEMBER(ret, name, params)   ret (*name) params;
+#define SHARED_API_VARIABLE_MEMBER(type, name)          type *name;
+
+typedef struct
+{
+    uint32 magic;
+    uint16 versionMajor;
+    uint16 versionMinor;
+    uint32 size;                /* sizeof(SHARED_API_T) of the exporting build */
+    uint32 layoutSignature;     /* SHARED_API_LAYOUT_SIGNATURE of the exporting build */
+    SHARED_API_FUNCTIONS(SHARED_API_FUNCTION_MEMBER)
+    SHARED_API_VARIABLES(SHARED_API_VARIABLE_MEMBER)
+    SHARED_API_APPENDED(SHARED_API_FUNCTION_MEMBER, SHARED_API_VARIABLE_MEMBER)
+} SHARED_API_T;
+
+#define SHARED_API_HEADER_SIZE          (16u)
+
+/* Entry count, used by the size assert */
+#define SHARED_API_COUNT_ENTRY2(a, b)       + 1u
+#define SHARED_API_COUNT_ENTRY3(a, b, c)    + 1u
+#define SHARED_API_ENTRY_COUNT          (0u SHARED_API_FUNCTIONS(SHARED_API_COUNT_ENTRY3) \
+                                            SHARED_API_VARIABLES(SHARED_API_COUNT_ENTRY2) \
+                                            SHARED_API_APPENDED(SHARED_API_COUNT_ENTRY3, SHARED_API_COUNT_ENTRY2))
+
+#define SHARED_API_TYPE_ENUM(type)      SHARED_API_TYPE_##type,
+
+typedef enum
+{
+    SHARED_API_TYPES(SHARED_API_TYPE_ENUM)
+    SHARED_API_TYPE_COUNT
+} SHARED_API_TYPE_INDEX_T;
+
+/* Position-weighted sum of the shared type sizes. Both images compute it from
+ * their own type definitions, so a mismatch in the mirrored BLE types is
+ * detected with a single compare.
+ */
+#define SHARED_API_TYPE_TERM(type)      + ((uint32)sizeof(type) * ((2u * (uint32)SHARED_API_TYPE_##type) + 1u))
+#define SHARED_API_LAYOUT_SIGNATURE     (0u SHARED_API_TYPES(SHARED_API_TYPE_TERM))
+
+
+/***************************************
+*        Compile-time Asserts
+***************************************/
+
+#define SHARED_API_STATIC_ASSERT(condition, name)   typedef char name[(condition) ? 1 : -1]
+
+SHARED_API_STATIC_ASSERT(offsetof(SHARED_API_T, layoutSignature) == 12u, sharedApiAssertHeader);
+SHARED_API_STATIC_ASSERT(sizeof(SHARED_API_T) == (SHARED_API_HEADER_SIZE + (SHARED_API_ENTRY_COUNT * sizeof(void *))),
+                         sharedApiAssertPacked);
+SHARED_API_STATIC_ASSERT(sizeof(SHARED_API_T) <= SHARED_API_SIZE_MAX, sharedApiAssertSize);
+SHARED_API_STATIC_ASSERT(sizeof(CYBLE_CONN_HANDLE_T) == 2u, sharedApiAssertConnHandle);
+SHARED_API_STATIC_ASSERT(sizeof(CYBLE_GAP_BD_ADDR_T) == 7u, sharedApiAssertBdAddr);
+SHARED_API_STATIC_ASSERT(sizeof(CYBLE_GAP_CONN_UPDATE_PARAM_T) == 8u, sharedApiAssertConnUpdateParam);
+
+
+/***************************************
+*        Table Access
+***************************************/
+
+#if (SHARED_API_EXPORT != 0u)
+
+    extern const SHARED_API_T cySharedApi;
+
+#else
+
+    #define SHARED_API                  ((const SHARED_API_T *) SHARED_API_ADDRESS)
+
+    /*******************************************************************************
+    * Function Name: SharedApi_IsCompatible()
+    ********************************************************************************
+    *
+    * Summary:
+    *   Checks in constant time that the Bootloader in flash exports a table this
+    *   image can use: same magic and major version, at least the minor version
+    *   and entries this image was built against, and the same shared type layout.
+    *
+    * Return:
+    *   Non-zero if the table is compatible.
+    *
+    *******************************************************************************/
+    static CY_INLINE uint32 SharedApi_IsCompatible(void)
+    {
+        return (uint32)((SHARED_API->magic == SHARED_API_MAGIC) &&
+                        (SHARED_API->versionMajor == SHARED_API_VERSION_MAJOR) &&
+                        (SHARED_API->versionMinor >= SHARED_API_VERSION_MINOR) &&
+                        (SHARED_API->size >= sizeof(SHARED_API_T)) &&
+                        (SHARED_API->layoutSignature == SHARED_API_LAYOUT_SIGNATURE));
+    }
+
+    /* Calls and variable accesses go through the table */
+    #define CyBle_Start                             (SHARED_API->CyBle_Start)
+    #define CyBle_Shutdown                          (SHARED_API->CyBle_Shutdown)
+    #define CyBle_ProcessEvents                     (SHARED_API->CyBle_ProcessEvents)
+    #define CyBle_EnterLPM                          (SHARED_API->CyBle_EnterLPM)
+    #define CyBle_GetBleSsState                     (SHARED_API->CyBle_GetBleSsState)
+    #define CyBle_GappStartAdvertisement            (SHARED_API->CyBle_GappStartAdvertisement)
+    #define CyBle_GetDeviceAddress                  (SHARED_API->CyBle_GetDeviceAddress)
+    #define CyBle_GattGetMtuSize                    (SHARED_API->CyBle_GattGetMtuSize)
+    #define CyBle_GattsWriteRsp                     (SHARED_API->CyBle_GattsWriteRsp)
+    #define CyBle_GattsErrorRsp                     (SHARED_API->CyBle_GattsErrorRsp)
+    #define CyBle_GattsNotification                 (SHARED_API->CyBle_GattsNotification)
+    #define CyBle_GattsEnableAttribute              (SHARED_API->CyBle_GattsEnableAttribute)
+    #define CyBle_GattsDisableAttribute             (SHARED_API->CyBle_GattsDisableAttribute)
+    #define CyBle_Get16ByPtr                        (SHARED_API->CyBle_Get16ByPtr)
+    #define CyBle_ScpsRegisterAttrCallback          (SHARED_API->CyBle_ScpsRegisterAttrCallback)
+    #define CyBle_ScpssGetCharacteristicDescriptor  (SHARED_API->CyBle_ScpssGetCharacteristicDescriptor)
+    #define CyBle_GapGetPeerBdAddr                  (SHARED_API->CyBle_GapGetPeerBdAddr)
+    #define CyBle_StoreAppData                      (SHARED_API->CyBle_StoreAppData)
+    #define CyBle_StoreBondingData                  (SHARED_API->CyBle_StoreBondingData)
+    #define CyBle_HidssSendNotification             (SHARED_API->CyBle_HidssSendNotification)
+    #define CyBle_BassSendNotification              (SHARED_API->CyBle_BassSendNotification)
+    #define CyBle_L2capLeConnectionParamUpdateRequest (SHARED_API->CyBle_L2capLeConnectionParamUpdateRequest)
+    #define CyBle_BassSetCharacteristicValue        (SHARED_API->CyBle_BassSetCharacteristicValue)
+    #define CyBle_GattsWriteAttributeValue          (SHARED_API->CyBle_GattsWriteAttributeValue)
+
+    #define cyBle_state                             (*SHARED_API->cyBle_state)
+    #define cyBle_connHandle                        (*SHARED_API->cyBle_connHandle)
+    #define cyBle_busyStatus                        (*SHARED_API->cyBle_busyStatus)
+    #define cyBle_cmdReceivedFlag                   (*SHARED_API->cyBle_cmdReceivedFlag)
+    #define cyBle_cmdLength                         (*SHARED_API->cyBle_cmdLength)
+    #define cyBle_discoveryModeInfo                 (*SHARED_API->cyBle_discoveryModeInfo)
+    #define gattSigRow                              (*SHARED_API->gattSigRow)
+    #define cyBle_pendingFlashWrite                 (*SHARED_API->cyBle_pendingFlashWrite)
+    #define cyBle_customs                           (*SHARED_API->cyBle_customs)
+
+#endif /* (SHARED_API_EXPORT != 0u) */
+
+#endif /* SHAREDAPI_H */
+
+
+/* [] END OF FILE */
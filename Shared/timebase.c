@@ -0,0 +1,43 @@
+/*******************************************************************************
+* File Name: timebase.c
+*
+* Version 1.30
+*
+* Description:
+*  Free-running low-frequency timebase on WDT counter 2.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "timebase.h"
+
+
+/*******************************************************************************
+* Function Name: Timebase_Start()
+********************************************************************************
+*
+* Summary:
+*   Enables WDT counter 2 as a free-running counter. The counter is left
+*   running if the other project already started it, so readings stay
+*   continuous across the switch between Bootloader and HelloApp.
+*
+* Parameters:
+*   None
+*
+*******************************************************************************/
+void Timebase_Start(void)
+{
+    if(0u == CySysWdtGetEnabledStatus(TIMEBASE_COUNTER))
+    {
+        CySysWdtUnlock();
+        CySysWdtSetMode(TIMEBASE_COUNTER, CY_SYS_WDT_MODE_NONE);
+        CySysWdtEnable(TIMEBASE_COUNTER_MASK);
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,63 @@
+/*******************************************************************************
+* File Name: timebase.h
+*
+* Version 1.30
+*
+* Description:
+*  Free-running low-frequency timebase shared by the Bootloader and
+*  HelloApp. WDT counter 2 counts LFCLK (WCO, 32.768 kHz) without an
+*  interrupt and keeps running in Deep-Sleep and across software resets.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(TIMEBASE_H)
+#define TIMEBASE_H
+
+#include <project.h>
+
+
+/***************************************
+*        Constants
+***************************************/
+
+#define TIMEBASE_COUNTER            (CY_SYS_WDT_COUNTER2)
+#define TIMEBASE_COUNTER_MASK       (CY_SYS_WDT_COUNTER2_MASK)
+#define TIMEBASE_TICKS_PER_SEC      (32768u)
+
+/* Converts timebase ticks to milliseconds, valid for spans up to 9 hours */
+#define TIMEBASE_TICKS_TO_MS(ticks) ((uint32)(((uint32)(ticks) / 32u) * 125u / 128u))
+
+/* Converts timebase ticks to microseconds, valid for spans up to 8 seconds */
+#define TIMEBASE_TICKS_TO_US(ticks) ((uint32)(((uint32)(ticks) * 15625u) / 512u))
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Timebase_Start(void);
+
+
+/*******************************************************************************
+* Function Name: Timebase_Now()
+********************************************************************************
+*
+* Summary:
+*   Returns the free-running tick count. Differences of two readings are
+*   valid across the 32-bit wrap.
+*
+*******************************************************************************/
+static CY_INLINE uint32 Timebase_Now(void)
+{
+    return CySysWdtGetCount(TIMEBASE_COUNTER);
+}
+
+#endif /* TIMEBASE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,146 @@
+/*******************************************************************************
+* File Name: writerouter.c
+*
+* Version 1.30
+*
+* Description:
+*  GATT write router; see writerouter.h. The table is searched in place, so
+*  the router needs no RAM besides the table pointer and a write costs
+*  log2 of the number of ranges in comparisons.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include "main.h"
+#include "writerouter.h"
+
+static const WRITE_ROUTER_ENTRY_T *writeRouterTable;
+static uint32 writeRouterCount;
+
+static const WRITE_ROUTER_ENTRY_T *WriteRouter_Find(CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle);
+
+
+/*******************************************************************************
+* Function Name: WriteRouter_Init()
+********************************************************************************
+*
+* Summary:
+*   Sets the route table. Called once, before CyBle_Start().
+*
+* Parameters:
+*   table - ranges in ascending handle order; must stay valid
+*   count - number of ranges
+*
+*******************************************************************************/
+void WriteRouter_Init(const WRITE_ROUTER_ENTRY_T table[], uint32 count)
+{
+    uint32 i;
+
+    for(i = 0u; i < count; i++)
+    {
+        CYASSERT(table[i].first <= table[i].last);
+        CYASSERT((0u == i) || (table[i - 1u].last < table[i].first));
+    }
+
+    writeRouterTable = table;
+    writeRouterCount = count;
+}
+
+
+/*******************************************************************************
+* Function Name: WriteRouter_Find()
+********************************************************************************
+*
+* Summary:
+*   Finds the range of an attribute handle by binary search.
+*
+* Parameters:
+*   attrHandle - attribute handle
+*
+* Return:
+*   The range, NULL if no range holds the handle.
+*
+*******************************************************************************/
+static const WRITE_ROUTER_ENTRY_T *WriteRouter_Find(CYBLE_GATT_DB_ATTR_HANDLE_T attrHandle)
+{
+    uint32 low = 0u;
+    uint32 high = writeRouterCount;
+    uint32 mid;
+
+    while(low < high)
+    {
+        mid = (low + high) / 2u;
+        if(attrHandle < writeRouterTable[mid].first)
+        {
+            high = mid;
+        }
+        else if(attrHandle > writeRouterTable[mid].last)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            return &writeRouterTable[mid];
+        }
+    }
+
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: WriteRouter_Event()
+********************************************************************************
+*
+* Summary:
+*   BLE event handler for CYBLE_EVT_GATTS_WRITE_REQ and
+*   CYBLE_EVT_GATTS_WRITE_CMD_REQ.
+*
+* Parameters:
+*   event - event code
+*   eventParam - CYBLE_GATTS_WRITE_REQ_PARAM_T or
+*                CYBLE_GATTS_WRITE_CMD_REQ_PARAM_T
+*
+*******************************************************************************/
+void WriteRouter_Event(uint32 event, void *eventParam)
+{
+    const CYBLE_GATTS_WRITE_REQ_PARAM_T *writeParam = (const CYBLE_GATTS_WRITE_REQ_PARAM_T *) eventParam;
+    const WRITE_ROUTER_ENTRY_T *route = WriteRouter_Find(writeParam->handleValPair.attrHandle);
+    uint32 request = (event == (uint32) CYBLE_EVT_GATTS_WRITE_REQ) ? 1u : 0u;
+    uint32 length = writeParam->handleValPair.value.len;
+    CYBLE_GATTS_ERR_PARAM_T errParam;
+
+    if(route == NULL)
+    {
+        errParam.errorCode = CYBLE_GATT_ERR_WRITE_NOT_PERMITTED;
+    }
+    else if((length < route->minLength) || (length > route->maxLength))
+    {
+        errParam.errorCode = CYBLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+    }
+    else
+    {
+        errParam.errorCode = route->handler(writeParam, request);
+    }
+
+    if(0u != request)
+    {
+        if(errParam.errorCode == CYBLE_GATT_ERR_NONE)
+        {
+            (void) CyBle_GattsWriteRsp(writeParam->connHandle);
+        }
+        else
+        {
+            errParam.attrHandle = writeParam->handleValPair.attrHandle;
+            errParam.opcode = (uint8) CYBLE_GATT_WRITE_REQ;
+            (void) CyBle_GattsErrorRsp(writeParam->connHandle, &errParam);
+        }
+    }
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,87 @@
+/*******************************************************************************
+* File Name: writerouter.h
+*
+* Version 1.30
+*
+* Description:
+*  GATT write router. Each project lists the attribute handle ranges it
+*  takes writes for in a constant table built at compile time, e.g.
+*
+*   #define APP_WRITE_ROUTES(X) \
+*       X(FIRST_HANDLE, LAST_HANDLE, MIN_LENGTH, MAX_LENGTH, WriteHandler)
+*
+*   static const WRITE_ROUTER_ENTRY_T appWriteRoutes[] =
+*   {
+*       APP_WRITE_ROUTES(WRITE_ROUTER_ENTRY)
+*   };
+*
+*  Handles that are only known at run time, such as those of the
+*  Bootloader's GATT database in the bootloadable, are filled into a table
+*  in RAM before WriteRouter_Init().
+*
+*  The ranges must be listed in ascending handle order and must not
+*  overlap; a write finds its range by binary search. WriteRouter_Event()
+*  handles CYBLE_EVT_GATTS_WRITE_REQ and CYBLE_EVT_GATTS_WRITE_CMD_REQ: it
+*  checks the value length against the range, calls the handler and, for
+*  a write request, sends the Write Response or the Error Response with the
+*  code the handler returned. Writes outside every range are refused with
+*  Write Not Permitted.
+*
+*  The header must be included after the BLE type definitions: project.h in
+*  the Bootloader, OTAMandatory.h in the bootloadable.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(WRITEROUTER_H)
+#define WRITEROUTER_H
+
+#include <cytypes.h>
+
+
+/***************************************
+*        Constants
+***************************************/
+
+/* Initializer of one WRITE_ROUTER_ENTRY_T, for the route list X-macros */
+#define WRITE_ROUTER_ENTRY(first, last, minLength, maxLength, handler) \
+    { (uint16) (first), (uint16) (last), (uint16) (minLength), (uint16) (maxLength), &(handler) },
+
+#define WRITE_ROUTER_COUNT(table)       (sizeof(table) / sizeof((table)[0u]))
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Takes a write; request is non-zero for a write request, zero for a write
+ * command. Returns CYBLE_GATT_ERR_NONE to accept it.
+ */
+typedef CYBLE_GATT_ERR_CODE_T (*WRITE_ROUTER_HANDLER_T)(const CYBLE_GATTS_WRITE_REQ_PARAM_T *writeParam,
+                                                        uint32 request);
+
+typedef struct
+{
+    uint16 first;                       /* First attribute handle */
+    uint16 last;                        /* Last attribute handle */
+    uint16 minLength;                   /* Value length range, bytes */
+    uint16 maxLength;
+    WRITE_ROUTER_HANDLER_T handler;
+} WRITE_ROUTER_ENTRY_T;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void WriteRouter_Init(const WRITE_ROUTER_ENTRY_T table[], uint32 count);
+void WriteRouter_Event(uint32 event, void *eventParam);
+
+#endif /* WRITEROUTER_H */
+
+
+/* [] END OF FILE */
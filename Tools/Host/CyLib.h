@@ -0,0 +1,29 @@
+/*******************************************************************************
+* File Name: CyLib.h
+*
+* Version 1.30
+*
+* Description:
+*  Host replacement for the PSoC Creator CyLib.h. Only the critical section
+*  functions are declared; a host tool that links a Shared\ module using
+*  them defines both, e.g. by blocking the signals it uses as interrupts.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(CY_BOOT_CYLIB_H)
+#define CY_BOOT_CYLIB_H
+
+#include <cytypes.h>
+
+uint8 CyEnterCriticalSection(void);
+void CyExitCriticalSection(uint8 savedIntrStatus);
+
+#endif /* CY_BOOT_CYLIB_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,55 @@
+/*******************************************************************************
+* File Name: cytypes.h
+*
+* Version 1.30
+*
+* Description:
+*  Host replacement for the PSoC Creator cytypes.h. It lets the portable
+*  firmware modules under Shared\ be compiled into the host tools.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(CY_BOOT_CYTYPES_H)
+#define CY_BOOT_CYTYPES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef uint8_t     uint8;
+typedef uint16_t    uint16;
+typedef uint32_t    uint32;
+typedef int8_t      int8;
+typedef int16_t     int16;
+typedef int32_t     int32;
+typedef char        char8;
+typedef uint16      cystatus;
+
+#define CYRET_SUCCESS           (0x00u)
+#define CYRET_BAD_PARAM         (0x01u)
+#define CYRET_INVALID_STATE     (0x02u)
+#define CYRET_UNKNOWN           ((cystatus) 0xFFFFu)
+
+#if !defined(CY_ALIGN)
+    #define CY_ALIGN(align)     __attribute__ ((aligned(align)))
+#endif /* !defined(CY_ALIGN) */
+
+#if !defined(CY_SECTION)
+    #define CY_SECTION(name)
+#endif /* !defined(CY_SECTION) */
+
+#define CY_INLINE               inline
+
+#if !defined(CYASSERT)
+    #include <assert.h>
+    #define CYASSERT(x)         assert(x)
+#endif /* !defined(CYASSERT) */
+
+#endif /* CY_BOOT_CYTYPES_H */
+
+
+/* [] END OF FILE */
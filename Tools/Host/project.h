@@ -0,0 +1,55 @@
+/*******************************************************************************
+* File Name: project.h
+*
+* Version 1.30
+*
+* Description:
+*  Host replacement for the project.h PSoC Creator generates for
+*  Bootloader.cydsn, with the parts Bootloader.cydsn\imageauth.c uses. The
+*  flash is an array of the host tool, which defines it together with
+*  CySysFlashWriteRow() and the BLE command buffer variables. Flash
+*  addresses are kept in uint32, so the tool must be linked at addresses
+*  below 4 GB, e.g. with -no-pie.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#if !defined(CY_PROJECT_H)
+#define CY_PROJECT_H
+
+#include <cytypes.h>
+#include <CyLib.h>
+
+#define CY_FLASH_SIZEOF_ROW             (128u)
+#define CY_FLASH_NUMBER_ROWS            (1024u)
+
+extern uint8 hostFlash[CY_FLASH_NUMBER_ROWS * CY_FLASH_SIZEOF_ROW];
+#define CYDEV_FLASH_BASE                ((uint32) (uintptr_t) hostFlash)
+
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[]);
+
+/* Bootloader component */
+#define Bootloader_SCHEDULE_BTLDR       (0x40u)
+extern uint32 hostRunType;
+#define Bootloader_SET_RUN_TYPE(type)   (hostRunType = (type))
+
+/* BLE component, Bootloader Service */
+extern uint8 cyBle_cmdReceivedFlag;
+extern uint16 cyBle_cmdLength;
+
+/* SysTick, for the profiling options */
+extern volatile uint32 hostSysTick[3u];
+#define CY_SYS_SYST_CSR_REG             (hostSysTick[0u])
+#define CY_SYS_SYST_RVR_REG             (hostSysTick[1u])
+#define CY_SYS_SYST_CVR_REG             (hostSysTick[2u])
+#define CY_SYS_SYST_CSR_ENABLE          (0x01u)
+#define CY_SYS_SYST_CSR_CLK_SRC_SYSCLK  (0x04u)
+
+#endif /* CY_PROJECT_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,598 @@
+/*******************************************************************************
+* File Name: bletrace.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host decoder for the BLE event trace of Shared\bletrace.c. Renders the
+*  records as a timeline with the time since the first record, the time
+*  since the previous one, the event name and the parameter digest. Gaps
+*  longer than --gap milliseconds are marked, and a per-event count is
+*  printed at the end.
+*
+*  Input is either a UART capture, where "@T" and "@D" lines are picked out
+*  of any other output, or with --binary the concatenated payloads of the
+*  trace GATT notifications (8-byte little-endian records). Timestamps are
+*  timebase ticks (32.768 kHz); 32-bit wrap is handled.
+*
+*  Event names follow CYBLE_EVENT_T and CYBLE_EVT_T of the BLE component
+*  (HelloApp.cydsn\OTAMandatory.h) and the BLE_TRACE_EVT_* records of
+*  Shared\bletrace.h.
+*
+*  Build:
+*   gcc -O2 -I Host -I ../Shared -o bletrace bletrace.c
+*
+*  Usage:
+*   bletrace [--binary] [--gap MS] [FILE]
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cytypes.h>
+
+#define TICKS_PER_SEC           (32768.0)
+#define GAP_MS_DEFAULT          (100.0)
+#define LINE_SIZE_MAX           (512u)
+#define EVENT_SLOTS             (0x10000u)
+
+typedef struct
+{
+    uint16 code;
+    const char *name;
+} EVENT_NAME_T;
+
+static const EVENT_NAME_T eventNames[] =
+{
+    { 0x0000u, "HOST_INVALID" },
+    { 0x0001u, "STACK_ON" },
+    { 0x0002u, "TIMEOUT" },
+    { 0x0003u, "HARDWARE_ERROR" },
+    { 0x0004u, "HCI_STATUS" },
+    { 0x0005u, "STACK_BUSY_STATUS" },
+    { 0x0020u, "GAPC_SCAN_PROGRESS_RESULT" },
+    { 0x0021u, "GAP_AUTH_REQ" },
+    { 0x0022u, "GAP_PASSKEY_ENTRY_REQUEST" },
+    { 0x0023u, "GAP_PASSKEY_DISPLAY_REQUEST" },
+    { 0x0024u, "GAP_AUTH_COMPLETE" },
+    { 0x0025u, "GAP_AUTH_FAILED" },
+    { 0x0026u, "GAPP_ADVERTISEMENT_START_STOP" },
+    { 0x0027u, "GAP_DEVICE_CONNECTED" },
+    { 0x0028u, "GAP_DEVICE_DISCONNECTED" },
+    { 0x0029u, "GAP_ENCRYPT_CHANGE" },
+    { 0x002Au, "GAP_RESOLVE_PVT_ADDR_VERIFY_CNF" },
+    { 0x002Bu, "GAP_CONNECTION_UPDATE_COMPLETE" },
+    { 0x002Cu, "GAPC_SCAN_START_STOP" },
+    { 0x002Du, "GAP_KEYINFO_EXCHNGE_CMPLT" },
+    { 0x0040u, "GATTC_ERROR_RSP" },
+    { 0x0041u, "GATT_CONNECT_IND" },
+    { 0x0042u, "GATT_DISCONNECT_IND" },
+    { 0x0043u, "GATTS_XCNHG_MTU_REQ" },
+    { 0x0044u, "GATTC_XCHNG_MTU_RSP" },
+    { 0x0045u, "GATTC_READ_BY_GROUP_TYPE_RSP" },
+    { 0x0046u, "GATTC_READ_BY_TYPE_RSP" },
+    { 0x0047u, "GATTC_FIND_INFO_RSP" },
+    { 0x0048u, "GATTC_FIND_BY_TYPE_VALUE_RSP" },
+    { 0x0049u, "GATTC_READ_RSP" },
+    { 0x004Au, "GATTC_READ_BLOB_RSP" },
+    { 0x004Bu, "GATTC_READ_MULTI_RSP" },
+    { 0x004Cu, "GATTS_WRITE_REQ" },
+    { 0x004Du, "GATTC_WRITE_RSP" },
+    { 0x004Eu, "GATTS_WRITE_CMD_REQ" },
+    { 0x004Fu, "GATTS_PREP_WRITE_REQ" },
+    { 0x0050u, "GATTS_EXEC_WRITE_REQ" },
+    { 0x0051u, "GATTC_EXEC_WRITE_RSP" },
+    { 0x0052u, "GATTC_HANDLE_VALUE_NTF" },
+    { 0x0053u, "GATTC_HANDLE_VALUE_IND" },
+    { 0x0054u, "GATTS_HANDLE_VALUE_CNF" },
+    { 0x0055u, "GATTS_DATA_SIGNED_CMD_REQ" },
+    { 0x0070u, "L2CAP_CONN_PARAM_UPDATE_REQ" },
+    { 0x0071u, "L2CAP_CONN_PARAM_UPDATE_RSP" },
+    { 0x0072u, "L2CAP_CONN_PARAM_UPDATE_CMD_REJ" },
+    { 0x0073u, "L2CAP_CBFC_CONN_IND" },
+    { 0x0074u, "L2CAP_CBFC_CONN_CNF" },
+    { 0x0075u, "L2CAP_CBFC_DISCONN_IND" },
+    { 0x0076u, "L2CAP_CBFC_DISCONN_CNF" },
+    { 0x0077u, "L2CAP_CBFC_DATA_READ" },
+    { 0x0078u, "L2CAP_CBFC_RX_CREDIT_IND" },
+    { 0x0079u, "L2CAP_CBFC_TX_CREDIT_IND" },
+    { 0x007Au, "L2CAP_CBFC_DATA_WRITE_IND" },
+    { 0x00FAu, "PENDING_FLASH_WRITE" },
+    { 0x0104u, "GATTS_INDICATION_ENABLED" },
+    { 0x0105u, "GATTS_INDICATION_DISABLED" },
+    { 0x0106u, "GATTC_INDICATION" },
+    { 0x0107u, "GATTC_SRVC_DISCOVERY_FAILED" },
+    { 0x0108u, "GATTC_INCL_DISCOVERY_FAILED" },
+    { 0x0109u, "GATTC_CHAR_DISCOVERY_FAILED" },
+    { 0x010Au, "GATTC_DESCR_DISCOVERY_FAILED" },
+    { 0x010Bu, "GATTC_SRVC_DUPLICATION" },
+    { 0x010Cu, "GATTC_CHAR_DUPLICATION" },
+    { 0x010Du, "GATTC_DESCR_DUPLICATION" },
+    { 0x010Eu, "GATTC_SRVC_DISCOVERY_COMPLETE" },
+    { 0x010Fu, "GATTC_INCL_DISCOVERY_COMPLETE" },
+    { 0x0110u, "GATTC_CHAR_DISCOVERY_COMPLETE" },
+    { 0x0111u, "GATTC_DISCOVERY_COMPLETE" },
+    { 0x0112u, "ANCSS_NOTIFICATION_ENABLED" },
+    { 0x0113u, "ANCSS_NOTIFICATION_DISABLED" },
+    { 0x0114u, "ANCSS_WRITE_CHAR" },
+    { 0x0115u, "ANCSC_NOTIFICATION" },
+    { 0x0116u, "ANCSC_READ_CHAR_RESPONSE" },
+    { 0x0117u, "ANCSC_WRITE_CHAR_RESPONSE" },
+    { 0x0118u, "ANCSC_READ_DESCR_RESPONSE" },
+    { 0x0119u, "ANCSC_WRITE_DESCR_RESPONSE" },
+    { 0x011Au, "ANCSC_ERROR_RESPONSE" },
+    { 0x011Bu, "ANSS_NOTIFICATION_ENABLED" },
+    { 0x011Cu, "ANSS_NOTIFICATION_DISABLED" },
+    { 0x011Du, "ANSS_CHAR_WRITE" },
+    { 0x011Eu, "ANSC_NOTIFICATION" },
+    { 0x011Fu, "ANSC_READ_CHAR_RESPONSE" },
+    { 0x0120u, "ANSC_WRITE_CHAR_RESPONSE" },
+    { 0x0121u, "ANSC_READ_DESCR_RESPONSE" },
+    { 0x0122u, "ANSC_WRITE_DESCR_RESPONSE" },
+    { 0x0123u, "BASS_NOTIFICATION_ENABLED" },
+    { 0x0124u, "BASS_NOTIFICATION_DISABLED" },
+    { 0x0125u, "BASC_NOTIFICATION" },
+    { 0x0126u, "BASC_READ_CHAR_RESPONSE" },
+    { 0x0127u, "BASC_READ_DESCR_RESPONSE" },
+    { 0x0128u, "BASC_WRITE_DESCR_RESPONSE" },
+    { 0x0129u, "BCSS_INDICATION_ENABLED" },
+    { 0x012Au, "BCSS_INDICATION_DISABLED" },
+    { 0x012Bu, "BCSS_INDICATION_CONFIRMED" },
+    { 0x012Cu, "BCSC_INDICATION" },
+    { 0x012Du, "BCSC_READ_CHAR_RESPONSE" },
+    { 0x012Eu, "BCSC_READ_DESCR_RESPONSE" },
+    { 0x012Fu, "BCSC_WRITE_DESCR_RESPONSE" },
+    { 0x0130u, "BLSS_INDICATION_ENABLED" },
+    { 0x0131u, "BLSS_INDICATION_DISABLED" },
+    { 0x0132u, "BLSS_INDICATION_CONFIRMED" },
+    { 0x0133u, "BLSS_NOTIFICATION_ENABLED" },
+    { 0x0134u, "BLSS_NOTIFICATION_DISABLED" },
+    { 0x0135u, "BLSC_INDICATION" },
+    { 0x0136u, "BLSC_NOTIFICATION" },
+    { 0x0137u, "BLSC_READ_CHAR_RESPONSE" },
+    { 0x0138u, "BLSC_READ_DESCR_RESPONSE" },
+    { 0x0139u, "BLSC_WRITE_DESCR_RESPONSE" },
+    { 0x013Au, "BMSS_WRITE_CHAR" },
+    { 0x013Bu, "BMSC_READ_CHAR_RESPONSE" },
+    { 0x013Cu, "BMSC_WRITE_CHAR_RESPONSE" },
+    { 0x013Du, "BMSC_READ_DESCR_RESPONSE" },
+    { 0x013Eu, "CGMSS_INDICATION_ENABLED" },
+    { 0x013Fu, "CGMSS_INDICATION_DISABLED" },
+    { 0x0140u, "CGMSS_INDICATION_CONFIRMED" },
+    { 0x0141u, "CGMSS_NOTIFICATION_ENABLED" },
+    { 0x0142u, "CGMSS_NOTIFICATION_DISABLED" },
+    { 0x0143u, "CGMSS_WRITE_CHAR" },
+    { 0x0144u, "CGMSC_INDICATION" },
+    { 0x0145u, "CGMSC_NOTIFICATION" },
+    { 0x0146u, "CGMSC_READ_CHAR_RESPONSE" },
+    { 0x0147u, "CGMSC_WRITE_CHAR_RESPONSE" },
+    { 0x0148u, "CGMSC_READ_DESCR_RESPONSE" },
+    { 0x0149u, "CGMSC_WRITE_DESCR_RESPONSE" },
+    { 0x014Au, "CPSS_NOTIFICATION_ENABLED" },
+    { 0x014Bu, "CPSS_NOTIFICATION_DISABLED" },
+    { 0x014Cu, "CPSS_INDICATION_ENABLED" },
+    { 0x014Du, "CPSS_INDICATION_DISABLED" },
+    { 0x014Eu, "CPSS_INDICATION_CONFIRMED" },
+    { 0x014Fu, "CPSS_BROADCAST_ENABLED" },
+    { 0x0150u, "CPSS_BROADCAST_DISABLED" },
+    { 0x0151u, "CPSS_CHAR_WRITE" },
+    { 0x0152u, "CPSC_NOTIFICATION" },
+    { 0x0153u, "CPSC_INDICATION" },
+    { 0x0154u, "CPSC_READ_CHAR_RESPONSE" },
+    { 0x0155u, "CPSC_WRITE_CHAR_RESPONSE" },
+    { 0x0156u, "CPSC_READ_DESCR_RESPONSE" },
+    { 0x0157u, "CPSC_WRITE_DESCR_RESPONSE" },
+    { 0x0158u, "CPSC_SCAN_PROGRESS_RESULT" },
+    { 0x0159u, "CSCSS_NOTIFICATION_ENABLED" },
+    { 0x015Au, "CSCSS_NOTIFICATION_DISABLED" },
+    { 0x015Bu, "CSCSS_INDICATION_ENABLED" },
+    { 0x015Cu, "CSCSS_INDICATION_DISABLED" },
+    { 0x015Du, "CSCSS_INDICATION_CONFIRMATION" },
+    { 0x015Eu, "CSCSS_CHAR_WRITE" },
+    { 0x015Fu, "CSCSC_NOTIFICATION" },
+    { 0x0160u, "CSCSC_INDICATION" },
+    { 0x0161u, "CSCSC_READ_CHAR_RESPONSE" },
+    { 0x0162u, "CSCSC_WRITE_CHAR_RESPONSE" },
+    { 0x0163u, "CSCSC_READ_DESCR_RESPONSE" },
+    { 0x0164u, "CSCSC_WRITE_DESCR_RESPONSE" },
+    { 0x0165u, "CTSS_NOTIFICATION_ENABLED" },
+    { 0x0166u, "CTSS_NOTIFICATION_DISABLED" },
+    { 0x0167u, "CTSS_CHAR_WRITE" },
+    { 0x0168u, "CTSC_NOTIFICATION" },
+    { 0x0169u, "CTSC_READ_CHAR_RESPONSE" },
+    { 0x016Au, "CTSC_READ_DESCR_RESPONSE" },
+    { 0x016Bu, "CTSC_WRITE_DESCR_RESPONSE" },
+    { 0x016Cu, "CTSC_WRITE_CHAR_RESPONSE" },
+    { 0x016Du, "DISC_READ_CHAR_RESPONSE" },
+    { 0x016Eu, "ESSS_NOTIFICATION_ENABLED" },
+    { 0x016Fu, "ESSS_NOTIFICATION_DISABLED" },
+    { 0x0170u, "ESSS_INDICATION_ENABLED" },
+    { 0x0171u, "ESSS_INDICATION_DISABLED" },
+    { 0x0172u, "ESSS_INDICATION_CONFIRMATION" },
+    { 0x0173u, "ESSS_CHAR_WRITE" },
+    { 0x0174u, "ESSS_EXEC_WRITE_REQ" },
+    { 0x0175u, "ESSS_DESCR_WRITE" },
+    { 0x0176u, "ESSC_NOTIFICATION" },
+    { 0x0177u, "ESSC_INDICATION" },
+    { 0x0178u, "ESSC_READ_CHAR_RESPONSE" },
+    { 0x0179u, "ESSC_WRITE_CHAR_RESPONSE" },
+    { 0x017Au, "ESSC_READ_DESCR_RESPONSE" },
+    { 0x017Bu, "ESSC_WRITE_DESCR_RESPONSE" },
+    { 0x017Cu, "GLSS_INDICATION_ENABLED" },
+    { 0x017Du, "GLSS_INDICATION_DISABLED" },
+    { 0x017Eu, "GLSS_INDICATION_CONFIRMED" },
+    { 0x017Fu, "GLSS_NOTIFICATION_ENABLED" },
+    { 0x0180u, "GLSS_NOTIFICATION_DISABLED" },
+    { 0x0181u, "GLSS_WRITE_CHAR" },
+    { 0x0182u, "GLSC_INDICATION" },
+    { 0x0183u, "GLSC_NOTIFICATION" },
+    { 0x0184u, "GLSC_READ_CHAR_RESPONSE" },
+    { 0x0185u, "GLSC_WRITE_CHAR_RESPONSE" },
+    { 0x0186u, "GLSC_READ_DESCR_RESPONSE" },
+    { 0x0187u, "GLSC_WRITE_DESCR_RESPONSE" },
+    { 0x0188u, "HIDSS_NOTIFICATION_ENABLED" },
+    { 0x0189u, "HIDSS_NOTIFICATION_DISABLED" },
+    { 0x018Au, "HIDSS_BOOT_MODE_ENTER" },
+    { 0x018Bu, "HIDSS_REPORT_MODE_ENTER" },
+    { 0x018Cu, "HIDSS_SUSPEND" },
+    { 0x018Du, "HIDSS_EXIT_SUSPEND" },
+    { 0x018Eu, "HIDSS_REPORT_CHAR_WRITE" },
+    { 0x018Fu, "HIDSC_NOTIFICATION" },
+    { 0x0190u, "HIDSC_READ_CHAR_RESPONSE" },
+    { 0x0191u, "HIDSC_WRITE_CHAR_RESPONSE" },
+    { 0x0192u, "HIDSC_READ_DESCR_RESPONSE" },
+    { 0x0193u, "HIDSC_WRITE_DESCR_RESPONSE" },
+    { 0x0194u, "HRSS_ENERGY_EXPENDED_RESET" },
+    { 0x0195u, "HRSS_NOTIFICATION_ENABLED" },
+    { 0x0196u, "HRSS_NOTIFICATION_DISABLED" },
+    { 0x0197u, "HRSC_NOTIFICATION" },
+    { 0x0198u, "HRSC_READ_CHAR_RESPONSE" },
+    { 0x0199u, "HRSC_WRITE_CHAR_RESPONSE" },
+    { 0x019Au, "HRSC_READ_DESCR_RESPONSE" },
+    { 0x019Bu, "HRSC_WRITE_DESCR_RESPONSE" },
+    { 0x019Cu, "HTSS_NOTIFICATION_ENABLED" },
+    { 0x019Du, "HTSS_NOTIFICATION_DISABLED" },
+    { 0x019Eu, "HTSS_INDICATION_ENABLED" },
+    { 0x019Fu, "HTSS_INDICATION_DISABLED" },
+    { 0x01A0u, "HTSS_INDICATION_CONFIRMED" },
+    { 0x01A1u, "HTSS_CHAR_WRITE" },
+    { 0x01A2u, "HTSC_NOTIFICATION" },
+    { 0x01A3u, "HTSC_INDICATION" },
+    { 0x01A4u, "HTSC_READ_CHAR_RESPONSE" },
+    { 0x01A5u, "HTSC_WRITE_CHAR_RESPONSE" },
+    { 0x01A6u, "HTSC_READ_DESCR_RESPONSE" },
+    { 0x01A7u, "HTSC_WRITE_DESCR_RESPONSE" },
+    { 0x01A8u, "IASS_WRITE_CHAR_CMD" },
+    { 0x01A9u, "LLSS_WRITE_CHAR_REQ" },
+    { 0x01AAu, "LLSC_READ_CHAR_RESPONSE" },
+    { 0x01ABu, "LLSC_WRITE_CHAR_RESPONSE" },
+    { 0x01ACu, "LNSS_INDICATION_ENABLED" },
+    { 0x01ADu, "LNSS_INDICATION_DISABLED" },
+    { 0x01AEu, "LNSS_INDICATION_CONFIRMED" },
+    { 0x01AFu, "LNSS_NOTIFICATION_ENABLED" },
+    { 0x01B0u, "LNSS_NOTIFICATION_DISABLED" },
+    { 0x01B1u, "LNSS_WRITE_CHAR" },
+    { 0x01B2u, "LNSC_INDICATION" },
+    { 0x01B3u, "LNSC_NOTIFICATION" },
+    { 0x01B4u, "LNSC_READ_CHAR_RESPONSE" },
+    { 0x01B5u, "LNSC_WRITE_CHAR_RESPONSE" },
+    { 0x01B6u, "LNSC_READ_DESCR_RESPONSE" },
+    { 0x01B7u, "LNSC_WRITE_DESCR_RESPONSE" },
+    { 0x01B8u, "NDCSC_READ_CHAR_RESPONSE" },
+    { 0x01B9u, "PASSS_NOTIFICATION_ENABLED" },
+    { 0x01BAu, "PASSS_NOTIFICATION_DISABLED" },
+    { 0x01BBu, "PASSS_WRITE_CHAR" },
+    { 0x01BCu, "PASSC_NOTIFICATION" },
+    { 0x01BDu, "PASSC_READ_CHAR_RESPONSE" },
+    { 0x01BEu, "PASSC_WRITE_CHAR_RESPONSE" },
+    { 0x01BFu, "PASSC_READ_DESCR_RESPONSE" },
+    { 0x01C0u, "PASSC_WRITE_DESCR_RESPONSE" },
+    { 0x01C1u, "RSCSS_NOTIFICATION_ENABLED" },
+    { 0x01C2u, "RSCSS_NOTIFICATION_DISABLED" },
+    { 0x01C3u, "RSCSS_INDICATION_ENABLED" },
+    { 0x01C4u, "RSCSS_INDICATION_DISABLED" },
+    { 0x01C5u, "RSCSS_INDICATION_CONFIRMATION" },
+    { 0x01C6u, "RSCSS_CHAR_WRITE" },
+    { 0x01C7u, "RSCSC_NOTIFICATION" },
+    { 0x01C8u, "RSCSC_INDICATION" },
+    { 0x01C9u, "RSCSC_READ_CHAR_RESPONSE" },
+    { 0x01CAu, "RSCSC_WRITE_CHAR_RESPONSE" },
+    { 0x01CBu, "RSCSC_READ_DESCR_RESPONSE" },
+    { 0x01CCu, "RSCSC_WRITE_DESCR_RESPONSE" },
+    { 0x01CDu, "RTUSS_WRITE_CHAR_CMD" },
+    { 0x01CEu, "RTUSC_READ_CHAR_RESPONSE" },
+    { 0x01CFu, "SCPSS_NOTIFICATION_ENABLED" },
+    { 0x01D0u, "SCPSS_NOTIFICATION_DISABLED" },
+    { 0x01D1u, "SCPSS_SCAN_INT_WIN_CHAR_WRITE" },
+    { 0x01D2u, "SCPSC_NOTIFICATION" },
+    { 0x01D3u, "SCPSC_READ_DESCR_RESPONSE" },
+    { 0x01D4u, "SCPSC_WRITE_DESCR_RESPONSE" },
+    { 0x01D5u, "TPSS_NOTIFICATION_ENABLED" },
+    { 0x01D6u, "TPSS_NOTIFICATION_DISABLED" },
+    { 0x01D7u, "TPSC_NOTIFICATION" },
+    { 0x01D8u, "TPSC_READ_CHAR_RESPONSE" },
+    { 0x01D9u, "TPSC_READ_DESCR_RESPONSE" },
+    { 0x01DAu, "TPSC_WRITE_DESCR_RESPONSE" },
+    { 0x01DBu, "UDSS_INDICATION_ENABLED" },
+    { 0x01DCu, "UDSS_INDICATION_DISABLED" },
+    { 0x01DDu, "UDSS_INDICATION_CONFIRMED" },
+    { 0x01DEu, "UDSS_NOTIFICATION_ENABLED" },
+    { 0x01DFu, "UDSS_NOTIFICATION_DISABLED" },
+    { 0x01E0u, "UDSS_READ_CHAR" },
+    { 0x01E1u, "UDSS_WRITE_CHAR" },
+    { 0x01E2u, "UDSC_INDICATION" },
+    { 0x01E3u, "UDSC_NOTIFICATION" },
+    { 0x01E4u, "UDSC_READ_CHAR_RESPONSE" },
+    { 0x01E5u, "UDSC_WRITE_CHAR_RESPONSE" },
+    { 0x01E6u, "UDSC_READ_DESCR_RESPONSE" },
+    { 0x01E7u, "UDSC_WRITE_DESCR_RESPONSE" },
+    { 0x01E8u, "UDSC_ERROR_RESPONSE" },
+    { 0x01E9u, "WPTSS_NOTIFICATION_ENABLED" },
+    { 0x01EAu, "WPTSS_NOTIFICATION_DISABLED" },
+    { 0x01EBu, "WPTSS_INDICATION_ENABLED" },
+    { 0x01ECu, "WPTSS_INDICATION_DISABLED" },
+    { 0x01EDu, "WPTSS_INDICATION_CONFIRMED" },
+    { 0x01EEu, "WPTSS_WRITE_CHAR" },
+    { 0x01EFu, "WPTSC_NOTIFICATION" },
+    { 0x01F0u, "WPTSC_INDICATION" },
+    { 0x01F1u, "WPTSC_WRITE_CHAR_RESPONSE" },
+    { 0x01F2u, "WPTSC_READ_CHAR_RESPONSE" },
+    { 0x01F3u, "WPTSC_READ_DESCR_RESPONSE" },
+    { 0x01F4u, "WPTSC_WRITE_DESCR_RESPONSE" },
+    { 0x01F5u, "WSSS_INDICATION_ENABLED" },
+    { 0x01F6u, "WSSS_INDICATION_DISABLED" },
+    { 0x01F7u, "WSSS_INDICATION_CONFIRMED" },
+    { 0x01F8u, "WSSC_INDICATION" },
+    { 0x01F9u, "WSSC_READ_CHAR_RESPONSE" },
+    { 0x01FAu, "WSSC_READ_DESCR_RESPONSE" },
+    { 0x01FBu, "WSSC_WRITE_DESCR_RESPONSE" },
+    { 0xE000u, "DEBUG_EVT_BLESS_INT" },
+    { 0xF100u, "POWER_ACTIVE" },
+    { 0xF101u, "POWER_SLEEP" },
+    { 0xF102u, "POWER_DEEPSLEEP" },
+    { 0xF200u, "SLOW_HANDLER" },
+};
+
+typedef struct
+{
+    int first;
+    uint32 firstStamp;
+    uint32 lastStamp;
+    double elapsed;
+    double gapMs;
+    uint32 records;
+    uint32 dropped;
+    uint32 *counts;
+} TIMELINE_T;
+
+
+/*******************************************************************************
+* Function Name: EventName()
+********************************************************************************
+*
+* Summary:
+*   Looks up the name of an event code, NULL if unknown.
+*
+*******************************************************************************/
+static const char *EventName(uint32 code)
+{
+    uint32 low = 0u;
+    uint32 high = sizeof(eventNames) / sizeof(eventNames[0u]);
+
+    while(low < high)
+    {
+        uint32 mid = (low + high) / 2u;
+
+        if(eventNames[mid].code == code)
+        {
+            return eventNames[mid].name;
+        }
+        if(eventNames[mid].code < code)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: TimelineRecord()
+********************************************************************************
+*
+* Summary:
+*   Prints one record.
+*
+*******************************************************************************/
+static void TimelineRecord(TIMELINE_T *timeline, uint32 stamp, uint32 event, uint32 digest)
+{
+    const char *name = EventName(event);
+    double delta = 0.0;
+    char unknown[16];
+
+    if(timeline->first != 0)
+    {
+        timeline->first = 0;
+        timeline->firstStamp = stamp;
+    }
+    else
+    {
+        delta = (double)(uint32)(stamp - timeline->lastStamp) * 1000.0 / TICKS_PER_SEC;
+        timeline->elapsed += delta;
+        if(delta >= timeline->gapMs)
+        {
+            printf("             ---- %.1f ms idle ----\n", delta);
+        }
+    }
+    timeline->lastStamp = stamp;
+
+    if(name == NULL)
+    {
+        (void) snprintf(unknown, sizeof(unknown), "EVENT_%04X", (unsigned int) event);
+        name = unknown;
+    }
+    printf("%12.3f %+10.3f  %-40s 0x%04X\n", timeline->elapsed, delta, name, (unsigned int) digest);
+
+    timeline->records++;
+    timeline->counts[event & (EVENT_SLOTS - 1u)]++;
+}
+
+
+/*******************************************************************************
+* Function Name: ReadText()
+********************************************************************************
+*
+* Summary:
+*   Picks trace lines out of a UART capture.
+*
+*******************************************************************************/
+static void ReadText(FILE *file, TIMELINE_T *timeline)
+{
+    char line[LINE_SIZE_MAX];
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        char *record = strstr(line, "@T ");
+        char *dropped = strstr(line, "@D ");
+        unsigned long stamp;
+        unsigned int event;
+        unsigned int digest;
+        unsigned long count;
+
+        if((record != NULL) && (sscanf(record, "@T %lx %x %x", &stamp, &event, &digest) == 3))
+        {
+            TimelineRecord(timeline, (uint32) stamp, event, digest);
+        }
+        else if((dropped != NULL) && (sscanf(dropped, "@D %lu", &count) == 1))
+        {
+            printf("             !!!! %lu records dropped\n", count);
+            timeline->dropped += (uint32) count;
+        }
+        else
+        {
+            /* Other UART output */
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ReadBinary()
+********************************************************************************
+*
+* Summary:
+*   Reads concatenated 8-byte records.
+*
+*******************************************************************************/
+static void ReadBinary(FILE *file, TIMELINE_T *timeline)
+{
+    uint8 record[8];
+
+    while(fread(record, sizeof(record), 1u, file) == 1u)
+    {
+        uint32 stamp = (uint32) record[0] | ((uint32) record[1] << 8) |
+                       ((uint32) record[2] << 16) | ((uint32) record[3] << 24);
+
+        TimelineRecord(timeline, stamp, (uint32) record[4] | ((uint32) record[5] << 8),
+                       (uint32) record[6] | ((uint32) record[7] << 8));
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    TIMELINE_T timeline;
+    const char *path = NULL;
+    FILE *file = stdin;
+    int binary = 0;
+    uint32 code;
+    int i;
+
+    memset(&timeline, 0, sizeof(timeline));
+    timeline.first = 1;
+    timeline.gapMs = GAP_MS_DEFAULT;
+
+    for(i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--binary") == 0)
+        {
+            binary = 1;
+        }
+        else if((strcmp(argv[i], "--gap") == 0) && ((i + 1) < argc))
+        {
+            timeline.gapMs = strtod(argv[++i], NULL);
+        }
+        else if((argv[i][0] != '-') && (path == NULL))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: bletrace [--binary] [--gap MS] [FILE]\n");
+            return 2;
+        }
+    }
+
+    if(path != NULL)
+    {
+        file = fopen(path, binary ? "rb" : "r");
+        if(file == NULL)
+        {
+            fprintf(stderr, "bletrace: cannot open %s\n", path);
+            return 2;
+        }
+    }
+
+    timeline.counts = calloc(EVENT_SLOTS, sizeof(uint32));
+    if(timeline.counts == NULL)
+    {
+        fprintf(stderr, "bletrace: out of memory\n");
+        return 2;
+    }
+
+    printf("%12s %10s  %-40s %s\n", "time ms", "delta ms", "event", "digest");
+    if(binary != 0)
+    {
+        ReadBinary(file, &timeline);
+    }
+    else
+    {
+        ReadText(file, &timeline);
+    }
+
+    printf("\n%lu records over %.3f ms, %lu dropped\n", (unsigned long) timeline.records,
+           timeline.elapsed, (unsigned long) timeline.dropped);
+    for(code = 0u; code < EVENT_SLOTS; code++)
+    {
+        if(timeline.counts[code] != 0u)
+        {
+            const char *name = EventName(code);
+
+            printf("  %8lu  %s (0x%04X)\n", (unsigned long) timeline.counts[code],
+                   (name != NULL) ? name : "unknown", (unsigned int) code);
+        }
+    }
+
+    if(file != stdin)
+    {
+        fclose(file);
+    }
+    free(timeline.counts);
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,798 @@
+/*******************************************************************************
+* File Name: blockpoolbench.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host stress test and benchmark for Shared\blockpool.c and
+*  Shared\bufpool.c, built with the buffer classes of Bootloader.cydsn.
+*
+*  The stress test allocates and frees at random, fills every block with a
+*  pattern of its owner and checks the pattern, the alignment and the pool
+*  counters on every free. On POSIX hosts a SIGALRM handler allocates and
+*  frees as well, standing in for an interrupt; the critical section
+*  functions block that signal. A failed check exits with code 1.
+*
+*  The benchmark replays one random trace of allocations and frees on the
+*  buffer pool and on a naive first-fit allocator with a header word per
+*  block over a heap of the same size, and reports the mean and the 99.9th
+*  percentile count per operation (the maximum only shows host
+*  preemption) and the allocations that failed. The same is done
+*  for a single BLOCKS x 32 byte pool, where first-fit has more to scan.
+*  Cycle counts come from the time stamp counter on x86 hosts and are
+*  nanoseconds elsewhere; both include reading the counter.
+*
+*  Build:
+*   gcc -O2 -I Host -I ../Shared -I ../Bootloader.cydsn -o blockpoolbench blockpoolbench.c ../Shared/blockpool.c ../Shared/bufpool.c
+*
+*  Usage:
+*   blockpoolbench [OPERATIONS] [BLOCKS] [SEED]
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/* sigprocmask(), setitimer() and clock_gettime() with -std=c99 */
+#if !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE     (200809L)
+#endif /* !defined(_POSIX_C_SOURCE) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif /* defined(__x86_64__) || defined(__i386__) */
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <signal.h>
+    #include <sys/time.h>
+    #define BENCH_ISR_ENABLED       (1)
+#else
+    #define BENCH_ISR_ENABLED       (0)
+#endif /* defined(__unix__) || defined(__APPLE__) */
+
+#include <cytypes.h>
+#include <CyLib.h>
+#include "blockpool.h"
+#include "bufpool.h"
+
+#define OPERATIONS_DEFAULT      (200000u)
+#define BLOCKS_DEFAULT          (64u)
+#define SEED_DEFAULT            (1u)
+
+#define BENCH_BLOCK_SIZE        (32u)
+#define BENCH_LIVE_MAX          (1024u)
+#define BENCH_ISR_SLOTS         (2u)
+#define BENCH_ISR_PERIOD_US     (50)
+
+/* First-fit header: block bytes including the header, bit 0 set when used */
+#define FIRST_FIT_USED          (1u)
+
+typedef struct
+{
+    uint8 *buffer;
+    uint32 size;
+    uint8 tag;
+} LIVE_T;
+
+typedef struct
+{
+    uint32 slot;                        /* Slot to allocate into or free */
+    uint32 size;                        /* Bytes, 0 to free */
+} TRACE_OP_T;
+
+typedef struct
+{
+    void *(*alloc)(uint32 size);
+    void (*free)(void *buffer);
+} ALLOCATOR_T;
+
+typedef struct
+{
+    double meanCycles;
+    uint64_t p999Cycles;
+    uint32 allocs;
+    uint32 failures;
+} BENCH_RESULT_T;
+
+static uint32 firstFitHeap[BENCH_LIVE_MAX * 16u];
+static uint32 firstFitWords;
+static BLOCK_POOL_T benchPool;
+static uint32 benchPoolStorage[BLOCK_POOL_STORAGE_WORDS(BENCH_BLOCK_SIZE, BENCH_LIVE_MAX)];
+static uint32 failed;
+
+#if (BENCH_ISR_ENABLED)
+    static sigset_t isrMask;
+    static uint32 isrArmed;
+    static LIVE_T isrLive[BENCH_ISR_SLOTS];
+    static volatile uint32 isrCalls;
+    static volatile uint32 isrErrors;
+#endif /* (BENCH_ISR_ENABLED) */
+
+
+/*******************************************************************************
+* Function Name: CyEnterCriticalSection()
+********************************************************************************
+*
+* Summary:
+*   Host critical section: blocks the simulated interrupt while it is
+*   armed. The benchmark runs without it, as the system call would hide
+*   the allocators; on target the critical section is a few cycles.
+*
+*******************************************************************************/
+uint8 CyEnterCriticalSection(void)
+{
+#if (BENCH_ISR_ENABLED)
+    sigset_t previous;
+
+    if(0u == isrArmed)
+    {
+        return 1u;
+    }
+    (void) sigprocmask(SIG_BLOCK, &isrMask, &previous);
+    return (uint8) sigismember(&previous, SIGALRM);
+#else
+    return 0u;
+#endif /* (BENCH_ISR_ENABLED) */
+}
+
+
+/*******************************************************************************
+* Function Name: CyExitCriticalSection()
+********************************************************************************
+*
+* Summary:
+*   Unblocks the simulated interrupt unless it was blocked on entry.
+*
+*******************************************************************************/
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+#if (BENCH_ISR_ENABLED)
+    if(0u == savedIntrStatus)
+    {
+        (void) sigprocmask(SIG_UNBLOCK, &isrMask, NULL);
+    }
+#else
+    (void) savedIntrStatus;
+#endif /* (BENCH_ISR_ENABLED) */
+}
+
+
+/*******************************************************************************
+* Function Name: ReadCycles()
+********************************************************************************
+*
+* Summary:
+*   Returns the time stamp counter, or a nanosecond clock.
+*
+*******************************************************************************/
+static uint64_t ReadCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint64_t)__rdtsc();
+#else
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+#endif /* defined(__x86_64__) || defined(__i386__) */
+}
+
+
+/*******************************************************************************
+* Function Name: Check()
+********************************************************************************
+*
+* Summary:
+*   Reports a failed check.
+*
+*******************************************************************************/
+static void Check(int ok, const char *what, uint32 step)
+{
+    if(!ok)
+    {
+        if(failed < 10u)
+        {
+            fprintf(stderr, "FAIL: %s at step %u\n", what, (unsigned int)step);
+        }
+        failed++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Fill() / Intact()
+********************************************************************************
+*
+* Summary:
+*   Writes and checks the owner pattern of a live buffer.
+*
+*******************************************************************************/
+static void Fill(const LIVE_T *live)
+{
+    (void) memset(live->buffer, live->tag, live->size);
+}
+
+static int Intact(const LIVE_T *live)
+{
+    uint32 i;
+
+    for(i = 0u; i < live->size; i++)
+    {
+        if(live->buffer[i] != live->tag)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+
+/*******************************************************************************
+* Function Name: FirstFit_Init()
+********************************************************************************
+*
+* Summary:
+*   Makes the whole heap one free block.
+*
+*******************************************************************************/
+static void FirstFit_Init(uint32 bytes)
+{
+    firstFitWords = bytes / 4u;
+    firstFitHeap[0] = firstFitWords * 4u;
+}
+
+
+/*******************************************************************************
+* Function Name: FirstFit_Alloc()
+********************************************************************************
+*
+* Summary:
+*   Walks the heap from the start and takes the first free block that fits,
+*   joining free neighbours on the way and splitting off the rest.
+*
+*******************************************************************************/
+static void *FirstFit_Alloc(uint32 size)
+{
+    uint8 interruptStatus = CyEnterCriticalSection();
+    uint32 need = 1u + ((size + 3u) / 4u);
+    uint32 *found = NULL;
+    uint32 at = 0u;
+
+    while(at < firstFitWords)
+    {
+        uint32 words = firstFitHeap[at] / 4u;
+
+        if(0u == (firstFitHeap[at] & FIRST_FIT_USED))
+        {
+            while(((at + words) < firstFitWords) && (0u == (firstFitHeap[at + words] & FIRST_FIT_USED)))
+            {
+                words += firstFitHeap[at + words] / 4u;
+            }
+            firstFitHeap[at] = words * 4u;
+
+            if(words >= need)
+            {
+                if(words >= (need + 2u))
+                {
+                    firstFitHeap[at + need] = (words - need) * 4u;
+                    words = need;
+                }
+                firstFitHeap[at] = (words * 4u) | FIRST_FIT_USED;
+                found = &firstFitHeap[at + 1u];
+                break;
+            }
+        }
+        at += words;
+    }
+    CyExitCriticalSection(interruptStatus);
+
+    return found;
+}
+
+
+/*******************************************************************************
+* Function Name: FirstFit_Free()
+********************************************************************************
+*
+* Summary:
+*   Marks a block free; joining is left to the next allocation.
+*
+*******************************************************************************/
+static void FirstFit_Free(void *buffer)
+{
+    uint8 interruptStatus;
+
+    if(buffer != NULL)
+    {
+        interruptStatus = CyEnterCriticalSection();
+        ((uint32 *) buffer)[-1] &= ~FIRST_FIT_USED;
+        CyExitCriticalSection(interruptStatus);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: BenchPool_Alloc() / BenchPool_Free()
+********************************************************************************
+*
+* Summary:
+*   The single BLOCKS x 32 byte pool behind the allocator interface.
+*
+*******************************************************************************/
+static void *BenchPool_Alloc(uint32 size)
+{
+    return (size <= BENCH_BLOCK_SIZE) ? BlockPool_Alloc(&benchPool) : NULL;
+}
+
+static void BenchPool_Free(void *buffer)
+{
+    BlockPool_Free(&benchPool, buffer);
+}
+
+
+/*******************************************************************************
+* Function Name: BufPoolBytes()
+********************************************************************************
+*
+* Summary:
+*   Returns the storage bytes and the largest buffer of the buffer pool.
+*
+*******************************************************************************/
+static uint32 BufPoolBytes(uint32 *largest)
+{
+    BLOCK_POOL_STATS_T stats;
+    uint32 bytes = 0u;
+    uint32 i;
+
+    *largest = 0u;
+    for(i = 0u; i < BUF_POOL_CLASS_COUNT; i++)
+    {
+        BufPool_GetStats(i, &stats);
+        bytes += stats.blockSize * stats.count;
+        *largest = stats.blockSize;
+    }
+    return bytes;
+}
+
+
+#if (BENCH_ISR_ENABLED)
+/*******************************************************************************
+* Function Name: IsrHandler()
+********************************************************************************
+*
+* Summary:
+*   Simulated interrupt: frees its oldest buffer and allocates a new one.
+*
+*******************************************************************************/
+static void IsrHandler(int signal)
+{
+    uint32 slot = isrCalls % BENCH_ISR_SLOTS;
+    LIVE_T *live = &isrLive[slot];
+
+    (void) signal;
+    if(live->buffer != NULL)
+    {
+        if(!Intact(live))
+        {
+            isrErrors++;
+        }
+        BufPool_Free(live->buffer);
+    }
+    live->size = 1u + (isrCalls % 8u);
+    live->tag = (uint8)(0xA0u + slot);
+    live->buffer = (uint8 *) BufPool_Alloc(live->size);
+    if(live->buffer != NULL)
+    {
+        Fill(live);
+    }
+    isrCalls++;
+}
+#endif /* (BENCH_ISR_ENABLED) */
+
+
+/*******************************************************************************
+* Function Name: StressBlockPool()
+********************************************************************************
+*
+* Summary:
+*   Random allocations and frees on one pool, checking exhaustion, pattern,
+*   alignment and counters.
+*
+*******************************************************************************/
+static void StressBlockPool(uint32 blockSize, uint32 count, uint32 operations)
+{
+    static uint32 storage[BLOCK_POOL_STORAGE_WORDS(64u, BENCH_LIVE_MAX)];
+    static LIVE_T live[BENCH_LIVE_MAX];
+    BLOCK_POOL_T pool;
+    BLOCK_POOL_STATS_T stats;
+    uint32 liveCount = 0u;
+    uint32 maxLive = 0u;
+    uint32 misses = 0u;
+    uint32 step;
+
+    BlockPool_Init(&pool, storage, blockSize, count);
+    for(step = 0u; step < operations; step++)
+    {
+        if((liveCount == 0u) || ((rand() % 5) < 3))
+        {
+            LIVE_T *entry = &live[liveCount];
+            uint8 *block = (uint8 *) BlockPool_Alloc(&pool);
+
+            if(liveCount == count)
+            {
+                Check(block == NULL, "allocation from an empty pool", step);
+                misses++;
+                continue;
+            }
+            entry->buffer = block;
+            Check(entry->buffer != NULL, "pool empty too early", step);
+            if(entry->buffer == NULL)
+            {
+                return;
+            }
+            Check((((size_t) entry->buffer) % 4u) == 0u, "unaligned block", step);
+            Check((entry->buffer >= (uint8 *) storage) &&
+                  ((entry->buffer + blockSize) <= (uint8 *) &storage[BLOCK_POOL_STORAGE_WORDS(blockSize, count)]),
+                  "block outside the storage", step);
+            entry->size = blockSize;
+            entry->tag = (uint8) step;
+            Fill(entry);
+            liveCount++;
+            if(liveCount > maxLive)
+            {
+                maxLive = liveCount;
+            }
+        }
+        else
+        {
+            uint32 pick = (uint32) rand() % liveCount;
+
+            Check(Intact(&live[pick]), "block overwritten while allocated", step);
+            BlockPool_Free(&pool, live[pick].buffer);
+            liveCount--;
+            live[pick] = live[liveCount];
+        }
+
+        Check(BlockPool_Available(&pool) == (count - liveCount), "available count", step);
+    }
+
+    BlockPool_GetStats(&pool, &stats);
+    Check(stats.used == liveCount, "used count", step);
+    Check(stats.maxUsed == maxLive, "high-water mark", step);
+    Check(stats.failures == misses, "failure count", step);
+
+    while(liveCount != 0u)
+    {
+        liveCount--;
+        BlockPool_Free(&pool, live[liveCount].buffer);
+    }
+    BlockPool_Free(&pool, NULL);
+    Check(BlockPool_Available(&pool) == count, "blocks lost", step);
+}
+
+
+/*******************************************************************************
+* Function Name: StressBufPool()
+********************************************************************************
+*
+* Summary:
+*   Random sizes on the buffer pool, with the simulated interrupt running
+*   on POSIX hosts.
+*
+*******************************************************************************/
+static void StressBufPool(uint32 operations)
+{
+    static LIVE_T live[BENCH_LIVE_MAX];
+    uint32 largest;
+    uint32 total;
+    uint32 liveCount = 0u;
+    uint32 step;
+
+    BufPool_Start();
+    (void) BufPoolBytes(&largest);
+    total = BufPool_Available(1u);
+
+#if (BENCH_ISR_ENABLED)
+    {
+        struct sigaction action;
+        struct itimerval timer;
+
+        (void) memset(&action, 0, sizeof(action));
+        action.sa_handler = &IsrHandler;
+        (void) sigaction(SIGALRM, &action, NULL);
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = BENCH_ISR_PERIOD_US;
+        timer.it_value = timer.it_interval;
+        isrArmed = 1u;
+        (void) setitimer(ITIMER_REAL, &timer, NULL);
+    }
+#endif /* (BENCH_ISR_ENABLED) */
+
+    for(step = 0u; step < operations; step++)
+    {
+        if((liveCount < BENCH_LIVE_MAX) && ((liveCount == 0u) || ((rand() % 2) == 0)))
+        {
+            LIVE_T *entry = &live[liveCount];
+
+            entry->size = 1u + ((uint32) rand() % largest);
+            entry->tag = (uint8)(step & 0x7Fu);
+            entry->buffer = (uint8 *) BufPool_Alloc(entry->size);
+            if(entry->buffer != NULL)
+            {
+                Check((((size_t) entry->buffer) % 4u) == 0u, "unaligned buffer", step);
+                Fill(entry);
+                liveCount++;
+            }
+            Check(BufPool_Alloc(largest + 1u) == NULL, "oversized allocation", step);
+        }
+        else if(liveCount != 0u)
+        {
+            uint32 pick = (uint32) rand() % liveCount;
+
+            Check(Intact(&live[pick]), "buffer overwritten while allocated", step);
+            BufPool_Free(live[pick].buffer);
+            liveCount--;
+            live[pick] = live[liveCount];
+        }
+        else
+        {
+            /* Nothing to free */
+        }
+    }
+
+#if (BENCH_ISR_ENABLED)
+    {
+        struct itimerval timer;
+        uint32 i;
+
+        (void) memset(&timer, 0, sizeof(timer));
+        (void) setitimer(ITIMER_REAL, &timer, NULL);
+        (void) signal(SIGALRM, SIG_IGN);
+        isrArmed = 0u;
+        for(i = 0u; i < BENCH_ISR_SLOTS; i++)
+        {
+            if(isrLive[i].buffer != NULL)
+            {
+                Check(Intact(&isrLive[i]), "interrupt buffer overwritten", step);
+                BufPool_Free(isrLive[i].buffer);
+                isrLive[i].buffer = NULL;
+            }
+        }
+        Check(isrErrors == 0u, "interrupt buffer overwritten", step);
+        printf("  simulated interrupts     %u\n", (unsigned int) isrCalls);
+    }
+#endif /* (BENCH_ISR_ENABLED) */
+
+    while(liveCount != 0u)
+    {
+        liveCount--;
+        Check(Intact(&live[liveCount]), "buffer overwritten while allocated", step);
+        BufPool_Free(live[liveCount].buffer);
+    }
+    BufPool_Free(NULL);
+    Check(BufPool_Available(1u) == total, "buffers lost", step);
+}
+
+
+/*******************************************************************************
+* Function Name: MakeTrace()
+********************************************************************************
+*
+* Summary:
+*   Random trace that keeps about three quarters of the blocks in use.
+*
+*******************************************************************************/
+static void MakeTrace(TRACE_OP_T trace[], uint32 operations, uint32 blocks, uint32 largest)
+{
+    static uint32 slots[BENCH_LIVE_MAX];
+    uint32 target = ((blocks * 3u) / 4u) + 1u;
+    uint32 used = 0u;
+    uint32 i;
+
+    /* slots[0..used) are the slots in use, the rest are free */
+    for(i = 0u; i < BENCH_LIVE_MAX; i++)
+    {
+        slots[i] = i;
+    }
+
+    for(i = 0u; i < operations; i++)
+    {
+        if((used == 0u) || ((used < target) && ((rand() % 2) == 0)))
+        {
+            trace[i].slot = slots[used];
+            trace[i].size = 1u + ((uint32) rand() % largest);
+            used++;
+        }
+        else
+        {
+            uint32 pick = (uint32) rand() % used;
+
+            trace[i].slot = slots[pick];
+            trace[i].size = 0u;
+            used--;
+            slots[pick] = slots[used];
+            slots[used] = trace[i].slot;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CompareCycles()
+********************************************************************************
+*
+* Summary:
+*   qsort() order of cycle counts.
+*
+*******************************************************************************/
+static int CompareCycles(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+/*******************************************************************************
+* Function Name: Replay()
+********************************************************************************
+*
+* Summary:
+*   Runs a trace on one allocator.
+*
+*******************************************************************************/
+static void Replay(const ALLOCATOR_T *allocator, const TRACE_OP_T trace[], uint64_t cycles[],
+                   uint32 operations, BENCH_RESULT_T *result)
+{
+    static void *slot[BENCH_LIVE_MAX];
+    uint64_t total = 0u;
+    uint32 i;
+
+    (void) memset(result, 0, sizeof(*result));
+    (void) memset(slot, 0, sizeof(slot));
+
+    for(i = 0u; i < operations; i++)
+    {
+        uint64_t start = ReadCycles();
+        uint64_t spent;
+
+        if(trace[i].size != 0u)
+        {
+            slot[trace[i].slot] = allocator->alloc(trace[i].size);
+            spent = ReadCycles() - start;
+            result->allocs++;
+            if(slot[trace[i].slot] == NULL)
+            {
+                result->failures++;
+            }
+        }
+        else
+        {
+            allocator->free(slot[trace[i].slot]);
+            spent = ReadCycles() - start;
+            slot[trace[i].slot] = NULL;
+        }
+
+        total += spent;
+        cycles[i] = spent;
+    }
+
+    for(i = 0u; i < BENCH_LIVE_MAX; i++)
+    {
+        allocator->free(slot[i]);
+    }
+    result->meanCycles = (double) total / (double) operations;
+    qsort(cycles, operations, sizeof(cycles[0]), &CompareCycles);
+    result->p999Cycles = cycles[((uint64_t) operations * 999u) / 1000u];
+}
+
+
+/*******************************************************************************
+* Function Name: Compare()
+********************************************************************************
+*
+* Summary:
+*   Replays one trace on a pool and on first-fit over the same bytes.
+*
+*******************************************************************************/
+static void Compare(const char *name, const ALLOCATOR_T *pool, uint32 bytes, uint32 blocks,
+                    uint32 largest, TRACE_OP_T trace[], uint64_t cycles[], uint32 operations)
+{
+    static const ALLOCATOR_T firstFit = { &FirstFit_Alloc, &FirstFit_Free };
+    BENCH_RESULT_T poolResult;
+    BENCH_RESULT_T fitResult;
+
+    MakeTrace(trace, operations, blocks, largest);
+
+    Replay(pool, trace, cycles, operations, &poolResult);
+    FirstFit_Init(bytes);
+    Replay(&firstFit, trace, cycles, operations, &fitResult);
+
+    printf("%-24s %6u bytes, sizes 1..%u\n", name, (unsigned int) bytes, (unsigned int) largest);
+    printf("  %-10s mean %7.1f  99.9%% %6llu  failed %6u of %u\n", "pool", poolResult.meanCycles,
+           (unsigned long long) poolResult.p999Cycles, (unsigned int) poolResult.failures,
+           (unsigned int) poolResult.allocs);
+    printf("  %-10s mean %7.1f  99.9%% %6llu  failed %6u of %u\n", "first-fit", fitResult.meanCycles,
+           (unsigned long long) fitResult.p999Cycles, (unsigned int) fitResult.failures,
+           (unsigned int) fitResult.allocs);
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const ALLOCATOR_T bufPool = { &BufPool_Alloc, &BufPool_Free };
+    static const ALLOCATOR_T blockPool = { &BenchPool_Alloc, &BenchPool_Free };
+    uint32 operations = (argc > 1) ? (uint32)strtoul(argv[1], NULL, 0) : OPERATIONS_DEFAULT;
+    uint32 blocks = (argc > 2) ? (uint32)strtoul(argv[2], NULL, 0) : BLOCKS_DEFAULT;
+    uint32 seed = (argc > 3) ? (uint32)strtoul(argv[3], NULL, 0) : SEED_DEFAULT;
+    BLOCK_POOL_STATS_T stats;
+    TRACE_OP_T *trace;
+    uint64_t *cycles;
+    uint32 largest;
+    uint32 bytes;
+    uint32 i;
+
+    if((argc > 4) || (operations == 0u) || (blocks == 0u) || (blocks > BENCH_LIVE_MAX))
+    {
+        fprintf(stderr, "usage: blockpoolbench [OPERATIONS] [BLOCKS] [SEED]\n"
+                        "  BLOCKS 1..%u, defaults %u %u %u\n",
+                BENCH_LIVE_MAX, OPERATIONS_DEFAULT, BLOCKS_DEFAULT, SEED_DEFAULT);
+        return 2;
+    }
+    trace = (TRACE_OP_T *) malloc(operations * sizeof(TRACE_OP_T));
+    cycles = (uint64_t *) malloc(operations * sizeof(uint64_t));
+    if((trace == NULL) || (cycles == NULL))
+    {
+        return 2;
+    }
+    srand(seed);
+#if (BENCH_ISR_ENABLED)
+    (void) sigemptyset(&isrMask);
+    (void) sigaddset(&isrMask, SIGALRM);
+#endif /* (BENCH_ISR_ENABLED) */
+
+    printf("Stress\n");
+    StressBlockPool(sizeof(void *), 1u, operations / 8u);
+    StressBlockPool(12u, 7u, operations / 8u);
+    StressBlockPool(BENCH_BLOCK_SIZE, blocks, operations);
+    StressBlockPool(64u, BENCH_LIVE_MAX, operations);
+    StressBufPool(operations);
+    for(i = 0u; i < BUF_POOL_CLASS_COUNT; i++)
+    {
+        BufPool_GetStats(i, &stats);
+        printf("  class %u: %3u x %3u bytes, max used %u, empty %u\n", (unsigned int) i,
+               (unsigned int) stats.count, (unsigned int) stats.blockSize, (unsigned int) stats.maxUsed,
+               (unsigned int) stats.failures);
+    }
+    printf("  %s\n\n", (failed == 0u) ? "passed" : "FAILED");
+
+    printf("Benchmark, %s per operation\n",
+#if defined(__x86_64__) || defined(__i386__)
+           "cycles"
+#else
+           "ns"
+#endif /* defined(__x86_64__) || defined(__i386__) */
+          );
+    BufPool_Start();
+    bytes = BufPoolBytes(&largest);
+    Compare("bufpool (Options.h)", &bufPool, bytes, BufPool_Available(1u), largest, trace, cycles, operations);
+
+    BlockPool_Init(&benchPool, benchPoolStorage, BENCH_BLOCK_SIZE, blocks);
+    Compare("blockpool", &blockPool, blocks * BENCH_BLOCK_SIZE, blocks, BENCH_BLOCK_SIZE, trace, cycles,
+            operations);
+
+    free(cycles);
+    free(trace);
+    return (failed == 0u) ? 0 : 1;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,708 @@
+/*******************************************************************************
+* File Name: cyacdstore.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host tool that keeps every released .cyacd image in a content-addressed
+*  row store. Each flash row is stored once under the SHA-256 of its data and
+*  every image is described by a small manifest listing (array, row, hash).
+*  Differences between two releases are computed from the manifests alone by
+*  a single merge walk, so the cost is proportional to the row count and no
+*  image file is re-read.
+*
+*  Store layout:
+*   <store>/rows/<sha256>         - raw row data, shared by all releases
+*   <store>/manifests/<name>.man  - one manifest per release
+*
+*  Build:
+*   gcc -O2 -I Host -I ../Shared -o cyacdstore cyacdstore.c ../Shared/sha256.c
+*
+*  Usage:
+*   cyacdstore add     <store> <name> <image.cyacd>
+*   cyacdstore diff    <store> <nameA> <nameB>
+*   cyacdstore extract <store> <name> <image.cyacd>
+*   cyacdstore stats   <store> <name>...
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+    #include <direct.h>
+    #define MKDIR(path)         _mkdir(path)
+#else
+    #define MKDIR(path)         mkdir((path), 0777)
+#endif /* defined(_WIN32) */
+
+#include "sha256.h"
+
+#define CYACD_ROW_SIZE_MAX      (256u)
+#define CYACD_LINE_MAX          (2u * (CYACD_ROW_SIZE_MAX + 8u) + 16u)
+#define HASH_HEX_SIZE           (2u * SHA256_DIGEST_SIZE + 1u)
+#define PATH_SIZE_MAX           (1024u)
+
+#define MANIFEST_SIGNATURE      "# cyacdstore manifest v1"
+
+
+/***************************************
+*       Data Types
+***************************************/
+typedef struct
+{
+    uint8  arrayId;
+    uint16 rowNum;
+    uint16 length;
+    char8  hash[HASH_HEX_SIZE];
+} ROW_REF_T;
+
+typedef struct
+{
+    uint32     siliconId;
+    uint8      siliconRev;
+    uint8      checksumType;
+    uint32     rowCount;
+    uint32     rowCapacity;
+    ROW_REF_T *rows;
+} MANIFEST_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+static int  ParseHex(const char8 *text, uint32 digits, uint32 *value);
+static void HashToHex(const uint8 digest[], char8 hex[]);
+static int  ManifestAppend(MANIFEST_T *manifest, const ROW_REF_T *row);
+static int  CompareRows(const void *a, const void *b);
+static int  CompareHashes(const void *a, const void *b);
+static void ManifestPath(char8 path[], const char8 *store, const char8 *name);
+static int  ManifestRead(const char8 *store, const char8 *name, MANIFEST_T *manifest);
+static int  ManifestWrite(const char8 *store, const char8 *name, const MANIFEST_T *manifest);
+static int  StorePutRow(const char8 *store, const uint8 data[], uint16 length, char8 hash[], uint32 *isNew);
+static int  CommandAdd(const char8 *store, const char8 *name, const char8 *imagePath);
+static int  CommandDiff(const char8 *store, const char8 *nameA, const char8 *nameB);
+static int  CommandExtract(const char8 *store, const char8 *name, const char8 *imagePath);
+static int  CommandStats(const char8 *store, int count, char8 *names[]);
+
+
+/*******************************************************************************
+* Function Name: ParseHex()
+********************************************************************************
+*
+* Summary:
+*   Parses a fixed number of hexadecimal digits.
+*
+* Return:
+*   0 on success, -1 if a non-hexadecimal character was found.
+*
+*******************************************************************************/
+static int ParseHex(const char8 *text, uint32 digits, uint32 *value)
+{
+    uint32 result = 0u;
+    uint32 i;
+
+    for(i = 0u; i < digits; i++)
+    {
+        char8 c = text[i];
+
+        result <<= 4u;
+        if((c >= '0') && (c <= '9'))
+        {
+            result |= (uint32)(c - '0');
+        }
+        else if((c >= 'a') && (c <= 'f'))
+        {
+            result |= (uint32)(c - 'a' + 10);
+        }
+        else if((c >= 'A') && (c <= 'F'))
+        {
+            result |= (uint32)(c - 'A' + 10);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    *value = result;
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: HashToHex()
+*******************************************************************************/
+static void HashToHex(const uint8 digest[], char8 hex[])
+{
+    static const char8 digits[] = "0123456789abcdef";
+    uint32 i;
+
+    for(i = 0u; i < SHA256_DIGEST_SIZE; i++)
+    {
+        hex[i * 2u] = digits[digest[i] >> 4u];
+        hex[(i * 2u) + 1u] = digits[digest[i] & 0x0Fu];
+    }
+    hex[SHA256_DIGEST_SIZE * 2u] = '\0';
+}
+
+
+/*******************************************************************************
+* Function Name: ManifestAppend()
+*******************************************************************************/
+static int ManifestAppend(MANIFEST_T *manifest, const ROW_REF_T *row)
+{
+    if(manifest->rowCount == manifest->rowCapacity)
+    {
+        uint32 capacity = (manifest->rowCapacity == 0u) ? 256u : (manifest->rowCapacity * 2u);
+        ROW_REF_T *rows = realloc(manifest->rows, capacity * sizeof(ROW_REF_T));
+
+        if(rows == NULL)
+        {
+            return -1;
+        }
+        manifest->rows = rows;
+        manifest->rowCapacity = capacity;
+    }
+    manifest->rows[manifest->rowCount] = *row;
+    manifest->rowCount++;
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: CompareRows()
+*******************************************************************************/
+static int CompareRows(const void *a, const void *b)
+{
+    const ROW_REF_T *rowA = a;
+    const ROW_REF_T *rowB = b;
+    uint32 keyA = ((uint32)rowA->arrayId << 16u) | rowA->rowNum;
+    uint32 keyB = ((uint32)rowB->arrayId << 16u) | rowB->rowNum;
+
+    return (keyA > keyB) - (keyA < keyB);
+}
+
+
+/*******************************************************************************
+* Function Name: CompareHashes()
+*******************************************************************************/
+static int CompareHashes(const void *a, const void *b)
+{
+    return strcmp(((const ROW_REF_T *)a)->hash, ((const ROW_REF_T *)b)->hash);
+}
+
+
+/*******************************************************************************
+* Function Name: ManifestPath()
+*******************************************************************************/
+static void ManifestPath(char8 path[], const char8 *store, const char8 *name)
+{
+    (void)snprintf(path, PATH_SIZE_MAX, "%s/manifests/%s.man", store, name);
+}
+
+
+/*******************************************************************************
+* Function Name: ManifestRead()
+********************************************************************************
+*
+* Summary:
+*   Loads a manifest. Rows are kept in the on-disk order, which ManifestWrite()
+*   guarantees to be sorted by array and row number.
+*
+*******************************************************************************/
+static int ManifestRead(const char8 *store, const char8 *name, MANIFEST_T *manifest)
+{
+    char8 path[PATH_SIZE_MAX];
+    char8 line[256u];
+    FILE *file;
+    int result = 0;
+
+    memset(manifest, 0, sizeof(*manifest));
+    ManifestPath(path, store, name);
+    file = fopen(path, "r");
+    if(file == NULL)
+    {
+        fprintf(stderr, "ERROR: can't open manifest %s\n", path);
+        return -1;
+    }
+
+    if((fgets(line, sizeof(line), file) == NULL) ||
+       (strncmp(line, MANIFEST_SIGNATURE, strlen(MANIFEST_SIGNATURE)) != 0))
+    {
+        fprintf(stderr, "ERROR: %s is not a manifest\n", path);
+        result = -1;
+    }
+
+    while((result == 0) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        unsigned int siliconId, siliconRev, checksumType;
+        unsigned int arrayId, rowNum, length;
+        ROW_REF_T row;
+
+        if(sscanf(line, "header %8x %2x %2x", &siliconId, &siliconRev, &checksumType) == 3)
+        {
+            manifest->siliconId = siliconId;
+            manifest->siliconRev = (uint8)siliconRev;
+            manifest->checksumType = (uint8)checksumType;
+        }
+        else if(sscanf(line, "row %2x %4x %4x %64s", &arrayId, &rowNum, &length, row.hash) == 4)
+        {
+            row.arrayId = (uint8)arrayId;
+            row.rowNum = (uint16)rowNum;
+            row.length = (uint16)length;
+            result = ManifestAppend(manifest, &row);
+        }
+        else
+        {
+            /* Comments and empty lines are ignored */
+        }
+    }
+
+    fclose(file);
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: ManifestWrite()
+*******************************************************************************/
+static int ManifestWrite(const char8 *store, const char8 *name, const MANIFEST_T *manifest)
+{
+    char8 path[PATH_SIZE_MAX];
+    FILE *file;
+    uint32 i;
+
+    ManifestPath(path, store, name);
+    file = fopen(path, "w");
+    if(file == NULL)
+    {
+        fprintf(stderr, "ERROR: can't create manifest %s\n", path);
+        return -1;
+    }
+
+    fprintf(file, "%s\n", MANIFEST_SIGNATURE);
+    fprintf(file, "header %08X %02X %02X\n", (unsigned int)manifest->siliconId,
+            manifest->siliconRev, manifest->checksumType);
+    for(i = 0u; i < manifest->rowCount; i++)
+    {
+        const ROW_REF_T *row = &manifest->rows[i];
+        fprintf(file, "row %02X %04X %04X %s\n", row->arrayId, row->rowNum, row->length, row->hash);
+    }
+
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+
+/*******************************************************************************
+* Function Name: StorePutRow()
+********************************************************************************
+*
+* Summary:
+*   Hashes the row data and writes it to the store unless an object with the
+*   same hash is already there.
+*
+* Parameters:
+*  isNew - set to 1 if the row was not present in the store before
+*
+*******************************************************************************/
+static int StorePutRow(const char8 *store, const uint8 data[], uint16 length, char8 hash[], uint32 *isNew)
+{
+    char8 path[PATH_SIZE_MAX];
+    uint8 digest[SHA256_DIGEST_SIZE];
+    SHA256_CTX_T ctx;
+    struct stat info;
+    FILE *file;
+
+    Sha256_Init(&ctx);
+    Sha256_Update(&ctx, data, length);
+    Sha256_Final(&ctx, digest);
+    HashToHex(digest, hash);
+
+    (void)snprintf(path, sizeof(path), "%s/rows/%s", store, hash);
+    *isNew = 0u;
+    if(stat(path, &info) == 0)
+    {
+        return 0;
+    }
+
+    file = fopen(path, "wb");
+    if((file == NULL) || (fwrite(data, 1u, length, file) != length))
+    {
+        fprintf(stderr, "ERROR: can't write row object %s\n", path);
+        if(file != NULL)
+        {
+            fclose(file);
+        }
+        return -1;
+    }
+    *isNew = 1u;
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandAdd()
+********************************************************************************
+*
+* Summary:
+*   Splits a .cyacd file into rows, stores the rows that are not yet in the
+*   store and writes the manifest of the image.
+*
+*******************************************************************************/
+static int CommandAdd(const char8 *store, const char8 *name, const char8 *imagePath)
+{
+    char8 path[PATH_SIZE_MAX];
+    char8 line[CYACD_LINE_MAX];
+    uint8 data[CYACD_ROW_SIZE_MAX];
+    MANIFEST_T manifest;
+    uint32 newRows = 0u;
+    uint32 lineNum = 1u;
+    uint32 value;
+    FILE *file;
+    int result = 0;
+
+    memset(&manifest, 0, sizeof(manifest));
+    (void)MKDIR(store);
+    (void)snprintf(path, sizeof(path), "%s/rows", store);
+    (void)MKDIR(path);
+    (void)snprintf(path, sizeof(path), "%s/manifests", store);
+    (void)MKDIR(path);
+
+    file = fopen(imagePath, "r");
+    if(file == NULL)
+    {
+        fprintf(stderr, "ERROR: can't open %s\n", imagePath);
+        return -1;
+    }
+
+    /* Header: 4 bytes silicon ID, 1 byte silicon revision, 1 byte checksum type */
+    if((fgets(line, sizeof(line), file) == NULL) || (ParseHex(line, 8u, &manifest.siliconId) != 0) ||
+       (ParseHex(&line[8], 2u, &value) != 0))
+    {
+        fprintf(stderr, "ERROR: %s: bad header\n", imagePath);
+        fclose(file);
+        return -1;
+    }
+    manifest.siliconRev = (uint8)value;
+    manifest.checksumType = (ParseHex(&line[10], 2u, &value) == 0) ? (uint8)value : 0u;
+
+    /* Rows: ':' array ID (1), row number (2), data length (2), data, checksum (1) */
+    while((result == 0) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        uint32 arrayId, rowNum, length, checksum, i;
+        uint8 sum;
+        ROW_REF_T row;
+        uint32 isNew;
+
+        lineNum++;
+        if((line[0] == '\r') || (line[0] == '\n') || (line[0] == '\0'))
+        {
+            continue;
+        }
+        if((line[0] != ':') || (ParseHex(&line[1], 2u, &arrayId) != 0) ||
+           (ParseHex(&line[3], 4u, &rowNum) != 0) || (ParseHex(&line[7], 4u, &length) != 0) ||
+           (length > CYACD_ROW_SIZE_MAX) || (strlen(line) < (11u + (2u * length) + 2u)))
+        {
+            fprintf(stderr, "ERROR: %s:%u: malformed row\n", imagePath, (unsigned int)lineNum);
+            result = -1;
+            break;
+        }
+
+        sum = (uint8)(arrayId + (rowNum >> 8u) + rowNum + (length >> 8u) + length);
+        for(i = 0u; i < length; i++)
+        {
+            (void)ParseHex(&line[11u + (2u * i)], 2u, &value);
+            data[i] = (uint8)value;
+            sum += data[i];
+        }
+        if((ParseHex(&line[11u + (2u * length)], 2u, &checksum) != 0) || ((uint8)(sum + checksum) != 0u))
+        {
+            fprintf(stderr, "ERROR: %s:%u: row checksum mismatch\n", imagePath, (unsigned int)lineNum);
+            result = -1;
+            break;
+        }
+
+        row.arrayId = (uint8)arrayId;
+        row.rowNum = (uint16)rowNum;
+        row.length = (uint16)length;
+        result = StorePutRow(store, data, row.length, row.hash, &isNew);
+        newRows += isNew;
+        if(result == 0)
+        {
+            result = ManifestAppend(&manifest, &row);
+        }
+    }
+    fclose(file);
+
+    if(result == 0)
+    {
+        qsort(manifest.rows, manifest.rowCount, sizeof(ROW_REF_T), &CompareRows);
+        result = ManifestWrite(store, name, &manifest);
+    }
+    if(result == 0)
+    {
+        printf("%s: %u rows, %u new row objects\n", name, (unsigned int)manifest.rowCount, (unsigned int)newRows);
+    }
+
+    free(manifest.rows);
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandDiff()
+********************************************************************************
+*
+* Summary:
+*   Lists the rows that differ between two images. Both manifests are sorted,
+*   so a single merge pass finds added ('+'), removed ('-') and changed ('*')
+*   rows. The row objects themselves are never opened.
+*
+* Return:
+*   0 if the images are identical, 1 if they differ, -1 on error.
+*
+*******************************************************************************/
+static int CommandDiff(const char8 *store, const char8 *nameA, const char8 *nameB)
+{
+    MANIFEST_T a, b;
+    uint32 i = 0u, j = 0u;
+    uint32 added = 0u, removed = 0u, changed = 0u, same = 0u;
+
+    if((ManifestRead(store, nameA, &a) != 0) || (ManifestRead(store, nameB, &b) != 0))
+    {
+        return -1;
+    }
+
+    if((a.siliconId != b.siliconId) || (a.siliconRev != b.siliconRev))
+    {
+        printf("! silicon ID differs: %08X/%02X -> %08X/%02X\n", (unsigned int)a.siliconId, a.siliconRev,
+               (unsigned int)b.siliconId, b.siliconRev);
+    }
+
+    while((i < a.rowCount) || (j < b.rowCount))
+    {
+        int order;
+
+        if(i == a.rowCount)
+        {
+            order = 1;
+        }
+        else if(j == b.rowCount)
+        {
+            order = -1;
+        }
+        else
+        {
+            order = CompareRows(&a.rows[i], &b.rows[j]);
+        }
+
+        if(order < 0)
+        {
+            printf("- %02X %04X\n", a.rows[i].arrayId, a.rows[i].rowNum);
+            removed++;
+            i++;
+        }
+        else if(order > 0)
+        {
+            printf("+ %02X %04X %s\n", b.rows[j].arrayId, b.rows[j].rowNum, b.rows[j].hash);
+            added++;
+            j++;
+        }
+        else
+        {
+            if(strcmp(a.rows[i].hash, b.rows[j].hash) != 0)
+            {
+                printf("* %02X %04X %s\n", b.rows[j].arrayId, b.rows[j].rowNum, b.rows[j].hash);
+                changed++;
+            }
+            else
+            {
+                same++;
+            }
+            i++;
+            j++;
+        }
+    }
+
+    printf("%s -> %s: %u unchanged, %u changed, %u added, %u removed\n", nameA, nameB,
+           (unsigned int)same, (unsigned int)changed, (unsigned int)added, (unsigned int)removed);
+
+    free(a.rows);
+    free(b.rows);
+    return ((changed + added + removed) == 0u) ? 0 : 1;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandExtract()
+********************************************************************************
+*
+* Summary:
+*   Rebuilds a .cyacd file from its manifest and the row objects.
+*
+*******************************************************************************/
+static int CommandExtract(const char8 *store, const char8 *name, const char8 *imagePath)
+{
+    MANIFEST_T manifest;
+    uint8 data[CYACD_ROW_SIZE_MAX];
+    char8 path[PATH_SIZE_MAX];
+    FILE *out;
+    uint32 i, k;
+    int result = 0;
+
+    if(ManifestRead(store, name, &manifest) != 0)
+    {
+        return -1;
+    }
+    out = fopen(imagePath, "w");
+    if(out == NULL)
+    {
+        fprintf(stderr, "ERROR: can't create %s\n", imagePath);
+        free(manifest.rows);
+        return -1;
+    }
+
+    fprintf(out, "%08X%02X%02X\n", (unsigned int)manifest.siliconId, manifest.siliconRev, manifest.checksumType);
+    for(i = 0u; (i < manifest.rowCount) && (result == 0); i++)
+    {
+        const ROW_REF_T *row = &manifest.rows[i];
+        FILE *obj;
+        uint8 sum;
+
+        (void)snprintf(path, sizeof(path), "%s/rows/%s", store, row->hash);
+        obj = fopen(path, "rb");
+        if((obj == NULL) || (fread(data, 1u, row->length, obj) != row->length))
+        {
+            fprintf(stderr, "ERROR: missing or short row object %s\n", path);
+            result = -1;
+        }
+        if(obj != NULL)
+        {
+            fclose(obj);
+        }
+        if(result != 0)
+        {
+            break;
+        }
+
+        sum = (uint8)(row->arrayId + (row->rowNum >> 8u) + row->rowNum + (row->length >> 8u) + row->length);
+        fprintf(out, ":%02X%04X%04X", row->arrayId, row->rowNum, row->length);
+        for(k = 0u; k < row->length; k++)
+        {
+            fprintf(out, "%02X", data[k]);
+            sum += data[k];
+        }
+        fprintf(out, "%02X\n", (uint8)(0u - sum));
+    }
+
+    if(fclose(out) != 0)
+    {
+        result = -1;
+    }
+    free(manifest.rows);
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandStats()
+********************************************************************************
+*
+* Summary:
+*   Reports how many distinct row objects the given releases reference and
+*   how much the store saves compared to keeping full images.
+*
+*******************************************************************************/
+static int CommandStats(const char8 *store, int count, char8 *names[])
+{
+    MANIFEST_T all;
+    uint32 referenced = 0u;
+    uint32 unique = 0u;
+    uint32 i;
+    int n;
+
+    memset(&all, 0, sizeof(all));
+    for(n = 0; n < count; n++)
+    {
+        MANIFEST_T manifest;
+
+        if(ManifestRead(store, names[n], &manifest) != 0)
+        {
+            free(all.rows);
+            return -1;
+        }
+        for(i = 0u; i < manifest.rowCount; i++)
+        {
+            if(ManifestAppend(&all, &manifest.rows[i]) != 0)
+            {
+                free(manifest.rows);
+                free(all.rows);
+                return -1;
+            }
+        }
+        referenced += manifest.rowCount;
+        free(manifest.rows);
+    }
+
+    /* Sort by hash to count distinct objects */
+    qsort(all.rows, all.rowCount, sizeof(ROW_REF_T), &CompareHashes);
+    for(i = 0u; i < all.rowCount; i++)
+    {
+        if((i == 0u) || (strcmp(all.rows[i].hash, all.rows[i - 1u].hash) != 0))
+        {
+            unique++;
+        }
+    }
+
+    printf("%d releases reference %u rows stored as %u row objects (%.1f%% of full images)\n",
+           count, (unsigned int)referenced, (unsigned int)unique,
+           (referenced != 0u) ? (100.0 * unique / referenced) : 0.0);
+    free(all.rows);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    int result = -1;
+
+    if((argc == 5) && (strcmp(argv[1], "add") == 0))
+    {
+        result = CommandAdd(argv[2], argv[3], argv[4]);
+    }
+    else if((argc == 5) && (strcmp(argv[1], "diff") == 0))
+    {
+        result = CommandDiff(argv[2], argv[3], argv[4]);
+    }
+    else if((argc == 5) && (strcmp(argv[1], "extract") == 0))
+    {
+        result = CommandExtract(argv[2], argv[3], argv[4]);
+    }
+    else if((argc >= 4) && (strcmp(argv[1], "stats") == 0))
+    {
+        result = CommandStats(argv[2], argc - 3, &argv[3]);
+    }
+    else
+    {
+        fprintf(stderr,
+            "usage: cyacdstore add     <store> <name> <image.cyacd>\n"
+            "       cyacdstore diff    <store> <nameA> <nameB>\n"
+            "       cyacdstore extract <store> <name> <image.cyacd>\n"
+            "       cyacdstore stats   <store> <name>...\n");
+        return 2;
+    }
+
+    return (result < 0) ? 2 : result;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,675 @@
+/*******************************************************************************
+* File Name: energyest.c
+*
+* Version: 1.30
+*
+* Description:
+*  Estimates the charge drawn by the device from its BLE event trace
+*  (Shared\bletrace.c) and a current model. The trace is split into idle,
+*  advertising and connected time. Every advertising and connection event
+*  is charged with the radio TX/RX time and the CPU wakeup of the model,
+*  GATT writes with their extra packets, and the rest of the time with the
+*  Deep-Sleep current. When power records (BLE_TRACE_EVT_POWER) from the
+*  Bootloader's power statistics or HelloApp's idle manager are present, the
+*  measured active, Sleep and Deep-Sleep residency replaces the modelled MCU
+*  charge for the time they cover, and the average current is based on it.
+*
+*  The result is given per hour and for every connection. A connection with
+*  at least ota_min_writes GATT writes is counted as an OTA session.
+*
+*  Input is a UART capture with "@T" lines, or with --binary the saved trace
+*  notifications (8-byte little-endian records). --simulate builds the trace
+*  of an OTA of the given number of bytes instead, so the effect of the
+*  connection interval and of the model values can be compared without a
+*  device.
+*
+*  The model file holds "key = value" lines, see modelKeys[] below; currents
+*  are in uA and times in us unless the key says otherwise. The defaults are
+*  typical CY8C4247LQI-BL483 values at 3.3 V and 0 dBm.
+*
+*  Build:
+*   gcc -O2 -I Host -o energyest energyest.c
+*
+*  Usage:
+*   energyest [--model FILE] [--binary] [FILE]
+*   energyest [--model FILE] --simulate BYTES [--interval UNITS] [--write-size BYTES]
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cytypes.h>
+
+#define TICKS_PER_SEC           (32768.0)
+#define LINE_SIZE_MAX           (512u)
+#define CONNECTIONS_MAX         (256u)
+
+/* CYBLE_EVT_* codes (HelloApp.cydsn\OTAMandatory.h) */
+#define EVT_STACK_ON            (0x0001u)
+#define EVT_CONNECTED           (0x0027u)
+#define EVT_DISCONNECTED        (0x0028u)
+#define EVT_CONN_UPDATE         (0x002Bu)
+#define EVT_WRITE_REQ           (0x004Cu)
+#define EVT_WRITE_CMD_REQ       (0x004Eu)
+
+/* BLE_TRACE_EVT_POWER + POWER_STATE_* (Shared\bletrace.h) */
+#define EVT_POWER_ACTIVE        (0xF100u)
+#define EVT_POWER_SLEEP         (0xF101u)
+#define EVT_POWER_DEEPSLEEP     (0xF102u)
+
+/* Simulation defaults */
+#define SIM_ADV_MS              (2000u)
+#define SIM_INTERVAL_DEFAULT    (6u)        /* 7.5 ms */
+#define SIM_WRITE_SIZE_DEFAULT  (20u)       /* Default MTU */
+#define SIM_ROW_SIZE            (128u)
+#define SIM_ROW_PROGRAM_MS      (20u)
+
+typedef struct
+{
+    uint32 stamp;
+    uint32 event;
+    uint32 digest;
+} RECORD_T;
+
+typedef struct
+{
+    RECORD_T *record;
+    uint32 count;
+    uint32 capacity;
+} TRACE_T;
+
+typedef struct
+{
+    double deepSleepUa;
+    double sleepUa;
+    double activeUa;
+    double txUa;
+    double rxUa;
+    double connTxUs;
+    double connRxUs;
+    double connCpuUs;
+    double advTxUs;
+    double advRxUs;
+    double advCpuUs;
+    double advFastMs;
+    double advFastTimeoutS;
+    double advSlowMs;
+    double connIntervalMs;
+    double packetUs;
+    double writePackets;
+    double otaMinWrites;
+} MODEL_T;
+
+typedef struct
+{
+    const char *key;
+    size_t offset;
+} MODEL_KEY_T;
+
+#define MODEL_KEY(key, field)   { key, offsetof(MODEL_T, field) }
+
+static const MODEL_KEY_T modelKeys[] =
+{
+    MODEL_KEY("deepsleep_ua", deepSleepUa),
+    MODEL_KEY("sleep_ua", sleepUa),
+    MODEL_KEY("active_ua", activeUa),
+    MODEL_KEY("tx_ua", txUa),
+    MODEL_KEY("rx_ua", rxUa),
+    MODEL_KEY("conn_tx_us", connTxUs),          /* Radio TX per connection event */
+    MODEL_KEY("conn_rx_us", connRxUs),          /* Radio RX per connection event */
+    MODEL_KEY("conn_cpu_us", connCpuUs),        /* CPU active per connection event */
+    MODEL_KEY("adv_tx_us", advTxUs),            /* Radio TX per advertising event, 3 channels */
+    MODEL_KEY("adv_rx_us", advRxUs),
+    MODEL_KEY("adv_cpu_us", advCpuUs),
+    MODEL_KEY("adv_fast_ms", advFastMs),        /* Fast advertising interval */
+    MODEL_KEY("adv_fast_timeout_s", advFastTimeoutS),
+    MODEL_KEY("adv_slow_ms", advSlowMs),
+    MODEL_KEY("conn_interval_ms", connIntervalMs), /* When the trace has none */
+    MODEL_KEY("packet_us", packetUs),           /* One 27-byte data PDU on air */
+    MODEL_KEY("write_packets", writePackets),   /* Data PDUs per GATT write */
+    MODEL_KEY("ota_min_writes", otaMinWrites)
+};
+
+static const MODEL_T modelDefault =
+{
+    1.3,        /* deepsleep_ua */
+    1300.0,     /* sleep_ua */
+    5600.0,     /* active_ua */
+    16500.0,    /* tx_ua */
+    16400.0,    /* rx_ua */
+    150.0,      /* conn_tx_us */
+    150.0,      /* conn_rx_us */
+    100.0,      /* conn_cpu_us */
+    1130.0,     /* adv_tx_us */
+    450.0,      /* adv_rx_us */
+    150.0,      /* adv_cpu_us */
+    20.0,       /* adv_fast_ms */
+    30.0,       /* adv_fast_timeout_s */
+    1000.0,     /* adv_slow_ms */
+    7.5,        /* conn_interval_ms */
+    328.0,      /* packet_us */
+    1.0,        /* write_packets */
+    16.0        /* ota_min_writes */
+};
+
+/* Charge in uA*s */
+typedef struct
+{
+    double seconds;
+    double mcuModel;            /* Deep-Sleep baseline and CPU wakeups */
+    double mcuMeasured;         /* From power records */
+    double measuredSeconds;
+    double connRadio;
+    double advRadio;
+    double dataRadio;
+    uint32 writes;
+} CHARGE_T;
+
+typedef struct
+{
+    double start;
+    double intervalMs;
+    CHARGE_T charge;
+} CONNECTION_T;
+
+enum
+{
+    STATE_IDLE,
+    STATE_ADVERTISING,
+    STATE_CONNECTED
+};
+
+
+/*******************************************************************************
+* Function Name: TraceAdd()
+********************************************************************************
+*
+* Summary:
+*   Appends a record, growing the array as needed.
+*
+*******************************************************************************/
+static void TraceAdd(TRACE_T *trace, uint32 stamp, uint32 event, uint32 digest)
+{
+    if(trace->count == trace->capacity)
+    {
+        trace->capacity = (trace->capacity != 0u) ? (trace->capacity * 2u) : 1024u;
+        trace->record = realloc(trace->record, trace->capacity * sizeof(RECORD_T));
+        if(trace->record == NULL)
+        {
+            fprintf(stderr, "energyest: out of memory\n");
+            exit(2);
+        }
+    }
+    trace->record[trace->count].stamp = stamp;
+    trace->record[trace->count].event = event;
+    trace->record[trace->count].digest = digest;
+    trace->count++;
+}
+
+
+/*******************************************************************************
+* Function Name: ReadText()
+********************************************************************************
+*
+* Summary:
+*   Picks "@T" lines out of a UART capture.
+*
+*******************************************************************************/
+static void ReadText(FILE *file, TRACE_T *trace)
+{
+    char line[LINE_SIZE_MAX];
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        char *record = strstr(line, "@T ");
+        unsigned long stamp;
+        unsigned int event;
+        unsigned int digest;
+
+        if((record != NULL) && (sscanf(record, "@T %lx %x %x", &stamp, &event, &digest) == 3))
+        {
+            TraceAdd(trace, (uint32) stamp, event, digest);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ReadBinary()
+********************************************************************************
+*
+* Summary:
+*   Reads concatenated 8-byte records.
+*
+*******************************************************************************/
+static void ReadBinary(FILE *file, TRACE_T *trace)
+{
+    uint8 record[8];
+
+    while(fread(record, sizeof(record), 1u, file) == 1u)
+    {
+        TraceAdd(trace, (uint32) record[0] | ((uint32) record[1] << 8) |
+                        ((uint32) record[2] << 16) | ((uint32) record[3] << 24),
+                 (uint32) record[4] | ((uint32) record[5] << 8),
+                 (uint32) record[6] | ((uint32) record[7] << 8));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ReadModel()
+********************************************************************************
+*
+* Summary:
+*   Overrides model values from a "key = value" file.
+*
+*******************************************************************************/
+static int ReadModel(const char *path, MODEL_T *model)
+{
+    char line[LINE_SIZE_MAX];
+    FILE *file = fopen(path, "r");
+    uint32 lineNumber = 0u;
+
+    if(file == NULL)
+    {
+        fprintf(stderr, "energyest: cannot open %s\n", path);
+        return 0;
+    }
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        char key[64];
+        double value;
+        uint32 i;
+
+        lineNumber++;
+        if((line[strspn(line, " \t\r\n")] == '\0') || (line[strspn(line, " \t")] == '#'))
+        {
+            continue;
+        }
+        if(sscanf(line, " %63[a-z_] = %lf", key, &value) != 2)
+        {
+            fprintf(stderr, "energyest: %s:%u: expected key = value\n", path, lineNumber);
+            fclose(file);
+            return 0;
+        }
+        for(i = 0u; i < (sizeof(modelKeys) / sizeof(modelKeys[0])); i++)
+        {
+            if(strcmp(key, modelKeys[i].key) == 0)
+            {
+                *(double *)((char *) model + modelKeys[i].offset) = value;
+                break;
+            }
+        }
+        if(i == (sizeof(modelKeys) / sizeof(modelKeys[0])))
+        {
+            fprintf(stderr, "energyest: %s:%u: unknown key %s\n", path, lineNumber, key);
+            fclose(file);
+            return 0;
+        }
+    }
+
+    fclose(file);
+    return 1;
+}
+
+
+/*******************************************************************************
+* Function Name: Simulate()
+********************************************************************************
+*
+* Summary:
+*   Builds the trace of one OTA: advertising, a connection, one write
+*   request per WRITE_SIZE bytes, each taking two connection events, the
+*   flash programming time per row and the disconnect.
+*
+*******************************************************************************/
+static void Simulate(TRACE_T *trace, uint32 bytes, uint32 interval, uint32 writeSize)
+{
+    double intervalS = (double) interval * 1.25e-3;
+    double now = 0.0;
+    uint32 writes = (bytes + writeSize - 1u) / writeSize;
+    uint32 rows = (bytes + SIM_ROW_SIZE - 1u) / SIM_ROW_SIZE;
+    uint32 i;
+
+#define SIM_STAMP(t)    ((uint32) ((t) * TICKS_PER_SEC))
+
+    TraceAdd(trace, SIM_STAMP(now), EVT_STACK_ON, 0u);
+    now += (double) SIM_ADV_MS / 1000.0;
+    TraceAdd(trace, SIM_STAMP(now), EVT_CONNECTED, interval);
+
+    for(i = 0u; i < writes; i++)
+    {
+        now += 2.0 * intervalS;
+        TraceAdd(trace, SIM_STAMP(now), EVT_WRITE_REQ, 0x0012u);
+    }
+    now += ((double) rows * SIM_ROW_PROGRAM_MS) / 1000.0;
+
+    TraceAdd(trace, SIM_STAMP(now), EVT_DISCONNECTED, 0x13u);
+    now += 1.0;
+    TraceAdd(trace, SIM_STAMP(now), EVT_STACK_ON, 0u);
+
+#undef SIM_STAMP
+}
+
+
+/*******************************************************************************
+* Function Name: Account()
+********************************************************************************
+*
+* Summary:
+*   Charges a span of the given state by the model.
+*
+*******************************************************************************/
+static void Account(CHARGE_T *charge, const MODEL_T *model, uint32 state,
+                    double span, double advElapsed, double intervalMs)
+{
+    double cpuUa = model->activeUa - model->deepSleepUa;
+    double events;
+
+    charge->seconds += span;
+    charge->mcuModel += model->deepSleepUa * span;
+
+    if(state == STATE_CONNECTED)
+    {
+        events = span / (intervalMs / 1000.0);
+        charge->connRadio += events * ((model->txUa * model->connTxUs) + (model->rxUa * model->connRxUs)) * 1e-6;
+        charge->mcuModel += events * cpuUa * model->connCpuUs * 1e-6;
+    }
+    else if(state == STATE_ADVERTISING)
+    {
+        double fast = model->advFastTimeoutS - advElapsed;
+
+        if(fast < 0.0)
+        {
+            fast = 0.0;
+        }
+        if(fast > span)
+        {
+            fast = span;
+        }
+        events = (fast / (model->advFastMs / 1000.0)) + ((span - fast) / (model->advSlowMs / 1000.0));
+        charge->advRadio += events * ((model->txUa * model->advTxUs) + (model->rxUa * model->advRxUs)) * 1e-6;
+        charge->mcuModel += events * cpuUa * model->advCpuUs * 1e-6;
+    }
+    else
+    {
+        /* Idle: baseline only */
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Mcu()
+********************************************************************************
+*
+* Summary:
+*   MCU charge: measured residency where power records cover the time, the
+*   model for the rest.
+*
+*******************************************************************************/
+static double Mcu(const CHARGE_T *charge)
+{
+    double modelShare = 1.0;
+
+    if(charge->seconds > 0.0)
+    {
+        modelShare = 1.0 - (charge->measuredSeconds / charge->seconds);
+        if(modelShare < 0.0)
+        {
+            modelShare = 0.0;
+        }
+    }
+
+    return charge->mcuMeasured + (charge->mcuModel * modelShare);
+}
+
+
+static double Total(const CHARGE_T *charge)
+{
+    return Mcu(charge) + charge->connRadio + charge->advRadio + charge->dataRadio;
+}
+
+
+/*******************************************************************************
+* Function Name: Estimate()
+********************************************************************************
+*
+* Summary:
+*   Walks the trace and prints the estimate.
+*
+*******************************************************************************/
+static void Estimate(const TRACE_T *trace, const MODEL_T *model)
+{
+    static CONNECTION_T connection[CONNECTIONS_MAX];
+    CHARGE_T total;
+    uint32 connections = 0u;
+    uint32 otaSessions = 0u;
+    double otaCharge = 0.0;
+    double otaSeconds = 0.0;
+    double now = 0.0;
+    double advStart = 0.0;
+    double intervalMs = model->connIntervalMs;
+    uint32 state = STATE_IDLE;
+    CHARGE_T *session = NULL;
+    uint32 i;
+
+    memset(&total, 0, sizeof(total));
+
+    for(i = 0u; i < trace->count; i++)
+    {
+        const RECORD_T *record = &trace->record[i];
+        double span = (i == 0u) ? 0.0 :
+            ((double)(uint32)(record->stamp - trace->record[i - 1u].stamp) / TICKS_PER_SEC);
+
+        Account(&total, model, state, span, now - advStart, intervalMs);
+        if(session != NULL)
+        {
+            Account(session, model, state, span, 0.0, intervalMs);
+        }
+        now += span;
+
+        switch(record->event)
+        {
+            case EVT_STACK_ON:
+            case EVT_DISCONNECTED:
+                /* Both images restart advertising right away */
+                state = STATE_ADVERTISING;
+                advStart = now;
+                session = NULL;
+                break;
+            case EVT_CONNECTED:
+            case EVT_CONN_UPDATE:
+                intervalMs = (record->digest != 0u) ? ((double) record->digest * 1.25) : model->connIntervalMs;
+                if((record->event == EVT_CONNECTED) && (connections < CONNECTIONS_MAX))
+                {
+                    session = &connection[connections].charge;
+                    memset(&connection[connections], 0, sizeof(connection[0]));
+                    connection[connections].start = now;
+                    connection[connections].intervalMs = intervalMs;
+                    connections++;
+                }
+                state = STATE_CONNECTED;
+                break;
+            case EVT_WRITE_REQ:
+            case EVT_WRITE_CMD_REQ:
+            {
+                /* The request's PDUs, plus the write response */
+                double packets = model->writePackets + ((record->event == EVT_WRITE_REQ) ? 1.0 : 0.0);
+                double rx = model->rxUa * model->writePackets * model->packetUs * 1e-6;
+                double data = rx + (model->txUa * (packets - model->writePackets) * model->packetUs * 1e-6);
+
+                total.dataRadio += data;
+                total.writes++;
+                if(session != NULL)
+                {
+                    session->dataRadio += data;
+                    session->writes++;
+                }
+                break;
+            }
+            case EVT_POWER_ACTIVE:
+            case EVT_POWER_SLEEP:
+            case EVT_POWER_DEEPSLEEP:
+            {
+                double ua = (record->event == EVT_POWER_ACTIVE) ? model->activeUa :
+                            ((record->event == EVT_POWER_SLEEP) ? model->sleepUa : model->deepSleepUa);
+                double seconds = (double) record->digest / 1000.0;
+
+                total.mcuMeasured += ua * seconds;
+                total.measuredSeconds += seconds;
+                if(session != NULL)
+                {
+                    session->mcuMeasured += ua * seconds;
+                    session->measuredSeconds += seconds;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    printf("trace: %u records, %.3f s, %u connections\n\n", trace->count, total.seconds, connections);
+    if(total.seconds <= 0.0)
+    {
+        return;
+    }
+
+    printf("charge             uAh    share\n");
+    printf("  mcu       %12.4f  %5.1f%%  (measured %.1f s of %.1f s)\n", Mcu(&total) / 3600.0,
+           (100.0 * Mcu(&total)) / Total(&total), total.measuredSeconds, total.seconds);
+    printf("  conn radio%12.4f  %5.1f%%\n", total.connRadio / 3600.0, (100.0 * total.connRadio) / Total(&total));
+    printf("  adv radio %12.4f  %5.1f%%\n", total.advRadio / 3600.0, (100.0 * total.advRadio) / Total(&total));
+    printf("  data radio%12.4f  %5.1f%%  (%u writes)\n", total.dataRadio / 3600.0,
+           (100.0 * total.dataRadio) / Total(&total), total.writes);
+    printf("  total     %12.4f\n\n", Total(&total) / 3600.0);
+    printf("average current %.1f uA, %.4f mAh per hour\n", Total(&total) / total.seconds,
+           (Total(&total) / total.seconds) / 1000.0);
+
+    if(connections != 0u)
+    {
+        printf("\n   #    start s  duration s  interval ms  writes   charge uAh  kind\n");
+        for(i = 0u; i < connections; i++)
+        {
+            const CHARGE_T *charge = &connection[i].charge;
+            int ota = ((double) charge->writes >= model->otaMinWrites);
+
+            printf("%4u %10.3f %11.3f %12.2f %7u %12.4f  %s\n", i + 1u, connection[i].start, charge->seconds,
+                   connection[i].intervalMs, charge->writes, Total(charge) / 3600.0, ota ? "ota" : "-");
+            if(ota)
+            {
+                otaSessions++;
+                otaCharge += Total(charge);
+                otaSeconds += charge->seconds;
+            }
+        }
+    }
+    if(otaSessions != 0u)
+    {
+        printf("\nper OTA session: %.4f uAh over %.3f s (%u sessions)\n",
+               (otaCharge / otaSessions) / 3600.0, otaSeconds / otaSessions, otaSessions);
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    MODEL_T model = modelDefault;
+    TRACE_T trace = { NULL, 0u, 0u };
+    const char *path = NULL;
+    FILE *file = stdin;
+    int binary = 0;
+    uint32 simulate = 0u;
+    uint32 interval = SIM_INTERVAL_DEFAULT;
+    uint32 writeSize = SIM_WRITE_SIZE_DEFAULT;
+    int usage = 0;
+    int i;
+
+    for(i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--binary") == 0)
+        {
+            binary = 1;
+        }
+        else if((strcmp(argv[i], "--model") == 0) && ((i + 1) < argc))
+        {
+            if(!ReadModel(argv[++i], &model))
+            {
+                return 2;
+            }
+        }
+        else if((strcmp(argv[i], "--simulate") == 0) && ((i + 1) < argc))
+        {
+            simulate = (uint32) strtoul(argv[++i], NULL, 0);
+        }
+        else if((strcmp(argv[i], "--interval") == 0) && ((i + 1) < argc))
+        {
+            interval = (uint32) strtoul(argv[++i], NULL, 0);
+        }
+        else if((strcmp(argv[i], "--write-size") == 0) && ((i + 1) < argc))
+        {
+            writeSize = (uint32) strtoul(argv[++i], NULL, 0);
+        }
+        else if((argv[i][0] != '-') && (path == NULL))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            usage = 1;
+        }
+    }
+    if(usage || (interval == 0u) || (writeSize == 0u) || ((simulate != 0u) && (path != NULL)))
+    {
+        fprintf(stderr, "usage: energyest [--model FILE] [--binary] [FILE]\n"
+                        "       energyest [--model FILE] --simulate BYTES [--interval UNITS] [--write-size BYTES]\n");
+        return 2;
+    }
+
+    if(simulate != 0u)
+    {
+        Simulate(&trace, simulate, interval, writeSize);
+        printf("simulated OTA: %u bytes, %u-byte writes, %.2f ms interval\n", simulate, writeSize, interval * 1.25);
+    }
+    else
+    {
+        if(path != NULL)
+        {
+            file = fopen(path, binary ? "rb" : "r");
+            if(file == NULL)
+            {
+                fprintf(stderr, "energyest: cannot open %s\n", path);
+                return 2;
+            }
+        }
+        if(binary != 0)
+        {
+            ReadBinary(file, &trace);
+        }
+        else
+        {
+            ReadText(file, &trace);
+        }
+        if(file != stdin)
+        {
+            fclose(file);
+        }
+    }
+
+    Estimate(&trace, &model);
+    free(trace.record);
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
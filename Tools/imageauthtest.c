@@ -0,0 +1,522 @@
+/*******************************************************************************
+* File Name: imageauthtest.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host test of Bootloader.cydsn\imageauth.c. A signed .cyacd image, see
+*  imagesign.c, is uploaded to a simulated flash in command packets the
+*  way the Bootloader receives them: ImageAuth_Inspect() sees each packet
+*  first, the Bootloader's part is done here for every packet it lets
+*  through (Program Row writes the row, Erase Row clears it) and
+*  ImageAuth_Update() follows. Each scenario checks whether Exit
+*  Bootloader is dropped, the reason logged with DIAG_EVT_OTA_AUTH_FAIL
+*  and whether the Bootloader is scheduled to stay after a reset:
+*   - the signed image, which launches
+*   - a reset in the middle of the upload, then Exit without rows
+*   - Enter Bootloader again after rows were programmed
+*   - one byte of one row changed
+*   - one row erased after the upload, and during one
+*  A failed check exits with code 1.
+*
+*  The tool must be built with the Bootloader.cydsn\imageauthkey.h of the
+*  key file the image was signed with.
+*
+*  Build:
+*   gcc -O2 -no-pie -I Host -I ../Shared -I ../Bootloader.cydsn -o imageauthtest imageauthtest.c ../Bootloader.cydsn/imageauth.c ../Shared/sha256.c ../Shared/p256.c
+*
+*  Usage:
+*   imageauthtest <signed.cyacd>
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/* mprotect() and sysconf() with -std=c99 */
+#if !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE     (200809L)
+#endif /* !defined(_POSIX_C_SOURCE) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "imageauth.h"
+#include "diaglog.h"
+
+#define CYACD_LINE_MAX          (2u * (CY_FLASH_SIZEOF_ROW + 8u) + 16u)
+#define ROWS_MAX                (CY_FLASH_NUMBER_ROWS)
+
+/* Bootloader commands not in imageauth.h */
+#define CMD_ERASE_ROW           (0x34u)
+
+/* Row of the image changed by the tamper and erase scenarios */
+#define TEST_ROW_INDEX          (1u)
+
+/* Erased PSoC 4 flash reads as zeros */
+#define FLASH_ERASED_VALUE      (0x00u)
+
+/* Filled by the upload before flash is written */
+#define FLASH_FILL_VALUE        (0xEEu)
+
+
+/***************************************
+*       Data Types
+***************************************/
+typedef struct
+{
+    uint8  arrayId;
+    uint16 rowNum;
+    uint8  data[CY_FLASH_SIZEOF_ROW];
+} ROW_T;
+
+
+/***************************************
+*       Simulated device
+***************************************/
+/* Aligned like the seal row, so the row number between them is exact */
+CY_ALIGN(CY_FLASH_SIZEOF_ROW) uint8 hostFlash[CY_FLASH_NUMBER_ROWS * CY_FLASH_SIZEOF_ROW];
+uint32 hostRunType;
+volatile uint32 hostSysTick[3u];
+
+uint8 packetRX[BLE_PACKET_SIZE_MAX];
+uint32 packetRXSize;
+uint32 packetRXFlag;
+uint8 packetTX[BLE_PACKET_SIZE_MAX];
+uint32 packetTXSize;
+
+uint8 cyBle_cmdReceivedFlag;
+uint16 cyBle_cmdLength;
+uint8 *cyBle_btsBuffPtr;
+
+static ROW_T rows[ROWS_MAX];
+static uint32 rowCount;
+static uint32 lastReason;               /* Argument of the last DIAG_EVT_OTA_AUTH_FAIL */
+static uint32 failures;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+static int    ImageRead(const char8 *path);
+static uint32 Send(uint32 command, const uint8 data[], uint32 length);
+static void   Enter(void);
+static uint32 Exit(void);
+static void   ProgramRow(const ROW_T *row);
+static void   EraseRow(const ROW_T *row);
+static void   Upload(uint32 count, uint32 tamperRow);
+static uint32 Reset(void);
+static void   Check(const char8 *scenario, uint32 dropped, uint32 reason, uint32 stays,
+                    uint32 expectDropped, uint32 expectReason, uint32 expectStays);
+
+
+/*******************************************************************************
+* Function Name: CySysFlashWriteRow()
+********************************************************************************
+*
+* Summary:
+*   Writes a row of the simulated flash. The seal row is a const object of
+*   imageauth.c outside hostFlash; its page is made writable first.
+*
+*******************************************************************************/
+uint32 CySysFlashWriteRow(uint32 rowNum, const uint8 rowData[])
+{
+    uint8 *row = (uint8 *) (uintptr_t) (uint32) (CYDEV_FLASH_BASE + (rowNum * CY_FLASH_SIZEOF_ROW));
+    uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+
+    if(rowNum >= CY_FLASH_NUMBER_ROWS)
+    {
+        if(0 != mprotect((void *) ((uintptr_t) row & ~(page - 1u)), (size_t) (2u * page),
+                         PROT_READ | PROT_WRITE))
+        {
+            perror("mprotect");
+            exit(2);
+        }
+    }
+    (void) memcpy(row, rowData, CY_FLASH_SIZEOF_ROW);
+
+    return CYRET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: DiagLog_Append()
+********************************************************************************
+*
+* Summary:
+*   Keeps the reason of the last image authentication failure.
+*
+*******************************************************************************/
+void DiagLog_Append(uint32 event, uint32 arg)
+{
+    if(event == DIAG_EVT_OTA_AUTH_FAIL)
+    {
+        lastReason = arg;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: B_UART_PutString()
+********************************************************************************
+*
+* Summary:
+*   Prints the IMAGE_AUTH_PROFILE_ENABLED report.
+*
+*******************************************************************************/
+void B_UART_PutString(const char8 string[])
+{
+    fputs(string, stdout);
+}
+
+
+/*******************************************************************************
+* Function Name: ImageRead()
+********************************************************************************
+*
+* Summary:
+*   Reads the rows of a .cyacd file, which must have the flash row size.
+*
+* Return:
+*   0 on success, -1 on error.
+*
+*******************************************************************************/
+static int ImageRead(const char8 *path)
+{
+    FILE *in = fopen(path, "r");
+    char8 line[CYACD_LINE_MAX];
+    unsigned int arrayId;
+    unsigned int rowNum;
+    unsigned int length;
+    unsigned int value;
+    uint32 i;
+
+    if(NULL == in)
+    {
+        perror(path);
+        return -1;
+    }
+
+    rowCount = 0u;
+    (void) fgets(line, (int) sizeof(line), in);
+    while(NULL != fgets(line, (int) sizeof(line), in))
+    {
+        if((line[0] != ':') || (3 != sscanf(&line[1], "%2x%4x%4x", &arrayId, &rowNum, &length)) ||
+           (length != CY_FLASH_SIZEOF_ROW) || (strlen(line) < (11u + (2u * length))) ||
+           (rowCount >= ROWS_MAX))
+        {
+            fprintf(stderr, "ERROR: %s: row %u is not a %u byte row\n", path, (unsigned int) rowCount,
+                    (unsigned int) CY_FLASH_SIZEOF_ROW);
+            (void) fclose(in);
+            return -1;
+        }
+        rows[rowCount].arrayId = (uint8) arrayId;
+        rows[rowCount].rowNum = (uint16) rowNum;
+        for(i = 0u; i < length; i++)
+        {
+            (void) sscanf(&line[11u + (2u * i)], "%2x", &value);
+            rows[rowCount].data[i] = (uint8) value;
+        }
+        rowCount++;
+    }
+    (void) fclose(in);
+
+    if(rowCount <= TEST_ROW_INDEX)
+    {
+        fprintf(stderr, "ERROR: %s: too few rows\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: Send()
+********************************************************************************
+*
+* Summary:
+*   Passes one command packet through ImageAuth_Inspect() and, unless it
+*   is dropped, does what the Bootloader would with it.
+*
+* Return:
+*   Non-zero if the packet was dropped.
+*
+*******************************************************************************/
+static uint32 Send(uint32 command, const uint8 data[], uint32 length)
+{
+    uint32 row;
+
+    packetRX[0u] = IMAGE_AUTH_PACKET_SOP;
+    packetRX[1u] = (uint8) command;
+    packetRX[2u] = (uint8) length;
+    packetRX[3u] = (uint8) (length >> 8u);
+    (void) memcpy(&packetRX[4u], data, length);
+    packetRX[4u + length] = 0u;
+    packetRX[5u + length] = 0u;
+    packetRX[6u + length] = IMAGE_AUTH_PACKET_EOP;
+    packetRXSize = length + IMAGE_AUTH_PACKET_OVERHEAD;
+    packetRXFlag = 1u;
+
+    if(0u == ImageAuth_Inspect())
+    {
+        if(0u != packetRXFlag)
+        {
+            printf("FAIL: command 0x%02X dropped but still pending\n", (unsigned int) command);
+            failures++;
+        }
+        return 1u;
+    }
+
+    row = (uint32) data[1u] | ((uint32) data[2u] << 8u);
+    if(command == IMAGE_AUTH_CMD_PROGRAM_ROW)
+    {
+        (void) CySysFlashWriteRow(row, &data[3u]);
+    }
+    else if(command == CMD_ERASE_ROW)
+    {
+        (void) memset(&hostFlash[row * CY_FLASH_SIZEOF_ROW], FLASH_ERASED_VALUE, CY_FLASH_SIZEOF_ROW);
+    }
+    else
+    {
+        /* Nothing in flash */
+    }
+    packetRXFlag = 0u;
+    ImageAuth_Update();
+
+    return 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Enter()
+********************************************************************************
+*
+* Summary:
+*   Sends Enter Bootloader.
+*
+*******************************************************************************/
+static void Enter(void)
+{
+    static const uint8 none[1u] = { 0u };
+
+    (void) Send(IMAGE_AUTH_CMD_ENTER, none, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: Exit()
+********************************************************************************
+*
+* Summary:
+*   Sends Exit Bootloader.
+*
+* Return:
+*   Non-zero if it was dropped.
+*
+*******************************************************************************/
+static uint32 Exit(void)
+{
+    static const uint8 none[1u] = { 0u };
+
+    return Send(IMAGE_AUTH_CMD_EXIT, none, 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: ProgramRow()
+********************************************************************************
+*
+* Summary:
+*   Sends Program Row with a row of the image.
+*
+*******************************************************************************/
+static void ProgramRow(const ROW_T *row)
+{
+    uint8 data[3u + CY_FLASH_SIZEOF_ROW];
+
+    data[0u] = row->arrayId;
+    data[1u] = (uint8) row->rowNum;
+    data[2u] = (uint8) (row->rowNum >> 8u);
+    (void) memcpy(&data[3u], row->data, CY_FLASH_SIZEOF_ROW);
+    (void) Send(IMAGE_AUTH_CMD_PROGRAM_ROW, data, sizeof(data));
+}
+
+
+/*******************************************************************************
+* Function Name: EraseRow()
+********************************************************************************
+*
+* Summary:
+*   Sends Erase Row for a row of the image.
+*
+*******************************************************************************/
+static void EraseRow(const ROW_T *row)
+{
+    uint8 data[3u];
+
+    data[0u] = row->arrayId;
+    data[1u] = (uint8) row->rowNum;
+    data[2u] = (uint8) (row->rowNum >> 8u);
+    (void) Send(CMD_ERASE_ROW, data, sizeof(data));
+}
+
+
+/*******************************************************************************
+* Function Name: Upload()
+********************************************************************************
+*
+* Summary:
+*   Sends Enter Bootloader and the first rows of the image, with one byte
+*   of one row changed unless tamperRow is rowCount.
+*
+*******************************************************************************/
+static void Upload(uint32 count, uint32 tamperRow)
+{
+    ROW_T row;
+    uint32 i;
+
+    Enter();
+    for(i = 0u; i < count; i++)
+    {
+        row = rows[i];
+        if(i == tamperRow)
+        {
+            row.data[CY_FLASH_SIZEOF_ROW / 2u] ^= 0x01u;
+        }
+        ProgramRow(&row);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Reset()
+********************************************************************************
+*
+* Summary:
+*   Starts the image authentication as after a reset.
+*
+* Return:
+*   Non-zero if the Bootloader is scheduled to stay.
+*
+*******************************************************************************/
+static uint32 Reset(void)
+{
+    hostRunType = 0u;
+    ImageAuth_Start();
+
+    return (uint32) (hostRunType == Bootloader_SCHEDULE_BTLDR);
+}
+
+
+/*******************************************************************************
+* Function Name: Check()
+********************************************************************************
+*
+* Summary:
+*   Compares the outcome of a scenario with the expected one.
+*
+*******************************************************************************/
+static void Check(const char8 *scenario, uint32 dropped, uint32 reason, uint32 stays,
+                  uint32 expectDropped, uint32 expectReason, uint32 expectStays)
+{
+    uint32 pass = (uint32) ((dropped == expectDropped) && (reason == expectReason) && (stays == expectStays));
+
+    printf("%s: %-36s Exit %s, reason %u, after reset %s\n", (0u != pass) ? "PASS" : "FAIL", scenario,
+           (0u != dropped) ? "dropped" : "launches", (unsigned int) reason,
+           (0u != stays) ? "stays" : "launches");
+    if(0u == pass)
+    {
+        failures++;
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    uint32 dropped;
+
+    if(argc != 2)
+    {
+        fprintf(stderr, "usage: imageauthtest <signed.cyacd>\n");
+        return 2;
+    }
+    if((uintptr_t) &hostFlash[sizeof(hostFlash) - 1u] > 0xFFFFFFFFu)
+    {
+        fprintf(stderr, "ERROR: the simulated flash is above 4 GB, build with -no-pie\n");
+        return 2;
+    }
+    if(0 != ImageRead(argv[1]))
+    {
+        return 2;
+    }
+    (void) memset(hostFlash, FLASH_FILL_VALUE, sizeof(hostFlash));
+
+    /* Built sealed */
+    Check("first boot", 0u, 0u, Reset(), 0u, 0u, 0u);
+
+    lastReason = 0u;
+    Upload(rowCount, rowCount);
+    dropped = Exit();
+    Check("signed image", dropped, lastReason, Reset(), 0u, 0u, 0u);
+
+    lastReason = 0u;
+    Upload(rowCount / 2u, rowCount);
+    Check("reset during the upload", 0u, lastReason, Reset(), 0u, 0u, 1u);
+    Enter();
+    dropped = Exit();
+    Check("then Exit without rows", dropped, lastReason, Reset(), 1u, IMAGE_AUTH_FAIL_NOT_SEALED, 1u);
+
+    lastReason = 0u;
+    Upload(rowCount, rowCount);
+    dropped = Exit();
+    Check("signed image again", dropped, lastReason, Reset(), 0u, 0u, 0u);
+
+    lastReason = 0u;
+    Upload(rowCount / 2u, rowCount);
+    Upload(rowCount, rowCount);
+    dropped = Exit();
+    Check("Enter again after rows", dropped, lastReason, Reset(), 0u, IMAGE_AUTH_FAIL_RESTART, 0u);
+
+    lastReason = 0u;
+    Upload(rowCount, TEST_ROW_INDEX);
+    dropped = Exit();
+    Check("one byte changed", dropped, lastReason, Reset(), 1u, IMAGE_AUTH_FAIL_SIGNATURE, 1u);
+
+    lastReason = 0u;
+    Upload(rowCount, rowCount);
+    dropped = Exit();
+    Check("signed image again", dropped, lastReason, Reset(), 0u, 0u, 0u);
+
+    lastReason = 0u;
+    Enter();
+    EraseRow(&rows[TEST_ROW_INDEX]);
+    dropped = Exit();
+    Check("one row erased after the upload", dropped, lastReason, Reset(), 1u, IMAGE_AUTH_FAIL_UNHASHED, 1u);
+
+    lastReason = 0u;
+    Upload(rowCount, rowCount);
+    EraseRow(&rows[TEST_ROW_INDEX]);
+    dropped = Exit();
+    Check("one row erased during the upload", dropped, lastReason, Reset(), 1u, IMAGE_AUTH_FAIL_UNHASHED, 1u);
+
+    if(0 != memcmp(&hostFlash[rows[TEST_ROW_INDEX].rowNum * CY_FLASH_SIZEOF_ROW], rows[TEST_ROW_INDEX].data,
+                   CY_FLASH_SIZEOF_ROW))
+    {
+        printf("FAIL: Erase Row reached flash\n");
+        failures++;
+    }
+
+    printf("%u of the checks failed\n", (unsigned int) failures);
+
+    return (0u != failures) ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,824 @@
+/*******************************************************************************
+* File Name: imagesign.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host tool that signs a HelloApp .cyacd image for the Bootloader's image
+*  authentication (Bootloader.cydsn\imageauth.h). The rows are hashed in
+*  file order exactly as the Bootloader hashes them while they are
+*  programmed:
+*   array ID (1 byte) | row number (2 bytes, little endian) | row data
+*  and the signature row, the ECDSA P-256 signature of the digest
+*  (Shared\p256.h) with the magic and the row count in front, is added to
+*  the image as row SIG_ROW. Rows must be in ascending order in one array,
+*  as the Bootloader rejects anything else.
+*
+*  The key file holds the private key as 64 hexadecimal digits and is the
+*  only thing that can sign; keep it off the devices and out of version
+*  control. The Bootloader gets the public key as IMAGE_AUTH_PUBLIC_KEY
+*  from Bootloader.cydsn\imageauthkey.h: keygen creates a random key file
+*  and that header, header writes the header from an existing key file,
+*  e.g. in a pre-build step. keygen does not overwrite a key file.
+*
+*  The bench command measures what the incremental hash costs per row,
+*  what is left for the end of the session (finalizing the digest and
+*  verifying the signature) and what hashing the whole image at the end
+*  would take instead.
+*  Cycle counts come from the time stamp counter on x86 hosts and are
+*  nanoseconds elsewhere; on target the same figures are printed with
+*  IMAGE_AUTH_PROFILE_ENABLED in Bootloader.cydsn\Options.h.
+*
+*  Build:
+*   gcc -O2 -I Host -I ../Shared -o imagesign imagesign.c ../Shared/sha256.c ../Shared/p256.c
+*
+*  Usage:
+*   imagesign keygen <key file> <imageauthkey.h>
+*   imagesign header <key file> <imageauthkey.h>
+*   imagesign sign   <key file> <in.cyacd> <out.cyacd> [SIG_ROW]
+*   imagesign digest <in.cyacd> [SIG_ROW]
+*   imagesign bench  [ROWS] [ROW_SIZE]
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+/* clock_gettime() with -std=c99 */
+#if !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE     (200809L)
+#endif /* !defined(_POSIX_C_SOURCE) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif /* defined(__x86_64__) || defined(__i386__) */
+
+#include "sha256.h"
+#include "p256.h"
+
+#define CYACD_ROW_SIZE_MAX      (256u)
+#define CYACD_LINE_MAX          (2u * (CYACD_ROW_SIZE_MAX + 8u) + 16u)
+#define ROWS_MAX                (4096u)
+
+/* CY8C4247LQI-BL483: 1024 rows, the last one holds the metadata */
+#define SIG_ROW_DEFAULT         (1022u)
+
+/* Same as Bootloader.cydsn\imageauth.h */
+#define IMAGE_AUTH_MAGIC        (0x32534149u)
+
+/* Source of keygen */
+#define KEY_RANDOM_SOURCE       "/dev/urandom"
+
+#define BENCH_ROWS_DEFAULT      (1024u)
+#define BENCH_ROW_SIZE_DEFAULT  (128u)
+#define BENCH_SESSIONS          (200u)
+
+/* Context kept for a retry and verification results; not static, so the
+ * work is not optimized away
+ */
+SHA256_CTX_T benchPrevious;
+uint32 benchValid;
+
+
+/***************************************
+*       Data Types
+***************************************/
+typedef struct
+{
+    uint8  arrayId;
+    uint16 rowNum;
+    uint16 length;
+    uint8  data[CYACD_ROW_SIZE_MAX];
+} ROW_T;
+
+typedef struct
+{
+    char8  header[32];
+    uint32 rowCount;
+    ROW_T *rows;
+} IMAGE_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+static int  ParseHex(const char8 *text, uint32 digits, uint32 *value);
+static uint64_t ReadCycles(void);
+static int  CompareCycles(const void *a, const void *b);
+static int  ImageRead(const char8 *path, uint32 sigRow, IMAGE_T *image);
+static void ImageDigest(const IMAGE_T *image, uint8 digest[]);
+static void WriteRow(FILE *out, const ROW_T *row);
+static int  ReadKey(const char8 *path, uint8 key[], uint8 publicKey[]);
+static int  WriteKeyHeader(const char8 *path, const uint8 publicKey[]);
+static int  CommandKeygen(const char8 *keyPath, const char8 *headerPath);
+static int  CommandHeader(const char8 *keyPath, const char8 *headerPath);
+static int  CommandSign(const char8 *keyPath, const char8 *inPath, const char8 *outPath, uint32 sigRow);
+static int  CommandDigest(const char8 *inPath, uint32 sigRow);
+static int  CommandBench(uint32 rows, uint32 rowSize);
+
+
+/*******************************************************************************
+* Function Name: ParseHex()
+********************************************************************************
+*
+* Summary:
+*   Parses a fixed number of hexadecimal digits.
+*
+* Return:
+*   0 on success, -1 if a non-hexadecimal character was found.
+*
+*******************************************************************************/
+static int ParseHex(const char8 *text, uint32 digits, uint32 *value)
+{
+    uint32 result = 0u;
+    uint32 i;
+
+    for(i = 0u; i < digits; i++)
+    {
+        char8 c = text[i];
+
+        result <<= 4u;
+        if((c >= '0') && (c <= '9'))
+        {
+            result |= (uint32)(c - '0');
+        }
+        else if((c >= 'a') && (c <= 'f'))
+        {
+            result |= (uint32)(c - 'a' + 10);
+        }
+        else if((c >= 'A') && (c <= 'F'))
+        {
+            result |= (uint32)(c - 'A' + 10);
+        }
+        else
+        {
+            return -1;
+        }
+    }
+    *value = result;
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: ReadCycles()
+********************************************************************************
+*
+* Summary:
+*   Returns the time stamp counter, or a nanosecond clock.
+*
+*******************************************************************************/
+static uint64_t ReadCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint64_t)__rdtsc();
+#else
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+#endif /* defined(__x86_64__) || defined(__i386__) */
+}
+
+
+/*******************************************************************************
+* Function Name: CompareCycles()
+********************************************************************************
+*
+* Summary:
+*   qsort() order of cycle counts.
+*
+*******************************************************************************/
+static int CompareCycles(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+
+/*******************************************************************************
+* Function Name: ImageRead()
+********************************************************************************
+*
+* Summary:
+*   Reads a .cyacd image and checks that it can be signed: valid row
+*   checksums, one array, ascending rows of one length. A row already at
+*   sigRow, from an earlier signature, is dropped.
+*
+* Return:
+*   0 on success, -1 on error.
+*
+*******************************************************************************/
+static int ImageRead(const char8 *path, uint32 sigRow, IMAGE_T *image)
+{
+    char8 line[CYACD_LINE_MAX];
+    uint32 lineNum = 1u;
+    FILE *file;
+    int result = 0;
+
+    memset(image, 0, sizeof(*image));
+    image->rows = (ROW_T *) malloc(ROWS_MAX * sizeof(ROW_T));
+    file = fopen(path, "r");
+    if((image->rows == NULL) || (file == NULL))
+    {
+        fprintf(stderr, "ERROR: can't open %s\n", path);
+        if(file != NULL)
+        {
+            fclose(file);
+        }
+        return -1;
+    }
+
+    /* Header: 4 bytes silicon ID, 1 byte silicon revision, 1 byte checksum type */
+    if((fgets(line, sizeof(line), file) == NULL) || (strlen(line) < 10u))
+    {
+        fprintf(stderr, "ERROR: %s: bad header\n", path);
+        fclose(file);
+        return -1;
+    }
+    line[strcspn(line, "\r\n")] = '\0';
+    (void)snprintf(image->header, sizeof(image->header), "%s", line);
+
+    /* Rows: ':' array ID (1), row number (2), data length (2), data, checksum (1) */
+    while((result == 0) && (fgets(line, sizeof(line), file) != NULL))
+    {
+        uint32 arrayId, rowNum, length, checksum, value, i;
+        ROW_T *row = &image->rows[image->rowCount];
+        uint8 sum;
+
+        lineNum++;
+        if((line[0] == '\r') || (line[0] == '\n') || (line[0] == '\0'))
+        {
+            continue;
+        }
+        if((line[0] != ':') || (ParseHex(&line[1], 2u, &arrayId) != 0) ||
+           (ParseHex(&line[3], 4u, &rowNum) != 0) || (ParseHex(&line[7], 4u, &length) != 0) ||
+           (length > CYACD_ROW_SIZE_MAX) || (strlen(line) < (11u + (2u * length) + 2u)))
+        {
+            fprintf(stderr, "ERROR: %s:%u: malformed row\n", path, (unsigned int)lineNum);
+            result = -1;
+            break;
+        }
+
+        sum = (uint8)(arrayId + (rowNum >> 8u) + rowNum + (length >> 8u) + length);
+        for(i = 0u; i < length; i++)
+        {
+            value = 0u;
+            (void)ParseHex(&line[11u + (2u * i)], 2u, &value);
+            row->data[i] = (uint8)value;
+            sum += row->data[i];
+        }
+        if((ParseHex(&line[11u + (2u * length)], 2u, &checksum) != 0) || ((uint8)(sum + checksum) != 0u))
+        {
+            fprintf(stderr, "ERROR: %s:%u: row checksum mismatch\n", path, (unsigned int)lineNum);
+            result = -1;
+            break;
+        }
+
+        if((arrayId == 0u) && (rowNum == sigRow))
+        {
+            continue;
+        }
+        if(arrayId != 0u)
+        {
+            fprintf(stderr, "ERROR: %s:%u: row in array %u, only array 0 is authenticated\n",
+                    path, (unsigned int)lineNum, (unsigned int)arrayId);
+            result = -1;
+        }
+        else if((image->rowCount != 0u) && (rowNum <= image->rows[image->rowCount - 1u].rowNum))
+        {
+            fprintf(stderr, "ERROR: %s:%u: rows are not in ascending order\n", path, (unsigned int)lineNum);
+            result = -1;
+        }
+        else if((image->rowCount != 0u) && (length != image->rows[0].length))
+        {
+            fprintf(stderr, "ERROR: %s:%u: row length differs from the first row\n", path, (unsigned int)lineNum);
+            result = -1;
+        }
+        else if(image->rowCount == ROWS_MAX)
+        {
+            fprintf(stderr, "ERROR: %s: more than %u rows\n", path, (unsigned int)ROWS_MAX);
+            result = -1;
+        }
+        else
+        {
+            row->arrayId = (uint8)arrayId;
+            row->rowNum = (uint16)rowNum;
+            row->length = (uint16)length;
+            image->rowCount++;
+        }
+    }
+    fclose(file);
+
+    if((result == 0) && (image->rowCount == 0u))
+    {
+        fprintf(stderr, "ERROR: %s: no rows\n", path);
+        result = -1;
+    }
+    if((result == 0) && (image->rows[0].length < (8u + SHA256_DIGEST_SIZE)))
+    {
+        fprintf(stderr, "ERROR: %s: rows are too short for the signature\n", path);
+        result = -1;
+    }
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: ImageDigest()
+********************************************************************************
+*
+* Summary:
+*   Hashes the rows the way ImageAuth_Update() does.
+*
+*******************************************************************************/
+static void ImageDigest(const IMAGE_T *image, uint8 digest[])
+{
+    SHA256_CTX_T ctx;
+    uint32 i;
+
+    Sha256_Init(&ctx);
+    for(i = 0u; i < image->rowCount; i++)
+    {
+        const ROW_T *row = &image->rows[i];
+        uint8 record[3];
+
+        record[0] = row->arrayId;
+        record[1] = (uint8)row->rowNum;
+        record[2] = (uint8)(row->rowNum >> 8u);
+        Sha256_Update(&ctx, record, sizeof(record));
+        Sha256_Update(&ctx, row->data, row->length);
+    }
+    Sha256_Final(&ctx, digest);
+}
+
+
+/*******************************************************************************
+* Function Name: WriteRow()
+*******************************************************************************/
+static void WriteRow(FILE *out, const ROW_T *row)
+{
+    uint8 sum = (uint8)(row->arrayId + (row->rowNum >> 8u) + row->rowNum + (row->length >> 8u) + row->length);
+    uint32 k;
+
+    fprintf(out, ":%02X%04X%04X", row->arrayId, row->rowNum, row->length);
+    for(k = 0u; k < row->length; k++)
+    {
+        fprintf(out, "%02X", row->data[k]);
+        sum += row->data[k];
+    }
+    fprintf(out, "%02X\n", (uint8)(0u - sum));
+}
+
+
+/*******************************************************************************
+* Function Name: ReadKey()
+********************************************************************************
+*
+* Summary:
+*   Reads the 32-byte private key as 64 hexadecimal digits and derives
+*   the public key.
+*
+* Return:
+*   0 on success, -1 on error.
+*
+*******************************************************************************/
+static int ReadKey(const char8 *path, uint8 key[], uint8 publicKey[])
+{
+    char8 text[128];
+    uint32 value;
+    uint32 i;
+    FILE *file = fopen(path, "r");
+
+    if((file == NULL) || (fgets(text, sizeof(text), file) == NULL) ||
+       (strcspn(text, "\r\n") != (2u * P256_PRIVATE_KEY_SIZE)))
+    {
+        fprintf(stderr, "ERROR: %s: expected a key of %u hexadecimal digits\n", path,
+                (unsigned int)(2u * P256_PRIVATE_KEY_SIZE));
+        if(file != NULL)
+        {
+            fclose(file);
+        }
+        return -1;
+    }
+    fclose(file);
+
+    for(i = 0u; i < P256_PRIVATE_KEY_SIZE; i++)
+    {
+        if(ParseHex(&text[2u * i], 2u, &value) != 0)
+        {
+            fprintf(stderr, "ERROR: %s: bad key\n", path);
+            return -1;
+        }
+        key[i] = (uint8)value;
+    }
+    if(P256_PublicKey(key, publicKey) == 0u)
+    {
+        fprintf(stderr, "ERROR: %s: not a P-256 private key\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: WriteKeyHeader()
+********************************************************************************
+*
+* Summary:
+*   Writes imageauthkey.h with IMAGE_AUTH_PUBLIC_KEY as a byte array
+*   initializer.
+*
+* Return:
+*   0 on success, -1 on error.
+*
+*******************************************************************************/
+static int WriteKeyHeader(const char8 *path, const uint8 publicKey[])
+{
+    uint32 i;
+    FILE *out = fopen(path, "w");
+
+    if(out == NULL)
+    {
+        fprintf(stderr, "ERROR: can't create %s\n", path);
+        return -1;
+    }
+    fprintf(out, "/* Image authentication public key (X | Y), written by Tools\\imagesign.c.\n"
+                 " * Images signed with the matching key file launch.\n"
+                 " */\n"
+                 "#if !defined(IMAGEAUTHKEY_H)\n"
+                 "#define IMAGEAUTHKEY_H\n\n"
+                 "#define IMAGE_AUTH_PUBLIC_KEY           { \\\n");
+    for(i = 0u; i < P256_PUBLIC_KEY_SIZE; i++)
+    {
+        fprintf(out, "%s0x%02Xu%s", ((i % 8u) == 0u) ? "    " : " ", (unsigned int)publicKey[i],
+                (i == (P256_PUBLIC_KEY_SIZE - 1u)) ? " \\\n" : (((i % 8u) == 7u) ? ", \\\n" : ","));
+    }
+    fprintf(out, "}\n\n#endif /* IMAGEAUTHKEY_H */\n");
+    if(fclose(out) != 0)
+    {
+        fprintf(stderr, "ERROR: can't write %s\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandKeygen()
+********************************************************************************
+*
+* Summary:
+*   Creates a random key file and the matching imageauthkey.h. A random
+*   number that is not a private key, 0 or above the group order, is
+*   drawn again.
+*
+*******************************************************************************/
+static int CommandKeygen(const char8 *keyPath, const char8 *headerPath)
+{
+    uint8 key[P256_PRIVATE_KEY_SIZE];
+    uint8 publicKey[P256_PUBLIC_KEY_SIZE];
+    uint32 i;
+    FILE *file = fopen(keyPath, "r");
+
+    if(file != NULL)
+    {
+        fclose(file);
+        fprintf(stderr, "ERROR: %s exists, use the header command for an existing key\n", keyPath);
+        return -1;
+    }
+
+    file = fopen(KEY_RANDOM_SOURCE, "rb");
+    do
+    {
+        if((file == NULL) || (fread(key, 1u, sizeof(key), file) != sizeof(key)))
+        {
+            fprintf(stderr, "ERROR: can't read %s\n", KEY_RANDOM_SOURCE);
+            if(file != NULL)
+            {
+                fclose(file);
+            }
+            return -1;
+        }
+    }
+    while(P256_PublicKey(key, publicKey) == 0u);
+    fclose(file);
+
+    file = fopen(keyPath, "w");
+    if(file == NULL)
+    {
+        fprintf(stderr, "ERROR: can't create %s\n", keyPath);
+        return -1;
+    }
+    for(i = 0u; i < P256_PRIVATE_KEY_SIZE; i++)
+    {
+        fprintf(file, "%02x", (unsigned int)key[i]);
+    }
+    fprintf(file, "\n");
+    if(fclose(file) != 0)
+    {
+        fprintf(stderr, "ERROR: can't write %s\n", keyPath);
+        return -1;
+    }
+
+    if(WriteKeyHeader(headerPath, publicKey) != 0)
+    {
+        return -1;
+    }
+    printf("%s: new private key, %s: IMAGE_AUTH_PUBLIC_KEY\n", keyPath, headerPath);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandHeader()
+********************************************************************************
+*
+* Summary:
+*   Writes imageauthkey.h from an existing key file.
+*
+*******************************************************************************/
+static int CommandHeader(const char8 *keyPath, const char8 *headerPath)
+{
+    uint8 key[P256_PRIVATE_KEY_SIZE];
+    uint8 publicKey[P256_PUBLIC_KEY_SIZE];
+
+    if((ReadKey(keyPath, key, publicKey) != 0) || (WriteKeyHeader(headerPath, publicKey) != 0))
+    {
+        return -1;
+    }
+    printf("%s: IMAGE_AUTH_PUBLIC_KEY of %s\n", headerPath, keyPath);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandSign()
+********************************************************************************
+*
+* Summary:
+*   Writes the image with its signature row, placed in row order.
+*
+*******************************************************************************/
+static int CommandSign(const char8 *keyPath, const char8 *inPath, const char8 *outPath, uint32 sigRow)
+{
+    uint8 key[P256_PRIVATE_KEY_SIZE];
+    uint8 publicKey[P256_PUBLIC_KEY_SIZE];
+    uint8 digest[SHA256_DIGEST_SIZE];
+    IMAGE_T image;
+    ROW_T signature;
+    uint32 placed = 0u;
+    uint32 i;
+    FILE *out;
+    int result = 0;
+
+    image.rows = NULL;
+    if((ReadKey(keyPath, key, publicKey) != 0) || (ImageRead(inPath, sigRow, &image) != 0))
+    {
+        free(image.rows);
+        return -1;
+    }
+
+    ImageDigest(&image, digest);
+
+    /* IMAGE_AUTH_SIG_T: magic, row count (little endian), r | s, zero fill */
+    memset(&signature, 0, sizeof(signature));
+    signature.rowNum = (uint16)sigRow;
+    signature.length = image.rows[0].length;
+    for(i = 0u; i < 4u; i++)
+    {
+        signature.data[i] = (uint8)(IMAGE_AUTH_MAGIC >> (8u * i));
+        signature.data[4u + i] = (uint8)(image.rowCount >> (8u * i));
+    }
+    (void)P256_Sign(key, digest, &signature.data[8]);
+
+    out = fopen(outPath, "w");
+    if(out == NULL)
+    {
+        fprintf(stderr, "ERROR: can't create %s\n", outPath);
+        free(image.rows);
+        return -1;
+    }
+    fprintf(out, "%s\n", image.header);
+    for(i = 0u; i < image.rowCount; i++)
+    {
+        if((placed == 0u) && (image.rows[i].rowNum > sigRow))
+        {
+            WriteRow(out, &signature);
+            placed = 1u;
+        }
+        WriteRow(out, &image.rows[i]);
+    }
+    if(placed == 0u)
+    {
+        WriteRow(out, &signature);
+    }
+    if(fclose(out) != 0)
+    {
+        result = -1;
+    }
+
+    if(result == 0)
+    {
+        printf("%s: %u rows signed, signature in row %u\n", outPath, (unsigned int)image.rowCount,
+               (unsigned int)sigRow);
+    }
+    free(image.rows);
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandDigest()
+********************************************************************************
+*
+* Summary:
+*   Prints the digest the Bootloader computes while the image is uploaded.
+*
+*******************************************************************************/
+static int CommandDigest(const char8 *inPath, uint32 sigRow)
+{
+    uint8 digest[SHA256_DIGEST_SIZE];
+    IMAGE_T image;
+    uint32 i;
+
+    if(ImageRead(inPath, sigRow, &image) != 0)
+    {
+        free(image.rows);
+        return -1;
+    }
+    ImageDigest(&image, digest);
+    for(i = 0u; i < SHA256_DIGEST_SIZE; i++)
+    {
+        printf("%02x", digest[i]);
+    }
+    printf("  %u rows\n", (unsigned int)image.rowCount);
+    free(image.rows);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandBench()
+********************************************************************************
+*
+* Summary:
+*   Uploads random images into the same hash steps as ImageAuth_Update()
+*   and ImageAuth_Verify(): per row the copy of the context kept for a
+*   retry and the hash of the record and the row, then once the digest
+*   and the verification of its signature. Reports the mean and 99.9th
+*   percentile per row, the session end and hashing the whole image at
+*   the end for comparison.
+*
+*******************************************************************************/
+static int CommandBench(uint32 rows, uint32 rowSize)
+{
+    static const uint8 key[P256_PRIVATE_KEY_SIZE] = { 0x5Au };
+    uint8 publicKey[P256_PUBLIC_KEY_SIZE];
+    uint64_t *cycles;
+    uint8 *flash;
+    uint64_t rowTotal = 0u;
+    uint64_t endTotal = 0u;
+    uint64_t wholeTotal = 0u;
+    uint32 samples = rows * BENCH_SESSIONS;
+    uint32 session;
+    uint32 i;
+    double rowMean;
+
+    cycles = (uint64_t *) malloc(samples * sizeof(uint64_t));
+    flash = (uint8 *) malloc(rows * rowSize);
+    if((cycles == NULL) || (flash == NULL))
+    {
+        fprintf(stderr, "ERROR: out of memory\n");
+        free(cycles);
+        free(flash);
+        return -1;
+    }
+    (void)P256_PublicKey(key, publicKey);
+    srand(1u);
+    for(i = 0u; i < (rows * rowSize); i++)
+    {
+        flash[i] = (uint8)rand();
+    }
+
+    for(session = 0u; session < BENCH_SESSIONS; session++)
+    {
+        SHA256_CTX_T ctx;
+        SHA256_CTX_T copy;
+        uint8 digest[SHA256_DIGEST_SIZE];
+        uint8 signature[P256_SIGNATURE_SIZE];
+        uint64_t start;
+
+        Sha256_Init(&ctx);
+        for(i = 0u; i < rows; i++)
+        {
+            uint8 record[3];
+
+            start = ReadCycles();
+            benchPrevious = ctx;
+            record[0] = 0u;
+            record[1] = (uint8)i;
+            record[2] = (uint8)(i >> 8u);
+            Sha256_Update(&ctx, record, sizeof(record));
+            Sha256_Update(&ctx, &flash[i * rowSize], rowSize);
+            cycles[(session * rows) + i] = ReadCycles() - start;
+            rowTotal += cycles[(session * rows) + i];
+        }
+
+        /* Signed outside the measurement */
+        copy = ctx;
+        Sha256_Final(&copy, digest);
+        (void)P256_Sign(key, digest, signature);
+
+        start = ReadCycles();
+        Sha256_Final(&ctx, digest);
+        benchValid += P256_Verify(publicKey, digest, signature);
+        endTotal += ReadCycles() - start;
+
+        /* The alternative: nothing during the upload, everything at the end */
+        start = ReadCycles();
+        Sha256_Init(&ctx);
+        Sha256_Update(&ctx, flash, rows * rowSize);
+        Sha256_Final(&ctx, digest);
+        benchValid += P256_Verify(publicKey, digest, signature);
+        wholeTotal += ReadCycles() - start;
+    }
+
+    rowMean = (double)rowTotal / (double)samples;
+    qsort(cycles, samples, sizeof(cycles[0]), &CompareCycles);
+    printf("%u rows of %u bytes, %u sessions\n", (unsigned int)rows, (unsigned int)rowSize,
+           (unsigned int)BENCH_SESSIONS);
+    printf("  per row      mean %9.1f  99.9%% %9llu  (%.1f per byte)\n", rowMean,
+           (unsigned long long)cycles[((uint64_t)samples * 999u) / 1000u], rowMean / (double)rowSize);
+    printf("  session end  mean %9.1f  (digest and signature)\n", (double)endTotal / BENCH_SESSIONS);
+    printf("  whole image  mean %9.1f  (hashed at the end instead, %.2fx the session end)\n",
+           (double)wholeTotal / BENCH_SESSIONS, (double)wholeTotal / (double)endTotal);
+
+    free(cycles);
+    free(flash);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    int result = -1;
+
+    if((argc == 4) && (strcmp(argv[1], "keygen") == 0))
+    {
+        result = CommandKeygen(argv[2], argv[3]);
+    }
+    else if((argc == 4) && (strcmp(argv[1], "header") == 0))
+    {
+        result = CommandHeader(argv[2], argv[3]);
+    }
+    else if(((argc == 5) || (argc == 6)) && (strcmp(argv[1], "sign") == 0))
+    {
+        result = CommandSign(argv[2], argv[3], argv[4],
+                             (argc == 6) ? (uint32)strtoul(argv[5], NULL, 0) : SIG_ROW_DEFAULT);
+    }
+    else if(((argc == 3) || (argc == 4)) && (strcmp(argv[1], "digest") == 0))
+    {
+        result = CommandDigest(argv[2], (argc == 4) ? (uint32)strtoul(argv[3], NULL, 0) : SIG_ROW_DEFAULT);
+    }
+    else if((argc <= 4) && (argc >= 2) && (strcmp(argv[1], "bench") == 0))
+    {
+        uint32 rows = (argc >= 3) ? (uint32)strtoul(argv[2], NULL, 0) : BENCH_ROWS_DEFAULT;
+        uint32 rowSize = (argc == 4) ? (uint32)strtoul(argv[3], NULL, 0) : BENCH_ROW_SIZE_DEFAULT;
+
+        if((rows == 0u) || (rows > ROWS_MAX) || (rowSize == 0u) || (rowSize > CYACD_ROW_SIZE_MAX))
+        {
+            fprintf(stderr, "ERROR: ROWS must be 1..%u and ROW_SIZE 1..%u\n", (unsigned int)ROWS_MAX,
+                    (unsigned int)CYACD_ROW_SIZE_MAX);
+            return 2;
+        }
+        result = CommandBench(rows, rowSize);
+    }
+    else
+    {
+        fprintf(stderr,
+            "usage: imagesign keygen <key file> <imageauthkey.h>\n"
+            "       imagesign header <key file> <imageauthkey.h>\n"
+            "       imagesign sign   <key file> <in.cyacd> <out.cyacd> [SIG_ROW]\n"
+            "       imagesign digest <in.cyacd> [SIG_ROW]\n"
+            "       imagesign bench  [ROWS] [ROW_SIZE]\n");
+        return 2;
+    }
+
+    return (result < 0) ? 2 : result;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,580 @@
+/*******************************************************************************
+* File Name: linkstable.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host tool that keeps the flash placement of HelloApp functions stable
+*  between releases so that row-level (delta) updates only carry the rows
+*  whose code really changed.
+*
+*  "generate" reads the GCC map file of the previous release and writes
+*  LinkerScripts\StableOrderGcc.ld. The script places every function section
+*  (-ffunction-sections) of the previous release in its own slot, in the same
+*  order and at the same address:
+*
+*      . = MAX(., 0x0000A180 - appl_start);
+*      *main.o(.text.DoProcess)
+*
+*  Inside an output section "." is relative to the section start, so the
+*  absolute slot addresses are rebased on appl_start (start of .text).
+*
+*  The first time a map without slots is processed each function gets a
+*  padding budget (percentage of its size, at least --pad-min bytes) so it
+*  can grow in later releases without moving its neighbours. Maps of builds
+*  that already used the script keep their slots unchanged. A function that
+*  outgrows its slot only pushes the following functions until the next
+*  slot with enough slack absorbs the difference. New functions are linked
+*  after the last slot by the regular *(.text .text.*) rule.
+*
+*  "estimate" compares two map files and reports how many flash rows change
+*  between them, both for the layout the linker actually produced and for
+*  the layout the stable slots of the first map would have produced. A row
+*  counts as changed if any function covering it moved or changed size,
+*  which is what shifts call offsets and literal pools in the row image.
+*
+*  Build:
+*   gcc -O2 -I Host -o linkstable linkstable.c
+*
+*  Usage:
+*   linkstable generate <previous.map> <StableOrderGcc.ld> [--pad PERCENT] [--pad-min BYTES]
+*   linkstable estimate <previous.map> <current.map> [--pad PERCENT] [--pad-min BYTES]
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cytypes.h>
+
+#define FLASH_ROW_SIZE          (128u)
+#define NAME_SIZE_MAX           (160u)
+#define LINE_SIZE_MAX           (1024u)
+
+#define PAD_PERCENT_DEFAULT     (12u)
+#define PAD_MIN_DEFAULT         (16u)
+
+/* Symbol emitted by the generated script; its presence marks a slotted map */
+#define STABLE_ORDER_MARKER     "__cy_stable_order_start"
+
+
+/***************************************
+*       Data Types
+***************************************/
+typedef struct
+{
+    char8  section[NAME_SIZE_MAX];
+    char8  object[NAME_SIZE_MAX];
+    uint32 address;
+    uint32 size;
+    uint32 slot;        /* Slot start assigned by the stable order */
+} FUNC_T;
+
+typedef struct
+{
+    FUNC_T *funcs;
+    uint32  count;
+    uint32  capacity;
+    uint32  isSlotted;
+    uint32  slotEnd;    /* First address after the last slot */
+} MAP_T;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+static int    MapRead(const char8 *path, MAP_T *map);
+static int    MapAppend(MAP_T *map, const char8 *section, const char8 *object, uint32 address, uint32 size);
+static void   ObjectPattern(const char8 *path, char8 pattern[]);
+static int    CompareAddress(const void *a, const void *b);
+static void   AssignSlots(MAP_T *map, uint32 padPercent, uint32 padMin);
+static const FUNC_T *FindFunc(const MAP_T *map, const FUNC_T *func);
+static uint32 CountChangedRows(const MAP_T *before, const MAP_T *after, uint32 useSlots, const MAP_T *slots);
+static int    CommandGenerate(const char8 *mapPath, const char8 *scriptPath, uint32 padPercent, uint32 padMin);
+static int    CommandEstimate(const char8 *oldPath, const char8 *newPath, uint32 padPercent, uint32 padMin);
+
+
+/*******************************************************************************
+* Function Name: ObjectPattern()
+********************************************************************************
+*
+* Summary:
+*   Converts an object path from the map file into a linker script file
+*   pattern. Directories are dropped and archive members "lib.a(member.o)"
+*   become "lib.a:member.o".
+*
+*******************************************************************************/
+static void ObjectPattern(const char8 *path, char8 pattern[])
+{
+    const char8 *base = path;
+    const char8 *end = strchr(path, '(');
+    const char8 *p;
+    char8 *paren;
+
+    if(end == NULL)
+    {
+        end = path + strlen(path);
+    }
+    for(p = path; p < end; p++)
+    {
+        if((*p == '/') || (*p == '\\'))
+        {
+            base = p + 1;
+        }
+    }
+
+    (void)snprintf(pattern, NAME_SIZE_MAX, "%s", base);
+    paren = strchr(pattern, '(');
+    if(paren != NULL)
+    {
+        char8 *close = strchr(paren, ')');
+
+        *paren = ':';
+        if(close != NULL)
+        {
+            *close = '\0';
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: MapAppend()
+*******************************************************************************/
+static int MapAppend(MAP_T *map, const char8 *section, const char8 *object, uint32 address, uint32 size)
+{
+    FUNC_T *func;
+
+    if(map->count == map->capacity)
+    {
+        uint32 capacity = (map->capacity == 0u) ? 512u : (map->capacity * 2u);
+        FUNC_T *funcs = realloc(map->funcs, capacity * sizeof(FUNC_T));
+
+        if(funcs == NULL)
+        {
+            return -1;
+        }
+        map->funcs = funcs;
+        map->capacity = capacity;
+    }
+
+    func = &map->funcs[map->count];
+    (void)snprintf(func->section, NAME_SIZE_MAX, "%s", section);
+    ObjectPattern(object, func->object);
+    func->address = address;
+    func->size = size;
+    func->slot = address;
+    map->count++;
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: MapRead()
+********************************************************************************
+*
+* Summary:
+*   Collects the .text.<function> input sections of a GNU ld map file. Long
+*   section names are printed by ld on their own line with the address, size
+*   and object file on the next line; both forms are handled.
+*
+*******************************************************************************/
+static int MapRead(const char8 *path, MAP_T *map)
+{
+    char8 line[LINE_SIZE_MAX];
+    char8 pending[NAME_SIZE_MAX];
+    FILE *file;
+
+    memset(map, 0, sizeof(*map));
+    pending[0] = '\0';
+    file = fopen(path, "r");
+    if(file == NULL)
+    {
+        fprintf(stderr, "ERROR: can't open %s\n", path);
+        return -1;
+    }
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        char8 section[NAME_SIZE_MAX];
+        char8 object[LINE_SIZE_MAX];
+        unsigned long address, size;
+
+        if(strstr(line, STABLE_ORDER_MARKER) != NULL)
+        {
+            map->isSlotted = 1u;
+        }
+
+        if(strncmp(line, " .text.", 7u) == 0)
+        {
+            int fields = sscanf(line, " %159s 0x%lx 0x%lx %1023s", section, &address, &size, object);
+
+            if(fields == 4)
+            {
+                if((size != 0u) && (MapAppend(map, section, object, (uint32)address, (uint32)size) != 0))
+                {
+                    fclose(file);
+                    return -1;
+                }
+                pending[0] = '\0';
+            }
+            else if(fields == 1)
+            {
+                (void)snprintf(pending, sizeof(pending), "%s", section);
+            }
+            else
+            {
+                pending[0] = '\0';
+            }
+        }
+        else if(pending[0] != '\0')
+        {
+            if((sscanf(line, " 0x%lx 0x%lx %1023s", &address, &size, object) == 3) && (size != 0u) &&
+               (MapAppend(map, pending, object, (uint32)address, (uint32)size) != 0))
+            {
+                fclose(file);
+                return -1;
+            }
+            pending[0] = '\0';
+        }
+        else
+        {
+            /* Not a function section */
+        }
+    }
+    fclose(file);
+
+    qsort(map->funcs, map->count, sizeof(FUNC_T), &CompareAddress);
+    if(map->count != 0u)
+    {
+        map->slotEnd = map->funcs[map->count - 1u].address + map->funcs[map->count - 1u].size;
+    }
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: CompareAddress()
+*******************************************************************************/
+static int CompareAddress(const void *a, const void *b)
+{
+    uint32 addrA = ((const FUNC_T *)a)->address;
+    uint32 addrB = ((const FUNC_T *)b)->address;
+
+    return (addrA > addrB) - (addrA < addrB);
+}
+
+
+/*******************************************************************************
+* Function Name: AssignSlots()
+********************************************************************************
+*
+* Summary:
+*   Computes the slot of every function. A slotted map already carries the
+*   padding, so its addresses are the slots. Otherwise functions are laid out
+*   again from the first address with a padding budget added to each one.
+*
+*******************************************************************************/
+static void AssignSlots(MAP_T *map, uint32 padPercent, uint32 padMin)
+{
+    uint32 next;
+    uint32 i;
+
+    if((map->isSlotted != 0u) || (map->count == 0u))
+    {
+        return;
+    }
+
+    next = map->funcs[0u].address;
+    for(i = 0u; i < map->count; i++)
+    {
+        FUNC_T *func = &map->funcs[i];
+        uint32 pad = (func->size * padPercent) / 100u;
+
+        if(pad < padMin)
+        {
+            pad = padMin;
+        }
+        func->slot = next;
+        next = (next + func->size + pad + 3u) & ~3u;
+    }
+    map->slotEnd = next;
+}
+
+
+/*******************************************************************************
+* Function Name: FindFunc()
+*******************************************************************************/
+static const FUNC_T *FindFunc(const MAP_T *map, const FUNC_T *func)
+{
+    uint32 i;
+
+    for(i = 0u; i < map->count; i++)
+    {
+        if((strcmp(map->funcs[i].section, func->section) == 0) &&
+           (strcmp(map->funcs[i].object, func->object) == 0))
+        {
+            return &map->funcs[i];
+        }
+    }
+    return NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: CountChangedRows()
+********************************************************************************
+*
+* Summary:
+*   Counts flash rows whose covering functions differ between two layouts.
+*   With useSlots set, the "after" layout is simulated as the linker would
+*   place it with the stable order script generated from "slots": each known
+*   function at MAX(current, slot), unknown functions after the last slot.
+*
+*******************************************************************************/
+static uint32 CountChangedRows(const MAP_T *before, const MAP_T *after, uint32 useSlots, const MAP_T *slots)
+{
+    uint32 *placed = calloc(after->count + 1u, sizeof(uint32));
+    uint8  *dirty;
+    uint32 lo = 0xFFFFFFFFu, hi = 0u;
+    uint32 rows = 0u;
+    uint32 i, r;
+
+    if(placed == NULL)
+    {
+        return 0u;
+    }
+
+    /* Placement of the new functions */
+    if(useSlots != 0u)
+    {
+        uint32 cursor = (slots->count != 0u) ? slots->funcs[0u].slot : 0u;
+        uint32 tail;
+
+        for(i = 0u; i < slots->count; i++)
+        {
+            const FUNC_T *now = FindFunc(after, &slots->funcs[i]);
+
+            if(now != NULL)
+            {
+                cursor = (cursor > slots->funcs[i].slot) ? cursor : slots->funcs[i].slot;
+                placed[now - after->funcs] = cursor;
+                cursor += (now->size + 3u) & ~3u;
+            }
+        }
+        tail = (cursor > slots->slotEnd) ? cursor : slots->slotEnd;
+        for(i = 0u; i < after->count; i++)
+        {
+            if(FindFunc(slots, &after->funcs[i]) == NULL)
+            {
+                placed[i] = tail;
+                tail += (after->funcs[i].size + 3u) & ~3u;
+            }
+        }
+    }
+    else
+    {
+        for(i = 0u; i < after->count; i++)
+        {
+            placed[i] = after->funcs[i].address;
+        }
+    }
+
+    for(i = 0u; i < before->count; i++)
+    {
+        uint32 start = (useSlots != 0u) ? before->funcs[i].slot : before->funcs[i].address;
+        lo = (start < lo) ? start : lo;
+        hi = ((start + before->funcs[i].size) > hi) ? (start + before->funcs[i].size) : hi;
+    }
+    for(i = 0u; i < after->count; i++)
+    {
+        lo = (placed[i] < lo) ? placed[i] : lo;
+        hi = ((placed[i] + after->funcs[i].size) > hi) ? (placed[i] + after->funcs[i].size) : hi;
+    }
+    if(hi <= lo)
+    {
+        free(placed);
+        return 0u;
+    }
+
+    lo /= FLASH_ROW_SIZE;
+    hi = (hi + FLASH_ROW_SIZE - 1u) / FLASH_ROW_SIZE;
+    dirty = calloc(hi - lo, 1u);
+    if(dirty == NULL)
+    {
+        free(placed);
+        return 0u;
+    }
+
+    /* A function that moved or changed size dirties every row it covers in
+     * both layouts; functions that only exist on one side dirty their rows too.
+     */
+    for(i = 0u; i < after->count; i++)
+    {
+        const FUNC_T *old = FindFunc(before, &after->funcs[i]);
+        uint32 oldStart = 0u;
+
+        if(old != NULL)
+        {
+            oldStart = (useSlots != 0u) ? old->slot : old->address;
+        }
+        if((old == NULL) || (oldStart != placed[i]) || (old->size != after->funcs[i].size))
+        {
+            for(r = placed[i] / FLASH_ROW_SIZE; r <= ((placed[i] + after->funcs[i].size - 1u) / FLASH_ROW_SIZE); r++)
+            {
+                dirty[r - lo] = 1u;
+            }
+            if(old != NULL)
+            {
+                for(r = oldStart / FLASH_ROW_SIZE; r <= ((oldStart + old->size - 1u) / FLASH_ROW_SIZE); r++)
+                {
+                    dirty[r - lo] = 1u;
+                }
+            }
+        }
+    }
+    for(i = 0u; i < before->count; i++)
+    {
+        if(FindFunc(after, &before->funcs[i]) == NULL)
+        {
+            uint32 start = (useSlots != 0u) ? before->funcs[i].slot : before->funcs[i].address;
+
+            for(r = start / FLASH_ROW_SIZE; r <= ((start + before->funcs[i].size - 1u) / FLASH_ROW_SIZE); r++)
+            {
+                dirty[r - lo] = 1u;
+            }
+        }
+    }
+
+    for(r = 0u; r < (hi - lo); r++)
+    {
+        rows += dirty[r];
+    }
+    free(dirty);
+    free(placed);
+    return rows;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandGenerate()
+*******************************************************************************/
+static int CommandGenerate(const char8 *mapPath, const char8 *scriptPath, uint32 padPercent, uint32 padMin)
+{
+    MAP_T map;
+    FILE *out;
+    uint32 i;
+
+    if(MapRead(mapPath, &map) != 0)
+    {
+        return -1;
+    }
+    AssignSlots(&map, padPercent, padMin);
+
+    out = fopen(scriptPath, "w");
+    if(out == NULL)
+    {
+        fprintf(stderr, "ERROR: can't create %s\n", scriptPath);
+        free(map.funcs);
+        return -1;
+    }
+
+    fprintf(out, "/* Generated by Tools\\linkstable from %s. Do not edit. */\n", mapPath);
+    fprintf(out, "/* %u function slots, padding %u%% (min %u bytes) */\n",
+            (unsigned int)map.count, (unsigned int)padPercent, (unsigned int)padMin);
+    if(map.count != 0u)
+    {
+        fprintf(out, "%s = .;\n", STABLE_ORDER_MARKER);
+    }
+    for(i = 0u; i < map.count; i++)
+    {
+        fprintf(out, ". = MAX(., 0x%08X - appl_start);\n*%s(%s)\n", (unsigned int)map.funcs[i].slot,
+                map.funcs[i].object, map.funcs[i].section);
+    }
+    if(map.count != 0u)
+    {
+        fprintf(out, ". = MAX(., 0x%08X - appl_start);\n", (unsigned int)map.slotEnd);
+    }
+
+    printf("%s: %u slots, 0x%08X..0x%08X\n", scriptPath, (unsigned int)map.count,
+           (map.count != 0u) ? (unsigned int)map.funcs[0u].slot : 0u, (unsigned int)map.slotEnd);
+    free(map.funcs);
+    return (fclose(out) == 0) ? 0 : -1;
+}
+
+
+/*******************************************************************************
+* Function Name: CommandEstimate()
+*******************************************************************************/
+static int CommandEstimate(const char8 *oldPath, const char8 *newPath, uint32 padPercent, uint32 padMin)
+{
+    MAP_T before, after;
+    uint32 plain, stable;
+
+    if((MapRead(oldPath, &before) != 0) || (MapRead(newPath, &after) != 0))
+    {
+        return -1;
+    }
+
+    plain = CountChangedRows(&before, &after, 0u, NULL);
+    AssignSlots(&before, padPercent, padMin);
+    stable = CountChangedRows(&before, &after, 1u, &before);
+
+    printf("functions: %u -> %u\n", (unsigned int)before.count, (unsigned int)after.count);
+    printf("rows changed without stable order: %u\n", (unsigned int)plain);
+    printf("rows changed with stable order:    %u\n", (unsigned int)stable);
+
+    free(before.funcs);
+    free(after.funcs);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32 padPercent = PAD_PERCENT_DEFAULT;
+    uint32 padMin = PAD_MIN_DEFAULT;
+    int i;
+
+    for(i = 5; i < argc; i += 2)
+    {
+        if(strcmp(argv[i - 1], "--pad") == 0)
+        {
+            padPercent = (uint32)strtoul(argv[i], NULL, 0);
+        }
+        else if(strcmp(argv[i - 1], "--pad-min") == 0)
+        {
+            padMin = (uint32)strtoul(argv[i], NULL, 0);
+        }
+        else
+        {
+            argc = 0;
+        }
+    }
+
+    if((argc >= 4) && ((argc % 2) == 0) && (strcmp(argv[1], "generate") == 0))
+    {
+        return (CommandGenerate(argv[2], argv[3], padPercent, padMin) == 0) ? 0 : 2;
+    }
+    if((argc >= 4) && ((argc % 2) == 0) && (strcmp(argv[1], "estimate") == 0))
+    {
+        return (CommandEstimate(argv[2], argv[3], padPercent, padMin) == 0) ? 0 : 2;
+    }
+
+    fprintf(stderr,
+        "usage: linkstable generate <previous.map> <StableOrderGcc.ld> [--pad PERCENT] [--pad-min BYTES]\n"
+        "       linkstable estimate <previous.map> <current.map> [--pad PERCENT] [--pad-min BYTES]\n");
+    return 2;
+}
+
+
+/* [] END OF FILE */
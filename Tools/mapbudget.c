@@ -0,0 +1,792 @@
+/*******************************************************************************
+* File Name: mapbudget.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host tool that reports the flash and SRAM footprint of the Bootloader and
+*  HelloApp projects from their GCC map files and enforces budgets.
+*
+*  Every allocated input section is attributed to its module (object file or
+*  library member) and to a component (CyBle, B_UART, Bootloader, ...).
+*  Components are assigned by object name prefix as listed in the budget
+*  file; unlisted modules form a component of their own. Space an output
+*  section reserves without input sections (.heap, .stack,
+*  .bootloader_data) is reported as "(.name)".
+*
+*  The HelloApp RAM is checked against the segment it shares with the
+*  Bootloader: any HelloApp section other than .ramvectors, .btldr_run and
+*  .bootloader_data that overlaps the Bootloader RAM image is flagged, as is
+*  a BOOTLOADER_RAM_SIZE smaller than the RAM the Bootloader really uses
+*  (LinkerScripts\BootloaderSymbolsGcc.ld out of date).
+*
+*  Budget file, one directive per line ('#' starts a comment):
+*    component <name> <prefix> [<prefix> ...]
+*    budget <bootloader|app> <flash|ram> <component|*> <bytes>
+*
+*  Build:
+*   gcc -O2 -I Host -o mapbudget mapbudget.c
+*
+*  Usage:
+*   mapbudget [--budget <file>] [--modules <count>]
+*             [--bootloader <Bootloader.map>] [--app <HelloApp.map>]
+*
+*  Exit code is 0 when all budgets hold and no overlap is found, 1 when a
+*  budget is exceeded or RAM overlaps, 2 on errors. It can be run as a
+*  post-build user command of HelloApp to fail the build.
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cytypes.h>
+
+#define NAME_SIZE_MAX           (128u)
+#define LINE_SIZE_MAX           (1024u)
+#define PREFIX_MAX              (16u)
+#define COMPONENT_RULES_MAX     (64u)
+#define BUDGETS_MAX             (64u)
+#define MODULES_DEFAULT         (10u)
+
+#define FLASH_END               (0x10000000u)
+#define RAM_START               (0x20000000u)
+#define RAM_END                 (0x30000000u)
+
+#define PROJECT_BOOTLOADER      (0u)
+#define PROJECT_APP             (1u)
+#define PROJECT_COUNT           (2u)
+
+#define MEMORY_FLASH            (0u)
+#define MEMORY_RAM              (1u)
+
+static const char8 *projectNames[PROJECT_COUNT] = { "bootloader", "app" };
+static const char8 *memoryNames[2u] = { "flash", "ram" };
+
+/* HelloApp output sections that are allowed inside the shared RAM segment */
+static const char8 *sharedRamSections[] = { ".ramvectors", ".btldr_run", ".bootloader_data" };
+
+
+/***************************************
+*       Data Types
+***************************************/
+typedef struct
+{
+    char8  name[NAME_SIZE_MAX];
+    char8  component[NAME_SIZE_MAX];
+    uint32 size[2u];
+} MODULE_T;
+
+typedef struct
+{
+    char8  name[NAME_SIZE_MAX];
+    uint32 address;
+    uint32 size;
+    uint32 used;        /* Sum of the input sections */
+} OUTPUT_T;
+
+typedef struct
+{
+    MODULE_T *modules;
+    uint32    moduleCount;
+    uint32    total[2u];
+    uint32    bssEnd;           /* __bss_end__ */
+    uint32    reservedRam;      /* BOOTLOADER_RAM_SIZE, HelloApp only */
+    uint32    overlaps;
+} PROJECT_T;
+
+typedef struct
+{
+    char8  name[NAME_SIZE_MAX];
+    char8  prefix[PREFIX_MAX][NAME_SIZE_MAX];
+    uint32 prefixCount;
+} COMPONENT_RULE_T;
+
+typedef struct
+{
+    uint32 project;
+    uint32 memory;
+    char8  component[NAME_SIZE_MAX];
+    uint32 limit;
+} BUDGET_T;
+
+static COMPONENT_RULE_T componentRules[COMPONENT_RULES_MAX];
+static uint32 componentRuleCount;
+static BUDGET_T budgets[BUDGETS_MAX];
+static uint32 budgetCount;
+
+
+/***************************************
+*       Function Prototypes
+***************************************/
+static int   BudgetRead(const char8 *path);
+static void  ModuleName(const char8 *path, char8 name[]);
+static void  ComponentName(const char8 *module, char8 component[]);
+static int   AddSize(PROJECT_T *project, const char8 *module, uint32 address, uint32 size, uint32 isData);
+static void  CheckShared(PROJECT_T *project, const char8 *section, const char8 *module, uint32 address,
+                         uint32 size, uint32 sharedEnd);
+static int   MapRead(const char8 *path, PROJECT_T *project, uint32 sharedEnd);
+static uint32 ComponentSize(const PROJECT_T *project, const char8 *component, uint32 memory);
+static void  Report(const char8 *title, PROJECT_T *project, uint32 moduleCount);
+static int   CompareModules(const void *a, const void *b);
+
+
+/*******************************************************************************
+* Function Name: BudgetRead()
+*******************************************************************************/
+static int BudgetRead(const char8 *path)
+{
+    char8 line[LINE_SIZE_MAX];
+    uint32 lineNumber = 0u;
+    FILE *file = fopen(path, "r");
+
+    if(file == NULL)
+    {
+        fprintf(stderr, "ERROR: can't open %s\n", path);
+        return -1;
+    }
+
+    while(fgets(line, sizeof(line), file) != NULL)
+    {
+        char8 *token;
+        char8 *comment = strchr(line, '#');
+
+        lineNumber++;
+        if(comment != NULL)
+        {
+            *comment = '\0';
+        }
+        token = strtok(line, " \t\r\n");
+        if(token == NULL)
+        {
+            continue;
+        }
+
+        if((strcmp(token, "component") == 0) && (componentRuleCount < COMPONENT_RULES_MAX))
+        {
+            COMPONENT_RULE_T *rule = &componentRules[componentRuleCount];
+
+            token = strtok(NULL, " \t\r\n");
+            if(token == NULL)
+            {
+                break;
+            }
+            (void)snprintf(rule->name, NAME_SIZE_MAX, "%s", token);
+            rule->prefixCount = 0u;
+            while(((token = strtok(NULL, " \t\r\n")) != NULL) && (rule->prefixCount < PREFIX_MAX))
+            {
+                (void)snprintf(rule->prefix[rule->prefixCount], NAME_SIZE_MAX, "%s", token);
+                rule->prefixCount++;
+            }
+            componentRuleCount++;
+        }
+        else if((strcmp(token, "budget") == 0) && (budgetCount < BUDGETS_MAX))
+        {
+            BUDGET_T *budget = &budgets[budgetCount];
+            char8 *project = strtok(NULL, " \t\r\n");
+            char8 *memory = strtok(NULL, " \t\r\n");
+            char8 *component = strtok(NULL, " \t\r\n");
+            char8 *limit = strtok(NULL, " \t\r\n");
+
+            if((limit == NULL) ||
+               ((strcmp(project, "bootloader") != 0) && (strcmp(project, "app") != 0)) ||
+               ((strcmp(memory, "flash") != 0) && (strcmp(memory, "ram") != 0)))
+            {
+                break;
+            }
+            budget->project = (strcmp(project, "app") == 0) ? PROJECT_APP : PROJECT_BOOTLOADER;
+            budget->memory = (strcmp(memory, "ram") == 0) ? MEMORY_RAM : MEMORY_FLASH;
+            (void)snprintf(budget->component, NAME_SIZE_MAX, "%s", component);
+            budget->limit = (uint32)strtoul(limit, NULL, 0);
+            budgetCount++;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if(!feof(file))
+    {
+        fprintf(stderr, "ERROR: %s:%u: invalid directive\n", path, (unsigned int)lineNumber);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: ModuleName()
+********************************************************************************
+*
+* Summary:
+*   Strips directories from an object path; "lib.a(member.o)" becomes
+*   "lib.a(member.o)" without the directories of the archive.
+*
+*******************************************************************************/
+static void ModuleName(const char8 *path, char8 name[])
+{
+    const char8 *base = path;
+    const char8 *end = strchr(path, '(');
+    const char8 *p;
+
+    if(end == NULL)
+    {
+        end = path + strlen(path);
+    }
+    for(p = path; p < end; p++)
+    {
+        if((*p == '/') || (*p == '\\'))
+        {
+            base = p + 1;
+        }
+    }
+    (void)snprintf(name, NAME_SIZE_MAX, "%s", base);
+}
+
+
+/*******************************************************************************
+* Function Name: ComponentName()
+********************************************************************************
+*
+* Summary:
+*   Finds the component of a module. The longest matching prefix of the
+*   budget file wins; it is matched against the object name and, for library
+*   members, against the archive name too. Unmatched library members belong
+*   to their archive, other modules (and the "(fill)" and "(.section)"
+*   pseudo modules) to themselves.
+*
+*******************************************************************************/
+static void ComponentName(const char8 *module, char8 component[])
+{
+    const char8 *member = strchr(module, '(');
+    size_t bestLength = 0u;
+    uint32 i, j;
+
+    for(i = 0u; i < componentRuleCount; i++)
+    {
+        for(j = 0u; j < componentRules[i].prefixCount; j++)
+        {
+            const char8 *prefix = componentRules[i].prefix[j];
+            size_t length = strlen(prefix);
+
+            if((length > bestLength) &&
+               ((strncmp(module, prefix, length) == 0) ||
+                ((member != NULL) && (strncmp(member + 1, prefix, length) == 0))))
+            {
+                bestLength = length;
+                (void)snprintf(component, NAME_SIZE_MAX, "%.127s", componentRules[i].name);
+            }
+        }
+    }
+
+    if(bestLength == 0u)
+    {
+        char8 *cut;
+
+        (void)snprintf(component, NAME_SIZE_MAX, "%s", module);
+        cut = (component[0] == '(') ? NULL : strchr(component, '(');
+        if((cut == NULL) && (component[0] != '('))
+        {
+            cut = strrchr(component, '.');
+        }
+        if(cut != NULL)
+        {
+            *cut = '\0';
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: AddSize()
+*******************************************************************************/
+static int AddSize(PROJECT_T *project, const char8 *module, uint32 address, uint32 size, uint32 isData)
+{
+    MODULE_T *entry = NULL;
+    uint32 i;
+
+    for(i = 0u; i < project->moduleCount; i++)
+    {
+        if(strcmp(project->modules[i].name, module) == 0)
+        {
+            entry = &project->modules[i];
+            break;
+        }
+    }
+    if(entry == NULL)
+    {
+        MODULE_T *modules = realloc(project->modules, (project->moduleCount + 1u) * sizeof(MODULE_T));
+
+        if(modules == NULL)
+        {
+            return -1;
+        }
+        project->modules = modules;
+        entry = &modules[project->moduleCount];
+        project->moduleCount++;
+        memset(entry, 0, sizeof(*entry));
+        (void)snprintf(entry->name, NAME_SIZE_MAX, "%s", module);
+        ComponentName(module, entry->component);
+    }
+
+    if(address < FLASH_END)
+    {
+        entry->size[MEMORY_FLASH] += size;
+        project->total[MEMORY_FLASH] += size;
+    }
+    else
+    {
+        entry->size[MEMORY_RAM] += size;
+        project->total[MEMORY_RAM] += size;
+        if(isData != 0u)
+        {
+            /* Initial values of .data are stored in flash */
+            entry->size[MEMORY_FLASH] += size;
+            project->total[MEMORY_FLASH] += size;
+        }
+    }
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: CheckShared()
+********************************************************************************
+*
+* Summary:
+*   Flags a HelloApp RAM range that overlaps the Bootloader RAM image
+*   [RAM_START, sharedEnd) outside of the sections reserved for it.
+*
+*******************************************************************************/
+static void CheckShared(PROJECT_T *project, const char8 *section, const char8 *module, uint32 address,
+                        uint32 size, uint32 sharedEnd)
+{
+    uint32 i;
+
+    if((sharedEnd == 0u) || (address < RAM_START) || (address >= sharedEnd) || (size == 0u))
+    {
+        return;
+    }
+    for(i = 0u; i < (sizeof(sharedRamSections) / sizeof(sharedRamSections[0u])); i++)
+    {
+        if(strcmp(section, sharedRamSections[i]) == 0)
+        {
+            return;
+        }
+    }
+    printf("OVERLAP %s %s 0x%08X..0x%08X is inside the Bootloader RAM (ends 0x%08X)\n", section, module,
+           (unsigned int)address, (unsigned int)(address + size), (unsigned int)sharedEnd);
+    project->overlaps++;
+}
+
+
+/*******************************************************************************
+* Function Name: MapRead()
+********************************************************************************
+*
+* Summary:
+*   Parses the memory map part of a GNU ld map file. Output sections start in
+*   column 0, input sections are indented by one space; ld moves address,
+*   size and object to the next line when the section name is long.
+*
+*******************************************************************************/
+static int MapRead(const char8 *path, PROJECT_T *project, uint32 sharedEnd)
+{
+    char8 line[LINE_SIZE_MAX];
+    char8 pending[NAME_SIZE_MAX];
+    uint32 pendingOutput = 0u;
+    uint32 inMemoryMap = 0u;
+    OUTPUT_T output;
+    FILE *file;
+
+    memset(project, 0, sizeof(*project));
+    memset(&output, 0, sizeof(output));
+    pending[0] = '\0';
+    file = fopen(path, "r");
+    if(file == NULL)
+    {
+        fprintf(stderr, "ERROR: can't open %s\n", path);
+        return -1;
+    }
+
+    /* Extra pass through the loop body with an empty line closes the last output section */
+    while((fgets(line, sizeof(line), file) != NULL) || ((line[0] = '\0'), (output.name[0] != '\0')))
+    {
+        char8 name[NAME_SIZE_MAX];
+        char8 object[LINE_SIZE_MAX];
+        char8 module[NAME_SIZE_MAX];
+        unsigned long address, size;
+        uint32 isOutput;
+        int count;
+
+        if(inMemoryMap == 0u)
+        {
+            inMemoryMap = (strncmp(line, "Linker script and memory map", 28u) == 0) ? 1u : 0u;
+            continue;
+        }
+
+        if((sscanf(line, " 0x%lx PROVIDE (%127[^,]", &address, name) == 2) ||
+           (sscanf(line, " 0x%lx %127s = ", &address, name) == 2))
+        {
+            if(strcmp(name, "__bss_end__") == 0)
+            {
+                project->bssEnd = (uint32)address;
+            }
+            else if(strcmp(name, "BOOTLOADER_RAM_SIZE") == 0)
+            {
+                project->reservedRam = (uint32)address;
+            }
+            else
+            {
+                /* Other symbols are not used */
+            }
+        }
+
+        /* Header of a new output section, or end of input */
+        isOutput = ((line[0] == '.') || (line[0] == '\0')) ? 1u : 0u;
+        if((isOutput != 0u) && (output.name[0] != '\0'))
+        {
+            /* Space the linker script reserved without input sections */
+            if(output.size > output.used)
+            {
+                uint32 gap = output.size - output.used;
+                uint32 gapAddress = output.address + output.used;
+
+                (void)snprintf(module, NAME_SIZE_MAX, "(%.120s)", output.name);
+                if(((gapAddress < FLASH_END) || ((gapAddress >= RAM_START) && (gapAddress < RAM_END))) &&
+                   (AddSize(project, module, gapAddress, gap, 0u) != 0))
+                {
+                    fclose(file);
+                    return -1;
+                }
+                CheckShared(project, output.name, module, gapAddress, gap, sharedEnd);
+            }
+            output.name[0] = '\0';
+        }
+        if(line[0] == '\0')
+        {
+            break;
+        }
+
+        if((isOutput != 0u) || (pendingOutput != 0u))
+        {
+            if(isOutput != 0u)
+            {
+                count = sscanf(line, "%127s 0x%lx 0x%lx", name, &address, &size);
+                if(count == 1)
+                {
+                    (void)snprintf(pending, sizeof(pending), "%s", name);
+                    pendingOutput = 1u;
+                    continue;
+                }
+            }
+            else
+            {
+                (void)snprintf(name, sizeof(name), "%s", pending);
+                count = 1 + sscanf(line, " 0x%lx 0x%lx", &address, &size);
+                pendingOutput = 0u;
+            }
+
+            /* Debug information and other non-allocated sections are skipped */
+            if((count == 3) && (strncmp(name, ".debug", 6u) != 0) && (strcmp(name, ".comment") != 0) &&
+               (strncmp(name, ".ARM.attributes", 15u) != 0) && (strncmp(name, ".stab", 5u) != 0))
+            {
+                (void)snprintf(output.name, NAME_SIZE_MAX, "%s", name);
+                output.address = (uint32)address;
+                output.size = (uint32)size;
+                output.used = 0u;
+            }
+            continue;
+        }
+
+        if((output.name[0] == '\0') || (line[0] != ' ') || (line[1] == '*' && line[2] == '('))
+        {
+            continue;
+        }
+
+        /* Input section: " name 0xaddr 0xsize object", possibly split over two lines */
+        if((pending[0] != '\0') && (sscanf(line, " 0x%lx 0x%lx %1023s", &address, &size, object) == 3))
+        {
+            (void)snprintf(name, sizeof(name), "%s", pending);
+            count = 4;
+        }
+        else
+        {
+            count = sscanf(line, " %127s 0x%lx 0x%lx %1023s", name, &address, &size, object);
+        }
+        pending[0] = '\0';
+        if(count == 1)
+        {
+            if((name[0] == '.') || (strcmp(name, "COMMON") == 0))
+            {
+                (void)snprintf(pending, sizeof(pending), "%s", name);
+            }
+            continue;
+        }
+
+        if(strcmp(name, "*fill*") == 0)
+        {
+            if(count < 3)
+            {
+                continue;
+            }
+            (void)snprintf(object, sizeof(object), "(fill)");
+            count = 4;
+        }
+        if((count != 4) || (size == 0u))
+        {
+            continue;
+        }
+        if((address >= FLASH_END) && ((address < RAM_START) || (address >= RAM_END)))
+        {
+            /* Metadata and other sections outside flash and SRAM */
+            continue;
+        }
+
+        ModuleName(object, module);
+        if(AddSize(project, module, (uint32)address, (uint32)size,
+                   (strncmp(output.name, ".data", 5u) == 0) ? 1u : 0u) != 0)
+        {
+            fclose(file);
+            return -1;
+        }
+        output.used += (uint32)size;
+        CheckShared(project, output.name, module, (uint32)address, (uint32)size, sharedEnd);
+    }
+
+    fclose(file);
+    if(inMemoryMap == 0u)
+    {
+        fprintf(stderr, "ERROR: %s is not a GNU ld map file\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: ComponentSize()
+*******************************************************************************/
+static uint32 ComponentSize(const PROJECT_T *project, const char8 *component, uint32 memory)
+{
+    uint32 size = 0u;
+    uint32 i;
+
+    if(strcmp(component, "*") == 0)
+    {
+        return project->total[memory];
+    }
+    for(i = 0u; i < project->moduleCount; i++)
+    {
+        if(strcmp(project->modules[i].component, component) == 0)
+        {
+            size += project->modules[i].size[memory];
+        }
+    }
+    return size;
+}
+
+
+/*******************************************************************************
+* Function Name: CompareModules()
+*******************************************************************************/
+static int CompareModules(const void *a, const void *b)
+{
+    const MODULE_T *moduleA = (const MODULE_T *)a;
+    const MODULE_T *moduleB = (const MODULE_T *)b;
+    uint32 sizeA = moduleA->size[MEMORY_FLASH] + moduleA->size[MEMORY_RAM];
+    uint32 sizeB = moduleB->size[MEMORY_FLASH] + moduleB->size[MEMORY_RAM];
+
+    if(sizeA != sizeB)
+    {
+        return (sizeA < sizeB) ? 1 : -1;
+    }
+    return strcmp(moduleA->name, moduleB->name);
+}
+
+
+/*******************************************************************************
+* Function Name: Report()
+********************************************************************************
+*
+* Summary:
+*   Prints the totals, the per-component table and the largest modules.
+*
+*******************************************************************************/
+static void Report(const char8 *title, PROJECT_T *project, uint32 moduleCount)
+{
+    char8 (*seen)[NAME_SIZE_MAX];
+    uint32 seenCount = 0u;
+    uint32 i, j;
+
+    qsort(project->modules, project->moduleCount, sizeof(MODULE_T), &CompareModules);
+
+    printf("== %s: flash %u bytes, ram %u bytes\n", title,
+           (unsigned int)project->total[MEMORY_FLASH], (unsigned int)project->total[MEMORY_RAM]);
+    printf("%-24s %10s %10s\n", "component", "flash", "ram");
+
+    /* Modules are sorted by size, so components come out largest first */
+    seen = calloc(project->moduleCount + 1u, NAME_SIZE_MAX);
+    if(seen != NULL)
+    {
+        for(i = 0u; i < project->moduleCount; i++)
+        {
+            for(j = 0u; j < seenCount; j++)
+            {
+                if(strcmp(seen[j], project->modules[i].component) == 0)
+                {
+                    break;
+                }
+            }
+            if(j == seenCount)
+            {
+                (void)snprintf(seen[seenCount], NAME_SIZE_MAX, "%s", project->modules[i].component);
+                seenCount++;
+                printf("%-24s %10u %10u\n", project->modules[i].component,
+                       (unsigned int)ComponentSize(project, project->modules[i].component, MEMORY_FLASH),
+                       (unsigned int)ComponentSize(project, project->modules[i].component, MEMORY_RAM));
+            }
+        }
+        free(seen);
+    }
+
+    printf("%-40s %10s %10s\n", "module", "flash", "ram");
+    for(i = 0u; (i < moduleCount) && (i < project->moduleCount); i++)
+    {
+        printf("%-40s %10u %10u\n", project->modules[i].name,
+               (unsigned int)project->modules[i].size[MEMORY_FLASH],
+               (unsigned int)project->modules[i].size[MEMORY_RAM]);
+    }
+    printf("\n");
+}
+
+
+/*******************************************************************************
+* Function Name: main
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char8 *mapPath[PROJECT_COUNT] = { NULL, NULL };
+    PROJECT_T project[PROJECT_COUNT];
+    uint32 loaded[PROJECT_COUNT] = { 0u, 0u };
+    uint32 moduleCount = MODULES_DEFAULT;
+    uint32 sharedEnd = 0u;
+    uint32 failures = 0u;
+    uint32 i;
+    int arg;
+
+    for(arg = 1; (arg + 1) < argc; arg += 2)
+    {
+        if(strcmp(argv[arg], "--budget") == 0)
+        {
+            if(BudgetRead(argv[arg + 1]) != 0)
+            {
+                return 2;
+            }
+        }
+        else if(strcmp(argv[arg], "--modules") == 0)
+        {
+            moduleCount = (uint32)strtoul(argv[arg + 1], NULL, 0);
+        }
+        else if(strcmp(argv[arg], "--bootloader") == 0)
+        {
+            mapPath[PROJECT_BOOTLOADER] = argv[arg + 1];
+        }
+        else if(strcmp(argv[arg], "--app") == 0)
+        {
+            mapPath[PROJECT_APP] = argv[arg + 1];
+        }
+        else
+        {
+            break;
+        }
+    }
+    if((arg != argc) || ((mapPath[PROJECT_BOOTLOADER] == NULL) && (mapPath[PROJECT_APP] == NULL)))
+    {
+        fprintf(stderr, "usage: mapbudget [--budget <file>] [--modules <count>]\n"
+                        "                 [--bootloader <Bootloader.map>] [--app <HelloApp.map>]\n");
+        return 2;
+    }
+
+    if(mapPath[PROJECT_BOOTLOADER] != NULL)
+    {
+        if(MapRead(mapPath[PROJECT_BOOTLOADER], &project[PROJECT_BOOTLOADER], 0u) != 0)
+        {
+            return 2;
+        }
+        loaded[PROJECT_BOOTLOADER] = 1u;
+        sharedEnd = project[PROJECT_BOOTLOADER].bssEnd;
+    }
+    if(mapPath[PROJECT_APP] != NULL)
+    {
+        /* Without the Bootloader map the reserved size is the best estimate */
+        if(sharedEnd == 0u)
+        {
+            PROJECT_T probe;
+
+            if(MapRead(mapPath[PROJECT_APP], &probe, 0u) != 0)
+            {
+                return 2;
+            }
+            sharedEnd = (probe.reservedRam != 0u) ? (RAM_START + probe.reservedRam) : 0u;
+            free(probe.modules);
+        }
+        if(MapRead(mapPath[PROJECT_APP], &project[PROJECT_APP], sharedEnd) != 0)
+        {
+            return 2;
+        }
+        loaded[PROJECT_APP] = 1u;
+        failures += project[PROJECT_APP].overlaps;
+
+        if((loaded[PROJECT_BOOTLOADER] != 0u) && (sharedEnd > RAM_START) &&
+           (project[PROJECT_APP].reservedRam < (sharedEnd - RAM_START)))
+        {
+            printf("OVERLAP HelloApp reserves BOOTLOADER_RAM_SIZE %u bytes, the Bootloader uses %u bytes; "
+                   "regenerate BootloaderSymbolsGcc.ld\n", (unsigned int)project[PROJECT_APP].reservedRam,
+                   (unsigned int)(sharedEnd - RAM_START));
+            failures++;
+        }
+    }
+
+    for(i = 0u; i < PROJECT_COUNT; i++)
+    {
+        if(loaded[i] != 0u)
+        {
+            Report(mapPath[i], &project[i], moduleCount);
+        }
+    }
+
+    for(i = 0u; i < budgetCount; i++)
+    {
+        const BUDGET_T *budget = &budgets[i];
+
+        if(loaded[budget->project] != 0u)
+        {
+            uint32 used = ComponentSize(&project[budget->project], budget->component, budget->memory);
+            uint32 over = (used > budget->limit) ? 1u : 0u;
+
+            printf("%-4s %-10s %-5s %-24s %8u / %8u\n", (over != 0u) ? "OVER" : "ok",
+                   projectNames[budget->project], memoryNames[budget->memory], budget->component,
+                   (unsigned int)used, (unsigned int)budget->limit);
+            failures += over;
+        }
+    }
+
+    for(i = 0u; i < PROJECT_COUNT; i++)
+    {
+        free(project[i].modules);
+    }
+    return (failures != 0u) ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,217 @@
+/*******************************************************************************
+* File Name: sraminitbench.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host benchmark for the Bootloader RAM initialization done by HelloApp's
+*  InitializeBootloaderSRAM(). It times the original word-by-word region
+*  loop against Shared\blockmem.c on buffers the size of the Bootloader
+*  .data and .bss regions.
+*
+*  The host build uses the portable C path of blockmem.c; the Thumb
+*  LDMIA/STMIA path is only measured on target with
+*  SRAM_INIT_PROFILE_ENABLED in HelloApp.cydsn\Options.h. Loop pattern
+*  distribution is disabled so the compiler does not turn either loop into
+*  a libc memcpy()/memset() call, which the firmware build does not do.
+*
+*  Cycle counts come from the time stamp counter on x86 hosts and are
+*  nanoseconds elsewhere. The minimum over all iterations is reported.
+*
+*  Build:
+*   gcc -O2 -fno-tree-loop-distribute-patterns -I Host -I ../Shared -o sraminitbench sraminitbench.c ../Shared/blockmem.c
+*
+*  Usage:
+*   sraminitbench [INIT_BYTES] [ZERO_BYTES] [ITERATIONS]
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif /* defined(__x86_64__) || defined(__i386__) */
+
+#include <cytypes.h>
+#include "blockmem.h"
+
+/* Default sizes follow Bootloader.cydsn (.data + .bss end at 0x20002500) */
+#define INIT_BYTES_DEFAULT      (0x0300u)
+#define ZERO_BYTES_DEFAULT      (0x2140u)
+#define ITERATIONS_DEFAULT      (2000u)
+
+typedef void (*INIT_FUNC_T)(uint32 *dst, const uint32 *src, uint32 initSize, uint32 zeroSize);
+
+
+/*******************************************************************************
+* Function Name: ReadCycles()
+********************************************************************************
+*
+* Summary:
+*   Returns the time stamp counter, or a nanosecond clock.
+*
+*******************************************************************************/
+static uint64_t ReadCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint64_t)__rdtsc();
+#else
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * 1000000000u) + (uint64_t)now.tv_nsec;
+#endif /* defined(__x86_64__) || defined(__i386__) */
+}
+
+
+/*******************************************************************************
+* Function Name: InitWordLoop()
+********************************************************************************
+*
+* Summary:
+*   The original Bootloader_Start_c() region loop.
+*
+*******************************************************************************/
+static void InitWordLoop(uint32 *dst, const uint32 *src, uint32 initSize, uint32 zeroSize)
+{
+    uint32 count;
+
+    for(count = 0u; count != initSize; count += sizeof(uint32))
+    {
+        *dst = *src;
+        dst++;
+        src++;
+    }
+    for(count = 0u; count != zeroSize; count += sizeof(uint32))
+    {
+        *dst = 0u;
+        dst++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: InitBlock()
+********************************************************************************
+*
+* Summary:
+*   The region loop on top of BlockMem_Copy32() and BlockMem_Zero32().
+*
+*******************************************************************************/
+static void InitBlock(uint32 *dst, const uint32 *src, uint32 initSize, uint32 zeroSize)
+{
+    BlockMem_Copy32(dst, src, initSize);
+    BlockMem_Zero32(dst + (initSize / sizeof(uint32)), zeroSize);
+}
+
+
+/*******************************************************************************
+* Function Name: Measure()
+********************************************************************************
+*
+* Summary:
+*   Runs one variant and returns the minimum count of a single call.
+*
+*******************************************************************************/
+static uint64_t Measure(INIT_FUNC_T func, uint32 *dst, const uint32 *src,
+                        uint32 initSize, uint32 zeroSize, uint32 iterations)
+{
+    uint64_t best = ~(uint64_t)0u;
+    uint32 i;
+
+    for(i = 0u; i < iterations; i++)
+    {
+        uint64_t start;
+        uint64_t spent;
+
+        /* Dirty the destination as the BLE Stack would */
+        dst[i % ((initSize + zeroSize) / sizeof(uint32))] = i;
+
+        start = ReadCycles();
+        func(dst, src, initSize, zeroSize);
+        spent = ReadCycles() - start;
+
+        if(spent < best)
+        {
+            best = spent;
+        }
+    }
+
+    return best;
+}
+
+
+int main(int argc, char *argv[])
+{
+    uint32 initSize = (argc > 1) ? (uint32)strtoul(argv[1], NULL, 0) : INIT_BYTES_DEFAULT;
+    uint32 zeroSize = (argc > 2) ? (uint32)strtoul(argv[2], NULL, 0) : ZERO_BYTES_DEFAULT;
+    uint32 iterations = (argc > 3) ? (uint32)strtoul(argv[3], NULL, 0) : ITERATIONS_DEFAULT;
+    uint32 *src;
+    uint32 *expect;
+    uint32 *dst;
+    uint64_t wordCycles;
+    uint64_t blockCycles;
+    uint32 i;
+
+    if((argc > 4) || ((initSize % sizeof(uint32)) != 0u) || ((zeroSize % sizeof(uint32)) != 0u) ||
+       ((initSize + zeroSize) == 0u) || (iterations == 0u))
+    {
+        fprintf(stderr, "usage: sraminitbench [INIT_BYTES] [ZERO_BYTES] [ITERATIONS]\n"
+                        "  sizes are multiples of 4, defaults 0x%X 0x%X %u\n",
+                INIT_BYTES_DEFAULT, ZERO_BYTES_DEFAULT, ITERATIONS_DEFAULT);
+        return 2;
+    }
+
+    src = malloc(initSize + sizeof(uint32));
+    expect = malloc(initSize + zeroSize);
+    dst = malloc(initSize + zeroSize);
+    if((src == NULL) || (expect == NULL) || (dst == NULL))
+    {
+        fprintf(stderr, "sraminitbench: out of memory\n");
+        return 2;
+    }
+    for(i = 0u; i < (initSize / sizeof(uint32)); i++)
+    {
+        src[i] = (i * 0x9E3779B9u) ^ 0x5A5A5A5Au;
+    }
+
+    /* Both implementations must produce the same image */
+    InitWordLoop(expect, src, initSize, zeroSize);
+    memset(dst, 0xA5, initSize + zeroSize);
+    InitBlock(dst, src, initSize, zeroSize);
+    if(memcmp(expect, dst, initSize + zeroSize) != 0)
+    {
+        fprintf(stderr, "sraminitbench: block init result differs from word loop\n");
+        return 1;
+    }
+
+    wordCycles = Measure(&InitWordLoop, dst, src, initSize, zeroSize, iterations);
+    blockCycles = Measure(&InitBlock, dst, src, initSize, zeroSize, iterations);
+
+    printf("region: %u init + %u zero bytes, %u iterations (%s)\n", initSize, zeroSize, iterations,
+#if defined(__x86_64__) || defined(__i386__)
+           "TSC cycles");
+#else
+           "ns");
+#endif /* defined(__x86_64__) || defined(__i386__) */
+    printf("  word loop      %10llu\n", (unsigned long long)wordCycles);
+    printf("  block copy     %10llu  (%.2fx)\n", (unsigned long long)blockCycles,
+           (blockCycles != 0u) ? ((double)wordCycles / (double)blockCycles) : 0.0);
+
+    free(src);
+    free(expect);
+    free(dst);
+
+    return 0;
+}
+
+
+/* [] END OF FILE */
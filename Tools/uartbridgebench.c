@@ -0,0 +1,386 @@
+/*******************************************************************************
+* File Name: uartbridgebench.c
+*
+* Version: 1.30
+*
+* Description:
+*  Host simulation of HelloApp's UART to BLE bridge (uartbridge.c) that
+*  reports the sustained throughput in both directions. The byte rings and
+*  the packet decision are the firmware's own Shared\bytering.c; around
+*  them the tool models:
+*   - a UART with an 8 byte hardware FIFO per direction at BAUD, 10 bits
+*    per byte, fed or drained continuously;
+*   - a main loop pass every SIM_LOOP_US, as HelloApp runs while the UART
+*    is active;
+*   - connection events every CONN_INTV_MS, each carrying up to PACKETS
+*    notifications or write commands of ATT MTU - 3 bytes, and a stack
+*    with PACKETS notification buffers;
+*   - a central that writes without pause, with write commands (cut when
+*    the ring is full) or with write requests (one per two connection
+*    events, refused when the ring is full and retried).
+*  UART to BLE is simulated for a range of flush times, showing the
+*  trade-off between packet fill and the latency of the first byte of each
+*  packet.
+*
+*  Build:
+*   gcc -O2 -I Host -I ../Shared -o uartbridgebench uartbridgebench.c ../Shared/bytering.c
+*
+*  Usage:
+*   uartbridgebench [BAUD] [CONN_INTV_MS] [MTU] [PACKETS] [SECONDS] [RING_SIZE]
+*
+********************************************************************************
+* Copyright 2014-2015, Cypress Semiconductor Corporation.  All rights reserved.
+* You may use this file only in accordance with the license, terms, conditions,
+* disclaimers, and limitations in the end user license agreement accompanying
+* the software package with which this file was provided.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cytypes.h>
+#include "bytering.h"
+
+/* Defaults follow HelloApp.cydsn: H_UART at 115200 baud, the 7.5 ms
+ * LINK_POLICY_CONN_INTV_MIN, CYBLE_GATT_MTU and UART_BRIDGE_RX_SIZE.
+ */
+#define BAUD_DEFAULT            (115200u)
+#define CONN_INTV_MS_DEFAULT    (7.5)
+#define MTU_DEFAULT             (144u)
+#define PACKETS_DEFAULT         (4u)
+#define SECONDS_DEFAULT         (10u)
+#define RING_SIZE_DEFAULT       (512u)
+
+#define RING_SIZE_MAX           (8192u)
+#define PACKETS_MAX             (16u)
+#define MTU_MIN                 (23u)
+#define MTU_MAX                 (512u)
+#define UART_FIFO_SIZE          (8u)
+#define UART_BITS_PER_BYTE      (10u)
+#define SIM_LOOP_US             (50u)
+#define US_PER_SEC              (1000000u)
+
+typedef struct
+{
+    uint32 baud;
+    uint32 connIntvUs;
+    uint32 payload;                     /* ATT MTU - 3 */
+    uint32 packets;                     /* Per connection event, and stack buffers */
+    uint32 seconds;
+    uint32 ringSize;
+} BENCH_CONFIG_T;
+
+typedef struct
+{
+    uint64_t bytes;                     /* Bytes delivered */
+    uint64_t packets;
+    uint64_t lost;                      /* Bytes dropped with the ring full */
+    uint64_t refused;                   /* Write requests refused */
+    uint64_t latencySum;                /* us, first byte of each packet */
+    uint64_t latencyMax;
+    uint32 ringMax;                     /* Most bytes buffered */
+} BENCH_RESULT_T;
+
+typedef struct
+{
+    uint32 length;
+    uint64_t firstUs;                   /* Arrival of the first byte */
+} BENCH_PACKET_T;
+
+static uint8 ringBuffer[RING_SIZE_MAX];
+static uint64_t arrivalUs[RING_SIZE_MAX];
+static uint8 packetBuffer[MTU_MAX];
+
+
+/*******************************************************************************
+* Function Name: UartBytes()
+********************************************************************************
+*
+* Summary:
+*   Returns the number of bytes the UART has moved since time zero.
+*
+*******************************************************************************/
+static uint64_t UartBytes(const BENCH_CONFIG_T *config, uint64_t nowUs)
+{
+    return (nowUs * config->baud) / ((uint64_t)UART_BITS_PER_BYTE * US_PER_SEC);
+}
+
+
+/*******************************************************************************
+* Function Name: SimToBle()
+********************************************************************************
+*
+* Summary:
+*   Simulates UART to BLE with the given flush time, following
+*   UartBridge_FromUart() and UartBridge_ToBle().
+*
+*******************************************************************************/
+static void SimToBle(const BENCH_CONFIG_T *config, uint32 flushUs, BENCH_RESULT_T *result)
+{
+    BYTE_RING_T ring;
+    BENCH_PACKET_T stack[PACKETS_MAX];
+    uint64_t endUs = (uint64_t)config->seconds * US_PER_SEC;
+    uint64_t nextEventUs = config->connIntvUs;
+    uint64_t deadlineUs = 0u;
+    uint64_t produced = 0u;
+    uint64_t nowUs;
+    uint32 fifo = 0u;
+    uint32 queued = 0u;
+    uint32 timer = 0u;
+    uint32 flush = 0u;
+    uint32 i;
+
+    (void) memset(result, 0, sizeof(*result));
+    ByteRing_Init(&ring, ringBuffer, config->ringSize);
+
+    for(nowUs = 0u; nowUs < endUs; nowUs += SIM_LOOP_US)
+    {
+        uint64_t total = UartBytes(config, nowUs);
+        uint32 wasEmpty = (0u == ByteRing_Count(&ring)) ? 1u : 0u;
+        uint32 received = 0u;
+        uint32 length;
+
+        /* UART receiver: overrun when the FIFO is not read in time */
+        fifo += (uint32)(total - produced);
+        produced = total;
+        if(fifo > UART_FIFO_SIZE)
+        {
+            result->lost += fifo - UART_FIFO_SIZE;
+            fifo = UART_FIFO_SIZE;
+        }
+
+        /* UartBridge_FromUart() */
+        for(; fifo != 0u; fifo--)
+        {
+            uint8 rxByte = (uint8)received;
+
+            received++;
+            if(0u != ByteRing_Write(&ring, &rxByte, 1u))
+            {
+                arrivalUs[(ring.head - 1u) & ring.mask] = nowUs;
+            }
+            else
+            {
+                result->lost++;
+            }
+        }
+        if((0u != received) && (0u != wasEmpty) && (0u != ByteRing_Count(&ring)))
+        {
+            if(0u == flushUs)
+            {
+                flush = 1u;
+            }
+            else
+            {
+                deadlineUs = nowUs + flushUs;
+                timer = 1u;
+            }
+        }
+        if(ByteRing_Count(&ring) > result->ringMax)
+        {
+            result->ringMax = ByteRing_Count(&ring);
+        }
+
+        /* UartBridge_ToBle() */
+        if((0u != timer) && (nowUs >= deadlineUs))
+        {
+            timer = 0u;
+            flush = 1u;
+        }
+        while(queued < config->packets)
+        {
+            length = ByteRing_Chunk(&ring, config->payload, flush);
+            if(0u == length)
+            {
+                break;
+            }
+            stack[queued].firstUs = arrivalUs[ring.tail & ring.mask];
+            stack[queued].length = ByteRing_Peek(&ring, packetBuffer, length);
+            ByteRing_Drop(&ring, length);
+            queued++;
+        }
+        if(0u == ByteRing_Count(&ring))
+        {
+            flush = 0u;
+            timer = 0u;
+        }
+
+        /* Connection event: the stack buffers go out */
+        if(nowUs >= nextEventUs)
+        {
+            for(i = 0u; i < queued; i++)
+            {
+                uint64_t latency = nowUs - stack[i].firstUs;
+
+                result->bytes += stack[i].length;
+                result->packets++;
+                result->latencySum += latency;
+                if(latency > result->latencyMax)
+                {
+                    result->latencyMax = latency;
+                }
+            }
+            queued = 0u;
+            nextEventUs += config->connIntvUs;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SimToUart()
+********************************************************************************
+*
+* Summary:
+*   Simulates BLE to UART, following UartBridge_Write() and
+*   UartBridge_ToUart(), with write commands or write requests.
+*
+*******************************************************************************/
+static void SimToUart(const BENCH_CONFIG_T *config, uint32 requests, BENCH_RESULT_T *result)
+{
+    BYTE_RING_T ring;
+    uint64_t endUs = (uint64_t)config->seconds * US_PER_SEC;
+    uint64_t nextEventUs = config->connIntvUs;
+    uint64_t credit = 0u;               /* Bit times, scaled by US_PER_SEC */
+    uint64_t byteCredit = (uint64_t)UART_BITS_PER_BYTE * US_PER_SEC;
+    uint64_t nowUs;
+    uint32 fifo = 0u;
+    uint32 awaitingRsp = 0u;
+    uint32 i;
+
+    (void) memset(result, 0, sizeof(*result));
+    (void) memset(packetBuffer, 0x55, sizeof(packetBuffer));
+    ByteRing_Init(&ring, ringBuffer, config->ringSize);
+
+    for(nowUs = 0u; nowUs < endUs; nowUs += SIM_LOOP_US)
+    {
+        uint8 txByte;
+
+        /* Connection event: the central writes */
+        if(nowUs >= nextEventUs)
+        {
+            if(0u != requests)
+            {
+                /* The response goes out in the next event */
+                if(0u != awaitingRsp)
+                {
+                    awaitingRsp = 0u;
+                }
+                else if(config->payload > ByteRing_Space(&ring))
+                {
+                    result->refused++;
+                    awaitingRsp = 1u;
+                }
+                else
+                {
+                    (void) ByteRing_Write(&ring, packetBuffer, config->payload);
+                    result->packets++;
+                    awaitingRsp = 1u;
+                }
+            }
+            else
+            {
+                for(i = 0u; i < config->packets; i++)
+                {
+                    result->lost += config->payload - ByteRing_Write(&ring, packetBuffer, config->payload);
+                    result->packets++;
+                }
+            }
+            if(ByteRing_Count(&ring) > result->ringMax)
+            {
+                result->ringMax = ByteRing_Count(&ring);
+            }
+            nextEventUs += config->connIntvUs;
+        }
+
+        /* UartBridge_ToUart() */
+        while((fifo < UART_FIFO_SIZE) && (0u != ByteRing_Read(&ring, &txByte, 1u)))
+        {
+            fifo++;
+        }
+
+        /* UART transmitter */
+        credit += (uint64_t)config->baud * SIM_LOOP_US;
+        while((credit >= byteCredit) && (fifo != 0u))
+        {
+            credit -= byteCredit;
+            fifo--;
+            result->bytes++;
+        }
+        if((0u == fifo) && (credit > byteCredit))
+        {
+            credit = byteCredit;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: main()
+********************************************************************************
+*
+* Summary:
+*   Parses the link parameters and prints both directions.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static const uint32 flushMs[] = { 0u, 1u, 2u, 5u, 10u, 20u, 50u };
+    BENCH_CONFIG_T config;
+    BENCH_RESULT_T result;
+    double connIntvMs = (argc > 2) ? strtod(argv[2], NULL) : CONN_INTV_MS_DEFAULT;
+    uint32 mtu = (argc > 3) ? (uint32)strtoul(argv[3], NULL, 0) : MTU_DEFAULT;
+    uint32 i;
+
+    config.baud = (argc > 1) ? (uint32)strtoul(argv[1], NULL, 0) : BAUD_DEFAULT;
+    config.connIntvUs = (uint32)((connIntvMs * 1000.0) + 0.5);
+    config.payload = mtu - 3u;
+    config.packets = (argc > 4) ? (uint32)strtoul(argv[4], NULL, 0) : PACKETS_DEFAULT;
+    config.seconds = (argc > 5) ? (uint32)strtoul(argv[5], NULL, 0) : SECONDS_DEFAULT;
+    config.ringSize = (argc > 6) ? (uint32)strtoul(argv[6], NULL, 0) : RING_SIZE_DEFAULT;
+
+    if((0u == config.baud) || (config.connIntvUs < SIM_LOOP_US) || (mtu < MTU_MIN) || (mtu > MTU_MAX) ||
+       (0u == config.packets) || (config.packets > PACKETS_MAX) || (0u == config.seconds) ||
+       (config.ringSize < config.payload) || (config.ringSize > RING_SIZE_MAX) ||
+       (0u != (config.ringSize & (config.ringSize - 1u))))
+    {
+        fprintf(stderr, "usage: uartbridgebench [BAUD] [CONN_INTV_MS] [MTU] [PACKETS] [SECONDS] [RING_SIZE]\n"
+                        "  MTU %u..%u, PACKETS 1..%u, RING_SIZE a power of two up to %u\n",
+                        MTU_MIN, MTU_MAX, PACKETS_MAX, RING_SIZE_MAX);
+        return 1;
+    }
+
+    printf("link: %u baud, %.2f ms connection interval, MTU %u, %u packets per event, %u byte rings, %u s\n",
+           config.baud, config.connIntvUs / 1000.0, mtu, config.packets, config.ringSize, config.seconds);
+    printf("ceilings: UART %.0f B/s, BLE %.0f B/s\n\n",
+           (double)config.baud / UART_BITS_PER_BYTE,
+           ((double)config.packets * config.payload * US_PER_SEC) / config.connIntvUs);
+
+    printf("UART to BLE\n");
+    printf("  flush ms      B/s   fill %%  latency ms (mean/max)   lost B   ring max\n");
+    for(i = 0u; i < (sizeof(flushMs) / sizeof(flushMs[0])); i++)
+    {
+        SimToBle(&config, flushMs[i] * 1000u, &result);
+        printf("  %8u %8.0f %8.1f %10.2f %10.2f %10llu %10u\n", flushMs[i],
+               (double)result.bytes / config.seconds,
+               (0u != result.packets) ? ((100.0 * result.bytes) / ((double)result.packets * config.payload)) : 0.0,
+               (0u != result.packets) ? ((double)result.latencySum / result.packets / 1000.0) : 0.0,
+               (double)result.latencyMax / 1000.0,
+               (unsigned long long)result.lost, result.ringMax);
+    }
+
+    printf("\nBLE to UART\n");
+    printf("  writes         B/s    lost B   refused   ring max\n");
+    SimToUart(&config, 0u, &result);
+    printf("  command   %9.0f %9llu %9llu %10u\n", (double)result.bytes / config.seconds,
+           (unsigned long long)result.lost, (unsigned long long)result.refused, result.ringMax);
+    SimToUart(&config, 1u, &result);
+    printf("  request   %9.0f %9llu %9llu %10u\n", (double)result.bytes / config.seconds,
+           (unsigned long long)result.lost, (unsigned long long)result.refused, result.ringMax);
+
+    return 0;
+}
+
+
+/* [] END OF FILE */